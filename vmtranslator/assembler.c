@@ -0,0 +1,634 @@
+/*! \file
+***************************************************************************************************************
+file name:					assembler.c
+*	\copyright				FourE
+*	\brief					Hack assembler source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The instructions are decoded when they are appended to the instruction list, so the assembler only
+	resolves the symbols. The symbol IDs of an instruction list are mapped to the IDs of the assembler once
+	per symbol, not once per use.
+
+	The fixups are kept in one array, the uses of a symbol form a list through it. The words of the uses are
+	0 until the symbol is defined.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "assembler.h"
+#include "diagnostics.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, realloc, free
+#include <string.h>			// memset, strcmp, strlen
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define WORD_TEXT_LENGTH		(17)				// 16 bits and '\n'
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+typedef struct {
+	const char* text;
+	uint16_t value;
+} T_mnemonic;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint32_t MapSymbol(T_assembler* assembler, const T_hackProgram* program, uint32_t* ids, uint32_t id);
+static uint32_t GetSymbol(T_assembler* assembler, const char* name, uint32_t length);
+static uint8_t DefineSymbol(T_assembler* assembler, uint32_t id, uint16_t value);
+static uint8_t AddWord(T_assembler* assembler, uint16_t word);
+static uint8_t AddFixup(T_assembler* assembler, uint32_t id);
+static void ReportLabel(T_assembler* assembler, const char* name);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+static const T_mnemonic predefinedSymbols[] = {
+	 {"SP", 0}, {"LCL", 1}, {"ARG", 2}, {"THIS", 3}, {"THAT", 4}
+	,{"R0", 0}, {"R1", 1}, {"R2", 2}, {"R3", 3}, {"R4", 4}, {"R5", 5}, {"R6", 6}, {"R7", 7}
+	,{"R8", 8}, {"R9", 9}, {"R10", 10}, {"R11", 11}, {"R12", 12}, {"R13", 13}, {"R14", 14}, {"R15", 15}
+	,{"SCREEN", 16384}, {"KBD", 24576}
+};
+
+// indexed by E_outputFormat
+static const char* const formatNames[OF_COUNT] = { "asm", "hack", "bin", "c" };
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InitAssembler(T_assembler* assembler) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an assembler with the predefined symbols
+
+	\param[out]		assembler		Pointer to assembler
+
+	\returns
+			0: out of memory (the assembler can still be freed)
+			1: assembler is initialized
+
+***************************************************************************************************************
+*/
+	memset(assembler, 0, sizeof(T_assembler));
+	assembler->result = 1;
+
+	if (InitStringTable(&assembler->names) == 0) {
+		return 0;
+	}
+	for (uint8_t i = 0; i < (sizeof(predefinedSymbols) / sizeof(predefinedSymbols[0])); i++) {
+		uint32_t id = GetSymbol(assembler, predefinedSymbols[i].text, (uint32_t)strlen(predefinedSymbols[i].text));
+
+		if (id == STRING_ID_INVALID) {
+			return 0;
+		}
+		assembler->symbols[id].value = predefinedSymbols[i].value;
+		assembler->symbols[id].isDefined = 1;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End InitAssembler
+***************************************************************************************************************
+*/
+
+void FreeAssembler(T_assembler* assembler) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the symbols and the machine code of an assembler
+
+	\param[in,out]	assembler		Pointer to assembler
+
+***************************************************************************************************************
+*/
+	FreeStringTable(&assembler->names);
+	free(assembler->symbols);
+	free(assembler->fixups);
+	free(assembler->words);
+	memset(assembler, 0, sizeof(T_assembler));
+}
+/*
+***************************************************************************************************************
+	End FreeAssembler
+***************************************************************************************************************
+*/
+
+uint8_t AssembleProgram(T_assembler* assembler, const T_hackProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function encodes the instructions of an instruction list and appends them to the machine code
+
+	\param[in,out]	assembler		Pointer to assembler
+	\param[in]		program			Pointer to instruction list, NULL is skipped
+
+	\returns
+			0: out of memory or a label is defined twice (the error is reported)
+			1: instruction list was assembled
+
+	\note
+		- the instructions are counted over all lists, an error reports the line of the equivalent .asm file
+
+***************************************************************************************************************
+*/
+	uint32_t* ids = NULL;
+	uint32_t id = 0;
+
+	if (	(program == NULL)
+		|| (program->count == 0)
+	) {
+		return assembler->result;
+	}
+
+	// ID of the assembler for every symbol ID of the list, STRING_ID_INVALID until the symbol is used
+	ids = malloc(program->symbols.count * sizeof(uint32_t));
+	if (ids == NULL) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		assembler->result = 0;
+		return 0;
+	}
+	memset(ids, 0xFF, program->symbols.count * sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < program->count; i++) {
+		const T_hackInstruction* instruction = &program->instructions[i];
+
+		assembler->lineNumber++;
+		switch (instruction->kind) {
+		case HK_LABEL:
+			id = MapSymbol(assembler, program, ids, instruction->operand);
+			if (id == STRING_ID_INVALID) {
+				assembler->result = 0;
+			} else if (assembler->symbols[id].isDefined != 0) {
+				// labels are defined once, the predefined symbols are not labels
+				ReportLabel(assembler, GetString(&program->symbols, instruction->operand));
+				assembler->result = 0;
+			} else {
+				assembler->stats.labels++;
+				DefineSymbol(assembler, id, (uint16_t)assembler->count);
+			}
+			break;
+		case HK_SYMBOL:
+			id = MapSymbol(assembler, program, ids, instruction->operand);
+			if (id == STRING_ID_INVALID) {
+				assembler->result = 0;
+			} else if (assembler->symbols[id].isDefined != 0) {
+				assembler->result &= AddWord(assembler, assembler->symbols[id].value);
+			} else {
+				assembler->result &= (AddFixup(assembler, id) && AddWord(assembler, 0)) ? 1 : 0;
+			}
+			break;
+		case HK_ADDRESS:
+			assembler->result &= AddWord(assembler, (uint16_t)instruction->operand);
+			break;
+		case HK_COMPUTE:
+			assembler->result &= AddWord(assembler, EncodeComputeInstruction(instruction));
+			break;
+		default:
+			break;
+		}
+	}
+
+	free(ids);
+	return assembler->result;
+}
+/*
+***************************************************************************************************************
+	End AssembleProgram
+***************************************************************************************************************
+*/
+
+uint8_t FinishAssembly(T_assembler* assembler) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gives the symbols that are not defined as label an address as variable
+
+	\param[in,out]	assembler		Pointer to assembler that assembled all buffers
+
+	\returns
+			0: the program does not fit in ROM or there are too many variables (the error is reported)
+			1: the machine code is complete
+
+	\note
+		- the IDs of the symbols are given in the order of their first use, so are the addresses
+
+***************************************************************************************************************
+*/
+	uint32_t address = VARIABLE_START_ADDRESS;
+
+	if (assembler->count > ROM_SIZE) {
+		DIAG_ERROR(DC_ENCODING, NULL, 0, 0, "program does not fit in ROM");
+		assembler->result = 0;
+	}
+
+	for (uint32_t id = STRING_ID_NONE + 1; id < assembler->names.count; id++) {
+		if (assembler->symbols[id].isDefined != 0) {
+			continue;
+		}
+		if (address > MAX_VARIABLE_ADDRESS) {
+			DIAG_ERROR(DC_ENCODING, NULL, 0, 0, GetString(&assembler->names, id));
+			assembler->result = 0;
+			break;
+		}
+		DefineSymbol(assembler, id, (uint16_t)address);
+		assembler->stats.variables++;
+		address++;
+	}
+
+	assembler->stats.instructions = assembler->count;
+	return assembler->result;
+}
+/*
+***************************************************************************************************************
+	End FinishAssembly
+***************************************************************************************************************
+*/
+
+uint8_t WriteMachineCode(const T_assembler* assembler, E_outputFormat format, T_outputBuffer* output) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the machine code to an output buffer as .hack text or as binary image
+
+	\param[in]		assembler		Pointer to assembler after FinishAssembly
+	\param[in]		format			OF_HACK_TEXT or OF_HACK_BINARY
+	\param[in,out]	output			Pointer to output buffer the machine code is appended to
+
+	\returns
+			0: out of memory or format is not a machine code format
+			1: machine code was written
+
+***************************************************************************************************************
+*/
+	char* data = NULL;
+
+	switch (format) {
+	case OF_HACK_TEXT:
+		data = BeginAppend(output, ((size_t)assembler->count * WORD_TEXT_LENGTH) + 1);
+		if (data == NULL) {
+			return 0;
+		}
+		for (uint32_t i = 0; i < assembler->count; i++) {
+			uint16_t word = assembler->words[i];
+
+			for (uint8_t bit = 0; bit < 16; bit++) {
+				data[bit] = (char)('0' + ((word >> (15 - bit)) & 1));
+			}
+			data[16] = '\n';
+			data += WORD_TEXT_LENGTH;
+		}
+		EndAppend(output, data);
+		return 1;
+	case OF_HACK_BINARY:
+		data = BeginAppend(output, ((size_t)assembler->count * 2) + 1);
+		if (data == NULL) {
+			return 0;
+		}
+		for (uint32_t i = 0; i < assembler->count; i++) {
+			data[0] = (char)(assembler->words[i] >> 8);
+			data[1] = (char)(assembler->words[i] & 0xFF);
+			data += 2;
+		}
+		EndAppend(output, data);
+		return 1;
+	default:
+		return 0;
+	}
+}
+/*
+***************************************************************************************************************
+	End WriteMachineCode
+***************************************************************************************************************
+*/
+
+void PrintAssemblerStats(const T_assemblerStats* stats) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the size of the machine code and the number of symbols
+
+	\param[in]		stats		Pointer to statistics of the assembler
+
+***************************************************************************************************************
+*/
+	printf("assembler: %u instructions (%.1f%% of ROM), %u labels, %u variables, %u fixups\n"
+			, stats->instructions, 100.0 * stats->instructions / ROM_SIZE, stats->labels, stats->variables
+			, stats->fixups);
+}
+/*
+***************************************************************************************************************
+	End PrintAssemblerStats
+***************************************************************************************************************
+*/
+
+uint8_t ParseOutputFormat(const char* input, E_outputFormat* format) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function converts the name of an output format (asm, hack, bin, c) to the format
+
+	\param[in]		input		Pointer to name of the format
+	\param[out]		format	Pointer that receives the format
+
+	\returns
+			0: name is not a format
+			1: format was found
+
+***************************************************************************************************************
+*/
+	for (uint8_t i = 0; i < OF_COUNT; i++) {
+		if (strcmp(input, formatNames[i]) == 0) {
+			*format = (E_outputFormat)i;
+			return 1;
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End ParseOutputFormat
+***************************************************************************************************************
+*/
+
+const char* GetOutputExtension(E_outputFormat format) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the extension of the output file of a format
+
+	\param[in]		format	Output format
+
+	\returns
+		Pointer to extension with '.'
+
+***************************************************************************************************************
+*/
+	static const char* const extensions[OF_COUNT] = { ".asm", ".hack", ".bin", ".c" };
+
+	return (format < OF_COUNT) ? extensions[format] : extensions[OF_ASSEMBLY];
+}
+/*
+***************************************************************************************************************
+	End GetOutputExtension
+***************************************************************************************************************
+*/
+
+static uint32_t MapSymbol(T_assembler* assembler, const T_hackProgram* program, uint32_t* ids, uint32_t id) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the ID of the assembler for a symbol of an instruction list
+
+	\param[in,out]	assembler		Pointer to assembler
+	\param[in]		program			Pointer to instruction list
+	\param[in,out]	ids				Pointer to IDs of the assembler per ID of the list, the ID is filled in
+	\param[in]		id					ID of the symbol in the instruction list
+
+	\returns
+		ID of the symbol or STRING_ID_INVALID when out of memory (the error is reported)
+
+***************************************************************************************************************
+*/
+	if (ids[id] == STRING_ID_INVALID) {
+		ids[id] = GetSymbol(assembler, GetString(&program->symbols, id), GetStringLength(&program->symbols, id));
+	}
+	return ids[id];
+}
+/*
+***************************************************************************************************************
+	End MapSymbol
+***************************************************************************************************************
+*/
+
+static uint32_t GetSymbol(T_assembler* assembler, const char* name, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the ID of a symbol, a new symbol is added as undefined
+
+	\param[in,out]	assembler		Pointer to assembler
+	\param[in]		name				Pointer to name of the symbol
+	\param[in]		length			Length of the name
+
+	\returns
+		ID of the symbol or STRING_ID_INVALID when out of memory (the error is reported)
+
+***************************************************************************************************************
+*/
+	uint32_t id = InternString(&assembler->names, name, length);
+
+	if (id == STRING_ID_INVALID) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return STRING_ID_INVALID;
+	}
+	if (id >= assembler->symbolCapacity) {
+		uint32_t capacity = (assembler->symbolCapacity > 0) ? assembler->symbolCapacity * 2 : 64;
+		T_symbol* symbols = NULL;
+
+		while (capacity <= id) {
+			capacity *= 2;
+		}
+		symbols = realloc(assembler->symbols, capacity * sizeof(T_symbol));
+		if (symbols == NULL) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			return STRING_ID_INVALID;
+		}
+		memset(&symbols[assembler->symbolCapacity], 0, (capacity - assembler->symbolCapacity) * sizeof(T_symbol));
+		assembler->symbols = symbols;
+		assembler->symbolCapacity = capacity;
+	}
+	return id;
+}
+/*
+***************************************************************************************************************
+	End GetSymbol
+***************************************************************************************************************
+*/
+
+static uint8_t DefineSymbol(T_assembler* assembler, uint32_t id, uint16_t value) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function defines a symbol and patches its uses before the definition
+
+	\param[in,out]	assembler		Pointer to assembler
+	\param[in]		id					ID of the symbol
+	\param[in]		value				Address of the symbol
+
+	\returns
+		1: symbol is defined
+
+***************************************************************************************************************
+*/
+	T_symbol* symbol = &assembler->symbols[id];
+
+	for (uint32_t fixup = symbol->fixups; fixup != 0; fixup = assembler->fixups[fixup - 1].next) {
+		assembler->words[assembler->fixups[fixup - 1].word] = value;
+	}
+	symbol->fixups = 0;
+	symbol->value = value;
+	symbol->isDefined = 1;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End DefineSymbol
+***************************************************************************************************************
+*/
+
+static uint8_t AddWord(T_assembler* assembler, uint16_t word) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a machine word
+
+	\param[in,out]	assembler		Pointer to assembler
+	\param[in]		word				Machine word
+
+	\returns
+			0: out of memory (the error is reported)
+			1: word was added
+
+***************************************************************************************************************
+*/
+	if (assembler->count == assembler->capacity) {
+		uint32_t capacity = (assembler->capacity > 0) ? assembler->capacity * 2 : 4096;
+		uint16_t* words = realloc(assembler->words, capacity * sizeof(uint16_t));
+
+		if (words == NULL) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			return 0;
+		}
+		assembler->words = words;
+		assembler->capacity = capacity;
+	}
+	assembler->words[assembler->count] = word;
+	assembler->count++;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AddWord
+***************************************************************************************************************
+*/
+
+static uint8_t AddFixup(T_assembler* assembler, uint32_t id) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function records that the next word uses a symbol that is not defined yet
+
+	\param[in,out]	assembler		Pointer to assembler
+	\param[in]		id					ID of the symbol
+
+	\returns
+			0: out of memory (the error is reported)
+			1: fixup was added
+
+***************************************************************************************************************
+*/
+	if (assembler->fixupCount == assembler->fixupCapacity) {
+		uint32_t capacity = (assembler->fixupCapacity > 0) ? assembler->fixupCapacity * 2 : 1024;
+		T_fixup* fixups = realloc(assembler->fixups, capacity * sizeof(T_fixup));
+
+		if (fixups == NULL) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			return 0;
+		}
+		assembler->fixups = fixups;
+		assembler->fixupCapacity = capacity;
+	}
+	assembler->fixups[assembler->fixupCount].word = assembler->count;
+	assembler->fixups[assembler->fixupCount].next = assembler->symbols[id].fixups;
+	assembler->fixupCount++;
+	assembler->symbols[id].fixups = assembler->fixupCount;
+	assembler->stats.fixups++;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AddFixup
+***************************************************************************************************************
+*/
+
+static void ReportLabel(T_assembler* assembler, const char* name) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function reports a label that is defined twice or that is a predefined symbol
+
+	\param[in]		assembler		Pointer to assembler
+	\param[in]		name				Pointer to name of the label
+
+***************************************************************************************************************
+*/
+	char detail[81];
+
+	snprintf(detail, sizeof(detail), "(%s)", name);
+	DIAG_ERROR(DC_ENCODING, NULL, assembler->lineNumber, 0, detail);
+}
+/*
+***************************************************************************************************************
+	End ReportLabel
+***************************************************************************************************************
+*/
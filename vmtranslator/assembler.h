@@ -0,0 +1,144 @@
+/*! \file
+***************************************************************************************************************
+file name:					assembler.h
+*	\copyright				FourE
+*	\brief					Hack assembler header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Assembler that encodes the generated Hack instructions into 16 bit machine words, so the translator
+	can write a .hack file (text, one word of 16 '0' and '1' characters per line) or a packed binary image
+	(2 bytes per word, most significant byte first) without running a separate assembler.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The instruction lists are assembled in one pass in the order they are written. A label that is used before
+	it is defined gets a chain of fixups that is patched when the label is defined. The symbols that are
+	still undefined at the end are variables, they get the addresses from VARIABLE_START_ADDRESS on in the
+	order of their first use, the same addresses a two pass assembler gives them.
+
+***************************************************************************************************************
+*/
+
+#ifndef __ASSEMBLER_H
+#define __ASSEMBLER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "outputbuffer.h"
+#include "hackprogram.h"
+#include "stringtable.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define VARIABLE_START_ADDRESS	(16)			// address of the first variable (the statics)
+#define MAX_VARIABLE_ADDRESS		(16383)		// last address below the screen
+#define ROM_SIZE						(32768)		// number of instructions the Hack ROM holds
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 OF_ASSEMBLY = 0						// .asm, the assembler is not used
+	,OF_HACK_TEXT							// .hack, one word per line in '0' and '1'
+	,OF_HACK_BINARY						// .bin, 2 bytes per word, most significant byte first
+	,OF_C_SOURCE							// .c, C code from the C code writer, the assembler is not used
+	,OF_COUNT
+} E_outputFormat;
+
+typedef struct {
+	uint32_t instructions;				// number of machine words
+	uint32_t labels;						// number of labels that were defined
+	uint32_t variables;					// number of variables that got an address
+	uint32_t fixups;						// number of uses of a label before its definition
+} T_assemblerStats;
+
+// symbol, the ID in the symbol table is the index
+typedef struct {
+	uint32_t fixups;						// first fixup of the uses before the definition + 1, 0: none
+	uint16_t value;						// address, only valid when defined
+	uint8_t isDefined;					// 1: predefined symbol or label that is defined
+} T_symbol;
+
+// use of a symbol before its definition
+typedef struct {
+	uint32_t word;							// index of the A-instruction
+	uint32_t next;							// next fixup of the same symbol + 1, 0: none
+} T_fixup;
+
+typedef struct {
+	T_stringTable names;					// names of the symbols, the ID is the index in symbols
+	T_symbol* symbols;
+	uint32_t symbolCapacity;
+	T_fixup* fixups;
+	uint32_t fixupCount;
+	uint32_t fixupCapacity;
+	uint16_t* words;						// machine code
+	uint32_t count;						// number of words
+	uint32_t capacity;
+	uint32_t lineNumber;					// line of the assembly code, counted over all instruction lists
+	uint8_t result;						// 0: an error was reported
+	T_assemblerStats stats;
+} T_assembler;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InitAssembler(T_assembler* assembler);
+void FreeAssembler(T_assembler* assembler);
+uint8_t AssembleProgram(T_assembler* assembler, const T_hackProgram* program);
+uint8_t FinishAssembly(T_assembler* assembler);
+uint8_t WriteMachineCode(const T_assembler* assembler, E_outputFormat format, T_outputBuffer* output);
+void PrintAssemblerStats(const T_assemblerStats* stats);
+uint8_t ParseOutputFormat(const char* input, E_outputFormat* format);
+const char* GetOutputExtension(E_outputFormat format);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __ASSEMBLER_H
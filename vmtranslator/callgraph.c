@@ -0,0 +1,776 @@
+/*! \file
+***************************************************************************************************************
+file name:					callgraph.c
+*	\copyright				FourE
+*	\brief					call graph source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The functions are stored in the order of the programs and of their function commands, the callees of a
+	function are a range in one array of function indices. Reachability is marked with an explicit stack, deep
+	call chains do not use the C stack.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "callgraph.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, calloc, free
+#include <string.h>			// memset, memmove, strlen
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+// state of a label while the stack depth of a function is followed
+#define LABEL_JUMPED					(1u << 0)		// a goto or if-goto to the label was seen
+#define LABEL_DEFINED				(1u << 1)		// the label command was seen
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint32_t LookupFunction(const T_callGraph* graph, const T_vmProgram* program, uint32_t nameId);
+static T_labelDepth* GetLabelDepth(T_labelDepth* labels, uint32_t* count, uint32_t nameId);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t BuildCallGraph(T_callGraph* graph, T_vmProgram* const* programs, uint32_t count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function builds the call graph of the functions of all VM programs
+
+	\param[out]		graph			Pointer to call graph
+	\param[in]		programs		Pointer to array of pointers to parsed VM programs
+	\param[in]		count			Number of VM programs
+
+	\returns
+		0: out of memory (the graph is freed)
+		1: graph is built
+
+	\note
+		- when a function is defined more than once the first definition is used for its calls
+
+***************************************************************************************************************
+*/
+	uint32_t functionCount = 0;
+	uint32_t callCount = 0;
+
+	memset(graph, 0, sizeof(T_callGraph));
+	if (InitStringTable(&graph->names) == 0) {
+		return 0;
+	}
+
+	for (uint32_t p = 0; p < count; p++) {
+		for (uint32_t i = 0; i < programs[p]->count; i++) {
+			if (programs[p]->commands[i].commandType == CT_FUNCTION) {
+				functionCount++;
+			} else if (programs[p]->commands[i].commandType == CT_CALL) {
+				callCount++;
+			}
+		}
+	}
+
+	graph->functions = calloc((functionCount > 0) ? functionCount : 1, sizeof(T_callGraphFunction));
+	graph->callees = malloc(((callCount > 0) ? callCount : 1) * sizeof(uint32_t));
+	graph->roots = malloc(((callCount > 0) ? callCount : 1) * sizeof(uint32_t));
+	if (	(graph->functions == NULL)
+		|| (graph->callees == NULL)
+		|| (graph->roots == NULL)
+	) {
+		FreeCallGraph(graph);
+		return 0;
+	}
+
+	// the functions and their ranges of commands
+	for (uint32_t p = 0; p < count; p++) {
+		const T_vmProgram* program = programs[p];
+		T_callGraphFunction* function = NULL;
+
+		for (uint32_t i = 0; i < program->count; i++) {
+			const T_vmCommand* command = &program->commands[i];
+
+			if (command->commandType != CT_FUNCTION) {
+				continue;
+			}
+			if (function != NULL) {
+				function->endCommand = i;
+			}
+			function = &graph->functions[graph->count];
+			function->nameId = InternString(&graph->names, GetString(&program->names, command->nameId)
+													, GetStringLength(&program->names, command->nameId));
+			if (function->nameId == STRING_ID_INVALID) {
+				FreeCallGraph(graph);
+				return 0;
+			}
+			function->program = p;
+			function->firstCommand = i;
+			graph->count++;
+		}
+		if (function != NULL) {
+			function->endCommand = program->count;
+		}
+	}
+
+	graph->nameCount = graph->names.count;
+	graph->functionByName = malloc(graph->nameCount * sizeof(uint32_t));
+	if (graph->functionByName == NULL) {
+		FreeCallGraph(graph);
+		return 0;
+	}
+	for (uint32_t i = 0; i < graph->nameCount; i++) {
+		graph->functionByName[i] = FUNCTION_NONE;
+	}
+	for (uint32_t f = graph->count; f > 0; f--) {
+		graph->functionByName[graph->functions[f - 1].nameId] = f - 1;
+	}
+
+	// the callees of every function, calls before the first function of a file are roots
+	for (uint32_t p = 0, f = 0; p < count; p++) {
+		const T_vmProgram* program = programs[p];
+		uint32_t firstFunction = program->count;
+
+		if (	(f < graph->count)
+			&& (graph->functions[f].program == p)
+		) {
+			firstFunction = graph->functions[f].firstCommand;
+		}
+		for (uint32_t i = 0; i < firstFunction; i++) {
+			if (program->commands[i].commandType == CT_CALL) {
+				uint32_t callee = LookupFunction(graph, program, program->commands[i].nameId);
+
+				if (callee != FUNCTION_NONE) {
+					graph->roots[graph->rootCount] = callee;
+					graph->rootCount++;
+				}
+			}
+		}
+
+		for (; (f < graph->count) && (graph->functions[f].program == p); f++) {
+			T_callGraphFunction* function = &graph->functions[f];
+
+			function->firstCallee = graph->calleeCount;
+			for (uint32_t i = function->firstCommand; i < function->endCommand; i++) {
+				if (program->commands[i].commandType == CT_CALL) {
+					graph->callees[graph->calleeCount] = LookupFunction(graph, program, program->commands[i].nameId);
+					graph->calleeCount++;
+				}
+			}
+			function->calleeCount = graph->calleeCount - function->firstCallee;
+		}
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End BuildCallGraph
+***************************************************************************************************************
+*/
+
+void FreeCallGraph(T_callGraph* graph) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees all memory of a call graph
+
+	\param[in,out]	graph		Pointer to call graph
+
+***************************************************************************************************************
+*/
+	FreeStringTable(&graph->names);
+	free(graph->functions);
+	free(graph->callees);
+	free(graph->roots);
+	free(graph->functionByName);
+	memset(graph, 0, sizeof(T_callGraph));
+}
+/*
+***************************************************************************************************************
+	End FreeCallGraph
+***************************************************************************************************************
+*/
+
+uint32_t FindFunction(const T_callGraph* graph, const char* name) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds a function by its name
+
+	\param[in]		graph		Pointer to call graph
+	\param[in]		name		Pointer to nul terminated function name
+
+	\returns
+		Index of the function, FUNCTION_NONE when the function is not defined
+
+***************************************************************************************************************
+*/
+	uint32_t nameId = FindString(&graph->names, name, (uint32_t)strlen(name));
+
+	if (	(nameId == STRING_ID_INVALID)
+		|| (nameId >= graph->nameCount)
+	) {
+		return FUNCTION_NONE;
+	}
+	return graph->functionByName[nameId];
+}
+/*
+***************************************************************************************************************
+	End FindFunction
+***************************************************************************************************************
+*/
+
+uint32_t MarkReachable(T_callGraph* graph, uint32_t entry) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function marks the functions that can be called from the entry function or from a root
+
+	\param[in,out]	graph		Pointer to call graph
+	\param[in]		entry		Index of the entry function, FUNCTION_NONE for none
+
+	\returns
+		Number of reachable functions, FUNCTION_NONE when out of memory (then every function is marked)
+
+	\note
+		- every function is pushed at most once, so the stack never holds more than all functions
+
+***************************************************************************************************************
+*/
+	uint32_t* stack = malloc(((graph->count > 0) ? graph->count : 1) * sizeof(uint32_t));
+	uint32_t depth = 0;
+	uint32_t reachable = 0;
+
+	if (stack == NULL) {
+		for (uint32_t f = 0; f < graph->count; f++) {
+			graph->functions[f].reachable = 1;
+		}
+		return FUNCTION_NONE;
+	}
+
+	for (uint32_t f = 0; f < graph->count; f++) {
+		graph->functions[f].reachable = 0;
+	}
+
+	for (uint32_t i = 0; i <= graph->rootCount; i++) {
+		uint32_t root = (i < graph->rootCount) ? graph->roots[i] : entry;
+
+		if (	(root == FUNCTION_NONE)
+			|| (graph->functions[root].reachable != 0)
+		) {
+			continue;
+		}
+		graph->functions[root].reachable = 1;
+		stack[depth] = root;
+		depth++;
+
+		while (depth > 0) {
+			const T_callGraphFunction* function = &graph->functions[stack[depth - 1]];
+
+			depth--;
+			reachable++;
+			for (uint32_t c = 0; c < function->calleeCount; c++) {
+				uint32_t callee = graph->callees[function->firstCallee + c];
+
+				if (	(callee != FUNCTION_NONE)
+					&& (graph->functions[callee].reachable == 0)
+				) {
+					graph->functions[callee].reachable = 1;
+					stack[depth] = callee;
+					depth++;
+				}
+			}
+		}
+	}
+
+	free(stack);
+	return reachable;
+}
+/*
+***************************************************************************************************************
+	End MarkReachable
+***************************************************************************************************************
+*/
+
+uint32_t RemoveUnreachable(const T_callGraph* graph, T_vmProgram* const* programs) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function removes the commands of the functions that are not reachable from the VM programs
+
+	\param[in]		graph			Pointer to call graph with marked functions
+	\param[in,out]	programs		Pointer to array of pointers to the VM programs the graph was built from
+
+	\returns
+		Number of commands that were removed
+
+	\note
+		- the graph keeps the original command ranges, they are no longer valid for the programs afterwards
+
+***************************************************************************************************************
+*/
+	uint32_t removed = 0;
+	uint32_t f = 0;
+
+	while (f < graph->count) {
+		T_vmProgram* program = programs[graph->functions[f].program];
+		uint32_t p = graph->functions[f].program;
+		uint32_t read = 0;
+		uint32_t write = 0;
+
+		for (; (f < graph->count) && (graph->functions[f].program == p); f++) {
+			const T_callGraphFunction* function = &graph->functions[f];
+
+			if (function->reachable != 0) {
+				continue;
+			}
+			memmove(&program->commands[write], &program->commands[read], (function->firstCommand - read) * sizeof(T_vmCommand));
+			write += function->firstCommand - read;
+			read = function->endCommand;
+			removed += function->endCommand - function->firstCommand;
+		}
+		memmove(&program->commands[write], &program->commands[read], (program->count - read) * sizeof(T_vmCommand));
+		write += program->count - read;
+		program->count = write;
+	}
+	return removed;
+}
+/*
+***************************************************************************************************************
+	End RemoveUnreachable
+***************************************************************************************************************
+*/
+
+void PrintUnreachable(const T_callGraph* graph) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the functions that are not reachable and their size in VM commands
+
+	\param[in]		graph		Pointer to call graph with marked functions
+
+***************************************************************************************************************
+*/
+	uint32_t functions = 0;
+	uint32_t commands = 0;
+
+	for (uint32_t f = 0; f < graph->count; f++) {
+		const T_callGraphFunction* function = &graph->functions[f];
+
+		if (function->reachable == 0) {
+			functions++;
+			commands += function->endCommand - function->firstCommand;
+		}
+	}
+
+	printf("dead functions: %u of %u functions, %u VM commands removed\n", functions, graph->count, commands);
+	for (uint32_t f = 0; f < graph->count; f++) {
+		const T_callGraphFunction* function = &graph->functions[f];
+
+		if (function->reachable == 0) {
+			printf("  %-40s %8u commands\n", GetString(&graph->names, function->nameId)
+					, function->endCommand - function->firstCommand);
+		}
+	}
+}
+/*
+***************************************************************************************************************
+	End PrintUnreachable
+***************************************************************************************************************
+*/
+
+uint32_t FindComponents(T_callGraph* graph) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the strongly connected components of the call graph and marks the recursive functions
+
+	\param[in,out]	graph		Pointer to call graph
+
+	\returns
+		Number of components, FUNCTION_NONE when out of memory (then every function is marked recursive)
+
+	\note
+		- Tarjan's algorithm with an explicit stack, a component is numbered when all components it calls are
+		  numbered, so the components in decreasing order are in topological order (callers first)
+		- calls of functions that are not defined are ignored
+
+***************************************************************************************************************
+*/
+	uint32_t size = (graph->count > 0) ? graph->count : 1;
+	uint32_t* order = malloc(size * sizeof(uint32_t));			// discovery order, FUNCTION_NONE: not visited
+	uint32_t* lowLink = malloc(size * sizeof(uint32_t));		// lowest order that can be reached
+	uint32_t* nextCallee = malloc(size * sizeof(uint32_t));	// next callee to visit of a function on the path
+	uint32_t* path = malloc(size * sizeof(uint32_t));			// functions of the depth first search
+	uint32_t* members = malloc(size * sizeof(uint32_t));		// functions without component yet
+	uint32_t pathDepth = 0;
+	uint32_t memberCount = 0;
+	uint32_t counter = 0;
+	uint32_t components = 0;
+
+	for (uint32_t f = 0; f < graph->count; f++) {
+		graph->functions[f].component = FUNCTION_NONE;
+		graph->functions[f].recursive = 0;
+	}
+
+	if (	(order == NULL)
+		|| (lowLink == NULL)
+		|| (nextCallee == NULL)
+		|| (path == NULL)
+		|| (members == NULL)
+	) {
+		for (uint32_t f = 0; f < graph->count; f++) {
+			graph->functions[f].component = f;
+			graph->functions[f].recursive = 1;
+		}
+		free(order);
+		free(lowLink);
+		free(nextCallee);
+		free(path);
+		free(members);
+		return FUNCTION_NONE;
+	}
+
+	for (uint32_t f = 0; f < graph->count; f++) {
+		order[f] = FUNCTION_NONE;
+	}
+
+	for (uint32_t root = 0; root < graph->count; root++) {
+		if (order[root] != FUNCTION_NONE) {
+			continue;
+		}
+		order[root] = counter;
+		lowLink[root] = counter;
+		counter++;
+		nextCallee[root] = 0;
+		members[memberCount] = root;
+		memberCount++;
+		path[pathDepth] = root;
+		pathDepth++;
+
+		while (pathDepth > 0) {
+			uint32_t f = path[pathDepth - 1];
+			T_callGraphFunction* function = &graph->functions[f];
+
+			if (nextCallee[f] < function->calleeCount) {
+				uint32_t callee = graph->callees[function->firstCallee + nextCallee[f]];
+
+				nextCallee[f]++;
+				if (callee == FUNCTION_NONE) {
+					continue;
+				}
+				if (callee == f) {
+					function->recursive = 1;
+				} else if (order[callee] == FUNCTION_NONE) {
+					order[callee] = counter;
+					lowLink[callee] = counter;
+					counter++;
+					nextCallee[callee] = 0;
+					members[memberCount] = callee;
+					memberCount++;
+					path[pathDepth] = callee;
+					pathDepth++;
+				} else if (	(graph->functions[callee].component == FUNCTION_NONE)
+							&& (order[callee] < lowLink[f])
+				) {
+					// the callee is still on the member stack, so it is in the component of f
+					lowLink[f] = order[callee];
+				}
+				continue;
+			}
+
+			// all callees are visited
+			pathDepth--;
+			if (	(pathDepth > 0)
+				&& (lowLink[f] < lowLink[path[pathDepth - 1]])
+			) {
+				lowLink[path[pathDepth - 1]] = lowLink[f];
+			}
+			if (lowLink[f] == order[f]) {
+				uint32_t first = memberCount;
+
+				do {
+					first--;
+					graph->functions[members[first]].component = components;
+				} while (members[first] != f);
+				if ((memberCount - first) > 1) {
+					for (uint32_t i = first; i < memberCount; i++) {
+						graph->functions[members[i]].recursive = 1;
+					}
+				}
+				memberCount = first;
+				components++;
+			}
+		}
+	}
+
+	free(order);
+	free(lowLink);
+	free(nextCallee);
+	free(path);
+	free(members);
+	return components;
+}
+/*
+***************************************************************************************************************
+	End FindComponents
+***************************************************************************************************************
+*/
+
+uint8_t CheckStackDepth(const T_vmProgram* program, const T_callGraphFunction* function, T_labelDepth* labels) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks that every return of a function leaves exactly the return value on its stack
+
+	\param[in]		program		Pointer to VM program of the function
+	\param[in]		function		Pointer to function in the call graph
+	\param[out]		labels		Pointer to scratch array with an entry for every command of the function
+
+	\returns
+		0: the stack depth of the function can not be followed
+		1: the stack depth is 1 at every return and the body does not fall through at its end
+
+	\note
+		- the stack depth is followed through the body, at every label it must be the same for all jumps to it
+		  and a call of n arguments replaces them by the return value
+		- code that is only reached by a backward jump is not followed, such functions are rejected
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* body = &program->commands[function->firstCommand];
+	uint32_t length = function->endCommand - function->firstCommand;
+	uint32_t labelCount = 0;
+	int32_t depth = 0;
+	uint8_t reachable = 1;
+
+	for (uint32_t i = 1; i < length; i++) {
+		const T_vmCommand* command = &body[i];
+		T_labelDepth* label = NULL;
+
+		if (command->commandType == CT_LABEL) {
+			label = GetLabelDepth(labels, &labelCount, command->nameId);
+			if ((label->state & LABEL_DEFINED) != 0) {
+				return 0;
+			}
+			if (reachable != 0) {
+				if (	((label->state & LABEL_JUMPED) != 0)
+					&& (label->depth != depth)
+				) {
+					return 0;
+				}
+				label->depth = depth;
+			} else if ((label->state & LABEL_JUMPED) != 0) {
+				depth = label->depth;
+				reachable = 1;
+			} else {
+				return 0;
+			}
+			label->state |= LABEL_DEFINED;
+			continue;
+		}
+		if (reachable == 0) {
+			return 0;
+		}
+
+		switch (command->commandType) {
+		case CT_ADD:
+		case CT_SUB:
+		case CT_EQ:
+		case CT_GT:
+		case CT_LT:
+		case CT_AND:
+		case CT_OR:
+			if (depth < 2) {
+				return 0;
+			}
+			depth--;
+			break;
+		case CT_NEG:
+		case CT_NOT:
+			if (depth < 1) {
+				return 0;
+			}
+			break;
+		case CT_PUSH:
+			depth++;
+			break;
+		case CT_POP:
+			if (depth < 1) {
+				return 0;
+			}
+			depth--;
+			break;
+		case CT_CALL:
+			if (depth < (int32_t)command->value) {
+				return 0;
+			}
+			depth -= (int32_t)command->value - 1;
+			break;
+		case CT_GOTO:
+		case CT_IFGOTO:
+			if (command->commandType == CT_IFGOTO) {
+				if (depth < 1) {
+					return 0;
+				}
+				depth--;
+			} else {
+				reachable = 0;
+			}
+			label = GetLabelDepth(labels, &labelCount, command->nameId);
+			if ((label->state & (LABEL_JUMPED | LABEL_DEFINED)) != 0) {
+				if (label->depth != depth) {
+					return 0;
+				}
+			} else {
+				label->depth = depth;
+			}
+			label->state |= LABEL_JUMPED;
+			break;
+		case CT_RETURN:
+			if (depth != 1) {
+				return 0;
+			}
+			reachable = 0;
+			break;
+		default:
+			return 0;
+		}
+	}
+
+	if (reachable != 0) {
+		return 0;
+	}
+	for (uint32_t i = 0; i < labelCount; i++) {
+		if ((labels[i].state & LABEL_DEFINED) == 0) {
+			return 0;
+		}
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End CheckStackDepth
+***************************************************************************************************************
+*/
+
+static uint32_t LookupFunction(const T_callGraph* graph, const T_vmProgram* program, uint32_t nameId) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the function a name of a VM program refers to
+
+	\param[in]		graph			Pointer to call graph
+	\param[in]		program		Pointer to VM program
+	\param[in]		nameId		ID of the name in the string table of the VM program
+
+	\returns
+		Index of the function, FUNCTION_NONE when the function is not defined
+
+***************************************************************************************************************
+*/
+	uint32_t id = FindString(&graph->names, GetString(&program->names, nameId), GetStringLength(&program->names, nameId));
+
+	if (	(id == STRING_ID_INVALID)
+		|| (id >= graph->nameCount)
+	) {
+		return FUNCTION_NONE;
+	}
+	return graph->functionByName[id];
+}
+/*
+***************************************************************************************************************
+	End LookupFunction
+***************************************************************************************************************
+*/
+
+static T_labelDepth* GetLabelDepth(T_labelDepth* labels, uint32_t* count, uint32_t nameId) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the entry of a label, a new entry is added when the label is not known yet
+
+	\param[in,out]	labels		Pointer to array of labels
+	\param[in,out]	count			Pointer to number of labels in the array
+	\param[in]		nameId		ID of the label name
+
+	\returns
+		Pointer to the entry of the label
+
+	\note
+		- a function has fewer labels than commands, so the array never overflows
+
+***************************************************************************************************************
+*/
+	for (uint32_t i = 0; i < *count; i++) {
+		if (labels[i].nameId == nameId) {
+			return &labels[i];
+		}
+	}
+	labels[*count].nameId = nameId;
+	labels[*count].depth = 0;
+	labels[*count].state = 0;
+	(*count)++;
+	return &labels[*count - 1];
+}
+/*
+***************************************************************************************************************
+	End GetLabelDepth
+***************************************************************************************************************
+*/
@@ -0,0 +1,130 @@
+/*! \file
+***************************************************************************************************************
+file name:					callgraph.h
+*	\copyright				FourE
+*	\brief					call graph header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Call graph of the functions of all parsed .vm files of a program, used for whole program optimizations.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	A function is identified by its index in the graph, the names of all files are interned in one string
+	table of the graph. Commands before the first function of a file belong to no function, the functions
+	they call are roots just like the entry function.
+
+	The strongly connected components of the graph are found with Tarjan's algorithm, a function that is in
+	a component with other functions or that calls itself is recursive.
+
+***************************************************************************************************************
+*/
+
+#ifndef __CALLGRAPH_H
+#define __CALLGRAPH_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "parser.h"
+#include "stringtable.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define FUNCTION_NONE		(0xFFFFFFFFu)
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// one function command and the commands up to the next function command (or the end of the file)
+typedef struct {
+	uint32_t nameId;						// name in the string table of the graph
+	uint32_t program;						// index of the VM program the function belongs to
+	uint32_t firstCommand;				// index of the function command
+	uint32_t endCommand;					// index after the last command of the function
+	uint32_t firstCallee;				// index of the first callee in the callee array of the graph
+	uint32_t calleeCount;				// number of call commands of the function
+	uint32_t component;					// strongly connected component, callees have a lower index
+	uint8_t reachable;					// 1: the function can be called from a root
+	uint8_t recursive;					// 1: the function can call itself (directly or through its callees)
+} T_callGraphFunction;
+
+typedef struct {
+	T_stringTable names;					// names of the defined functions
+	T_callGraphFunction* functions;
+	uint32_t count;
+	uint32_t* callees;					// function index of every call command, FUNCTION_NONE: not defined
+	uint32_t calleeCount;
+	uint32_t* roots;						// functions that are called outside a function
+	uint32_t rootCount;
+	uint32_t* functionByName;			// function index of every name ID, FUNCTION_NONE: not defined
+	uint32_t nameCount;					// number of names in functionByName
+} T_callGraph;
+
+// stack depth at a label of a function that is checked, CheckStackDepth needs one entry per command
+typedef struct {
+	uint32_t nameId;
+	int32_t depth;
+	uint8_t state;							// LABEL_ flags of callgraph.c
+} T_labelDepth;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t BuildCallGraph(T_callGraph* graph, T_vmProgram* const* programs, uint32_t count);
+void FreeCallGraph(T_callGraph* graph);
+uint32_t FindFunction(const T_callGraph* graph, const char* name);
+uint32_t MarkReachable(T_callGraph* graph, uint32_t entry);
+uint32_t RemoveUnreachable(const T_callGraph* graph, T_vmProgram* const* programs);
+void PrintUnreachable(const T_callGraph* graph);
+uint32_t FindComponents(T_callGraph* graph);
+uint8_t CheckStackDepth(const T_vmProgram* program, const T_callGraphFunction* function, T_labelDepth* labels);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __CALLGRAPH_H
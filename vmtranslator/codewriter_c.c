@@ -0,0 +1,855 @@
+/*! \file
+***************************************************************************************************************
+file name:					codewriter_c.c
+*	\copyright				FourE
+*	\brief					C code writer source file
+*	\author					agent
+*	\date	created:			2026-10-18
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	A call pushes the frame like the Hack translation and then calls the C function, a return restores the
+	frame and returns from it. The C call stack is the dispatch, the return address on the VM stack is the
+	number of the call site (the bootstrap call is 0), like the VM interpreter pushes it. Code that runs
+	past the end of a function falls through into the next one: the C function calls the next and returns.
+
+	"label L" followed by "goto L" is the endless loop a program ends with, it is written as a stop of the
+	program, so the RAM can be printed.
+
+	The stack pointer is the global variable sp instead of RAM[0], so the C compiler can keep it in a
+	register. RAM[0] is only written before a push through LCL, ARG, THIS or THAT and when the program
+	stops, the only ways a program can read it, and a pop through those pointers that writes RAM[0] loads sp
+	again.
+
+	The names of the VM code are written as C names: letters and digits are kept, '_' becomes "__", '.'
+	becomes "_0" and every other character '_' and its two hex digits, so different names stay different.
+	Functions get the prefix F_, the code of a file before its first function T_, labels L_ and statics S_.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "codewriter_c.h"
+#include "assembler.h"			// VARIABLE_START_ADDRESS, MAX_VARIABLE_ADDRESS
+#include "diagnostics.h"
+#include "stringtable.h"
+#include <stdio.h>
+#include <stdlib.h>			// calloc, free
+#include <string.h>			// strlen
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define POINTER_ADDRESS			(3)				// pointer 0 is THIS, pointer 1 is THAT
+#define TEMP_ADDRESS				(5)
+#define MAX_NAME_EXPANSION		(3)				// characters a character of a VM name can become
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t WriteCCommand(T_outputBuffer* output, const T_vmProgram* program, const char* fileName, uint32_t index, uint32_t* callSite);
+static uint8_t WriteStaticAddresses(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count);
+static uint8_t WritePrototypes(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count);
+static uint8_t WriteMain(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, uint8_t bootstrap);
+static uint8_t AppendRegionName(T_outputBuffer* output, const T_vmProgram* program, const char* fileName, uint32_t command);
+static uint8_t AppendCName(T_outputBuffer* output, const char* prefix, const char* name, uint32_t length);
+static uint8_t AppendStaticName(T_outputBuffer* output, const char* fileName, uint16_t index);
+static void MarkUsedLabels(const T_vmProgram* program, uint32_t first, uint32_t end, uint32_t* labelRegions, uint32_t region);
+static uint8_t IsHalt(const T_vmProgram* program, uint32_t index);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// RAM, stack and calling convention of the generated program
+static const char runtime[] =
+	"#include <stdint.h>\n"
+	"#include <stdio.h>\n"
+	"#include <stdlib.h>\n"
+	"\n"
+	"// every 16 bit address is valid, so no address is masked\n"
+	"static uint16_t RAM[65536];\n"
+	"// stack pointer, RAM[0] is only written where the program can read it\n"
+	"static uint16_t sp;\n"
+	"static int argumentCount;\n"
+	"static char** arguments;\n"
+	"\n"
+	"#define PUSH(value)\t\t(RAM[sp++] = (uint16_t)(value))\n"
+	"#define POP()\t\t\t\t(RAM[--sp])\n"
+	"#define TOP\t\t\t\t\t(RAM[(uint16_t)(sp - 1)])\n"
+	"#define BINARY(op)\t\tdo { sp--; TOP = (uint16_t)(TOP op RAM[sp]); } while (0)\n"
+	"// eq, gt and lt compare the difference of the two words like the Hack translation does\n"
+	"#define COMPARE(op)\t\tdo { sp--; TOP = ((int16_t)(uint16_t)(TOP - RAM[sp]) op 0) ? 0xFFFF : 0; } while (0)\n"
+	"\n"
+	"static inline void PushSegment(uint16_t pointer, uint16_t index) {\n"
+	"\tRAM[0] = sp;\n"
+	"\tPUSH(RAM[(uint16_t)(RAM[pointer] + index)]);\n"
+	"}\n"
+	"\n"
+	"static inline void PopSegment(uint16_t pointer, uint16_t index) {\n"
+	"\tuint16_t address = (uint16_t)(RAM[pointer] + index);\n"
+	"\n"
+	"\tRAM[address] = POP();\n"
+	"\tif (address == 0) {\n"
+	"\t\tsp = RAM[0];\n"
+	"\t}\n"
+	"}\n"
+	"\n"
+	"static inline void PushZeros(uint16_t count) {\n"
+	"\tfor (uint16_t i = 0; i < count; i++) {\n"
+	"\t\tPUSH(0);\n"
+	"\t}\n"
+	"}\n"
+	"\n"
+	"static inline void Call(void (*function)(void), uint16_t argumentWords, uint16_t returnAddress) {\n"
+	"\tPUSH(returnAddress);\n"
+	"\tPUSH(RAM[1]);\n"
+	"\tPUSH(RAM[2]);\n"
+	"\tPUSH(RAM[3]);\n"
+	"\tPUSH(RAM[4]);\n"
+	"\tRAM[2] = (uint16_t)(sp - 5 - argumentWords);\n"
+	"\tRAM[1] = sp;\n"
+	"\tfunction();\n"
+	"}\n"
+	"\n"
+	"static inline void Return(void) {\n"
+	"\tuint16_t frame = RAM[1];\n"
+	"\n"
+	"\tRAM[RAM[2]] = TOP;\n"
+	"\tsp = (uint16_t)(RAM[2] + 1);\n"
+	"\tRAM[4] = RAM[(uint16_t)(frame - 1)];\n"
+	"\tRAM[3] = RAM[(uint16_t)(frame - 2)];\n"
+	"\tRAM[2] = RAM[(uint16_t)(frame - 3)];\n"
+	"\tRAM[1] = RAM[(uint16_t)(frame - 4)];\n"
+	"}\n"
+	"\n"
+	"// prints the RAM words of the arguments \"first-last\" or \"address\" and ends the program\n"
+	"static void Stop(const char* reason) {\n"
+	"\tRAM[0] = sp;\n"
+	"\tprintf(\"program: %s\\n\", reason);\n"
+	"\tfor (int i = 1; i < argumentCount; i++) {\n"
+	"\t\tchar* end = NULL;\n"
+	"\t\tlong first = strtol(arguments[i], &end, 10);\n"
+	"\t\tlong last = (*end == '-') ? strtol(end + 1, &end, 10) : first;\n"
+	"\n"
+	"\t\tif ((*end != '\\0') || (first < 0) || (last < first) || (last > 65535)) {\n"
+	"\t\t\tcontinue;\n"
+	"\t\t}\n"
+	"\t\tprintf(\"RAM[%ld..%ld]:\", first, last);\n"
+	"\t\tfor (long address = first; address <= last; address++) {\n"
+	"\t\t\tprintf(\" %d\", (int16_t)RAM[address]);\n"
+	"\t\t}\n"
+	"\t\tprintf(\"\\n\");\n"
+	"\t}\n"
+	"\texit(EXIT_SUCCESS);\n"
+	"}\n"
+	"\n";
+
+// RAM address of the pointer of a segment, indexed by E_memorySegment
+static const uint8_t segmentPointers[MS_UNKNOWN] = {
+	 [MS_LOCAL] = 1, [MS_ARGUMENT] = 2, [MS_THIS] = 3, [MS_THAT] = 4
+};
+
+// operators of the arithmetic commands, indexed by E_commandType
+static const char* const arithmeticStatements[CT_UNKNOWN] = {
+	 [CT_ADD] = "\tBINARY(+);\n", [CT_SUB] = "\tBINARY(-);\n", [CT_NEG] = "\tTOP = (uint16_t)-TOP;\n"
+	,[CT_EQ] = "\tCOMPARE(==);\n", [CT_GT] = "\tCOMPARE(>);\n", [CT_LT] = "\tCOMPARE(<);\n"
+	,[CT_AND] = "\tBINARY(&);\n", [CT_OR] = "\tBINARY(|);\n", [CT_NOT] = "\tTOP = (uint16_t)~TOP;\n"
+};
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t WriteCPreamble(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, uint8_t bootstrap) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the start of the C program: the runtime, the addresses of the statics, the prototypes
+		of the functions and main
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		programs			Array of parsed programs, in the order their code is written
+	\param[in]		fileNames		Array of their file names without path and extension
+	\param[in]		count				Number of programs
+	\param[in]		bootstrap		1: main sets SP = 256 and calls Sys.init, 0: main sets SP from RAM[0] and
+											runs the code of the first file
+
+	\returns
+			0: out of memory
+			1: preamble is written
+
+	\note
+		- the generated program takes arguments "address=value" that set RAM words before the run and
+		  "first-last" or "address" that print RAM words after the run
+
+***************************************************************************************************************
+*/
+	if (	(AppendString(output, "// C translation of VM code, RAM dumps are comparable with the Hack translation\n\n") == 0)
+		|| (AppendBytes(output, runtime, sizeof(runtime) - 1) == 0)
+		|| (WriteStaticAddresses(output, programs, fileNames, count) == 0)
+		|| (WritePrototypes(output, programs, fileNames, count) == 0)
+		|| (WriteMain(output, programs, fileNames, count, bootstrap) == 0)
+	) {
+		return 0;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End WriteCPreamble
+***************************************************************************************************************
+*/
+
+uint8_t WriteCCommandRange(T_outputBuffer* output, const T_vmProgram* program, const char* fileName, const char* sourcePath, uint32_t first, uint32_t end, const T_cRegion* next, uint32_t firstCallSite) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the C functions of a range of commands
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		program			Pointer to parsed program
+	\param[in]		fileName			Pointer to file name without path and extension
+	\param[in]		sourcePath		Pointer to path of the .vm file that diagnostics report
+	\param[in]		first				Index of first command, a function command or 0
+	\param[in]		end				Index after the last command, the next command is a function command
+	\param[in]		next				Pointer to start of the function the code falls through into at the end
+	\param[in]		firstCallSite	Number of the first call of the range, see CountCalls
+
+	\returns
+			0: out of memory or a command can not be written (the errors are reported)
+			1: commands are written
+
+	\note
+		- a label is only written when a goto or if-goto of its function uses it, C compilers warn about
+		  unused labels
+
+***************************************************************************************************************
+*/
+	uint32_t* labelRegions = NULL;
+	uint32_t callSite = firstCallSite;
+	uint32_t region = 0;
+	uint8_t isOpen = 0;					// 1: a C function is open
+	uint8_t canFallThrough = 0;		// 1: the code can run past the last command written
+	uint8_t result = 1;
+
+	if (first >= end) {
+		return 1;
+	}
+
+	labelRegions = calloc((program->names.count > 0) ? program->names.count : 1, sizeof(uint32_t));
+	if (labelRegions == NULL) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, sourcePath, 0, 0, NULL);
+		return 0;
+	}
+
+	for (uint32_t i = first; (result != 0) && (i < end); i++) {
+		const T_vmCommand* command = &program->commands[i];
+
+		if (	(command->commandType == CT_FUNCTION)
+			|| (isOpen == 0)
+		) {
+			// close the function before, the code falls through into this one
+			if (isOpen != 0) {
+				if (canFallThrough != 0) {
+					result &= AppendString(output, "\t");
+					result &= AppendRegionName(output, program, fileName, i);
+					result &= AppendString(output, "();\n");
+				}
+				result &= AppendString(output, "}\n\n");
+			}
+			region++;
+			MarkUsedLabels(program, i, end, labelRegions, region);
+
+			result &= AppendString(output, "void ");
+			result &= AppendRegionName(output, program, fileName, i);
+			result &= AppendString(output, "(void) {\n");
+			isOpen = 1;
+			if (command->commandType == CT_FUNCTION) {
+				if (command->value > 0) {
+					result &= AppendFormat(output, "\tPushZeros(%u);\n", command->value);
+				}
+				canFallThrough = 1;
+				continue;
+			}
+		}
+
+		if (command->commandType == CT_LABEL) {
+			if (labelRegions[command->nameId] == region) {
+				result &= AppendCName(output, "L_", GetString(&program->names, command->nameId), GetStringLength(&program->names, command->nameId));
+				result &= AppendString(output, ":;\n");
+			}
+			canFallThrough = 1;
+			continue;
+		}
+
+		if (	(command->commandType == CT_POP)
+			&& (command->memorySegment == MS_CONSTANT)
+		) {
+			DIAG_ERROR(DC_UNKNOWN_SEGMENT, sourcePath, command->lineNumber, command->column, "pop constant");
+			free(labelRegions);
+			return 0;
+		}
+
+		result &= WriteCCommand(output, program, fileName, i, &callSite);
+		canFallThrough = (	(command->commandType == CT_GOTO)
+								|| (command->commandType == CT_RETURN)
+								) ? 0 : 1;
+	}
+
+	// the end of the range falls through into the next function or is the end of the program
+	if (canFallThrough != 0) {
+		if (	(next != NULL)
+			&& (next->program != NULL)
+		) {
+			result &= AppendString(output, "\t");
+			result &= AppendRegionName(output, next->program, next->fileName, next->command);
+			result &= AppendString(output, "();\n");
+		} else {
+			result &= AppendString(output, "\tStop(\"ran past the end\");\n");
+		}
+	}
+	result &= AppendString(output, "}\n\n");
+
+	if (result == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, sourcePath, 0, 0, NULL);
+	}
+	free(labelRegions);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteCCommandRange
+***************************************************************************************************************
+*/
+
+uint32_t CountCalls(const T_vmProgram* program, uint32_t first, uint32_t end) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function counts the call commands of a range, the call sites are numbered in the order of the output
+
+	\param[in]		program			Pointer to parsed program
+	\param[in]		first				Index of first command
+	\param[in]		end				Index after the last command
+
+	\returns
+		Number of call commands
+
+***************************************************************************************************************
+*/
+	uint32_t count = 0;
+
+	for (uint32_t i = first; i < end; i++) {
+		if (program->commands[i].commandType == CT_CALL) {
+			count++;
+		}
+	}
+	return count;
+}
+/*
+***************************************************************************************************************
+	End CountCalls
+***************************************************************************************************************
+*/
+
+static uint8_t WriteCCommand(T_outputBuffer* output, const T_vmProgram* program, const char* fileName, uint32_t index, uint32_t* callSite) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the C statements of a command that is not a label or function command
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		program			Pointer to parsed program
+	\param[in]		fileName			Pointer to file name without path and extension
+	\param[in]		index				Index of the command
+	\param[in,out]	callSite			Pointer to number of the next call site
+
+	\returns
+			0: out of memory or pop constant (the error is not reported)
+			1: command is written
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* command = &program->commands[index];
+	const char* name = GetString(&program->names, command->nameId);
+	uint32_t nameLength = GetStringLength(&program->names, command->nameId);
+	uint8_t result = 1;
+
+	switch (command->commandType) {
+	case CT_PUSH:
+		switch (command->memorySegment) {
+		case MS_CONSTANT:
+			return AppendFormat(output, "\tPUSH(%u);\n", command->value);
+		case MS_STATIC:
+			result &= AppendString(output, "\tPUSH(RAM[");
+			result &= AppendStaticName(output, fileName, command->value);
+			return result & AppendString(output, "]);\n");
+		case MS_POINTER:
+			return AppendFormat(output, "\tPUSH(RAM[%u]);\n", (uint16_t)(POINTER_ADDRESS + command->value));
+		case MS_TEMP:
+			return AppendFormat(output, "\tPUSH(RAM[%u]);\n", (uint16_t)(TEMP_ADDRESS + command->value));
+		default:
+			return AppendFormat(output, "\tPushSegment(%u, %u);\n", segmentPointers[command->memorySegment], command->value);
+		}
+	case CT_POP:
+		switch (command->memorySegment) {
+		case MS_CONSTANT:
+			// rejected by WriteCCommandRange, a constant has no address
+			return 0;
+		case MS_STATIC:
+			result &= AppendString(output, "\tRAM[");
+			result &= AppendStaticName(output, fileName, command->value);
+			return result & AppendString(output, "] = POP();\n");
+		case MS_POINTER:
+			return AppendFormat(output, "\tRAM[%u] = POP();\n", (uint16_t)(POINTER_ADDRESS + command->value));
+		case MS_TEMP:
+			return AppendFormat(output, "\tRAM[%u] = POP();\n", (uint16_t)(TEMP_ADDRESS + command->value));
+		default:
+			return AppendFormat(output, "\tPopSegment(%u, %u);\n", segmentPointers[command->memorySegment], command->value);
+		}
+	case CT_GOTO:
+		if (IsHalt(program, index) != 0) {
+			return AppendString(output, "\tStop(\"halted\");\n");
+		}
+		result &= AppendString(output, "\tgoto ");
+		result &= AppendCName(output, "L_", name, nameLength);
+		return result & AppendString(output, ";\n");
+	case CT_IFGOTO:
+		result &= AppendString(output, "\tif (POP() != 0) goto ");
+		result &= AppendCName(output, "L_", name, nameLength);
+		return result & AppendString(output, ";\n");
+	case CT_CALL:
+		result &= AppendString(output, "\tCall(");
+		result &= AppendCName(output, "F_", name, nameLength);
+		result &= AppendFormat(output, ", %u, %u);\n", command->value, (uint16_t)*callSite);
+		(*callSite)++;
+		return result;
+	case CT_RETURN:
+		return AppendString(output, "\tReturn();\n\treturn;\n");
+	default:
+		return AppendString(output, arithmeticStatements[command->commandType]);
+	}
+}
+/*
+***************************************************************************************************************
+	End WriteCCommand
+***************************************************************************************************************
+*/
+
+static uint8_t WriteStaticAddresses(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes a define with the RAM address of every static, the addresses are given from
+		VARIABLE_START_ADDRESS on in the order of first use, like the assembler gives them
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		programs			Array of parsed programs, in the order their code is written
+	\param[in]		fileNames		Array of their file names without path and extension
+	\param[in]		count				Number of programs
+
+	\returns
+			0: out of memory
+			1: addresses are written
+
+***************************************************************************************************************
+*/
+	uint32_t address = VARIABLE_START_ADDRESS;
+	uint8_t result = 1;
+
+	for (uint32_t i = 0; (result != 0) && (i < count); i++) {
+		const T_vmProgram* program = programs[i];
+		uint8_t* isWritten = calloc(UINT16_MAX + 1, sizeof(uint8_t));
+
+		if (isWritten == NULL) {
+			return 0;
+		}
+		for (uint32_t j = 0; (result != 0) && (j < program->count); j++) {
+			const T_vmCommand* command = &program->commands[j];
+
+			if (	((command->commandType == CT_PUSH) || (command->commandType == CT_POP))
+				&& (command->memorySegment == MS_STATIC)
+				&& (isWritten[command->value] == 0)
+			) {
+				isWritten[command->value] = 1;
+				result &= AppendString(output, "#define ");
+				result &= AppendStaticName(output, fileNames[i], command->value);
+				result &= AppendFormat(output, " (%u)\n", (uint16_t)address);
+				address++;
+			}
+		}
+		free(isWritten);
+	}
+
+	if (address > (MAX_VARIABLE_ADDRESS + 1)) {
+		DIAG_WARN(DC_INVALID_VALUE, NULL, 0, 0, "the statics do not fit below the screen");
+	}
+	return result & AppendString(output, "\n");
+}
+/*
+***************************************************************************************************************
+	End WriteStaticAddresses
+***************************************************************************************************************
+*/
+
+static uint8_t WritePrototypes(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the prototypes of the functions that are defined or called and of the code of the
+		files before their first function
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		programs			Array of parsed programs
+	\param[in]		fileNames		Array of their file names without path and extension
+	\param[in]		count				Number of programs
+
+	\returns
+			0: out of memory
+			1: prototypes are written
+
+	\note
+		- the functions are not static, so a function that is not called is not reported as unused and a
+		  single file can call the functions of other files
+
+***************************************************************************************************************
+*/
+	T_stringTable written;
+	uint8_t result = 1;
+
+	if (InitStringTable(&written) == 0) {
+		return 0;
+	}
+
+	for (uint32_t i = 0; (result != 0) && (i < count); i++) {
+		const T_vmProgram* program = programs[i];
+
+		if (	(program->count > 0)
+			&& (program->commands[0].commandType != CT_FUNCTION)
+		) {
+			result &= AppendString(output, "void ");
+			result &= AppendRegionName(output, program, fileNames[i], 0);
+			result &= AppendString(output, "(void);\n");
+		}
+
+		for (uint32_t j = 0; (result != 0) && (j < program->count); j++) {
+			const T_vmCommand* command = &program->commands[j];
+			const char* name = NULL;
+			uint32_t length = 0;
+			uint32_t countBefore = written.count;
+
+			if (	(command->commandType != CT_FUNCTION)
+				&& (command->commandType != CT_CALL)
+			) {
+				continue;
+			}
+			name = GetString(&program->names, command->nameId);
+			length = GetStringLength(&program->names, command->nameId);
+			if (InternString(&written, name, length) == STRING_ID_INVALID) {
+				result = 0;
+			} else if (written.count > countBefore) {
+				result &= AppendString(output, "void ");
+				result &= AppendCName(output, "F_", name, length);
+				result &= AppendString(output, "(void);\n");
+			}
+		}
+	}
+
+	FreeStringTable(&written);
+	return result & AppendString(output, "\n");
+}
+/*
+***************************************************************************************************************
+	End WritePrototypes
+***************************************************************************************************************
+*/
+
+static uint8_t WriteMain(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, uint8_t bootstrap) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes main: it presets the RAM words of the arguments "address=value" and starts the program
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		programs			Array of parsed programs
+	\param[in]		fileNames		Array of their file names without path and extension
+	\param[in]		count				Number of programs
+	\param[in]		bootstrap		1: SP = 256 and call Sys.init, 0: run the code of the first file
+
+	\returns
+			0: out of memory
+			1: main is written
+
+***************************************************************************************************************
+*/
+	uint8_t result = 1;
+
+	result &= AppendString(output,
+		"int main(int argc, char* argv[]) {\n"
+		"\targumentCount = argc;\n"
+		"\targuments = argv;\n"
+		"\tfor (int i = 1; i < argc; i++) {\n"
+		"\t\tchar* end = NULL;\n"
+		"\t\tlong address = strtol(argv[i], &end, 10);\n"
+		"\n"
+		"\t\tif ((*end == '=') && (address >= 0) && (address <= 65535)) {\n"
+		"\t\t\tRAM[address] = (uint16_t)strtol(end + 1, NULL, 10);\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\n");
+
+	if (bootstrap != 0) {
+		// like the bootstrap of the Hack translation, a return of Sys.init ends the program
+		result &= AppendString(output, "\tsp = 256;\n\tCall(F_Sys_0init, 0, 0);\n\tStop(\"halted\");\n}\n\n");
+		return result;
+	}
+
+	result &= AppendString(output, "\tsp = RAM[0];\n");
+	for (uint32_t i = 0; i < count; i++) {
+		if (programs[i]->count > 0) {
+			result &= AppendString(output, "\t");
+			result &= AppendRegionName(output, programs[i], fileNames[i], 0);
+			result &= AppendString(output, "();\n");
+			break;
+		}
+	}
+	return result & AppendString(output, "\tStop(\"returned\");\n}\n\n");
+}
+/*
+***************************************************************************************************************
+	End WriteMain
+***************************************************************************************************************
+*/
+
+static uint8_t AppendRegionName(T_outputBuffer* output, const T_vmProgram* program, const char* fileName, uint32_t command) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends the name of the C function that starts at a command: the VM function or the code of
+		the file before its first function
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		program			Pointer to parsed program
+	\param[in]		fileName			Pointer to file name without path and extension
+	\param[in]		command			Index of a function command or 0
+
+	\returns
+			0: out of memory
+			1: name is appended
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* start = &program->commands[command];
+
+	if (start->commandType == CT_FUNCTION) {
+		return AppendCName(output, "F_", GetString(&program->names, start->nameId), GetStringLength(&program->names, start->nameId));
+	}
+	return AppendCName(output, "T_", fileName, (uint32_t)strlen(fileName));
+}
+/*
+***************************************************************************************************************
+	End AppendRegionName
+***************************************************************************************************************
+*/
+
+static uint8_t AppendCName(T_outputBuffer* output, const char* prefix, const char* name, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a VM name as C name with a prefix
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		prefix			Pointer to prefix
+	\param[in]		name				Pointer to VM name
+	\param[in]		length			Length of the VM name
+
+	\returns
+			0: out of memory
+			1: name is appended
+
+***************************************************************************************************************
+*/
+	static const char hexDigits[] = "0123456789ABCDEF";
+	size_t prefixLength = strlen(prefix);
+	char* start = BeginAppend(output, prefixLength + (MAX_NAME_EXPANSION * (size_t)length));
+	char* end = start;
+
+	if (start == NULL) {
+		return 0;
+	}
+	memcpy(end, prefix, prefixLength);
+	end += prefixLength;
+
+	for (uint32_t i = 0; i < length; i++) {
+		unsigned char character = (unsigned char)name[i];
+
+		if (	((character >= 'a') && (character <= 'z'))
+			|| ((character >= 'A') && (character <= 'Z'))
+			|| ((character >= '0') && (character <= '9'))
+		) {
+			*end++ = (char)character;
+		} else if (character == '_') {
+			*end++ = '_';
+			*end++ = '_';
+		} else if (character == '.') {
+			*end++ = '_';
+			*end++ = '0';
+		} else {
+			*end++ = '_';
+			*end++ = hexDigits[character >> 4];
+			*end++ = hexDigits[character & 0x0F];
+		}
+	}
+	EndAppend(output, end);
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AppendCName
+***************************************************************************************************************
+*/
+
+static uint8_t AppendStaticName(T_outputBuffer* output, const char* fileName, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends the name of the define with the address of a static
+
+	\param[out]		output			Pointer to output buffer
+	\param[in]		fileName			Pointer to file name without path and extension
+	\param[in]		index				Index of the static
+
+	\returns
+			0: out of memory
+			1: name is appended
+
+***************************************************************************************************************
+*/
+	return AppendCName(output, "S_", fileName, (uint32_t)strlen(fileName)) & AppendFormat(output, "_%u", index);
+}
+/*
+***************************************************************************************************************
+	End AppendStaticName
+***************************************************************************************************************
+*/
+
+static void MarkUsedLabels(const T_vmProgram* program, uint32_t first, uint32_t end, uint32_t* labelRegions, uint32_t region) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function marks the labels that the goto and if-goto commands of a C function jump to
+
+	\param[in]		program			Pointer to parsed program
+	\param[in]		first				Index of the first command of the C function
+	\param[in]		end				Index after the last command of the range
+	\param[in,out]	labelRegions	Array that receives the region of every label that is jumped to, indexed by
+											name ID
+	\param[in]		region			Number of the C function in the range
+
+	\note
+		- the goto of "label L" "goto L" is written as a stop and does not use the label
+
+***************************************************************************************************************
+*/
+	for (uint32_t i = first; i < end; i++) {
+		const T_vmCommand* command = &program->commands[i];
+
+		if (	(i > first)
+			&& (command->commandType == CT_FUNCTION)
+		) {
+			break;
+		}
+		if (	(command->commandType == CT_IFGOTO)
+			|| (	(command->commandType == CT_GOTO)
+				&& (IsHalt(program, i) == 0)
+				)
+		) {
+			labelRegions[command->nameId] = region;
+		}
+	}
+}
+/*
+***************************************************************************************************************
+	End MarkUsedLabels
+***************************************************************************************************************
+*/
+
+static uint8_t IsHalt(const T_vmProgram* program, uint32_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks if a goto command is the endless loop "label L" "goto L" a program ends with
+
+	\param[in]		program			Pointer to parsed program
+	\param[in]		index				Index of a goto command
+
+	\returns
+			0: the goto is a jump
+			1: the goto ends the program
+
+***************************************************************************************************************
+*/
+	if (	(index > 0)
+		&& (program->commands[index - 1].commandType == CT_LABEL)
+		&& (program->commands[index - 1].nameId == program->commands[index].nameId)
+	) {
+		return 1;
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End IsHalt
+***************************************************************************************************************
+*/
@@ -0,0 +1,98 @@
+/*! \file
+***************************************************************************************************************
+file name:					codewriter_c.h
+*	\copyright				FourE
+*	\brief					C code writer header file
+*	\author					agent
+*	\date	created:			2026-10-18
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Code writer that translates VM code into portable C instead of Hack assembly code, so VM programs can
+	be built with the system C compiler and run at native speed. Every VM function becomes a C function, the
+	stack and the segments are a uint16_t RAM array with the same layout as the Hack translation.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The preamble holds the runtime (RAM, stack macros, call and return), the addresses of the statics, the
+	prototypes of all functions and main. The code of the .vm files follows it and can be written in
+	parallel chunks that start at a function command.
+
+***************************************************************************************************************
+*/
+
+#ifndef __CODEWRITER_C_H_
+#define __CODEWRITER_C_H_
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "outputbuffer.h"
+#include "parser.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// start of the C function that follows a range of commands, the code falls through into it
+typedef struct {
+	const T_vmProgram* program;		// NULL: the range is the end of the program
+	const char* fileName;				// file name without path and extension
+	uint32_t command;						// index of the first command of the function
+} T_cRegion;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t WriteCPreamble(T_outputBuffer* output, const T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, uint8_t bootstrap);
+uint8_t WriteCCommandRange(T_outputBuffer* output, const T_vmProgram* program, const char* fileName, const char* sourcePath, uint32_t first, uint32_t end, const T_cRegion* next, uint32_t firstCallSite);
+uint32_t CountCalls(const T_vmProgram* program, uint32_t first, uint32_t end);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __CODEWRITER_C_H_
@@ -1,719 +1,3431 @@
-/*! \file
-***************************************************************************************************************
-file name:					codewriter_hack.c
-*	\copyright				FourE
-*	\brief					codewriter for hack source file
-*	\author					Frank Eggink
-*	\date	created:			2020-02-03
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include "codewriter_hack.h"
-#include <stdio.h>
-#include <string.h> // memset
-
-/*
-***************************************************************************************************************
-	LOCAL DEFINES
-***************************************************************************************************************
-*/
-
-#define POP_D		"//POP_D\n" \
-						"@SP\nM=M-1\nD=M\nA=D\nD=M\n"
-
-#define PUSH_D		"//PUSH_D\n" \
-						"@SP\nA=M\nM=D\n@SP\nM=M+1\n"
-
-
-// buffer size is increased from 512 to 1024
-// WriteFunction outputs ~25 chars for each local variable a function uses
-#define MAX_OUTPUT_LENGTH		(1024)
-
-
-/*
-***************************************************************************************************************
-	LOCAL TYPEDEFS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-static void ClearOutputBuffer(void);
-static uint8_t WriteArithmetic(E_commandType command, char* output);
-static uint8_t WritePush(E_memorySegment memorySegment, uint16_t index, char* fileName, char* output);
-static uint8_t WritePop(E_memorySegment memorySegment, uint16_t index, char* fileName, char* output);
-static uint8_t WriteLabel(char* labelName,  char* fileName, char* output);
-static uint8_t WriteGoto(char* labelName,  char* fileName, char* output);
-static uint8_t WriteIfGoto(char* labelName,  char* fileName, char* output);
-static uint8_t WriteFunction(char* labelName, uint8_t numLocals, char* output);
-static uint8_t WriteCall(char* labelName, uint8_t numParams, char* output);
-static uint8_t WriteReturn(char* output);
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL VARS
-***************************************************************************************************************
-*/
-
-static char outputBuffer[MAX_OUTPUT_LENGTH];
-
-/*
-***************************************************************************************************************
-	IMPLEMENTATION
-***************************************************************************************************************
-*/
-
-static void ClearOutputBuffer(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function clears the output buffer
-
-***************************************************************************************************************
-*/
-	memset(outputBuffer, 0, MAX_OUTPUT_LENGTH);
-}
-/*
-***************************************************************************************************************
-	End ClearOutputBuffer
-***************************************************************************************************************
-*/
-
-// Or move function to main ? NOPE (all codewriting here !!!)
-uint8_t WriteInit(FILE* pFile) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the Bootstrap code and writes it to a output buffer
-
-	\param[out]		pFile			Pointer to output file
-
-	\returns
-		0: writing assembly instructions failed
-		1: writing assembly instructions was successful
-
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-	uint8_t result = 0;
-
-	char sysInit[] = "Sys.init";
-
-	// output file needs to be opened
-	if (pFile != NULL) {
-		val = fprintf(pFile, "%s\n", "//Bootstrap code\n@256\nD=A\n@SP\nM=D\n\n//call Sys.init 0");
-		result = WriteCall(sysInit, 0, outputBuffer);
-	}
-
-	// check for errors in encoding and buffer overflow
-	// fprintf return a negative value if something went wrong
-	if (	(val >= 0)
-		&& (result != 0)
-	) {
-		fprintf(pFile, "%s\n", outputBuffer);
-		return 1;
-	} else {
-		printf("Error encoding\n");
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteInit
-***************************************************************************************************************
-*/
-
-// TODO: let WriteCommand also handle opening file?
-void WriteCommand(FILE* pFile, char* comment, char* fileName,  E_commandType command) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the VM command and writes it to the output file
-
-	\param[out]		pFile			Pointer to output file
-	\param[in]		comment		Pointer to comment string
-	\param[in]		fileName		Pointer to filename
-	\param[in]		command		VM command to assemble
-
-	\note
-		- comment parameter is output as a C-style comment in the output file just before the generated assembly
-		  for the specified command (could be helpful for debugging)
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	// output file needs to be opened
-	if (pFile != NULL) {
-		fprintf(pFile, "//%s\n", comment);
-
-		// WHY NOT CALL PARSER HERE??
-
-		// get parsed data from parser
-		E_memorySegment memorySegment = GetMemorySegment();
-		uint16_t value = GetValue();
-		char* name = GetName();
-
-		ClearOutputBuffer();
-
-		uint8_t result = 0;
-
-		switch (command) {
-		case CT_ADD:
-		case CT_SUB:
-		case CT_NEG:
-		case CT_EQ:
-		case CT_GT:
-		case CT_LT:
-		case CT_AND:
-		case CT_OR:
-		case CT_NOT:
-			result = WriteArithmetic(command, outputBuffer);
-			break;
-		case CT_PUSH:
-			result = WritePush(memorySegment, value, fileName, outputBuffer);
-			break;
-		case CT_POP:
-			result = WritePop(memorySegment, value, fileName, outputBuffer);
-			break;
-		case CT_LABEL:
-			result = WriteLabel(name, fileName, outputBuffer);
-			break;
-		case CT_GOTO:
-			result = WriteGoto(name, fileName, outputBuffer);
-			break;
-		case CT_IFGOTO:
-			result = WriteIfGoto(name, fileName, outputBuffer);
-			break;
-		case CT_FUNCTION:
-			result = WriteFunction(name, value, outputBuffer);
-			break;
-		case CT_CALL:
-			result = WriteCall(name, value, outputBuffer);
-			break;
-		case CT_RETURN:
-			result = WriteReturn(outputBuffer);
-			break;
-		default:
-			break;
-		}
-
-		// output generated code to the output file
-		if (result != 0) {
-			fprintf(pFile, "%s\n", outputBuffer);
-		} else {
-			printf("Error encoding\n");
-		}
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteCommand
-***************************************************************************************************************
-*/
-
-static uint8_t WriteArithmetic(E_commandType command, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generated assembly code for the Arithmetic VM commands and writes it to a output buffer
-
-	\param[in]		command		VM command to assemble
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-***************************************************************************************************************
-*/
-
-	int16_t val = 0;
-	static uint32_t labelCounter = 0;
-
-	switch (command) {
-	case CT_ADD:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D+M\n%s\n", POP_D, POP_D, PUSH_D);
-		break;
-	case CT_AND:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D&M\n%s\n", POP_D, POP_D, PUSH_D);
-		break;
-	case CT_EQ:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D-M\n@true%d\nD;JEQ\nD=0\n@end%d\n0;JMP\n(true%d)\nD=-1\n(end%d)\n%s\n"
-																, POP_D, POP_D, labelCounter, labelCounter, labelCounter, labelCounter, PUSH_D);
-		labelCounter++;
-		break;
-	case CT_GT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D-M\n@true%d\nD;JGT\nD=0\n@end%d\n0;JMP\n(true%d)\nD=-1\n(end%d)\n%s\n"
-																, POP_D, POP_D, labelCounter, labelCounter, labelCounter, labelCounter, PUSH_D);
-		labelCounter++;
-		break;
-	case CT_LT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D-M\n@true%d\nD;JLT\nD=0\n@end%d\n0;JMP\n(true%d)\nD=-1\n(end%d)\n%s\n"
-																, POP_D, POP_D, labelCounter, labelCounter, labelCounter, labelCounter, PUSH_D);
-		labelCounter++;
-		break;
-	case CT_NEG:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\nD=-D\n%s\n", POP_D, PUSH_D);
-		break;
-	case CT_NOT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\nD=!D\n%s\n", POP_D, PUSH_D);
-		break;
-	case CT_OR:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D|M\n%s\n", POP_D, POP_D, PUSH_D);
-		break;
-	case CT_SUB:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@R13\nM=D\n%s\n@R13\nD=D-M\n%s\n", POP_D, POP_D, PUSH_D);
-		break;
-	default:
-		break;
-	}
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteArithmetic
-***************************************************************************************************************
-*/
-
-static uint8_t WritePush(E_memorySegment memorySegment, uint16_t index, char* fileName, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the PUSH VM commands and writes it to a output buffer
-
-	\param[in]		memorySegment	Memory Segment that is used to PUSH a value to
-	\param[in]		index				Push the value of segment[index] onto the stack
-	\param[in]		fileName			Pointer to filename
-	\param[out]		output			Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-	\note
-		- fileName is used to generate file specific labels for the assembly code output
-		- if MS_CONSTANT is the memory segment the index parameter is used as the value to PUSH onto the stack
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-
-	switch (memorySegment) {
-	case MS_LOCAL:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n@%s\nA=M\nA=D+A\nD=M\n%s\n", index, "LCL", PUSH_D);
-		break;
-	case MS_ARGUMENT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n@%s\nA=M\nA=D+A\nD=M\n%s\n", index, "ARG", PUSH_D);
-		break;
-	case MS_THIS:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n@%s\nA=M\nA=D+A\nD=M\n%s\n", index, "THIS", PUSH_D);
-		break;
-	case MS_THAT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n@%s\nA=M\nA=D+A\nD=M\n%s\n", index, "THAT", PUSH_D);
-		break;
-	case MS_CONSTANT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n%s\n", index, PUSH_D);
-		break;
-	case MS_STATIC:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%s.%d\nD=M\n%s\n", fileName, index, PUSH_D);
-		break;
-	case MS_POINTER:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n@%s\nA=D+A\nD=M\n%s\n", index, "3", PUSH_D);
-		break;
-	case MS_TEMP:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"@%d\nD=A\n@%s\nA=D+A\nD=M\n%s\n", index, "5", PUSH_D);
-		break;
-	default:
-		break;
-	}
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WritePush
-***************************************************************************************************************
-*/
-
-static uint8_t WritePop(E_memorySegment memorySegment, uint16_t index, char* fileName, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the POP VM commands and writes it to a output buffer
-
-	\param[in]		memorySegment	Memory Segment that is used to POP a value from
-	\param[in]		index				POP the top stack value and store int in segment[index]
-	\param[in]		fileName			Pointer to filename
-	\param[out]		output			Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-	\note
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-
-	switch (memorySegment) {
-	case MS_LOCAL:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@R13\nM=D\n@%d\nD=A\n@%s\nA=M\nD=D+A\n@R14\nM=D\n@R13\nD=M\n@R14\nA=M\nM=D\n"
-																	, POP_D, index, "LCL");
-		break;
-	case MS_ARGUMENT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@R13\nM=D\n@%d\nD=A\n@%s\nA=M\nD=D+A\n@R14\nM=D\n@R13\nD=M\n@R14\nA=M\nM=D\n"
-																	, POP_D, index, "ARG");
-		break;
-	case MS_THIS:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@R13\nM=D\n@%d\nD=A\n@%s\nA=M\nD=D+A\n@R14\nM=D\n@R13\nD=M\n@R14\nA=M\nM=D\n"
-																	, POP_D, index, "THIS");
-		break;
-	case MS_THAT:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@R13\nM=D\n@%d\nD=A\n@%s\nA=M\nD=D+A\n@R14\nM=D\n@R13\nD=M\n@R14\nA=M\nM=D\n"
-																	, POP_D, index, "THAT");
-		break;
-	case MS_STATIC:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@%s.%d\nM=D\n", POP_D, fileName, index);
-		break;
-	case MS_POINTER:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@R13\nM=D\n@%d\nD=A\n@%s\nD=D+A\n@R14\nM=D\n@R13\nD=M\n@R14\nA=M\nM=D\n"
-																	, POP_D, index, "3");
-		break;
-	case MS_TEMP:
-		val = snprintf(output, MAX_OUTPUT_LENGTH, 	"%s\n@R13\nM=D\n@%d\nD=A\n@%s\nD=D+A\n@R14\nM=D\n@R13\nD=M\n@R14\nA=M\nM=D\n"
-																	, POP_D, index, "5");
-		break;
-	default:
-		break;
-	}
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WritePop
-***************************************************************************************************************
-*/
-
-static uint8_t WriteLabel(char* labelName,  char* fileName, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the Label VM command and writes it to a output buffer
-
-	\param[in]		labelName	Pointer to labelname
-	\param[in]		fileName		Pointer to filename
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-	\note
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-
-	val = snprintf(output, MAX_OUTPUT_LENGTH, "(%s$%s)\n", fileName, labelName);
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteLabel
-***************************************************************************************************************
-*/
-
-static uint8_t WriteGoto(char* labelName,  char* fileName, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the Goto VM command and writes it to a output buffer
-
-	\param[in]		labelName	Pointer to labelname
-	\param[in]		fileName		Pointer to filename
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-	\note
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-
-	val = snprintf(output, MAX_OUTPUT_LENGTH, "@%s$%s\n0;JMP\n", fileName, labelName);
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteGoto
-***************************************************************************************************************
-*/
-
-static uint8_t WriteIfGoto(char* labelName,  char* fileName, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the IfGoto VM command and writes it to a output buffer
-
-	\param[in]		labelName	Pointer to labelname
-	\param[in]		fileName		Pointer to filename
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-	\note
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-
-	val = snprintf(output, MAX_OUTPUT_LENGTH, "%s\n@%s$%s\nD;JNE\n", POP_D, fileName, labelName);
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteIfGoto
-***************************************************************************************************************
-*/
-
-static uint8_t WriteFunction(char* labelName, uint8_t numLocals, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the Function VM command and writes it to a output buffer
-
-	\param[in]		labelName	Pointer to labelname
-	\param[in]		numLocals	The number of local variables the function uses
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-	\note
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-	val = snprintf(output, MAX_OUTPUT_LENGTH, "(%s)\n", labelName);
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		for (uint8_t i = 0; i < numLocals; i++) {
-			strcat(output, "//PUSH 0 on stack for local variable\n");
-			strcat(output, "D=0\n@SP\nA=M\nM=D\n@SP\nM=M+1\n");
-		}
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteFunction
-***************************************************************************************************************
-*/
-
-static uint8_t WriteCall(char* labelName, uint8_t numParams, char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generates assembly code for the Call VM command and writes it to a output buffer
-
-	\param[in]		labelName	Pointer to labelname
-	\param[in]		numLocals	The number of paramters the function uses
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-	static uint32_t labelCounter = 0;
-
-	val = snprintf(output, MAX_OUTPUT_LENGTH, "@%s_return%d\nD=A\n%s\n@LCL\nD=M\n%s\n@ARG\nD=M\n%s\n@THIS\nD=M\n%s\n@THAT\nD=M\n%s\n@SP\nD=M\n"
-															"@5\nD=D-A\n@%d\nD=D-A\n@ARG\nM=D\n@SP\nD=M\n@LCL\nM=D\n@%s\n0;JMP\n(%s_return%d)\n"
-															, labelName, labelCounter, PUSH_D, PUSH_D, PUSH_D, PUSH_D, PUSH_D, numParams, labelName, labelName
-															, labelCounter);
-
-	labelCounter++;
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteCall
-***************************************************************************************************************
-*/
-
-static uint8_t WriteReturn(char* output) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function generated assembly code for the Return VM command and writes it to a output buffer
-
-	\param[out]		output		Pointer to output buffer
-
-	\returns
-		0: writing assembly instruction failed
-		1: writing assembly instructions was successful
-
-
-***************************************************************************************************************
-*/
-	int16_t val = 0;
-
-	val = snprintf(output, MAX_OUTPUT_LENGTH, "@LCL\nD=M\n@R13\nM=D\n@5\nD=D-A\nA=D\nD=M\n@R14\nM=D\n%s\n@ARG\nA=M\nM=D\n@ARG\nD=M\n@SP\nM=D+1\n"
-															"@R13\nD=M\n@1\nD=D-A\nA=D\nD=M\n@THAT\nM=D\n@R13\nD=M\n@2\nD=D-A\nA=D\nD=M\n@THIS\nM=D\n@R13\nD=M\n"
-															"@3\nD=D-A\nA=D\nD=M\n@ARG\nM=D\n@R13\nD=M\n@4\nD=D-A\nA=D\nD=M\n@LCL\nM=D\n@R14\nA=M\n0;JMP\n"
-															, POP_D);
-
-
-	// check for errors in encoding and buffer overflow
-	// snprintf return a negative value if something went wrong while encoding the string
-	if (	(val >= 0)
-		&& (val < MAX_OUTPUT_LENGTH)
-	) {
-		return 1;
-	} else {
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End WriteReturn
-***************************************************************************************************************
-*/
-
-
-
-
-/*
-***************************************************************************************************************
-	TEST CODE
-***************************************************************************************************************
-*/
-
-// TODO ADD MODULE TESTCODE
+/*! \file
+***************************************************************************************************************
+file name:					codewriter_hack.c
+*	\copyright				FourE
+*	\brief					codewriter for hack source file
+*	\author					Frank Eggink
+*	\date	created:			2020-02-03
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The codewriter has no global state, all state lives in the T_codeWriter that is passed to every function.
+	Different code writers can therefore be used on different threads at the same time.
+
+	The labels of the VM code ("function$label") and the labels of eq, gt, lt and call are generated in the
+	namespace of the function they belong to, the counters start at 0 for every function command. Code for a
+	range of commands that starts at a function command therefore does not depend on the commands before it,
+	which is used to translate one file in parallel chunks.
+
+	The assembly code is generated from templates that are compiled into constant instruction records, the
+	same records the instruction list holds. Emitting a template copies its records and fills their holes: the
+	value of an A-instruction, a jump, or a symbol. The fixed symbols are interned once per code writer, the
+	names of labels, statics and comments are composed from their parts and interned, no text is formatted
+	and decoded again.
+
+	With foldConstants a run of "push constant" and arithmetic commands on those constants is evaluated at
+	translation time with the 16 bit two's complement semantics of the Hack ALU (true is -1). Only the values
+	that are left on the stack are pushed, a value that is popped directly after the run is stored without
+	going through the stack.
+
+	With specializeIndex push and pop pick the shortest sequence for the class of their (segment, index):
+	"A=M" for index 0, "A=M+1, A=A+1, ..." chains for small indices, direct addressing for pointer and temp,
+	and a pop of a base segment forms the address and the value in D (addr + value) so neither R13 nor R14 is
+	needed to keep the value while the address is computed.
+
+	Before a command is written normally the idiom writers get the chance to write it together with the
+	commands that follow it as one superinstruction. Every idiom writer checks its own option and returns the
+	number of commands it has written, the first idiom that matches wins.
+
+	With fuseCompare an eq, gt or lt (optionally followed by not) that is directly followed by if-goto jumps on
+	the difference of its operands, no boolean is created and no private labels are needed.
+
+	With fuseMove a push that is directly followed by a pop loads the value into D and stores it at the
+	destination, the stack is not touched.
+
+	With fuseArray the array access patterns of the Jack compiler are recognized:
+	- read:	push base, push index, add, pop pointer 1, push that 0
+	- write:	[push value,] pop temp 0, pop pointer 1, push temp 0, pop that 0 (the address is below the value)
+	The address is computed in D without the stack, THAT and temp 0 get the values the VM commands give them.
+
+	With tailCalls a call that is directly followed by return reuses the frame of the current function. When
+	the current function accesses at least as many arguments as the call passes, the new arguments overwrite
+	the old ones and the saved frame stays where it is. Otherwise the saved frame is first copied above the
+	stack, the arguments are moved down to ARG and the frame is written back behind them. Either way the
+	callee returns directly to the caller of the current function and recursion runs in constant stack.
+
+	With a frame table the functions with a static frame are called without the frame protocol: the call
+	jumps with the return address in D, the function stores it at the base of its frame and its return jumps
+	back through it. Their locals and arguments are already frame accesses (MS_FRAME) at fixed addresses in
+	the VM program, the call sites have popped the arguments into the frame.
+
+	The other functions keep the frame on the stack, the frame table tells which of THIS and THAT it saves.
+	The call only saves those and skips the slots of the others, so the layout below LCL stays the same for
+	the return and the tail calls, and the return only restores those.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "codewriter_hack.h"
+#include "stringhelper.h"
+#include "diagnostics.h"
+#include <stdio.h>
+#include <stdlib.h>			// calloc, free
+#include <string.h>			// memcpy, strlen
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+// instruction records of the templates, a fixed symbol, label or comment is given as E_writerSymbol
+#define BLANK						{ { 0, HK_BLANK, 0, 0, 0 }, H_NONE, NULL }
+#define COMMENT(symbol)			{ { (symbol), HK_COMMENT, 0, 0, 0 }, H_SYMBOL, NULL }
+#define COMMENT_NAME(name)		{ { 0, HK_COMMENT, 0, 0, 0 }, H_COMPOSED, &(name) }
+#define LABEL(symbol)				{ { (symbol), HK_LABEL, 0, 0, 0 }, H_SYMBOL, NULL }
+#define LABEL_NAME(name)			{ { 0, HK_LABEL, 0, 0, 0 }, H_COMPOSED, &(name) }
+#define AT(value)					{ { (value), HK_ADDRESS, 0, 0, 0 }, H_NONE, NULL }
+#define AT_INDEX					{ { 0, HK_ADDRESS, 0, 0, 0 }, H_INDEX, NULL }
+#define AT_SYMBOL(symbol)		{ { (symbol), HK_SYMBOL, 0, 0, 0 }, H_SYMBOL, NULL }
+#define AT_BASE					{ { 0, HK_SYMBOL, 0, 0, 0 }, H_BASE, NULL }
+#define AT_NAME(name)				{ { 0, HK_SYMBOL, 0, 0, 0 }, H_COMPOSED, &(name) }
+#define COMPUTE(dest, comp)		{ { 0, HK_COMPUTE, (dest), (comp), 0 }, H_NONE, NULL }
+#define JUMP(comp, jump)			{ { 0, HK_COMPUTE, 0, (comp), (jump) }, H_NONE, NULL }
+#define JUMP_ARG(comp)			{ { 0, HK_COMPUTE, 0, (comp), 0 }, H_JUMP, NULL }
+
+#define POP_D		COMMENT(WS_POP_D), AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_M_MINUS_1), COMPUTE(DEST_D, COMP_M) \
+						, COMPUTE(DEST_A, COMP_D), COMPUTE(DEST_D, COMP_M)
+
+#define PUSH_D		COMMENT(WS_PUSH_D), AT_SYMBOL(WS_SP), COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_M, COMP_D) \
+						, AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_M_PLUS_1)
+
+// moves the top of the stack from RAM to D (cached top of stack)
+#define FILL_D		COMMENT(WS_FILL_D), TAKE_D
+
+// maximum number of constants on the stack during constant folding
+#define FOLD_WINDOW			(16)
+
+// largest index for which an "A=A+1" chain is shorter than computing the address with the index
+#define CHAIN_LOAD_LIMIT			(2)		// push: chain of index + 2 vs 5 instructions
+#define CHAIN_POP_LIMIT			(2)		// pop from the stack: 3 + chain vs 8 instructions
+#define CHAIN_STORE_LIMIT			(7)		// pop from a cached top of stack: chain vs 10 instructions
+
+// specialized pop takes the value from the stack without the POP_D macro
+#define TAKE_D		TAKE_OPERAND, COMPUTE(DEST_D, COMP_M)
+
+// addresses the top of the stack and pops it, M is the operand
+#define TAKE_OPERAND	AT_SYMBOL(WS_SP), COMPUTE(DEST_A | DEST_M, COMP_M_MINUS_1)
+
+// namespace of the labels that are generated for the bootstrap code
+#define BOOTSTRAP_NAMESPACE	"$bootstrap"
+
+// shared calling convention: the call site sets R13 (function), R14 (number of arguments) and D (return
+// address) and jumps to $call, return jumps to $return with the return value on the stack
+#define SHARED_SAVE(symbol)	AT_SYMBOL(symbol), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_SP) \
+									, COMPUTE(DEST_A | DEST_M, COMP_M_PLUS_1), COMPUTE(DEST_M, COMP_D)
+
+#define SHARED_CALL			COMMENT(WS_SHARED_CALL), LABEL(WS_CALL_ROUTINE) \
+									, AT_SYMBOL(WS_SP), COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_M, COMP_D) \
+									, SHARED_SAVE(WS_LCL), SHARED_SAVE(WS_ARG), SHARED_SAVE(WS_THIS), SHARED_SAVE(WS_THAT) \
+									, AT_SYMBOL(WS_SP), COMPUTE(DEST_M | DEST_D, COMP_M_PLUS_1) \
+									, AT_SYMBOL(WS_LCL), COMPUTE(DEST_M, COMP_D) \
+									, AT_SYMBOL(WS_R14), COMPUTE(DEST_D, COMP_D_MINUS_M), AT(5), COMPUTE(DEST_D, COMP_D_MINUS_A) \
+									, AT_SYMBOL(WS_ARG), COMPUTE(DEST_M, COMP_D) \
+									, AT_SYMBOL(WS_R13), COMPUTE(DEST_A, COMP_M), JUMP(COMP_0, JUMP_JMP), BLANK
+
+#define SHARED_RESTORE(symbol)	AT_SYMBOL(WS_R13), COMPUTE(DEST_A | DEST_M, COMP_M_MINUS_1), COMPUTE(DEST_D, COMP_M) \
+									, AT_SYMBOL(symbol), COMPUTE(DEST_M, COMP_D)
+
+#define SHARED_RETURN		COMMENT(WS_SHARED_RETURN), LABEL(WS_RETURN_ROUTINE) \
+									, AT_SYMBOL(WS_LCL), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D) \
+									, AT(5), COMPUTE(DEST_A, COMP_D_MINUS_A), COMPUTE(DEST_D, COMP_M) \
+									, AT_SYMBOL(WS_R14), COMPUTE(DEST_M, COMP_D) \
+									, TAKE_D, AT_SYMBOL(WS_ARG), COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_M, COMP_D) \
+									, AT_SYMBOL(WS_ARG), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_D_PLUS_1) \
+									, SHARED_RESTORE(WS_THAT), SHARED_RESTORE(WS_THIS), SHARED_RESTORE(WS_ARG), SHARED_RESTORE(WS_LCL) \
+									, AT_SYMBOL(WS_R14), COMPUTE(DEST_A, COMP_M), JUMP(COMP_0, JUMP_JMP), BLANK
+
+// the frame is found through LCL (R13), the return address is kept in R14 while the return value is stored
+#define RETURN_START			AT_SYMBOL(WS_LCL), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D) \
+									, AT(5), COMPUTE(DEST_D, COMP_D_MINUS_A), COMPUTE(DEST_A, COMP_D), COMPUTE(DEST_D, COMP_M) \
+									, AT_SYMBOL(WS_R14), COMPUTE(DEST_M, COMP_D), POP_D, BLANK \
+									, AT_SYMBOL(WS_ARG), COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_M, COMP_D) \
+									, AT_SYMBOL(WS_ARG), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_D_PLUS_1)
+#define RESTORE_WORD(offset, symbol)	AT_SYMBOL(WS_R13), COMPUTE(DEST_D, COMP_M), AT(offset), COMPUTE(DEST_D, COMP_D_MINUS_A) \
+									, COMPUTE(DEST_A, COMP_D), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(symbol), COMPUTE(DEST_M, COMP_D)
+#define RESTORE_THAT			RESTORE_WORD(1, WS_THAT)
+#define RESTORE_THIS			RESTORE_WORD(2, WS_THIS)
+#define RETURN_END			RESTORE_WORD(3, WS_ARG), RESTORE_WORD(4, WS_LCL) \
+									, AT_SYMBOL(WS_R14), COMPUTE(DEST_A, COMP_M), JUMP(COMP_0, JUMP_JMP)
+
+// the slots of THIS and THAT in a frame on the stack, a pointer the callee does not set is not saved
+#define SAVE_THIS				AT_SYMBOL(WS_THIS), COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK
+#define SAVE_THAT				AT_SYMBOL(WS_THAT), COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK
+#define SKIP_SLOT				AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_M_PLUS_1)
+
+#define SHARED_RETURN_JUMP	AT_SYMBOL(WS_RETURN_ROUTINE), JUMP(COMP_0, JUMP_JMP)
+
+// tail call with moved frame: the 5 saved words below LCL are pushed (THAT first, the return address last),
+// R14 walks over the arguments and R13 over their destination from ARG on, then the frame is popped behind
+// the arguments and R13 is the new LCL and SP
+#define TAIL_SAVE_WORD		AT_SYMBOL(WS_R13), COMPUTE(DEST_A | DEST_M, COMP_M_MINUS_1), COMPUTE(DEST_D, COMP_M) \
+									, AT_SYMBOL(WS_SP), COMPUTE(DEST_A | DEST_M, COMP_M_PLUS_1), COMPUTE(DEST_A, COMP_A_MINUS_1) \
+									, COMPUTE(DEST_M, COMP_D)
+#define TAIL_SAVE_FRAME		AT_SYMBOL(WS_LCL), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D) \
+									, TAIL_SAVE_WORD, TAIL_SAVE_WORD, TAIL_SAVE_WORD, TAIL_SAVE_WORD, TAIL_SAVE_WORD
+#define TAIL_MOVE_ARGUMENT	AT_SYMBOL(WS_R14), COMPUTE(DEST_A | DEST_M, COMP_M_PLUS_1), COMPUTE(DEST_A, COMP_A_MINUS_1) \
+									, COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_R13), COMPUTE(DEST_A | DEST_M, COMP_M_PLUS_1) \
+									, COMPUTE(DEST_A, COMP_A_MINUS_1), COMPUTE(DEST_M, COMP_D)
+#define TAIL_RESTORE_WORD	TAKE_D, AT_SYMBOL(WS_R13), COMPUTE(DEST_A | DEST_M, COMP_M_PLUS_1) \
+									, COMPUTE(DEST_A, COMP_A_MINUS_1), COMPUTE(DEST_M, COMP_D)
+#define TAIL_RESTORE_FRAME	TAIL_RESTORE_WORD, TAIL_RESTORE_WORD, TAIL_RESTORE_WORD, TAIL_RESTORE_WORD, TAIL_RESTORE_WORD \
+									, AT_SYMBOL(WS_R13), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_LCL), COMPUTE(DEST_M, COMP_D)
+
+// fixed text of a name part and the hole that follows it
+#define PART(text, hole)			{ (text), sizeof(text) - 1, (hole) }
+
+// defines a static name that is composed from the specified parts
+#define NAME(name, ...)			static const T_namePart name##Parts[] = { __VA_ARGS__ }; \
+											static const T_name name = { name##Parts, sizeof(name##Parts) / sizeof(T_namePart) }
+
+// defines a static template with the specified instruction records
+#define TEMPLATE(name, ...)		static const T_fragment name##Fragments[] = { __VA_ARGS__ }; \
+											static const T_template name = { name##Fragments, sizeof(name##Fragments) / sizeof(T_fragment) }
+
+// defines the text of an E_writerSymbol
+#define SYMBOL(text)				{ (text), sizeof(text) - 1 }
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// what fills the hole of a name part (H_FILE .. H_COUNTER) or of an instruction record
+typedef enum {
+	 H_NONE = 0
+	,H_FILE					// fileName of the code writer
+	,H_NAMESPACE			// label namespace of the code writer
+	,H_NAME					// name of the command (label, function)
+	,H_TEXT					// additional text (memory segment of push and pop)
+	,H_INDEX					// index or count of the command, a record gets it as value of its A-instruction
+	,H_COUNTER				// label counter
+	,H_SYMBOL				// record: the operand is an E_writerSymbol that is replaced by its string ID
+	,H_BASE					// record: the symbol is the base segment of the arguments
+	,H_JUMP					// record: the jump of the C-instruction is the jump of the arguments
+	,H_COMPOSED				// record: the symbol, label or comment is composed from the parts of a name
+} E_hole;
+
+typedef struct {
+	const char* text;
+	uint16_t length;
+	uint8_t hole;				// E_hole
+} T_namePart;
+
+typedef struct {
+	const T_namePart* parts;
+	uint8_t count;
+} T_name;
+
+// instruction record of a template and the hole that completes it
+typedef struct {
+	T_hackInstruction instruction;
+	uint8_t hole;				// E_hole
+	const T_name* name;		// H_COMPOSED: name of the symbol, label or comment
+} T_fragment;
+
+typedef struct {
+	const T_fragment* fragments;
+	uint16_t count;
+} T_template;
+
+// values for the holes of a template
+typedef struct {
+	T_stringView name;
+	T_stringView text;
+	uint32_t index;
+	uint32_t counter;
+	uint8_t base;				// E_writerSymbol of the base segment
+	uint8_t jump;				// jump bits
+} T_templateArgs;
+
+// writes the command and the commands after it as one superinstruction, returns the number of commands written
+typedef uint32_t (*T_idiomWriter)(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t EmitTemplate(T_codeWriter* writer, const T_template* template, const T_templateArgs* args);
+static uint8_t PrintTemplate(T_codeWriter* writer, const T_template* template, const T_templateArgs* args);
+static const T_printedTemplate* GetPrintedTemplate(T_codeWriter* writer, const T_template* template);
+static size_t GetRecordLength(const T_codeWriter* writer, const T_fragment* fragment, const T_templateArgs* args);
+static char* PrintRecord(T_codeWriter* writer, const T_fragment* fragment, const T_templateArgs* args, char* position);
+static uint32_t GetSymbolId(T_codeWriter* writer, E_writerSymbol symbol);
+static uint32_t InternName(T_codeWriter* writer, const T_name* name, const T_templateArgs* args);
+static size_t GetNameLength(const T_codeWriter* writer, const T_name* name, const T_templateArgs* args);
+static char* ComposeName(const T_codeWriter* writer, const T_name* name, const T_templateArgs* args, char* text);
+static uint8_t WriteComment(T_codeWriter* writer, E_commandType command, E_memorySegment memorySegment, uint16_t value, const T_stringView* name);
+static uint8_t WriteArithmetic(T_codeWriter* writer, E_commandType command);
+static uint8_t WritePush(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index);
+static uint8_t WritePop(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index);
+static uint8_t WriteLabel(T_codeWriter* writer, const T_stringView* labelName);
+static uint8_t WriteGoto(T_codeWriter* writer, const T_stringView* labelName);
+static uint8_t WriteIfGoto(T_codeWriter* writer, const T_stringView* labelName);
+static uint8_t WriteFunction(T_codeWriter* writer, const T_stringView* labelName, uint16_t numLocals);
+static uint8_t WriteCall(T_codeWriter* writer, const T_stringView* labelName, uint16_t numParams);
+static uint8_t WriteReturn(T_codeWriter* writer);
+static uint8_t SpillTop(T_codeWriter* writer);
+static uint8_t FillTop(T_codeWriter* writer);
+static uint32_t CountInstructions(const T_template* template);
+static uint8_t IsStaticFrame(const T_frameInfo* frame);
+static uint8_t SavedPointers(const T_frameInfo* frame);
+static uint32_t FoldConstants(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+static uint32_t FuseCompare(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+static uint32_t FuseMove(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+static uint32_t FuseArrayRead(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+static uint32_t FuseArrayWrite(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+static uint32_t FuseTailCall(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result);
+static uint16_t CountArguments(const T_vmProgram* program, const T_vmCommand* function);
+static uint8_t IsCommand(const T_vmCommand* command, E_commandType commandType, E_memorySegment memorySegment, uint16_t value);
+static uint8_t IsDirectOperand(E_memorySegment memorySegment, uint16_t index);
+static uint8_t WriteAddOperand(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index);
+static uint8_t WriteLoad(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index);
+static uint16_t EvaluateConstant(E_commandType command, uint16_t x, uint16_t y);
+static uint8_t LoadConstant(T_codeWriter* writer, uint16_t value);
+static uint8_t WriteSpecializedPush(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index);
+static uint8_t WriteSpecializedPop(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index);
+static uint8_t WriteStore(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index, uint8_t fromStack);
+static uint8_t WriteChain(T_codeWriter* writer, E_writerSymbol base, uint16_t index, const T_template* access);
+static E_indexClass GetIndexClass(E_memorySegment memorySegment, uint16_t index, uint16_t chainLimit);
+static uint16_t FixedAddress(E_memorySegment memorySegment, uint16_t index);
+static void CountSaved(T_codeWriter* writer, E_indexClass indexClass, const T_template* baseline, uint32_t start);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// indexed by E_writerSymbol
+static const T_stringView writerSymbols[WS_COUNT] = {
+	 SYMBOL("SP"), SYMBOL("LCL"), SYMBOL("ARG"), SYMBOL("THIS"), SYMBOL("THAT"), SYMBOL("R13"), SYMBOL("R14")
+	,SYMBOL("$call"), SYMBOL("$return"), SYMBOL("$start"), SYMBOL("POP_D"), SYMBOL("PUSH_D"), SYMBOL("FILL_D")
+	,SYMBOL("add"), SYMBOL("sub"), SYMBOL("neg"), SYMBOL("eq"), SYMBOL("gt"), SYMBOL("lt"), SYMBOL("and")
+	,SYMBOL("or"), SYMBOL("not"), SYMBOL("return"), SYMBOL("PUSH 0 on stack for local variable")
+	,SYMBOL("shared call routine"), SYMBOL("shared return routine"), SYMBOL("Bootstrap code")
+	,SYMBOL("call Sys.init 0")
+};
+
+// printed template of the templates that are printed record by record when the table is full
+static const T_printedTemplate recordByRecord = { NULL, 0, { 0 }, 0, { 0 }, PRINTED_RECORDS };
+
+// names of the labels, symbols and comments that are composed per command
+NAME(commandName		, PART("", H_NAME));
+NAME(functionLabel		, PART("", H_NAMESPACE), PART("$", H_NAME));
+NAME(staticVariable		, PART("", H_FILE), PART(".", H_INDEX));
+NAME(trueLabel			, PART("", H_NAMESPACE), PART(":true", H_COUNTER));
+NAME(endLabel			, PART("", H_NAMESPACE), PART(":end", H_COUNTER));
+NAME(returnLabel		, PART("", H_NAMESPACE), PART(":return", H_COUNTER));
+NAME(pushCommand		, PART("push ", H_TEXT), PART(" ", H_INDEX));
+NAME(popCommand			, PART("pop ", H_TEXT), PART(" ", H_INDEX));
+NAME(labelCommand		, PART("label ", H_NAME));
+NAME(gotoCommand		, PART("goto ", H_NAME));
+NAME(ifGotoCommand		, PART("if-goto ", H_NAME));
+NAME(functionCommand	, PART("function ", H_NAME), PART(" ", H_INDEX));
+NAME(callCommand		, PART("call ", H_NAME), PART(" ", H_INDEX));
+
+// comments
+TEMPLATE(commentNone		, COMMENT_NAME(commandName));
+TEMPLATE(commentAdd		, COMMENT(WS_ADD));
+TEMPLATE(commentSub		, COMMENT(WS_SUB));
+TEMPLATE(commentNeg		, COMMENT(WS_NEG));
+TEMPLATE(commentEq			, COMMENT(WS_EQ));
+TEMPLATE(commentGt			, COMMENT(WS_GT));
+TEMPLATE(commentLt			, COMMENT(WS_LT));
+TEMPLATE(commentAnd		, COMMENT(WS_AND));
+TEMPLATE(commentOr			, COMMENT(WS_OR));
+TEMPLATE(commentNot		, COMMENT(WS_NOT));
+TEMPLATE(commentPush		, COMMENT_NAME(pushCommand));
+TEMPLATE(commentPop		, COMMENT_NAME(popCommand));
+TEMPLATE(commentLabel		, COMMENT_NAME(labelCommand));
+TEMPLATE(commentGoto		, COMMENT_NAME(gotoCommand));
+TEMPLATE(commentIfGoto		, COMMENT_NAME(ifGotoCommand));
+TEMPLATE(commentFunction	, COMMENT_NAME(functionCommand));
+TEMPLATE(commentCall		, COMMENT_NAME(callCommand));
+TEMPLATE(commentReturn		, COMMENT(WS_RETURN));
+
+// indexed by E_commandType, CT_UNKNOWN (and push/pop with an unknown segment) write the source line
+static const T_template* const commentTemplates[CT_UNKNOWN + 1] = {
+	 &commentAdd, &commentSub, &commentNeg, &commentEq, &commentGt, &commentLt, &commentAnd, &commentOr
+	,&commentNot, &commentPush, &commentPop, &commentLabel, &commentGoto, &commentIfGoto, &commentFunction
+	,&commentCall, &commentReturn, &commentNone
+};
+
+// every command is followed by an empty line
+TEMPLATE(blank				, BLANK);
+
+// arithmetic
+#define BINARY_TEMPLATE(name, comp) \
+	TEMPLATE(name	, POP_D, BLANK, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D) \
+						, POP_D, BLANK, AT_SYMBOL(WS_R13), COMPUTE(DEST_D, (comp)), PUSH_D, BLANK)
+
+#define UNARY_TEMPLATE(name, comp) \
+	TEMPLATE(name	, POP_D, BLANK, COMPUTE(DEST_D, (comp)), PUSH_D, BLANK)
+
+// D = x - y, the boolean is left in D
+#define COMPARE_END(jump)	AT_NAME(trueLabel), JUMP(COMP_D, (jump)), COMPUTE(DEST_D, COMP_0) \
+									, AT_NAME(endLabel), JUMP(COMP_0, JUMP_JMP) \
+									, LABEL_NAME(trueLabel), COMPUTE(DEST_D, COMP_MINUS_1), LABEL_NAME(endLabel)
+
+#define COMPARE_TEMPLATE(name, jump) \
+	TEMPLATE(name	, POP_D, BLANK, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D) \
+						, POP_D, BLANK, AT_SYMBOL(WS_R13), COMPUTE(DEST_D, COMP_D_MINUS_M) \
+						, COMPARE_END(jump), PUSH_D, BLANK)
+
+BINARY_TEMPLATE(arithmeticAdd, COMP_D_PLUS_M);
+BINARY_TEMPLATE(arithmeticSub, COMP_D_MINUS_M);
+UNARY_TEMPLATE(arithmeticNeg, COMP_NEG_D);
+BINARY_TEMPLATE(arithmeticAnd, COMP_D_AND_M);
+BINARY_TEMPLATE(arithmeticOr, COMP_D_OR_M);
+UNARY_TEMPLATE(arithmeticNot, COMP_NOT_D);
+COMPARE_TEMPLATE(arithmeticEq, JUMP_JEQ);
+COMPARE_TEMPLATE(arithmeticGt, JUMP_JGT);
+COMPARE_TEMPLATE(arithmeticLt, JUMP_JLT);
+
+// indexed by E_commandType (CT_ADD .. CT_NOT)
+static const T_template* const arithmeticTemplates[CT_NOT + 1] = {
+	 &arithmeticAdd, &arithmeticSub, &arithmeticNeg, &arithmeticEq, &arithmeticGt, &arithmeticLt
+	,&arithmeticAnd, &arithmeticOr, &arithmeticNot
+};
+
+// push
+#define PUSH_BASE_TEMPLATE(name, base) \
+	TEMPLATE(name	, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_SYMBOL(base), COMPUTE(DEST_A, COMP_M) \
+						, COMPUTE(DEST_A, COMP_D_PLUS_A), COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK)
+
+#define PUSH_FIXED_TEMPLATE(name, base) \
+	TEMPLATE(name	, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT(base), COMPUTE(DEST_A, COMP_D_PLUS_A) \
+						, COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK)
+
+PUSH_BASE_TEMPLATE(pushLocal, WS_LCL);
+PUSH_BASE_TEMPLATE(pushArgument, WS_ARG);
+PUSH_BASE_TEMPLATE(pushThis, WS_THIS);
+PUSH_BASE_TEMPLATE(pushThat, WS_THAT);
+TEMPLATE(pushConstant	, AT_INDEX, COMPUTE(DEST_D, COMP_A), PUSH_D, BLANK);
+TEMPLATE(pushStatic		, AT_NAME(staticVariable), COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK);
+PUSH_FIXED_TEMPLATE(pushPointer, 3);
+PUSH_FIXED_TEMPLATE(pushTemp, 5);
+TEMPLATE(pushFrame		, AT_INDEX, COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK);
+
+// indexed by E_memorySegment
+static const T_template* const pushTemplates[MS_UNKNOWN] = {
+	 &pushLocal, &pushArgument, &pushThis, &pushThat, &pushConstant, &pushStatic, &pushPointer, &pushTemp, &pushFrame
+};
+
+// pop, the address is kept in R14 (the last records are the same for every segment)
+#define POP_ADDRESS			AT_SYMBOL(WS_R14), COMPUTE(DEST_M, COMP_D), AT_SYMBOL(WS_R13), COMPUTE(DEST_D, COMP_M) \
+									, AT_SYMBOL(WS_R14), COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_M, COMP_D)
+
+#define POP_BASE_TEMPLATE(name, base) \
+	TEMPLATE(name	, POP_D, BLANK, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D), AT_INDEX, COMPUTE(DEST_D, COMP_A) \
+						, AT_SYMBOL(base), COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_D, COMP_D_PLUS_A), POP_ADDRESS)
+
+#define POP_FIXED_TEMPLATE(name, base) \
+	TEMPLATE(name	, POP_D, BLANK, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D), AT_INDEX, COMPUTE(DEST_D, COMP_A) \
+						, AT(base), COMPUTE(DEST_D, COMP_D_PLUS_A), POP_ADDRESS)
+
+POP_BASE_TEMPLATE(popLocal, WS_LCL);
+POP_BASE_TEMPLATE(popArgument, WS_ARG);
+POP_BASE_TEMPLATE(popThis, WS_THIS);
+POP_BASE_TEMPLATE(popThat, WS_THAT);
+TEMPLATE(popStatic			, POP_D, BLANK, AT_NAME(staticVariable), COMPUTE(DEST_M, COMP_D));
+POP_FIXED_TEMPLATE(popPointer, 3);
+POP_FIXED_TEMPLATE(popTemp, 5);
+TEMPLATE(popFrame			, POP_D, BLANK, AT_INDEX, COMPUTE(DEST_M, COMP_D));
+
+// indexed by E_memorySegment, nothing is generated for pop constant
+static const T_template* const popTemplates[MS_UNKNOWN] = {
+	 &popLocal, &popArgument, &popThis, &popThat, NULL, &popStatic, &popPointer, &popTemp, &popFrame
+};
+
+// program flow
+TEMPLATE(label		, LABEL_NAME(functionLabel));
+TEMPLATE(gotoLabel	, AT_NAME(functionLabel), JUMP(COMP_0, JUMP_JMP));
+TEMPLATE(ifGoto		, POP_D, BLANK, AT_NAME(functionLabel), JUMP(COMP_D, JUMP_JNE));
+
+// function calling
+TEMPLATE(function		, LABEL_NAME(commandName));
+TEMPLATE(functionLocal	, COMMENT(WS_PUSH_LOCAL), COMPUTE(DEST_D, COMP_0), AT_SYMBOL(WS_SP), COMPUTE(DEST_A, COMP_M)
+							, COMPUTE(DEST_M, COMP_D), AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_M_PLUS_1));
+
+#define CALL_TEMPLATE(name, saveThis, saveThat) \
+	TEMPLATE(name	, AT_NAME(returnLabel), COMPUTE(DEST_D, COMP_A), PUSH_D, BLANK \
+						, AT_SYMBOL(WS_LCL), COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK \
+						, AT_SYMBOL(WS_ARG), COMPUTE(DEST_D, COMP_M), PUSH_D, BLANK, saveThis, saveThat \
+						, AT_SYMBOL(WS_SP), COMPUTE(DEST_D, COMP_M), AT(5), COMPUTE(DEST_D, COMP_D_MINUS_A) \
+						, AT_INDEX, COMPUTE(DEST_D, COMP_D_MINUS_A), AT_SYMBOL(WS_ARG), COMPUTE(DEST_M, COMP_D) \
+						, AT_SYMBOL(WS_SP), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_LCL), COMPUTE(DEST_M, COMP_D) \
+						, AT_NAME(commandName), JUMP(COMP_0, JUMP_JMP), LABEL_NAME(returnLabel))
+
+CALL_TEMPLATE(callSavingNone, SKIP_SLOT, SKIP_SLOT);
+CALL_TEMPLATE(callSavingThis, SAVE_THIS, SKIP_SLOT);
+CALL_TEMPLATE(callSavingThat, SKIP_SLOT, SAVE_THAT);
+CALL_TEMPLATE(call, SAVE_THIS, SAVE_THAT);
+TEMPLATE(returnRestoringNone	, RETURN_START, RETURN_END);
+TEMPLATE(returnRestoringThis	, RETURN_START, RESTORE_THIS, RETURN_END);
+TEMPLATE(returnRestoringThat	, RETURN_START, RESTORE_THAT, RETURN_END);
+TEMPLATE(inlineReturn			, RETURN_START, RESTORE_THAT, RESTORE_THIS, RETURN_END);
+
+// indexed by the pointers a frame saves, bit 0: THIS, bit 1: THAT
+static const T_template* const callTemplates[4] = {
+	 &callSavingNone, &callSavingThis, &callSavingThat, &call
+};
+static const T_template* const returnTemplates[4] = {
+	 &returnRestoringNone, &returnRestoringThis, &returnRestoringThat, &inlineReturn
+};
+
+// shared calling convention
+TEMPLATE(sharedCall	, AT_NAME(commandName), COMPUTE(DEST_D, COMP_A), AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D)
+							, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_SYMBOL(WS_R14), COMPUTE(DEST_M, COMP_D)
+							, AT_NAME(returnLabel), COMPUTE(DEST_D, COMP_A), AT_SYMBOL(WS_CALL_ROUTINE), JUMP(COMP_0, JUMP_JMP)
+							, LABEL_NAME(returnLabel));
+TEMPLATE(sharedReturn	, SHARED_RETURN_JUMP);
+TEMPLATE(sharedRoutines	, SHARED_CALL, SHARED_RETURN);
+TEMPLATE(startJump		, AT_SYMBOL(WS_START), JUMP(COMP_0, JUMP_JMP), BLANK);
+TEMPLATE(startLabel		, LABEL(WS_START), BLANK);
+
+// bootstrap code (H_INDEX: start of the stack), it is followed by the call of Sys.init
+TEMPLATE(bootstrap		, COMMENT(WS_BOOTSTRAP), AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_D)
+							, BLANK, COMMENT(WS_CALL_SYS_INIT));
+
+// static frames, the return address is passed in D and kept at the base of the frame (H_INDEX: base)
+TEMPLATE(staticFunction	, LABEL_NAME(commandName), AT_INDEX, COMPUTE(DEST_M, COMP_D));
+TEMPLATE(staticCall		, AT_NAME(returnLabel), COMPUTE(DEST_D, COMP_A), AT_NAME(commandName), JUMP(COMP_0, JUMP_JMP)
+							, LABEL_NAME(returnLabel));
+TEMPLATE(staticReturn	, AT_INDEX, COMPUTE(DEST_A, COMP_M), JUMP(COMP_0, JUMP_JMP));
+TEMPLATE(staticTailCall	, AT_INDEX, COMPUTE(DEST_D, COMP_M), AT_NAME(commandName), JUMP(COMP_0, JUMP_JMP));
+
+// cached top of stack: the operand on top of the stack is in D, the result is left in D
+TEMPLATE(cachedAdd		, TAKE_OPERAND, COMPUTE(DEST_D, COMP_D_PLUS_M));
+TEMPLATE(cachedSub		, TAKE_OPERAND, COMPUTE(DEST_D, COMP_M_MINUS_D));
+TEMPLATE(cachedNeg		, COMPUTE(DEST_D, COMP_NEG_D));
+TEMPLATE(cachedAnd		, TAKE_OPERAND, COMPUTE(DEST_D, COMP_D_AND_M));
+TEMPLATE(cachedOr			, TAKE_OPERAND, COMPUTE(DEST_D, COMP_D_OR_M));
+TEMPLATE(cachedNot		, COMPUTE(DEST_D, COMP_NOT_D));
+
+#define CACHED_COMPARE_TEMPLATE(name, jump) \
+	TEMPLATE(name	, TAKE_OPERAND, COMPUTE(DEST_D, COMP_M_MINUS_D), COMPARE_END(jump))
+
+CACHED_COMPARE_TEMPLATE(cachedEq, JUMP_JEQ);
+CACHED_COMPARE_TEMPLATE(cachedGt, JUMP_JGT);
+CACHED_COMPARE_TEMPLATE(cachedLt, JUMP_JLT);
+
+// indexed by E_commandType (CT_ADD .. CT_NOT)
+static const T_template* const cachedArithmeticTemplates[CT_NOT + 1] = {
+	 &cachedAdd, &cachedSub, &cachedNeg, &cachedEq, &cachedGt, &cachedLt, &cachedAnd, &cachedOr, &cachedNot
+};
+
+// cached top of stack: push loads the value into D
+#define LOAD_BASE_TEMPLATE(name, base) \
+	TEMPLATE(name	, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_SYMBOL(base), COMPUTE(DEST_A, COMP_D_PLUS_M), COMPUTE(DEST_D, COMP_M))
+
+#define LOAD_FIXED_TEMPLATE(name, base) \
+	TEMPLATE(name	, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT(base), COMPUTE(DEST_A, COMP_D_PLUS_A), COMPUTE(DEST_D, COMP_M))
+
+LOAD_BASE_TEMPLATE(loadLocal, WS_LCL);
+LOAD_BASE_TEMPLATE(loadArgument, WS_ARG);
+LOAD_BASE_TEMPLATE(loadThis, WS_THIS);
+LOAD_BASE_TEMPLATE(loadThat, WS_THAT);
+TEMPLATE(loadConstant		, AT_INDEX, COMPUTE(DEST_D, COMP_A));
+TEMPLATE(loadInverted		, AT_INDEX, COMPUTE(DEST_D, COMP_NOT_A));
+TEMPLATE(loadStatic		, AT_NAME(staticVariable), COMPUTE(DEST_D, COMP_M));
+LOAD_FIXED_TEMPLATE(loadPointer, 3);
+LOAD_FIXED_TEMPLATE(loadTemp, 5);
+TEMPLATE(loadFixed			, AT_INDEX, COMPUTE(DEST_D, COMP_M));
+
+// indexed by E_memorySegment, the index of a frame access is its address
+static const T_template* const loadTemplates[MS_UNKNOWN] = {
+	 &loadLocal, &loadArgument, &loadThis, &loadThat, &loadConstant, &loadStatic, &loadPointer, &loadTemp, &loadFixed
+};
+
+// constants that need no A-instruction
+TEMPLATE(loadZero			, COMPUTE(DEST_D, COMP_0));
+TEMPLATE(loadOne			, COMPUTE(DEST_D, COMP_1));
+TEMPLATE(loadMinusOne		, COMPUTE(DEST_D, COMP_MINUS_1));
+
+// cached top of stack: pop stores D
+#define STORE_BASE_TEMPLATE(name, base) \
+	TEMPLATE(name	, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D), AT_INDEX, COMPUTE(DEST_D, COMP_A) \
+						, AT_SYMBOL(base), COMPUTE(DEST_D, COMP_D_PLUS_M), POP_ADDRESS)
+
+#define STORE_FIXED_TEMPLATE(name, base) \
+	TEMPLATE(name	, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D), AT_INDEX, COMPUTE(DEST_D, COMP_A) \
+						, AT(base), COMPUTE(DEST_D, COMP_D_PLUS_A), POP_ADDRESS)
+
+STORE_BASE_TEMPLATE(storeLocal, WS_LCL);
+STORE_BASE_TEMPLATE(storeArgument, WS_ARG);
+STORE_BASE_TEMPLATE(storeThis, WS_THIS);
+STORE_BASE_TEMPLATE(storeThat, WS_THAT);
+TEMPLATE(storeStatic		, AT_NAME(staticVariable), COMPUTE(DEST_M, COMP_D));
+STORE_FIXED_TEMPLATE(storePointer, 3);
+STORE_FIXED_TEMPLATE(storeTemp, 5);
+TEMPLATE(storeFixed			, AT_INDEX, COMPUTE(DEST_M, COMP_D));
+
+// indexed by E_memorySegment, nothing is generated for pop constant, the index of a frame access is its address
+static const T_template* const storeTemplates[MS_UNKNOWN] = {
+	 &storeLocal, &storeArgument, &storeThis, &storeThat, NULL, &storeStatic, &storePointer, &storeTemp, &storeFixed
+};
+
+// specialized push and pop, the base segments get their base symbol as argument
+TEMPLATE(loadBaseZero		, AT_BASE, COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_D, COMP_M));
+TEMPLATE(storeBaseZero		, AT_BASE, COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_M, COMP_D));
+TEMPLATE(loadBase				, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_BASE, COMPUTE(DEST_A, COMP_D_PLUS_M), COMPUTE(DEST_D, COMP_M));
+TEMPLATE(popBase				, AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_BASE, COMPUTE(DEST_D, COMP_D_PLUS_M)
+								, TAKE_OPERAND, COMPUTE(DEST_D, COMP_D_PLUS_M), COMPUTE(DEST_A, COMP_D_MINUS_M), COMPUTE(DEST_M, COMP_D_MINUS_A));
+TEMPLATE(storeBase			, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D), AT_INDEX, COMPUTE(DEST_D, COMP_A), AT_BASE
+								, COMPUTE(DEST_D, COMP_D_PLUS_M), AT_SYMBOL(WS_R13), COMPUTE(DEST_D, COMP_D_PLUS_M)
+								, COMPUTE(DEST_A, COMP_D_MINUS_M), COMPUTE(DEST_M, COMP_D_MINUS_A));
+TEMPLATE(pushD				, PUSH_D);
+TEMPLATE(fillD				, FILL_D);
+TEMPLATE(takeD				, TAKE_D);
+
+// "@base, A=M+1, A=A+1, ..." chain to base[index] and the access at its end
+TEMPLATE(chainStart			, AT_BASE, COMPUTE(DEST_A, COMP_M_PLUS_1));
+TEMPLATE(chainNext			, COMPUTE(DEST_A, COMP_A_PLUS_1));
+TEMPLATE(chainLoad			, COMPUTE(DEST_D, COMP_M));
+TEMPLATE(chainStore			, COMPUTE(DEST_M, COMP_D));
+TEMPLATE(chainAdd				, COMPUTE(DEST_D, COMP_D_PLUS_M));
+
+// indexed by E_memorySegment (MS_LOCAL .. MS_THAT)
+static const uint8_t baseSymbols[MS_THAT + 1] = {
+	 WS_LCL, WS_ARG, WS_THIS, WS_THAT
+};
+
+// address of index 0 of pointer and temp, the index of frame is the address itself
+#define POINTER_ADDRESS		(3)
+#define TEMP_ADDRESS			(5)
+
+// indexed by E_indexClass
+static const char* const indexClassNames[IC_COUNT] = {
+	 "base index 0", "base small index", "base other index", "pointer/temp", "constant", "static"
+};
+
+// cached top of stack: the condition is in D
+TEMPLATE(cachedIfGoto	, AT_NAME(functionLabel), JUMP(COMP_D, JUMP_JNE));
+
+// compare followed by if-goto, the jump is an argument
+TEMPLATE(fusedCompare			, TAKE_D, TAKE_OPERAND, COMPUTE(DEST_D, COMP_M_MINUS_D), AT_NAME(functionLabel), JUMP_ARG(COMP_D));
+TEMPLATE(cachedFusedCompare	, TAKE_OPERAND, COMPUTE(DEST_D, COMP_M_MINUS_D), AT_NAME(functionLabel), JUMP_ARG(COMP_D));
+
+// superinstructions, tried in this order
+static const T_idiomWriter idiomWriters[] = {
+	 FoldConstants, FuseArrayRead, FuseArrayWrite, FuseCompare, FuseMove, FuseTailCall
+};
+
+#define IDIOM_WRITER_COUNT	(sizeof(idiomWriters) / sizeof(idiomWriters[0]))
+
+// array access, the address is in D (the index is kept in R13 while the base is loaded)
+TEMPLATE(arraySaveIndex	, AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D));
+TEMPLATE(arrayAddIndex	, AT_SYMBOL(WS_R13), COMPUTE(DEST_D, COMP_D_PLUS_M));
+TEMPLATE(arrayRead			, AT_SYMBOL(WS_THAT), COMPUTE(DEST_A | DEST_M, COMP_D), COMPUTE(DEST_D, COMP_M));
+TEMPLATE(arrayWrite		, AT(5), COMPUTE(DEST_M, COMP_D), TAKE_D, AT_SYMBOL(WS_THAT), COMPUTE(DEST_M, COMP_D)
+							, AT(5), COMPUTE(DEST_D, COMP_D_PLUS_M), COMPUTE(DEST_A, COMP_D_MINUS_M), COMPUTE(DEST_M, COMP_D_MINUS_A)
+							, BLANK);
+
+// tail calls, the frame is reused (H_INDEX: number of arguments + 5)
+TEMPLATE(tailJump			, AT_SYMBOL(WS_LCL), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_D)
+							, AT_NAME(commandName), JUMP(COMP_0, JUMP_JMP));
+TEMPLATE(tailMoveStart	, TAIL_SAVE_FRAME, AT_SYMBOL(WS_ARG), COMPUTE(DEST_D, COMP_M), AT_SYMBOL(WS_R13), COMPUTE(DEST_M, COMP_D)
+							, AT_SYMBOL(WS_SP), COMPUTE(DEST_D, COMP_M), AT_INDEX, COMPUTE(DEST_D, COMP_D_MINUS_A)
+							, AT_SYMBOL(WS_R14), COMPUTE(DEST_M, COMP_D));
+TEMPLATE(tailMoveArgument	, TAIL_MOVE_ARGUMENT);
+TEMPLATE(tailMoveJump	, TAIL_RESTORE_FRAME, AT_SYMBOL(WS_SP), COMPUTE(DEST_M, COMP_D), AT_NAME(commandName)
+							, JUMP(COMP_0, JUMP_JMP));
+
+// D = D + operand
+TEMPLATE(addConstant		, AT_INDEX, COMPUTE(DEST_D, COMP_D_PLUS_A));
+TEMPLATE(addFixed			, AT_INDEX, COMPUTE(DEST_D, COMP_D_PLUS_M));
+TEMPLATE(addStatic			, AT_NAME(staticVariable), COMPUTE(DEST_D, COMP_D_PLUS_M));
+TEMPLATE(addBaseZero		, AT_BASE, COMPUTE(DEST_A, COMP_M), COMPUTE(DEST_D, COMP_D_PLUS_M));
+
+// jump of eq, gt and lt (indexed by command - CT_EQ), and of the negated compare
+static const uint8_t compareJumps[3][2] = {
+	 { JUMP_JEQ, JUMP_JNE }
+	,{ JUMP_JGT, JUMP_JLE }
+	,{ JUMP_JLT, JUMP_JGE }
+};
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void InitCodeWriter(T_codeWriter* writer, T_hackProgram* output, const char* fileName, const char* sourcePath) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes a code writer that writes assembly code for one .vm file to an instruction list
+
+	\param[out]		writer		Pointer to code writer
+	\param[in]		output		Pointer to instruction list that receives the assembly code
+	\param[in]		fileName		Pointer to filename
+	\param[in]		sourcePath	Pointer to path of the .vm file that diagnostics report, may be NULL
+
+	\note
+		- fileName is used to generate file specific labels for the assembly code output, it must stay valid as
+		  long as the code writer is used, the same holds for sourcePath
+		- the labels the code writer generates itself are numbered per function, commands before the first
+		  function of a file use the fileName as namespace
+		- set cacheTop after initializing to keep the top of the stack in D between commands
+		- set sharedCalls after initializing to use the shared $call and $return routines, they must be written
+		  once with WriteInit or WriteSharedRoutines
+		- set foldConstants after initializing to evaluate arithmetic on constants at translation time
+		- set specializeIndex after initializing to use the shortest push and pop sequence for every index
+		- set fuseCompare after initializing to jump directly on a compare that is followed by if-goto
+		- set fuseMove after initializing to move a value without the stack when a push is followed by a pop
+		- set fuseArray after initializing to compute the address of array reads and writes without the stack
+		- set tailCalls after initializing to reuse the frame for a call that is directly followed by return
+		- set frames after initializing to call the functions with a static frame without the frame protocol,
+		  the table must stay valid as long as the code writer is used
+		- set text after initializing to print the assembly code directly into that buffer, output then gets no
+		  records, use it when no pass needs them, the code writer must be freed with FreeCodeWriter
+
+***************************************************************************************************************
+*/
+	writer->output = output;
+	writer->text = NULL;
+	writer->fileName = fileName;
+	writer->fileNameLength = (uint32_t)strlen(fileName);
+	writer->sourcePath = sourcePath;
+	writer->labelNamespace = fileName;
+	writer->labelNamespaceLength = writer->fileNameLength;
+	writer->compareCounter = 0;
+	writer->returnCounter = 0;
+	writer->cacheTop = 0;
+	writer->topInD = 0;
+	writer->sharedCalls = 0;
+	writer->foldConstants = 0;
+	writer->specializeIndex = 0;
+	writer->fuseCompare = 0;
+	writer->fuseMove = 0;
+	writer->fuseArray = 0;
+	writer->tailCalls = 0;
+	writer->argumentCount = 0;
+	writer->frames = NULL;
+	writer->frame = NULL;
+	memset(&writer->stats, 0, sizeof(writer->stats));
+	writer->instructions = 0;
+	for (uint32_t i = 0; i < WS_COUNT; i++) {
+		writer->symbols[i] = STRING_ID_INVALID;
+	}
+	writer->printed = NULL;
+	InitOutputBuffer(&writer->printedText);
+}
+/*
+***************************************************************************************************************
+	End InitCodeWriter
+***************************************************************************************************************
+*/
+
+void FreeCodeWriter(T_codeWriter* writer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the printed templates of a code writer
+
+	\param[in,out]	writer		Pointer to code writer
+
+***************************************************************************************************************
+*/
+	free(writer->printed);
+	writer->printed = NULL;
+	FreeOutputBuffer(&writer->printedText);
+}
+/*
+***************************************************************************************************************
+	End FreeCodeWriter
+***************************************************************************************************************
+*/
+
+// Or move function to main ? NOPE (all codewriting here !!!)
+uint8_t WriteInit(T_hackProgram* output, uint8_t sharedCalls, uint16_t stackStart) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the Bootstrap code and writes it to an instruction list
+
+	\param[out]		output			Pointer to instruction list
+	\param[in]		sharedCalls		1: Sys.init is called through the shared $call routine, the shared routines
+										   are written after the bootstrap code
+	\param[in]		stackStart		Address of the stack, STACK_START_ADDRESS unless there are static frames
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+	\note
+		- the call of Sys.init never returns, so the shared routines need no jump around them
+
+***************************************************************************************************************
+*/
+	T_codeWriter writer;
+	T_stringView sysInit = { "Sys.init", sizeof("Sys.init") - 1 };
+	T_templateArgs args;
+	uint8_t result = 0;
+
+	InitCodeWriter(&writer, output, BOOTSTRAP_NAMESPACE, NULL);
+	writer.sharedCalls = sharedCalls;
+
+	memset(&args, 0, sizeof(args));
+	args.index = stackStart;
+	result = EmitTemplate(&writer, &bootstrap, &args);
+	if (result != 0) {
+		result = WriteCall(&writer, &sysInit, 0);
+	}
+
+	if (result != 0) {
+		result = EmitTemplate(&writer, &blank, NULL);
+	}
+
+	if (	(result != 0)
+		&& (sharedCalls != 0)
+	) {
+		result = WriteSharedRoutines(output, 0);
+	}
+
+	if (result == 0) {
+		DIAG_ERROR(DC_ENCODING, NULL, 0, 0, "bootstrap");
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteInit
+***************************************************************************************************************
+*/
+
+uint8_t WriteSharedRoutines(T_hackProgram* output, uint8_t skip) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the shared $call and $return routines to an instruction list
+
+	\param[out]		output		Pointer to instruction list
+	\param[in]		skip			1: jump around the routines (when the code that follows them is executed first)
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+***************************************************************************************************************
+*/
+	T_codeWriter writer;
+	uint8_t result = 1;
+
+	InitCodeWriter(&writer, output, BOOTSTRAP_NAMESPACE, NULL);
+	if (skip != 0) {
+		result = EmitTemplate(&writer, &startJump, NULL);
+	}
+	if (result != 0) {
+		result = EmitTemplate(&writer, &sharedRoutines, NULL);
+	}
+	if (	(result != 0)
+		&& (skip != 0)
+	) {
+		result = EmitTemplate(&writer, &startLabel, NULL);
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteSharedRoutines
+***************************************************************************************************************
+*/
+
+void AddCodeWriterStats(T_codeWriterStats* total, const T_codeWriterStats* stats) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function adds the statistics of one code writer to the total
+
+	\param[in,out]	total		Pointer to total statistics
+	\param[in]		stats		Pointer to statistics that are added
+
+***************************************************************************************************************
+*/
+	total->calls += stats->calls;
+	total->returns += stats->returns;
+	total->folds += stats->folds;
+	total->foldedPops += stats->foldedPops;
+	total->fusedCompares += stats->fusedCompares;
+	total->fusedMoves += stats->fusedMoves;
+	total->arrayReads += stats->arrayReads;
+	total->arrayWrites += stats->arrayWrites;
+	total->tailCalls += stats->tailCalls;
+	total->movedTailCalls += stats->movedTailCalls;
+	total->staticCalls += stats->staticCalls;
+	total->staticReturns += stats->staticReturns;
+	for (uint8_t i = 0; i < IC_COUNT; i++) {
+		total->indexCommands[i] += stats->indexCommands[i];
+		total->indexSaved[i] += stats->indexSaved[i];
+	}
+}
+/*
+***************************************************************************************************************
+	End AddCodeWriterStats
+***************************************************************************************************************
+*/
+
+void PrintCodeWriterStats(const T_codeWriterStats* stats, uint8_t sharedCalls) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the code size of the calling convention, inline and with the shared routines, the
+		number of folded constant operations, of fused compares, moves and array accesses and the instructions
+		saved by the specialized push and pop
+
+	\param[in]		stats				Pointer to statistics of all code writers
+	\param[in]		sharedCalls		1: the shared routines were used
+
+	\note
+		- the sizes are counted from the templates, a cached top of stack and the peephole optimizer are not
+		  taken into account
+
+***************************************************************************************************************
+*/
+	uint32_t inlineCallSize = CountInstructions(&call);
+	uint32_t inlineReturnSize = CountInstructions(&inlineReturn);
+	uint32_t sharedCallSize = CountInstructions(&sharedCall);
+	uint32_t sharedReturnSize = CountInstructions(&sharedReturn);
+	uint32_t routinesSize = CountInstructions(&sharedRoutines);
+	uint64_t inlineSize = ((uint64_t)stats->calls * inlineCallSize) + ((uint64_t)stats->returns * inlineReturnSize);
+	uint64_t sharedSize = ((uint64_t)stats->calls * sharedCallSize) + ((uint64_t)stats->returns * sharedReturnSize)
+								+ routinesSize;
+
+	printf("calls: %u call sites, %u returns (%s)\n", stats->calls, stats->returns, (sharedCalls != 0) ? "shared" : "inline");
+	printf("  inline  %u per call, %u per return: %llu instructions\n"
+			, inlineCallSize, inlineReturnSize, (unsigned long long)inlineSize);
+	printf("  shared  %u per call, %u per return, %u for the routines: %llu instructions\n"
+			, sharedCallSize, sharedReturnSize, routinesSize, (unsigned long long)sharedSize);
+	printf("folds: %u constant operations, %u constants popped without the stack\n", stats->folds, stats->foldedPops);
+	printf("fused compares: %u compare and if-goto pairs\n", stats->fusedCompares);
+	printf("fused moves: %u push and pop pairs\n", stats->fusedMoves);
+	printf("fused array accesses: %u reads, %u writes\n", stats->arrayReads, stats->arrayWrites);
+	printf("tail calls: %u in place, %u with moved frame\n", stats->tailCalls - stats->movedTailCalls, stats->movedTailCalls);
+	printf("static frames: %u call sites, %u returns\n", stats->staticCalls, stats->staticReturns);
+	printf("specialized push/pop:\n");
+	for (uint8_t i = 0; i < IC_COUNT; i++) {
+		printf("  %-18s %8u commands %8d instructions saved\n", indexClassNames[i], stats->indexCommands[i], stats->indexSaved[i]);
+	}
+}
+/*
+***************************************************************************************************************
+	End PrintCodeWriterStats
+***************************************************************************************************************
+*/
+
+void PrintFrameCosts(const T_frameTable* frames, uint8_t sharedCalls) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the frame of every function with the pointers it saves and the size of its call and
+		return
+
+	\param[in]		frames			Pointer to frame table
+	\param[in]		sharedCalls		1: the shared routines were used for the frames on the stack
+
+	\note
+		- the sizes are counted from the templates like in PrintCodeWriterStats, the shared routines always save
+		  both pointers
+
+***************************************************************************************************************
+*/
+	printf("frame costs: instructions per call site and per return\n");
+	// the names are the IDs of the frames, the empty string comes first
+	for (uint32_t i = STRING_ID_NONE + 1; i < frames->count; i++) {
+		const T_frameInfo* frame = &frames->frames[i];
+		uint8_t saved = SavedPointers(frame);
+
+		if (IsStaticFrame(frame) != 0) {
+			printf("  %-40s static at %4u, %3u words  %3u call %3u return\n", GetString(&frames->names, i)
+					, frame->base, (frame->locals + frame->localCount) - frame->base
+					, CountInstructions(&staticCall), CountInstructions(&staticReturn));
+		} else if (sharedCalls != 0) {
+			printf("  %-40s stack  THIS THAT         %3u call %3u return\n", GetString(&frames->names, i)
+					, CountInstructions(&sharedCall), CountInstructions(&sharedReturn));
+		} else {
+			printf("  %-40s stack  %-4s %-4s         %3u call %3u return\n", GetString(&frames->names, i)
+					, ((saved & 1) != 0) ? "THIS" : "-", ((saved & 2) != 0) ? "THAT" : "-"
+					, CountInstructions(callTemplates[saved]), CountInstructions(returnTemplates[saved]));
+		}
+	}
+}
+/*
+***************************************************************************************************************
+	End PrintFrameCosts
+***************************************************************************************************************
+*/
+
+uint8_t WriteProgram(T_codeWriter* writer, const T_vmProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for all commands of a parsed VM program
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to parsed VM program
+
+	\returns
+		0: writing assembly instructions failed for one or more commands
+		1: writing assembly instructions was successful
+
+***************************************************************************************************************
+*/
+	return WriteCommandRange(writer, program, 0, program->count);
+}
+/*
+***************************************************************************************************************
+	End WriteProgram
+***************************************************************************************************************
+*/
+
+uint8_t WriteCommandRange(T_codeWriter* writer, const T_vmProgram* program, uint32_t first, uint32_t end) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the commands [first, end) of a parsed VM program
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to parsed VM program
+	\param[in]		first			Index of the first command
+	\param[in]		end			Index after the last command
+
+	\returns
+		0: writing assembly instructions failed for one or more commands
+		1: writing assembly instructions was successful
+
+	\note
+		- when first is not 0 it should be the index of a function command, only then the generated labels are
+		  the same as when the whole program is written at once
+		- a cached top of stack is written to RAM at the end of the range, at the same place where the next
+		  function command would write it
+		- superinstructions never cross the end of the range
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* command = program->commands + first;
+	const T_vmCommand* last = program->commands + end;
+	uint8_t result = 1;
+
+	while (command < last) {
+		uint32_t count = 0;
+
+		for (uint8_t i = 0; (i < IDIOM_WRITER_COUNT) && (count == 0); i++) {
+			count = idiomWriters[i](writer, program, command, last, &result);
+		}
+		if (count == 0) {
+			if (WriteCommand(writer, program, command) == 0) {
+				result = 0;
+			}
+			count = 1;
+		}
+		command += count;
+	}
+
+	if (SpillTop(writer) == 0) {
+		result = 0;
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteCommandRange
+***************************************************************************************************************
+*/
+
+uint8_t WriteCommand(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* vmCommand) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the VM command and writes it to the output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the command belongs to
+	\param[in]		vmCommand	Pointer to VM command to assemble
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+	\note
+		- the VM command is output as a C-style comment in the output file just before the generated assembly
+		  for the specified command (could be helpful for debugging)
+
+***************************************************************************************************************
+*/
+	E_commandType command = (E_commandType)vmCommand->commandType;
+	E_memorySegment memorySegment = (E_memorySegment)vmCommand->memorySegment;
+	uint16_t value = vmCommand->value;
+	T_stringView name;
+	uint8_t result = 0;
+
+	name.start = GetString(&program->names, vmCommand->nameId);
+	name.length = GetStringLength(&program->names, vmCommand->nameId);
+
+	// control flow needs the complete stack in RAM, a cached top of stack is written before the command
+	if (	(command >= CT_LABEL)
+		&& (command <= CT_RETURN)
+		&& (command != CT_IFGOTO)
+		&& (SpillTop(writer) == 0)
+	) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, vmCommand->lineNumber, vmCommand->column, NULL);
+		return 0;
+	}
+
+	// a constant has no memory to pop into, the other backends reject it as well
+	if (	(command == CT_POP)
+		&& (memorySegment == MS_CONSTANT)
+	) {
+		DIAG_ERROR(DC_UNKNOWN_SEGMENT, writer->sourcePath, vmCommand->lineNumber, vmCommand->column, "pop constant");
+		return 0;
+	}
+
+	if (WriteComment(writer, command, memorySegment, value, &name) == 0) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, vmCommand->lineNumber, vmCommand->column, NULL);
+		return 0;
+	}
+
+	switch (command) {
+	case CT_ADD:
+	case CT_SUB:
+	case CT_NEG:
+	case CT_EQ:
+	case CT_GT:
+	case CT_LT:
+	case CT_AND:
+	case CT_OR:
+	case CT_NOT:
+		result = WriteArithmetic(writer, command);
+		break;
+	case CT_PUSH:
+		result = WritePush(writer, memorySegment, value);
+		break;
+	case CT_POP:
+		result = WritePop(writer, memorySegment, value);
+		break;
+	case CT_LABEL:
+		result = WriteLabel(writer, &name);
+		break;
+	case CT_GOTO:
+		result = WriteGoto(writer, &name);
+		break;
+	case CT_IFGOTO:
+		result = WriteIfGoto(writer, &name);
+		break;
+	case CT_FUNCTION:
+		// the labels that are generated from here on belong to this function
+		writer->labelNamespace = name.start;
+		writer->labelNamespaceLength = name.length;
+		writer->compareCounter = 0;
+		writer->returnCounter = 0;
+		if (writer->tailCalls != 0) {
+			writer->argumentCount = CountArguments(program, vmCommand);
+		}
+		writer->frame = NULL;
+		if (writer->frames != NULL) {
+			writer->frame = FindFrame(writer->frames, name.start, name.length);
+		}
+		result = WriteFunction(writer, &name, value);
+		break;
+	case CT_CALL:
+		result = WriteCall(writer, &name, value);
+		break;
+	case CT_RETURN:
+		result = WriteReturn(writer);
+		break;
+	default:
+		break;
+	}
+
+	// every command is followed by an empty line
+	if (result != 0) {
+		result = EmitTemplate(writer, &blank, NULL);
+	}
+
+	// unknown commands are already reported by the parser
+	if (	(result == 0)
+		&& (command != CT_UNKNOWN)
+	) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, vmCommand->lineNumber, vmCommand->column, NULL);
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteCommand
+***************************************************************************************************************
+*/
+
+static uint8_t EmitTemplate(T_codeWriter* writer, const T_template* template, const T_templateArgs* args) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends the instruction records of a template to the instruction list and fills their holes
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		template		Pointer to template
+	\param[in]		args			Pointer to values for the holes, may be NULL for a template without H_INDEX,
+										H_BASE, H_JUMP and name holes
+
+	\returns
+		0: out of memory, or an index does not fit in an A-instruction
+		1: template was written
+
+	\note
+		- a record without a hole is copied as it is, no text is formatted and decoded
+		- when a hole cannot be filled the records before it stay in the instruction list
+		- with text the template is printed by PrintTemplate instead
+
+***************************************************************************************************************
+*/
+	const T_fragment* fragment = template->fragments;
+	const T_fragment* end = template->fragments + template->count;
+	T_hackInstruction* instruction = NULL;
+	uint8_t result = 1;
+
+	if (writer->text != NULL) {
+		return PrintTemplate(writer, template, args);
+	}
+
+	instruction = BeginInstructions(writer->output, template->count);
+	if (instruction == NULL) {
+		return 0;
+	}
+
+	for (fragment = template->fragments; (fragment < end) && (result != 0); fragment++) {
+		*instruction = fragment->instruction;
+		switch (fragment->hole) {
+		case H_INDEX:
+			instruction->operand = (args->index <= MAX_A_VALUE) ? args->index : STRING_ID_INVALID;
+			break;
+		case H_SYMBOL:
+			instruction->operand = GetSymbolId(writer, (E_writerSymbol)instruction->operand);
+			break;
+		case H_BASE:
+			instruction->operand = GetSymbolId(writer, (E_writerSymbol)args->base);
+			break;
+		case H_JUMP:
+			instruction->jump = args->jump;
+			break;
+		case H_COMPOSED:
+			instruction->operand = InternName(writer, fragment->name, args);
+			break;
+		default:
+			break;
+		}
+
+		if (instruction->operand == STRING_ID_INVALID) {
+			result = 0;
+		} else {
+			writer->instructions += (instruction->kind >= HK_ADDRESS) ? 1 : 0;
+			instruction++;
+		}
+	}
+
+	EndInstructions(writer->output, instruction);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End EmitTemplate
+***************************************************************************************************************
+*/
+
+static uint8_t PrintTemplate(T_codeWriter* writer, const T_template* template, const T_templateArgs* args) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the instruction records of a template as assembly code and fills their holes
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		template		Pointer to template
+	\param[in]		args			Pointer to values for the holes, may be NULL for a template without H_INDEX,
+										H_BASE, H_JUMP and name holes
+
+	\returns
+		0: out of memory, or an index does not fit in an A-instruction
+		1: template was written
+
+	\note
+		- the fixed lines between the holes are printed once per code writer and copied from then on, only the
+		  records with a hole are printed per use
+		- the composed names are printed as they are composed, they are not interned
+		- when a hole cannot be filled the lines before it stay in the text, like the records of EmitTemplate
+
+***************************************************************************************************************
+*/
+	const T_printedTemplate* printed = GetPrintedTemplate(writer, template);
+	const char* text = NULL;
+	size_t maxLength = 0;
+	char* position = NULL;
+	char* next = NULL;
+	uint32_t start = 0;
+	uint8_t result = 1;
+
+	if (printed == NULL) {
+		return 0;
+	}
+
+	if (printed->holeCount == PRINTED_RECORDS) {
+		for (uint16_t i = 0; i < template->count; i++) {
+			maxLength += GetRecordLength(writer, &template->fragments[i], args);
+		}
+	} else {
+		maxLength = printed->runs[printed->holeCount];
+		for (uint8_t i = 0; i < printed->holeCount; i++) {
+			maxLength += GetRecordLength(writer, &template->fragments[printed->holes[i]], args);
+		}
+	}
+
+	position = BeginAppend(writer->text, maxLength);
+	if (position == NULL) {
+		return 0;
+	}
+
+	if (printed->holeCount == PRINTED_RECORDS) {
+		for (uint16_t i = 0; (i < template->count) && (result != 0); i++) {
+			next = PrintRecord(writer, &template->fragments[i], args, position);
+			result = (next != NULL) ? 1 : 0;
+			position = (next != NULL) ? next : position;
+		}
+	} else {
+		text = &writer->printedText.data[printed->text];
+		for (uint8_t i = 0; (i <= printed->holeCount) && (result != 0); i++) {
+			memcpy(position, &text[start], printed->runs[i] - start);
+			position += printed->runs[i] - start;
+			start = printed->runs[i];
+			if (i < printed->holeCount) {
+				next = PrintRecord(writer, &template->fragments[printed->holes[i]], args, position);
+				result = (next != NULL) ? 1 : 0;
+				position = (next != NULL) ? next : position;
+			}
+		}
+		if (result != 0) {
+			writer->instructions += printed->instructions;
+		}
+	}
+
+	EndAppend(writer->text, position);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End PrintTemplate
+***************************************************************************************************************
+*/
+
+static const T_printedTemplate* GetPrintedTemplate(T_codeWriter* writer, const T_template* template) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gets the fixed lines of a template, they are printed on first use
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		template		Pointer to template
+
+	\returns
+		Pointer to printed template, NULL: out of memory
+
+	\note
+		- every record without H_NONE or H_SYMBOL hole is a hole of the printed template, H_SYMBOL is printed
+		  with the text of the fixed symbol, output does not get the symbols
+		- a template with more than MAX_PRINTED_HOLES holes, or one that finds the table full, is printed
+		  record by record
+
+***************************************************************************************************************
+*/
+	T_printedTemplate* printed = NULL;
+	size_t slot = ((size_t)(uintptr_t)template / sizeof(T_template)) & (PRINTED_TEMPLATE_SLOTS - 1);
+	size_t maxLength = 0;
+	char* start = NULL;
+	char* position = NULL;
+
+	if (writer->printed == NULL) {
+		writer->printed = calloc(PRINTED_TEMPLATE_SLOTS, sizeof(T_printedTemplate));
+		if (writer->printed == NULL) {
+			return NULL;
+		}
+	}
+
+	for (size_t i = 0; i < PRINTED_TEMPLATE_SLOTS; i++) {
+		printed = &writer->printed[(slot + i) & (PRINTED_TEMPLATE_SLOTS - 1)];
+		if (printed->template == template) {
+			return printed;
+		}
+		if (printed->template == NULL) {
+			break;
+		}
+	}
+	if (printed->template != NULL) {
+		return &recordByRecord;
+	}
+
+	// at least one byte, so the buffer also exists for a template that only has holes
+	maxLength = 1;
+	for (uint16_t i = 0; i < template->count; i++) {
+		if (	(template->fragments[i].hole == H_NONE)
+			|| (template->fragments[i].hole == H_SYMBOL)
+		) {
+			maxLength += GetRecordLength(writer, &template->fragments[i], NULL);
+		}
+	}
+	start = BeginAppend(&writer->printedText, maxLength);
+	if (start == NULL) {
+		return NULL;
+	}
+
+	printed->template = template;
+	printed->text = (uint32_t)writer->printedText.length;
+	printed->instructions = 0;
+	printed->holeCount = 0;
+	position = start;
+	for (uint16_t i = 0; (i < template->count) && (printed->holeCount != PRINTED_RECORDS); i++) {
+		const T_fragment* fragment = &template->fragments[i];
+
+		if (fragment->hole == H_SYMBOL) {
+			position = PrintNamedInstruction(fragment->instruction.kind, writerSymbols[fragment->instruction.operand].start, writerSymbols[fragment->instruction.operand].length, position);
+		} else if (fragment->hole == H_NONE) {
+			position = PrintInstruction(writer->output, &fragment->instruction, position);
+		} else if (printed->holeCount < MAX_PRINTED_HOLES) {
+			printed->holes[printed->holeCount] = (uint8_t)i;
+			printed->runs[printed->holeCount] = (uint32_t)(position - start);
+			printed->holeCount++;
+			continue;
+		} else {
+			printed->holeCount = PRINTED_RECORDS;
+			position = start;
+			continue;
+		}
+		printed->instructions += (fragment->instruction.kind >= HK_ADDRESS) ? 1 : 0;
+	}
+	if (printed->holeCount != PRINTED_RECORDS) {
+		printed->runs[printed->holeCount] = (uint32_t)(position - start);
+	}
+
+	EndAppend(&writer->printedText, position);
+	return printed;
+}
+/*
+***************************************************************************************************************
+	End GetPrintedTemplate
+***************************************************************************************************************
+*/
+
+static size_t GetRecordLength(const T_codeWriter* writer, const T_fragment* fragment, const T_templateArgs* args) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gets the maximum length of the line of an instruction record
+
+	\param[in]		writer		Pointer to code writer
+	\param[in]		fragment		Pointer to instruction record
+	\param[in]		args			Pointer to values for the holes, may be NULL for a record without H_BASE and
+										H_COMPOSED hole
+
+	\returns
+		Maximum length of the line
+
+***************************************************************************************************************
+*/
+	switch (fragment->hole) {
+	case H_SYMBOL:
+		return writerSymbols[fragment->instruction.operand].length + NAME_LINE_EXTRA;
+	case H_BASE:
+		return writerSymbols[args->base].length + NAME_LINE_EXTRA;
+	case H_COMPOSED:
+		return GetNameLength(writer, fragment->name, args) + NAME_LINE_EXTRA;
+	default:
+		return MAX_INSTRUCTION_LINE_LENGTH;
+	}
+}
+/*
+***************************************************************************************************************
+	End GetRecordLength
+***************************************************************************************************************
+*/
+
+static char* PrintRecord(T_codeWriter* writer, const T_fragment* fragment, const T_templateArgs* args, char* position) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints an instruction record of a template as a line of assembly code and fills its hole
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		fragment		Pointer to instruction record
+	\param[in]		args			Pointer to values for the holes, may be NULL for a record without H_INDEX,
+										H_BASE, H_JUMP and H_COMPOSED hole
+	\param[out]		position		Pointer to room for the line, see GetRecordLength
+
+	\returns
+		Pointer just after the line, NULL: out of memory, or the index does not fit in an A-instruction
+
+***************************************************************************************************************
+*/
+	T_hackInstruction instruction = fragment->instruction;
+	const T_stringView* symbol = NULL;
+	char* name = NULL;
+
+	switch (fragment->hole) {
+	case H_INDEX:
+		if (args->index > MAX_A_VALUE) {
+			return NULL;
+		}
+		instruction.operand = args->index;
+		break;
+	case H_SYMBOL:
+		symbol = &writerSymbols[instruction.operand];
+		break;
+	case H_BASE:
+		symbol = &writerSymbols[args->base];
+		break;
+	case H_JUMP:
+		instruction.jump = args->jump;
+		break;
+	case H_COMPOSED:
+		name = GetNameBuffer(writer->output, GetNameLength(writer, fragment->name, args));
+		if (name == NULL) {
+			return NULL;
+		}
+		writer->instructions += (instruction.kind >= HK_ADDRESS) ? 1 : 0;
+		return PrintNamedInstruction(instruction.kind, name, (uint32_t)(ComposeName(writer, fragment->name, args, name) - name), position);
+	default:
+		break;
+	}
+
+	writer->instructions += (instruction.kind >= HK_ADDRESS) ? 1 : 0;
+	if (symbol != NULL) {
+		return PrintNamedInstruction(instruction.kind, symbol->start, symbol->length, position);
+	}
+	return PrintInstruction(writer->output, &instruction, position);
+}
+/*
+***************************************************************************************************************
+	End PrintRecord
+***************************************************************************************************************
+*/
+
+static uint32_t GetSymbolId(T_codeWriter* writer, E_writerSymbol symbol) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gets the string ID of a fixed symbol, label or comment of the templates
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		symbol		Symbol
+
+	\returns
+		String ID, STRING_ID_INVALID: out of memory
+
+	\note
+		- the text is interned on first use, so the string table gets the same order as for an .asm file
+
+***************************************************************************************************************
+*/
+	if (writer->symbols[symbol] == STRING_ID_INVALID) {
+		writer->symbols[symbol] = InternString(&writer->output->symbols, writerSymbols[symbol].start, writerSymbols[symbol].length);
+	}
+	return writer->symbols[symbol];
+}
+/*
+***************************************************************************************************************
+	End GetSymbolId
+***************************************************************************************************************
+*/
+
+static uint32_t InternName(T_codeWriter* writer, const T_name* name, const T_templateArgs* args) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function composes a name from its parts and interns it in the string table of the instruction list
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		name			Pointer to name
+	\param[in]		args			Pointer to values for the H_NAME, H_TEXT, H_INDEX and H_COUNTER holes
+
+	\returns
+		String ID, STRING_ID_INVALID: out of memory
+
+***************************************************************************************************************
+*/
+	char* buffer = GetNameBuffer(writer->output, GetNameLength(writer, name, args));
+	char* text = NULL;
+
+	if (buffer == NULL) {
+		return STRING_ID_INVALID;
+	}
+	text = ComposeName(writer, name, args, buffer);
+	return InternString(&writer->output->symbols, buffer, (uint32_t)(text - buffer));
+}
+/*
+***************************************************************************************************************
+	End InternName
+***************************************************************************************************************
+*/
+
+static size_t GetNameLength(const T_codeWriter* writer, const T_name* name, const T_templateArgs* args) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function determines the maximum length of a name that is composed from its parts
+
+	\param[in]		writer		Pointer to code writer
+	\param[in]		name			Pointer to name
+	\param[in]		args			Pointer to values for the H_NAME, H_TEXT, H_INDEX and H_COUNTER holes
+
+	\returns
+		Maximum number of characters ComposeName writes
+
+***************************************************************************************************************
+*/
+	const T_namePart* part = name->parts;
+	const T_namePart* end = name->parts + name->count;
+	size_t maxLength = 0;
+
+	for (part = name->parts; part < end; part++) {
+		maxLength += part->length;
+		switch (part->hole) {
+		case H_FILE:
+			maxLength += writer->fileNameLength;
+			break;
+		case H_NAMESPACE:
+			maxLength += writer->labelNamespaceLength;
+			break;
+		case H_NAME:
+			maxLength += args->name.length;
+			break;
+		case H_TEXT:
+			maxLength += args->text.length;
+			break;
+		case H_INDEX:
+		case H_COUNTER:
+			maxLength += MAX_DECIMAL_LENGTH;
+			break;
+		default:
+			break;
+		}
+	}
+	return maxLength;
+}
+/*
+***************************************************************************************************************
+	End GetNameLength
+***************************************************************************************************************
+*/
+
+static char* ComposeName(const T_codeWriter* writer, const T_name* name, const T_templateArgs* args, char* text) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function composes a name from its parts
+
+	\param[in]		writer		Pointer to code writer
+	\param[in]		name			Pointer to name
+	\param[in]		args			Pointer to values for the H_NAME, H_TEXT, H_INDEX and H_COUNTER holes
+	\param[out]		text			Pointer to room for GetNameLength characters
+
+	\returns
+		Pointer just after the name
+
+***************************************************************************************************************
+*/
+	const T_namePart* part = name->parts;
+	const T_namePart* end = name->parts + name->count;
+
+	for (part = name->parts; part < end; part++) {
+		memcpy(text, part->text, part->length);
+		text += part->length;
+
+		switch (part->hole) {
+		case H_FILE:
+			memcpy(text, writer->fileName, writer->fileNameLength);
+			text += writer->fileNameLength;
+			break;
+		case H_NAMESPACE:
+			memcpy(text, writer->labelNamespace, writer->labelNamespaceLength);
+			text += writer->labelNamespaceLength;
+			break;
+		case H_NAME:
+			memcpy(text, args->name.start, args->name.length);
+			text += args->name.length;
+			break;
+		case H_TEXT:
+			memcpy(text, args->text.start, args->text.length);
+			text += args->text.length;
+			break;
+		case H_INDEX:
+			text += FormatDecimal(args->index, text);
+			break;
+		case H_COUNTER:
+			text += FormatDecimal(args->counter, text);
+			break;
+		default:
+			break;
+		}
+	}
+	return text;
+}
+/*
+***************************************************************************************************************
+	End ComposeName
+***************************************************************************************************************
+*/
+
+static uint8_t WriteComment(T_codeWriter* writer, E_commandType command, E_memorySegment memorySegment, uint16_t value, const T_stringView* name) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the VM command as a comment to the output buffer
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		command			VM command
+	\param[in]		memorySegment	Memory segment of the VM command (push, pop)
+	\param[in]		value				Value of the VM command (push, pop, function, call)
+	\param[in]		name				Pointer to name of the VM command (label, goto, if-goto, function, call)
+
+	\returns
+		0: writing the comment failed
+		1: writing the comment was successful
+
+	\note
+		- commands that could not be parsed have the original VM source line as name
+
+***************************************************************************************************************
+*/
+	const T_template* template = commentTemplates[CT_UNKNOWN];
+	T_templateArgs args;
+
+	args.name = *name;
+	args.text.start = NULL;
+	args.text.length = 0;
+	args.index = value;
+	args.counter = 0;
+
+	if ((command == CT_PUSH) || (command == CT_POP)) {
+		if (memorySegment != MS_UNKNOWN) {
+			template = commentTemplates[command];
+			args.text.start = GetMemorySegmentString(memorySegment);
+			args.text.length = (uint32_t)strlen(args.text.start);
+		}
+	} else if (command <= CT_UNKNOWN) {
+		template = commentTemplates[command];
+	}
+	return EmitTemplate(writer, template, &args);
+}
+/*
+***************************************************************************************************************
+	End WriteComment
+***************************************************************************************************************
+*/
+
+static uint8_t WriteArithmetic(T_codeWriter* writer, E_commandType command) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generated assembly code for the Arithmetic VM commands and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		command		VM command to assemble
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- the labels of eq, gt and lt are numbered per function and prefixed with the function name
+		- with a cached top of stack the result is left in D
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	if (command > CT_NOT) {
+		return 0;
+	}
+
+	args.counter = writer->compareCounter;
+	args.index = 0;
+
+	if ((command == CT_EQ) || (command == CT_GT) || (command == CT_LT)) {
+		writer->compareCounter++;
+	}
+
+	if (writer->cacheTop != 0) {
+		if (FillTop(writer) == 0) {
+			return 0;
+		}
+		return EmitTemplate(writer, cachedArithmeticTemplates[command], &args);
+	}
+	return EmitTemplate(writer, arithmeticTemplates[command], &args);
+}
+/*
+***************************************************************************************************************
+	End WriteArithmetic
+***************************************************************************************************************
+*/
+
+static uint8_t WritePush(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the PUSH VM commands and writes it to a output buffer
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory Segment that is used to PUSH a value to
+	\param[in]		index				Push the value of segment[index] onto the stack
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- fileName of the code writer is used to generate file specific labels for the assembly code output
+		- if MS_CONSTANT is the memory segment the index parameter is used as the value to PUSH onto the stack
+		- with a cached top of stack the value is loaded into D, the previous top is written to RAM first
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	if (	(memorySegment >= MS_UNKNOWN)
+		|| ((memorySegment == MS_CONSTANT) && (index > MAX_A_VALUE))
+	) {
+		// nothing is generated for an unknown memory segment or a constant out of range, the parser reports them
+		return 1;
+	}
+
+	if (writer->specializeIndex != 0) {
+		return WriteSpecializedPush(writer, memorySegment, index);
+	}
+
+	args.index = index;
+
+	if (writer->cacheTop != 0) {
+		if (SpillTop(writer) == 0) {
+			return 0;
+		}
+		writer->topInD = 1;
+		return EmitTemplate(writer, loadTemplates[memorySegment], &args);
+	}
+	return EmitTemplate(writer, pushTemplates[memorySegment], &args);
+}
+/*
+***************************************************************************************************************
+	End WritePush
+***************************************************************************************************************
+*/
+
+static uint8_t WritePop(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the POP VM commands and writes it to a output buffer
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory Segment that is used to POP a value from
+	\param[in]		index				POP the top stack value and store int in segment[index]
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- fileName of the code writer is used to generate file specific labels for the assembly code output
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	if (	(memorySegment >= MS_UNKNOWN)
+		|| (popTemplates[memorySegment] == NULL)
+	) {
+		// an unknown memory segment is reported by the parser, pop constant by WriteCommand
+		return 1;
+	}
+
+	if (writer->specializeIndex != 0) {
+		return WriteSpecializedPop(writer, memorySegment, index);
+	}
+
+	args.index = index;
+
+	if (writer->cacheTop != 0) {
+		if (FillTop(writer) == 0) {
+			return 0;
+		}
+		writer->topInD = 0;
+		return EmitTemplate(writer, storeTemplates[memorySegment], &args);
+	}
+	return EmitTemplate(writer, popTemplates[memorySegment], &args);
+}
+/*
+***************************************************************************************************************
+	End WritePop
+***************************************************************************************************************
+*/
+
+static uint8_t WriteLabel(T_codeWriter* writer, const T_stringView* labelName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the Label VM command and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		labelName	Pointer to labelname
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- fileName of the code writer is used to generate file specific labels for the assembly code output
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	args.name = *labelName;
+	return EmitTemplate(writer, &label, &args);
+}
+/*
+***************************************************************************************************************
+	End WriteLabel
+***************************************************************************************************************
+*/
+
+static uint8_t WriteGoto(T_codeWriter* writer, const T_stringView* labelName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the Goto VM command and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		labelName	Pointer to labelname
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- fileName of the code writer is used to generate file specific labels for the assembly code output
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	args.name = *labelName;
+	return EmitTemplate(writer, &gotoLabel, &args);
+}
+/*
+***************************************************************************************************************
+	End WriteGoto
+***************************************************************************************************************
+*/
+
+static uint8_t WriteIfGoto(T_codeWriter* writer, const T_stringView* labelName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the IfGoto VM command and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		labelName	Pointer to labelname
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- fileName of the code writer is used to generate file specific labels for the assembly code output
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	args.name = *labelName;
+
+	if (writer->cacheTop != 0) {
+		if (FillTop(writer) == 0) {
+			return 0;
+		}
+		writer->topInD = 0;
+		return EmitTemplate(writer, &cachedIfGoto, &args);
+	}
+	return EmitTemplate(writer, &ifGoto, &args);
+}
+/*
+***************************************************************************************************************
+	End WriteIfGoto
+***************************************************************************************************************
+*/
+
+static uint8_t WriteFunction(T_codeWriter* writer, const T_stringView* labelName, uint16_t numLocals) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the Function VM command and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		labelName	Pointer to labelname
+	\param[in]		numLocals	The number of local variables the function uses
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+	uint8_t result = 0;
+
+	args.name = *labelName;
+	if (IsStaticFrame(writer->frame) != 0) {
+		// the VM program zeroes the locals in the frame
+		args.index = writer->frame->base;
+		return EmitTemplate(writer, &staticFunction, &args);
+	}
+
+	result = EmitTemplate(writer, &function, &args);
+	for (uint16_t i = 0; (i < numLocals) && (result != 0); i++) {
+		result = EmitTemplate(writer, &functionLocal, NULL);
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteFunction
+***************************************************************************************************************
+*/
+
+static uint8_t WriteCall(T_codeWriter* writer, const T_stringView* labelName, uint16_t numParams) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generates assembly code for the Call VM command and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		labelName	Pointer to labelname
+	\param[in]		numParams	The number of paramters the function uses
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- the return labels are numbered per function and prefixed with the function name
+		- a function with a static frame gets the return address in D, its arguments are already in its frame
+		- the inline call only saves the THIS and THAT that the frame of the callee restores
+
+***************************************************************************************************************
+*/
+	const T_frameInfo* frame = (writer->frames != NULL) ? FindFrame(writer->frames, labelName->start, labelName->length) : NULL;
+	T_templateArgs args;
+
+	args.name = *labelName;
+	args.index = numParams;
+	args.counter = writer->returnCounter;
+
+	writer->returnCounter++;
+
+	if (IsStaticFrame(frame) != 0) {
+		writer->stats.staticCalls++;
+		return EmitTemplate(writer, &staticCall, &args);
+	}
+
+	writer->stats.calls++;
+
+	if (writer->sharedCalls != 0) {
+		return EmitTemplate(writer, &sharedCall, &args);
+	}
+	return EmitTemplate(writer, callTemplates[SavedPointers(frame)], &args);
+}
+/*
+***************************************************************************************************************
+	End WriteCall
+***************************************************************************************************************
+*/
+
+static uint8_t WriteReturn(T_codeWriter* writer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function generated assembly code for the Return VM command and writes it to a output buffer
+
+	\param[in,out]	writer		Pointer to code writer
+
+	\returns
+		0: writing assembly instruction failed
+		1: writing assembly instructions was successful
+
+	\note
+		- the inline return only restores the THIS and THAT that the frame of the current function saves
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	if (IsStaticFrame(writer->frame) != 0) {
+		args.index = writer->frame->base;
+		writer->stats.staticReturns++;
+		return EmitTemplate(writer, &staticReturn, &args);
+	}
+
+	writer->stats.returns++;
+
+	if (writer->sharedCalls != 0) {
+		return EmitTemplate(writer, &sharedReturn, NULL);
+	}
+	return EmitTemplate(writer, returnTemplates[SavedPointers(writer->frame)], NULL);
+}
+/*
+***************************************************************************************************************
+	End WriteReturn
+***************************************************************************************************************
+*/
+
+static uint8_t SpillTop(T_codeWriter* writer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes a top of stack that is cached in D to RAM
+
+	\param[in,out]	writer		Pointer to code writer
+
+	\returns
+		0: writing assembly instructions failed
+		1: top of stack is in RAM
+
+***************************************************************************************************************
+*/
+	if (writer->topInD == 0) {
+		return 1;
+	}
+	writer->topInD = 0;
+	return EmitTemplate(writer, &pushD, NULL);
+}
+/*
+***************************************************************************************************************
+	End SpillTop
+***************************************************************************************************************
+*/
+
+static uint8_t FillTop(T_codeWriter* writer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function moves the top of stack from RAM to D when it is not cached in D already
+
+	\param[in,out]	writer		Pointer to code writer
+
+	\returns
+		0: writing assembly instructions failed
+		1: top of stack is in D
+
+***************************************************************************************************************
+*/
+	if (writer->topInD != 0) {
+		return 1;
+	}
+	writer->topInD = 1;
+	return EmitTemplate(writer, &fillD, NULL);
+}
+/*
+***************************************************************************************************************
+	End FillTop
+***************************************************************************************************************
+*/
+
+static uint32_t CountInstructions(const T_template* template) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function counts the Hack instructions of a template, comments, labels and blank lines are skipped
+
+	\param[in]		template		Pointer to template
+
+	\returns
+		Number of instructions
+
+***************************************************************************************************************
+*/
+	uint32_t count = 0;
+
+	for (uint16_t i = 0; i < template->count; i++) {
+		if (template->fragments[i].instruction.kind >= HK_ADDRESS) {
+			count++;
+		}
+	}
+	return count;
+}
+/*
+***************************************************************************************************************
+	End CountInstructions
+***************************************************************************************************************
+*/
+
+static uint8_t IsStaticFrame(const T_frameInfo* frame) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks whether a frame is at a fixed address
+
+	\param[in]		frame			Pointer to frame, NULL: dynamic frame
+
+	\returns
+		0: the frame is on the stack
+		1: the frame is at a fixed address
+
+***************************************************************************************************************
+*/
+	return ((frame != NULL) && (frame->isStatic != 0)) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End IsStaticFrame
+***************************************************************************************************************
+*/
+
+static uint8_t SavedPointers(const T_frameInfo* frame) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the pointers a frame on the stack saves, the index of callTemplates and returnTemplates
+
+	\param[in]		frame			Pointer to frame, NULL: dynamic frame that saves everything
+
+	\returns
+		Bit 0: the frame saves THIS, bit 1: the frame saves THAT
+
+***************************************************************************************************************
+*/
+	if (frame == NULL) {
+		return 3;
+	}
+	return (uint8_t)(frame->savePointer[0] | (frame->savePointer[1] << 1));
+}
+/*
+***************************************************************************************************************
+	End SavedPointers
+***************************************************************************************************************
+*/
+
+static uint8_t WriteSpecializedPush(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the shortest push sequence for the segment and index
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory segment (not MS_UNKNOWN)
+	\param[in]		index				Index in the segment, the value for MS_CONSTANT
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+***************************************************************************************************************
+*/
+	E_indexClass indexClass = GetIndexClass(memorySegment, index, CHAIN_LOAD_LIMIT);
+	const T_template* baseline = (writer->cacheTop != 0) ? loadTemplates[memorySegment] : pushTemplates[memorySegment];
+	uint32_t start = 0;
+
+	if (SpillTop(writer) == 0) {
+		return 0;
+	}
+	start = writer->instructions;
+
+	if (WriteLoad(writer, memorySegment, index) == 0) {
+		return 0;
+	}
+	if (writer->cacheTop != 0) {
+		writer->topInD = 1;
+	} else if (EmitTemplate(writer, &pushD, NULL) == 0) {
+		return 0;
+	}
+
+	CountSaved(writer, indexClass, baseline, start);
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End WriteSpecializedPush
+***************************************************************************************************************
+*/
+
+static uint8_t WriteLoad(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes code that loads segment[index] into D
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory segment (not MS_UNKNOWN)
+	\param[in]		index				Index in the segment, the value for MS_CONSTANT
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+	\note
+		- without specializeIndex the load templates are used
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	args.index = index;
+
+	if (writer->specializeIndex == 0) {
+		return EmitTemplate(writer, loadTemplates[memorySegment], &args);
+	}
+
+	if (memorySegment <= MS_THAT) {
+		args.base = baseSymbols[memorySegment];
+	}
+
+	switch (GetIndexClass(memorySegment, index, CHAIN_LOAD_LIMIT)) {
+	case IC_BASE_ZERO:
+		return EmitTemplate(writer, &loadBaseZero, &args);
+	case IC_BASE_SMALL:
+		return WriteChain(writer, (E_writerSymbol)baseSymbols[memorySegment], index, &chainLoad);
+	case IC_BASE_OTHER:
+		return EmitTemplate(writer, &loadBase, &args);
+	case IC_FIXED:
+		args.index = FixedAddress(memorySegment, index);
+		return EmitTemplate(writer, &loadFixed, &args);
+	case IC_CONSTANT:
+		return LoadConstant(writer, index);
+	default:
+		return EmitTemplate(writer, &loadStatic, &args);
+	}
+}
+/*
+***************************************************************************************************************
+	End WriteLoad
+***************************************************************************************************************
+*/
+
+static uint8_t WriteSpecializedPop(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the shortest pop sequence for the segment and index
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory segment (not MS_CONSTANT or MS_UNKNOWN)
+	\param[in]		index				Index in the segment
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+	\note
+		- with a cached top of stack the value is already in D, otherwise it is still on the stack
+
+***************************************************************************************************************
+*/
+	E_indexClass indexClass = IC_COUNT;
+	const T_template* baseline = NULL;
+	uint32_t start = 0;
+
+	if (writer->cacheTop != 0) {
+		if (FillTop(writer) == 0) {
+			return 0;
+		}
+		writer->topInD = 0;
+		indexClass = GetIndexClass(memorySegment, index, CHAIN_STORE_LIMIT);
+		baseline = storeTemplates[memorySegment];
+		start = writer->instructions;
+	} else {
+		indexClass = GetIndexClass(memorySegment, index, CHAIN_POP_LIMIT);
+		baseline = popTemplates[memorySegment];
+		start = writer->instructions;
+	}
+
+	if (WriteStore(writer, memorySegment, index, (writer->cacheTop == 0) ? 1 : 0) == 0) {
+		return 0;
+	}
+
+	CountSaved(writer, indexClass, baseline, start);
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End WriteSpecializedPop
+***************************************************************************************************************
+*/
+
+static uint8_t WriteStore(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index, uint8_t fromStack) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes code that stores a value in segment[index]
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory segment (not MS_CONSTANT or MS_UNKNOWN)
+	\param[in]		index				Index in the segment
+	\param[in]		fromStack		1: the value is popped from the stack, 0: the value is in D
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+	\note
+		- without specializeIndex the value must be in D and the store templates are used
+
+***************************************************************************************************************
+*/
+	uint16_t chainLimit = (fromStack != 0) ? CHAIN_POP_LIMIT : CHAIN_STORE_LIMIT;
+	E_indexClass indexClass = GetIndexClass(memorySegment, index, chainLimit);
+	T_templateArgs args;
+
+	args.index = index;
+
+	if (writer->specializeIndex == 0) {
+		return EmitTemplate(writer, storeTemplates[memorySegment], &args);
+	}
+
+	if (memorySegment <= MS_THAT) {
+		args.base = baseSymbols[memorySegment];
+	}
+
+	// a base segment with a large index forms the address before the value is taken from the stack
+	if (indexClass == IC_BASE_OTHER) {
+		return EmitTemplate(writer, (fromStack != 0) ? &popBase : &storeBase, &args);
+	}
+
+	if (	(fromStack != 0)
+		&& (EmitTemplate(writer, &takeD, NULL) == 0)
+	) {
+		return 0;
+	}
+
+	switch (indexClass) {
+	case IC_BASE_ZERO:
+		return EmitTemplate(writer, &storeBaseZero, &args);
+	case IC_BASE_SMALL:
+		return WriteChain(writer, (E_writerSymbol)baseSymbols[memorySegment], index, &chainStore);
+	case IC_FIXED:
+		args.index = FixedAddress(memorySegment, index);
+		return EmitTemplate(writer, &storeFixed, &args);
+	default:
+		return EmitTemplate(writer, &storeStatic, &args);
+	}
+}
+/*
+***************************************************************************************************************
+	End WriteStore
+***************************************************************************************************************
+*/
+
+static uint8_t WriteChain(T_codeWriter* writer, E_writerSymbol base, uint16_t index, const T_template* access) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes "@base, A=M+1, A=A+1, ..." to address base[index] followed by the access instruction
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		base			Base symbol
+	\param[in]		index			Index (at least 1)
+	\param[in]		access		Pointer to template with the instruction that reads or writes M
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	args.base = (uint8_t)base;
+	if (EmitTemplate(writer, &chainStart, &args) == 0) {
+		return 0;
+	}
+	for (uint16_t i = 1; i < index; i++) {
+		if (EmitTemplate(writer, &chainNext, NULL) == 0) {
+			return 0;
+		}
+	}
+	return EmitTemplate(writer, access, NULL);
+}
+/*
+***************************************************************************************************************
+	End WriteChain
+***************************************************************************************************************
+*/
+
+static E_indexClass GetIndexClass(E_memorySegment memorySegment, uint16_t index, uint16_t chainLimit) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function determines the class of the push or pop sequence of a segment and index
+
+	\param[in]		memorySegment	Memory segment (not MS_UNKNOWN)
+	\param[in]		index				Index in the segment
+	\param[in]		chainLimit		Largest index that is addressed with an "A=A+1" chain
+
+	\returns
+		Class of the sequence
+
+***************************************************************************************************************
+*/
+	switch (memorySegment) {
+	case MS_LOCAL:
+	case MS_ARGUMENT:
+	case MS_THIS:
+	case MS_THAT:
+		if (index == 0) {
+			return IC_BASE_ZERO;
+		}
+		return (index <= chainLimit) ? IC_BASE_SMALL : IC_BASE_OTHER;
+	case MS_POINTER:
+	case MS_TEMP:
+	case MS_FRAME:
+		return IC_FIXED;
+	case MS_CONSTANT:
+		return IC_CONSTANT;
+	default:
+		return IC_STATIC;
+	}
+}
+/*
+***************************************************************************************************************
+	End GetIndexClass
+***************************************************************************************************************
+*/
+
+static uint16_t FixedAddress(E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the RAM address of a pointer, temp or frame access
+
+	\param[in]		memorySegment	Memory segment (MS_POINTER, MS_TEMP or MS_FRAME)
+	\param[in]		index				Index in the segment
+
+	\returns
+		RAM address
+
+***************************************************************************************************************
+*/
+	switch (memorySegment) {
+	case MS_POINTER:
+		return (uint16_t)(POINTER_ADDRESS + index);
+	case MS_TEMP:
+		return (uint16_t)(TEMP_ADDRESS + index);
+	default:
+		return index;
+	}
+}
+/*
+***************************************************************************************************************
+	End FixedAddress
+***************************************************************************************************************
+*/
+
+static void CountSaved(T_codeWriter* writer, E_indexClass indexClass, const T_template* baseline, uint32_t start) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function adds the instructions a specialized push or pop saved compared to the general template
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		indexClass	Class of the specialized sequence
+	\param[in]		baseline		Pointer to template that would have been written without specializeIndex
+	\param[in]		start			Number of instructions the writer had written before the specialized sequence
+
+***************************************************************************************************************
+*/
+	uint32_t written = writer->instructions - start;
+
+	writer->stats.indexCommands[indexClass]++;
+	writer->stats.indexSaved[indexClass] += (int32_t)CountInstructions(baseline) - (int32_t)written;
+}
+/*
+***************************************************************************************************************
+	End CountSaved
+***************************************************************************************************************
+*/
+
+static uint32_t FoldConstants(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function evaluates a run of constant pushes and arithmetic commands and writes the remaining constants
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the commands belong to (unused)
+	\param[in]		command		Pointer to first command of the run
+	\param[in]		last			Pointer after the last command that may be folded
+	\param[out]		result		Set to 0 when writing assembly instructions failed
+
+	\returns
+		Number of commands that were written, 0: nothing to fold, the command must be written normally
+
+	\note
+		- the run stops at the first command that does not only use constants, every command of the run is
+		  still written as a comment
+		- a run without arithmetic is only written here when its last constant is popped
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* next = command;
+	uint16_t values[FOLD_WINDOW];
+	uint32_t depth = 0;
+	uint32_t folds = 0;
+	uint8_t popped = 0;
+
+	(void)program;
+
+	if (	(writer->foldConstants == 0)
+		|| (command->commandType != CT_PUSH)
+		|| (command->memorySegment != MS_CONSTANT)
+	) {
+		return 0;
+	}
+
+	while (next < last) {
+		E_commandType type = (E_commandType)next->commandType;
+
+		if (	(type == CT_PUSH)
+			&& (next->memorySegment == MS_CONSTANT)
+			&& (depth < FOLD_WINDOW)
+		) {
+			values[depth] = next->value;
+			depth++;
+		} else if (	((type == CT_NEG) || (type == CT_NOT))
+					&& (depth >= 1)
+		) {
+			values[depth - 1] = EvaluateConstant(type, 0, values[depth - 1]);
+			folds++;
+		} else if (	(type <= CT_NOT)
+					&& (depth >= 2)
+		) {
+			values[depth - 2] = EvaluateConstant(type, values[depth - 2], values[depth - 1]);
+			depth--;
+			folds++;
+		} else {
+			break;
+		}
+		next++;
+	}
+
+	// a constant that is popped right away does not need the stack
+	if (	(next < last)
+		&& (depth >= 1)
+		&& (next->commandType == CT_POP)
+		&& (next->memorySegment < MS_UNKNOWN)
+		&& (storeTemplates[next->memorySegment] != NULL)
+	) {
+		popped = 1;
+		next++;
+	}
+
+	if (	(folds == 0)
+		&& (popped == 0)
+	) {
+		return 0;
+	}
+
+	for (const T_vmCommand* folded = command; folded < next; folded++) {
+		T_stringView name = { "", 0 };
+
+		if (WriteComment(writer, (E_commandType)folded->commandType, (E_memorySegment)folded->memorySegment, folded->value, &name) == 0) {
+			*result = 0;
+		}
+	}
+
+	// the remaining constants are pushed, with a cached top of stack the last one stays in D
+	for (uint32_t i = 0; i < depth; i++) {
+		if (	(SpillTop(writer) == 0)
+			|| (LoadConstant(writer, values[i]) == 0)
+		) {
+			*result = 0;
+		} else if (	(writer->cacheTop != 0)
+					|| ((popped != 0) && (i == (depth - 1)))
+		) {
+			writer->topInD = 1;
+		} else if (EmitTemplate(writer, &pushD, NULL) == 0) {
+			*result = 0;
+		}
+	}
+
+	if (popped != 0) {
+		const T_vmCommand* pop = next - 1;
+
+		writer->topInD = 0;
+		if (WriteStore(writer, (E_memorySegment)pop->memorySegment, pop->value, 0) == 0) {
+			*result = 0;
+		}
+		writer->stats.foldedPops++;
+	}
+
+	writer->stats.folds += folds;
+
+	if (EmitTemplate(writer, &blank, NULL) == 0) {
+		*result = 0;
+	}
+	if (*result == 0) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, command->lineNumber, command->column, NULL);
+	}
+
+	return (uint32_t)(next - command);
+}
+/*
+***************************************************************************************************************
+	End FoldConstants
+***************************************************************************************************************
+*/
+
+static uint32_t FuseCompare(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes eq, gt or lt (optionally followed by not) and the if-goto that follows as one jump
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the commands belong to
+	\param[in]		command		Pointer to the compare command
+	\param[in]		last			Pointer after the last command that may be fused
+	\param[out]		result		Set to 0 when writing assembly instructions failed
+
+	\returns
+		Number of commands that were written, 0: no compare and if-goto, the command must be written normally
+
+	\note
+		- the jump tests x - y like the compare itself, so the result is the same when the difference overflows
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* next = command + 1;
+	const T_template* template = &fusedCompare;
+	uint8_t negated = 0;
+	T_templateArgs args;
+
+	if (	(writer->fuseCompare == 0)
+		|| (	(command->commandType != CT_EQ)
+			&& (command->commandType != CT_GT)
+			&& (command->commandType != CT_LT))
+	) {
+		return 0;
+	}
+
+	if (	(next < last)
+		&& (next->commandType == CT_NOT)
+	) {
+		negated = 1;
+		next++;
+	}
+	if (	(next >= last)
+		|| (next->commandType != CT_IFGOTO)
+	) {
+		return 0;
+	}
+	next++;
+
+	args.name.start = GetString(&program->names, next[-1].nameId);
+	args.name.length = GetStringLength(&program->names, next[-1].nameId);
+
+	for (const T_vmCommand* fused = command; fused < next; fused++) {
+		if (WriteComment(writer, (E_commandType)fused->commandType, MS_UNKNOWN, 0, &args.name) == 0) {
+			*result = 0;
+		}
+	}
+
+	if (writer->cacheTop != 0) {
+		if (FillTop(writer) == 0) {
+			*result = 0;
+		}
+		template = &cachedFusedCompare;
+	}
+	writer->topInD = 0;
+
+	args.jump = compareJumps[command->commandType - CT_EQ][negated];
+	if (	(EmitTemplate(writer, template, &args) == 0)
+		|| (EmitTemplate(writer, &blank, NULL) == 0)
+	) {
+		*result = 0;
+	}
+	if (*result == 0) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, command->lineNumber, command->column, NULL);
+	}
+
+	writer->stats.fusedCompares++;
+	return (uint32_t)(next - command);
+}
+/*
+***************************************************************************************************************
+	End FuseCompare
+***************************************************************************************************************
+*/
+
+static uint32_t FuseMove(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes a push that is directly followed by a pop as a move from one segment to the other
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the commands belong to (unused)
+	\param[in]		command		Pointer to the push command
+	\param[in]		last			Pointer after the last command that may be fused
+	\param[out]		result		Set to 0 when writing assembly instructions failed
+
+	\returns
+		Number of commands that were written, 0: no push and pop, the command must be written normally
+
+	\note
+		- the value is loaded into D and stored at the destination, SP is not touched
+		- the source is read before the destination is written, so "push that 0, pop pointer 1" is a move too
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* pop = command + 1;
+	T_stringView name = { "", 0 };
+
+	(void)program;
+
+	if (	(writer->fuseMove == 0)
+		|| (pop >= last)
+		|| (command->commandType != CT_PUSH)
+		|| (command->memorySegment >= MS_UNKNOWN)
+		|| (pop->commandType != CT_POP)
+		|| (pop->memorySegment >= MS_UNKNOWN)
+		|| (storeTemplates[pop->memorySegment] == NULL)
+	) {
+		return 0;
+	}
+
+	if (	(WriteComment(writer, CT_PUSH, (E_memorySegment)command->memorySegment, command->value, &name) == 0)
+		|| (WriteComment(writer, CT_POP, (E_memorySegment)pop->memorySegment, pop->value, &name) == 0)
+		|| (SpillTop(writer) == 0)
+		|| (WriteLoad(writer, (E_memorySegment)command->memorySegment, command->value) == 0)
+		|| (WriteStore(writer, (E_memorySegment)pop->memorySegment, pop->value, 0) == 0)
+		|| (EmitTemplate(writer, &blank, NULL) == 0)
+	) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, command->lineNumber, command->column, NULL);
+		*result = 0;
+	}
+
+	writer->stats.fusedMoves++;
+	return 2;
+}
+/*
+***************************************************************************************************************
+	End FuseMove
+***************************************************************************************************************
+*/
+
+static uint32_t FuseArrayRead(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes "push base, push index, add, pop pointer 1, push that 0" as one array read
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the commands belong to (unused)
+	\param[in]		command		Pointer to the first push command
+	\param[in]		last			Pointer after the last command that may be fused
+	\param[out]		result		Set to 0 when writing assembly instructions failed
+
+	\returns
+		Number of commands that were written, 0: no array read, the command must be written normally
+
+	\note
+		- the sum is added directly to D when one of the operands can be read without D (a constant, a fixed
+		  address or a base segment with a small index), otherwise the index is kept in R13
+		- THAT is set to the address like "pop pointer 1" does
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* base = command;
+	const T_vmCommand* index = command + 1;
+	const T_vmCommand* first = NULL;
+	const T_vmCommand* second = NULL;
+	T_stringView name = { "", 0 };
+	uint8_t ok = 1;
+
+	(void)program;
+
+	if (	(writer->fuseArray == 0)
+		|| ((last - command) < 5)
+		|| (base->commandType != CT_PUSH)
+		|| (base->memorySegment >= MS_UNKNOWN)
+		|| (index->commandType != CT_PUSH)
+		|| (index->memorySegment >= MS_UNKNOWN)
+		|| (IsCommand(command + 2, CT_ADD, MS_UNKNOWN, 0) == 0)
+		|| (IsCommand(command + 3, CT_POP, MS_POINTER, 1) == 0)
+		|| (IsCommand(command + 4, CT_PUSH, MS_THAT, 0) == 0)
+	) {
+		return 0;
+	}
+
+	for (const T_vmCommand* fused = command; fused < (command + 5); fused++) {
+		ok &= WriteComment(writer, (E_commandType)fused->commandType, (E_memorySegment)fused->memorySegment, fused->value, &name);
+	}
+	ok &= SpillTop(writer);
+
+	// the operand that can be added without D is loaded last
+	if (IsDirectOperand((E_memorySegment)index->memorySegment, index->value) != 0) {
+		first = base;
+		second = index;
+	} else {
+		first = index;
+		second = base;
+	}
+
+	ok &= WriteLoad(writer, (E_memorySegment)first->memorySegment, first->value);
+	if (IsDirectOperand((E_memorySegment)second->memorySegment, second->value) != 0) {
+		ok &= WriteAddOperand(writer, (E_memorySegment)second->memorySegment, second->value);
+	} else {
+		ok &= EmitTemplate(writer, &arraySaveIndex, NULL);
+		ok &= WriteLoad(writer, (E_memorySegment)second->memorySegment, second->value);
+		ok &= EmitTemplate(writer, &arrayAddIndex, NULL);
+	}
+	ok &= EmitTemplate(writer, &arrayRead, NULL);
+
+	if (writer->cacheTop != 0) {
+		writer->topInD = 1;
+	} else {
+		ok &= EmitTemplate(writer, &pushD, NULL);
+	}
+	ok &= EmitTemplate(writer, &blank, NULL);
+
+	if (ok == 0) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, command->lineNumber, command->column, NULL);
+		*result = 0;
+	}
+
+	writer->stats.arrayReads++;
+	return 5;
+}
+/*
+***************************************************************************************************************
+	End FuseArrayRead
+***************************************************************************************************************
+*/
+
+static uint32_t FuseArrayWrite(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes "[push value,] pop temp 0, pop pointer 1, push temp 0, pop that 0" as one array write
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the commands belong to (unused)
+	\param[in]		command		Pointer to the push of the value or to the "pop temp 0" command
+	\param[in]		last			Pointer after the last command that may be fused
+	\param[out]		result		Set to 0 when writing assembly instructions failed
+
+	\returns
+		Number of commands that were written, 0: no array write, the command must be written normally
+
+	\note
+		- the value is on top of the stack (or pushed by the first command) and the address below it
+		- temp 0 gets the value and THAT the address, then D = address + value gives the address with
+		  "A=D-M" (M is temp 0) and the value with "M=D-A"
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* pattern = command;
+	T_stringView name = { "", 0 };
+	uint8_t ok = 1;
+
+	(void)program;
+
+	if (writer->fuseArray == 0) {
+		return 0;
+	}
+
+	// the value can be loaded directly instead of being pushed
+	if (	(command->commandType == CT_PUSH)
+		&& (command->memorySegment < MS_UNKNOWN)
+	) {
+		pattern++;
+	}
+
+	if (	((last - pattern) < 4)
+		|| (IsCommand(pattern, CT_POP, MS_TEMP, 0) == 0)
+		|| (IsCommand(pattern + 1, CT_POP, MS_POINTER, 1) == 0)
+		|| (IsCommand(pattern + 2, CT_PUSH, MS_TEMP, 0) == 0)
+		|| (IsCommand(pattern + 3, CT_POP, MS_THAT, 0) == 0)
+	) {
+		return 0;
+	}
+
+	for (const T_vmCommand* fused = command; fused < (pattern + 4); fused++) {
+		ok &= WriteComment(writer, (E_commandType)fused->commandType, (E_memorySegment)fused->memorySegment, fused->value, &name);
+	}
+
+	if (pattern != command) {
+		ok &= SpillTop(writer);
+		ok &= WriteLoad(writer, (E_memorySegment)command->memorySegment, command->value);
+	} else if (writer->cacheTop != 0) {
+		ok &= FillTop(writer);
+		writer->topInD = 0;
+	} else {
+		ok &= EmitTemplate(writer, &takeD, NULL);
+	}
+	ok &= EmitTemplate(writer, &arrayWrite, NULL);
+
+	if (ok == 0) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, command->lineNumber, command->column, NULL);
+		*result = 0;
+	}
+
+	writer->stats.arrayWrites++;
+	return (uint32_t)((pattern + 4) - command);
+}
+/*
+***************************************************************************************************************
+	End FuseArrayWrite
+***************************************************************************************************************
+*/
+
+static uint32_t FuseTailCall(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* command, const T_vmCommand* last, uint8_t* result) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes "call f n, return" as a jump to f that reuses the frame of the current function
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		program		Pointer to VM program the commands belong to
+	\param[in]		command		Pointer to the call command
+	\param[in]		last			Pointer after the last command that may be fused
+	\param[out]		result		Set to 0 when writing assembly instructions failed
+
+	\returns
+		Number of commands that were written, 0: no tail call, the command must be written normally
+
+	\note
+		- in place when the current function accesses at least n arguments (a caller passes at least the
+		  arguments the function uses): the new arguments are stored in argument n-1 .. 0, SP = LCL and the
+		  callee pushes its locals over the old ones, its return uses the saved frame and ARG of the current
+		  function
+		- otherwise the frame is moved to ARG + n, with shared calls the normal call is smaller and is used
+		  instead
+		- a function with a static frame passes its own return address to a callee with a static frame, other
+		  calls of or from a static frame are not fused
+
+***************************************************************************************************************
+*/
+	const T_frameInfo* callee = NULL;
+	T_templateArgs args;
+	uint8_t ok = 1;
+
+	if (	(writer->tailCalls == 0)
+		|| (command->commandType != CT_CALL)
+		|| ((last - command) < 2)
+		|| (command[1].commandType != CT_RETURN)
+	) {
+		return 0;
+	}
+
+	args.name.start = GetString(&program->names, command->nameId);
+	args.name.length = GetStringLength(&program->names, command->nameId);
+	args.index = command->value + 5;
+
+	if (writer->frames != NULL) {
+		callee = FindFrame(writer->frames, args.name.start, args.name.length);
+		if (IsStaticFrame(callee) == 0) {
+			callee = NULL;
+		}
+	}
+	// a static frame is not on the stack, only a static function can pass its return address to a static callee
+	if (	(IsStaticFrame(writer->frame) != 0)
+		|| (callee != NULL)
+	) {
+		if (	(IsStaticFrame(writer->frame) == 0)
+			|| (callee == NULL)
+		) {
+			return 0;
+		}
+		args.index = writer->frame->base;
+	} else if (	(command->value > writer->argumentCount)
+				&& (writer->sharedCalls != 0)
+	) {
+		return 0;
+	}
+
+	ok &= WriteComment(writer, CT_CALL, MS_UNKNOWN, command->value, &args.name);
+	ok &= WriteComment(writer, CT_RETURN, MS_UNKNOWN, 0, &args.name);
+
+	if (callee != NULL) {
+		ok &= SpillTop(writer);
+		ok &= EmitTemplate(writer, &staticTailCall, &args);
+		writer->stats.staticCalls++;
+	} else if (command->value <= writer->argumentCount) {
+		for (uint16_t i = command->value; i > 0; i--) {
+			uint8_t fromStack = ((writer->specializeIndex != 0) && (writer->topInD == 0)) ? 1 : 0;
+
+			if (	(fromStack == 0)
+				&& (writer->topInD == 0)
+			) {
+				ok &= EmitTemplate(writer, &takeD, NULL);
+			}
+			writer->topInD = 0;
+			ok &= WriteStore(writer, MS_ARGUMENT, i - 1, fromStack);
+		}
+		writer->topInD = 0;
+		ok &= EmitTemplate(writer, &tailJump, &args);
+	} else {
+		ok &= SpillTop(writer);
+		ok &= EmitTemplate(writer, &tailMoveStart, &args);
+		for (uint16_t i = 0; i < command->value; i++) {
+			ok &= EmitTemplate(writer, &tailMoveArgument, NULL);
+		}
+		ok &= EmitTemplate(writer, &tailMoveJump, &args);
+		writer->stats.movedTailCalls++;
+	}
+	ok &= EmitTemplate(writer, &blank, NULL);
+
+	if (ok == 0) {
+		DIAG_ERROR(DC_ENCODING, writer->sourcePath, command->lineNumber, command->column, NULL);
+		*result = 0;
+	}
+
+	writer->stats.tailCalls++;
+	return 2;
+}
+/*
+***************************************************************************************************************
+	End FuseTailCall
+***************************************************************************************************************
+*/
+
+static uint16_t CountArguments(const T_vmProgram* program, const T_vmCommand* function) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function determines the number of arguments a function accesses
+
+	\param[in]		program		Pointer to VM program the function belongs to
+	\param[in]		function		Pointer to the function command
+
+	\returns
+		Highest argument index of a push or pop in the function body + 1, 0 when no argument is accessed
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* end = program->commands + program->count;
+	uint16_t count = 0;
+
+	for (const T_vmCommand* command = function + 1; (command < end) && (command->commandType != CT_FUNCTION); command++) {
+		if (	((command->commandType == CT_PUSH) || (command->commandType == CT_POP))
+			&& (command->memorySegment == MS_ARGUMENT)
+			&& (command->value >= count)
+		) {
+			count = command->value + 1;
+		}
+	}
+	return count;
+}
+/*
+***************************************************************************************************************
+	End CountArguments
+***************************************************************************************************************
+*/
+
+static uint8_t IsCommand(const T_vmCommand* command, E_commandType commandType, E_memorySegment memorySegment, uint16_t value) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks the type, segment and value of a command
+
+	\param[in]		command			Pointer to command
+	\param[in]		commandType		Expected command type
+	\param[in]		memorySegment	Expected memory segment, MS_UNKNOWN: the segment and value are not checked
+	\param[in]		value				Expected value
+
+	\returns
+		0: the command is different
+		1: the command matches
+
+***************************************************************************************************************
+*/
+	if (command->commandType != commandType) {
+		return 0;
+	}
+	if (memorySegment == MS_UNKNOWN) {
+		return 1;
+	}
+	return ((command->memorySegment == memorySegment) && (command->value == value)) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End IsCommand
+***************************************************************************************************************
+*/
+
+static uint8_t IsDirectOperand(E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks whether a value can be added to D without using D to form its address
+
+	\param[in]		memorySegment	Memory segment
+	\param[in]		index				Index in the segment, the value for MS_CONSTANT
+
+	\returns
+		0: the value has to be loaded into D first
+		1: WriteAddOperand can add the value
+
+***************************************************************************************************************
+*/
+	switch (memorySegment) {
+	case MS_CONSTANT:
+		return (index <= MAX_A_VALUE) ? 1 : 0;
+	case MS_STATIC:
+	case MS_POINTER:
+	case MS_TEMP:
+	case MS_FRAME:
+		return 1;
+	case MS_LOCAL:
+	case MS_ARGUMENT:
+	case MS_THIS:
+	case MS_THAT:
+		return (index <= CHAIN_STORE_LIMIT) ? 1 : 0;
+	default:
+		return 0;
+	}
+}
+/*
+***************************************************************************************************************
+	End IsDirectOperand
+***************************************************************************************************************
+*/
+
+static uint8_t WriteAddOperand(T_codeWriter* writer, E_memorySegment memorySegment, uint16_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes D = D + segment[index] for an operand that IsDirectOperand accepts
+
+	\param[in,out]	writer			Pointer to code writer
+	\param[in]		memorySegment	Memory segment
+	\param[in]		index				Index in the segment, the value for MS_CONSTANT
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	args.index = index;
+
+	switch (memorySegment) {
+	case MS_CONSTANT:
+		return EmitTemplate(writer, &addConstant, &args);
+	case MS_STATIC:
+		return EmitTemplate(writer, &addStatic, &args);
+	case MS_POINTER:
+	case MS_TEMP:
+	case MS_FRAME:
+		args.index = FixedAddress(memorySegment, index);
+		return EmitTemplate(writer, &addFixed, &args);
+	default:
+		if (index == 0) {
+			args.base = baseSymbols[memorySegment];
+			return EmitTemplate(writer, &addBaseZero, &args);
+		}
+		return WriteChain(writer, (E_writerSymbol)baseSymbols[memorySegment], index, &chainAdd);
+	}
+}
+/*
+***************************************************************************************************************
+	End WriteAddOperand
+***************************************************************************************************************
+*/
+
+static uint16_t EvaluateConstant(E_commandType command, uint16_t x, uint16_t y) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function evaluates an arithmetic VM command with the 16 bit two's complement semantics of the Hack ALU
+
+	\param[in]		command		Arithmetic VM command (CT_ADD .. CT_NOT)
+	\param[in]		x				First operand (the value below the top of the stack), unused for neg and not
+	\param[in]		y				Second operand (the top of the stack)
+
+	\returns
+		Result of the command, true is 0xFFFF and false is 0
+
+	\note
+		- like the generated code gt and lt compare the (wrapped) difference x - y with 0
+
+***************************************************************************************************************
+*/
+	int16_t difference = (int16_t)(uint16_t)(x - y);
+
+	switch (command) {
+	case CT_ADD:
+		return (uint16_t)(x + y);
+	case CT_SUB:
+		return (uint16_t)(x - y);
+	case CT_NEG:
+		return (uint16_t)(0 - y);
+	case CT_EQ:
+		return (difference == 0) ? 0xFFFF : 0;
+	case CT_GT:
+		return (difference > 0) ? 0xFFFF : 0;
+	case CT_LT:
+		return (difference < 0) ? 0xFFFF : 0;
+	case CT_AND:
+		return (uint16_t)(x & y);
+	case CT_OR:
+		return (uint16_t)(x | y);
+	case CT_NOT:
+		return (uint16_t)~y;
+	default:
+		return 0;
+	}
+}
+/*
+***************************************************************************************************************
+	End EvaluateConstant
+***************************************************************************************************************
+*/
+
+static uint8_t LoadConstant(T_codeWriter* writer, uint16_t value) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the shortest code that loads a 16 bit constant into D
+
+	\param[in,out]	writer		Pointer to code writer
+	\param[in]		value			Constant
+
+	\returns
+		0: writing assembly instructions failed
+		1: writing assembly instructions was successful
+
+	\note
+		- an A-instruction only holds 15 bits, larger values are loaded inverted
+
+***************************************************************************************************************
+*/
+	T_templateArgs args;
+
+	if (value == 0) {
+		return EmitTemplate(writer, &loadZero, NULL);
+	}
+	if (value == 1) {
+		return EmitTemplate(writer, &loadOne, NULL);
+	}
+	if (value == 0xFFFF) {
+		return EmitTemplate(writer, &loadMinusOne, NULL);
+	}
+
+	if (value <= MAX_A_VALUE) {
+		args.index = value;
+		return EmitTemplate(writer, &loadConstant, &args);
+	}
+	args.index = (uint16_t)~value;
+	return EmitTemplate(writer, &loadInverted, &args);
+}
+/*
+***************************************************************************************************************
+	End LoadConstant
+***************************************************************************************************************
+*/
+
+
+
+
+/*
+***************************************************************************************************************
+	TEST CODE
+***************************************************************************************************************
+*/
+
+// TODO ADD MODULE TESTCODE
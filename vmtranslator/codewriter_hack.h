@@ -1,87 +1,202 @@
-/*! \file
-***************************************************************************************************************
-file name:					codewriter_hack.h
-*	\copyright				FourE
-*	\brief					codewriter for hack header file
-*	\author					Frank Eggink
-*	\date	created:			2020-02-03
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-#ifndef __CODEWRITER_HACK_H_
-#define __CODEWRITER_HACK_H_
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include "parser.h"
-#include <stdio.h> // FILE
-
-/*
-***************************************************************************************************************
-	Make header CPP compatible
-***************************************************************************************************************
-*/
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
-***************************************************************************************************************
-	GLOBAL DEFINES
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL TYPEDEF
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-void WriteCommand(FILE* pFile, char* comment, char* fileName,  E_commandType command);
-uint8_t WriteInit(FILE* pFile);
-
-/*
-***************************************************************************************************************
-
-***************************************************************************************************************
-*/
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif		// __CODEWRITER_HACK_H_
-
+/*! \file
+***************************************************************************************************************
+file name:					codewriter_hack.h
+*	\copyright				FourE
+*	\brief					codewriter for hack header file
+*	\author					Frank Eggink
+*	\date	created:			2020-02-03
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+#ifndef __CODEWRITER_HACK_H_
+#define __CODEWRITER_HACK_H_
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "parser.h"
+#include "hackprogram.h"
+#include "frametable.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+#define PRINTED_TEMPLATE_SLOTS	(512)		// slots of the printed templates of a code writer, a power of 2
+#define MAX_PRINTED_HOLES			(8)		// a template with more holes is printed record by record
+#define PRINTED_RECORDS			(0xFF)	// holeCount of a template that is printed record by record
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// classes of the specialized push and pop sequences
+typedef enum {
+	 IC_BASE_ZERO = 0				// local, argument, this and that with index 0
+	,IC_BASE_SMALL					// local, argument, this and that with an index that is reached with a chain
+	,IC_BASE_OTHER					// local, argument, this and that with a larger index
+	,IC_FIXED						// pointer and temp
+	,IC_CONSTANT
+	,IC_STATIC
+	,IC_COUNT
+} E_indexClass;
+
+// symbols, labels and comments that the templates use as they are, interned once per code writer
+typedef enum {
+	 WS_SP = 0
+	,WS_LCL
+	,WS_ARG
+	,WS_THIS
+	,WS_THAT
+	,WS_R13
+	,WS_R14
+	,WS_CALL_ROUTINE				// $call
+	,WS_RETURN_ROUTINE			// $return
+	,WS_START						// $start
+	,WS_POP_D						// comments of the stack macros
+	,WS_PUSH_D
+	,WS_FILL_D
+	,WS_ADD							// comments of the commands without operands
+	,WS_SUB
+	,WS_NEG
+	,WS_EQ
+	,WS_GT
+	,WS_LT
+	,WS_AND
+	,WS_OR
+	,WS_NOT
+	,WS_RETURN
+	,WS_PUSH_LOCAL					// other comments
+	,WS_SHARED_CALL
+	,WS_SHARED_RETURN
+	,WS_BOOTSTRAP
+	,WS_CALL_SYS_INIT
+	,WS_COUNT
+} E_writerSymbol;
+
+// fixed lines of a template, printed once per code writer when the assembly code is printed directly
+typedef struct {
+	const void* template;					// template of the slot, NULL: slot is empty
+	uint32_t text;								// offset of the lines in printedText
+	uint32_t runs[MAX_PRINTED_HOLES + 1];	// end of the lines before each hole and of the lines after the last
+	uint16_t instructions;					// number of machine instructions of the lines
+	uint8_t holes[MAX_PRINTED_HOLES];		// index of the records with a hole, they are filled per use
+	uint8_t holeCount;						// number of holes, PRINTED_RECORDS: no fixed lines
+} T_printedTemplate;
+
+// numbers of commands that determine the code size of the calling convention, of folded constants, of
+// superinstructions and of specialized push and pop sequences
+typedef struct {
+	uint32_t calls;						// number of call commands written
+	uint32_t returns;						// number of return commands written
+	uint32_t folds;						// number of arithmetic commands evaluated at translation time
+	uint32_t foldedPops;					// number of constants that were popped without the stack
+	uint32_t fusedCompares;				// number of compares that were fused with the if-goto that follows
+	uint32_t fusedMoves;					// number of push and pop pairs that were written as a move
+	uint32_t arrayReads;					// number of array reads that were written as one access
+	uint32_t arrayWrites;				// number of array writes that were written as one access
+	uint32_t tailCalls;					// number of call and return pairs that were written as a tail call
+	uint32_t movedTailCalls;			// number of tail calls that had to move the frame
+	uint32_t staticCalls;				// number of calls of functions with a static frame
+	uint32_t staticReturns;				// number of returns of functions with a static frame
+	uint32_t indexCommands[IC_COUNT];	// number of specialized push and pop commands per class
+	int32_t indexSaved[IC_COUNT];		// number of instructions saved per class
+} T_codeWriterStats;
+
+// state of the code writer for one .vm file
+typedef struct {
+	T_hackProgram* output;				// receives the generated assembly code
+	T_outputBuffer* text;				// NULL: records are appended to output, else the assembly code is printed here
+	const char* fileName;				// namespace of the static variables and the labels of the VM code
+	uint32_t fileNameLength;
+	const char* sourcePath;				// path of the .vm file, only used for diagnostics (may be NULL)
+	const char* labelNamespace;		// namespace of the generated labels, the current function
+	uint32_t labelNamespaceLength;
+	uint32_t compareCounter;			// number of eq, gt and lt commands written in the namespace
+	uint32_t returnCounter;				// number of call commands written in the namespace
+	uint8_t cacheTop;						// 1: keep the top of the stack in D between commands
+	uint8_t topInD;						// 1: the top of the stack is in D and not in RAM (only with cacheTop)
+	uint8_t sharedCalls;					// 1: call and return jump to the shared $call and $return routines
+	uint8_t foldConstants;				// 1: evaluate arithmetic on constants at translation time
+	uint8_t specializeIndex;			// 1: use the shortest push and pop sequence for every segment and index
+	uint8_t fuseCompare;					// 1: jump directly on a compare that is followed by if-goto
+	uint8_t fuseMove;						// 1: move a value without the stack when a push is followed by a pop
+	uint8_t fuseArray;					// 1: compute the address of array reads and writes without the stack
+	uint8_t tailCalls;					// 1: reuse the frame for a call that is directly followed by return
+	uint16_t argumentCount;				// number of arguments the current function accesses (with tailCalls)
+	const T_frameTable* frames;		// frames of the functions, NULL: every function has a dynamic frame
+	const T_frameInfo* frame;			// frame of the current function, NULL: dynamic frame that saves everything
+	T_codeWriterStats stats;
+	uint32_t instructions;				// number of machine instructions written
+	uint32_t symbols[WS_COUNT];		// string IDs of the E_writerSymbol in output, STRING_ID_INVALID: not interned yet
+	T_printedTemplate* printed;		// text: hash table of the printed templates, NULL: not allocated yet
+	T_outputBuffer printedText;		// text: fixed lines of the printed templates
+} T_codeWriter;
+
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void InitCodeWriter(T_codeWriter* writer, T_hackProgram* output, const char* fileName, const char* sourcePath);
+void FreeCodeWriter(T_codeWriter* writer);
+uint8_t WriteProgram(T_codeWriter* writer, const T_vmProgram* program);
+uint8_t WriteCommandRange(T_codeWriter* writer, const T_vmProgram* program, uint32_t first, uint32_t end);
+uint8_t WriteCommand(T_codeWriter* writer, const T_vmProgram* program, const T_vmCommand* vmCommand);
+uint8_t WriteInit(T_hackProgram* output, uint8_t sharedCalls, uint16_t stackStart);
+uint8_t WriteSharedRoutines(T_hackProgram* output, uint8_t skip);
+void AddCodeWriterStats(T_codeWriterStats* total, const T_codeWriterStats* stats);
+void PrintCodeWriterStats(const T_codeWriterStats* stats, uint8_t sharedCalls);
+void PrintFrameCosts(const T_frameTable* frames, uint8_t sharedCalls);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __CODEWRITER_HACK_H_
+
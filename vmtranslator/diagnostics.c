@@ -0,0 +1,426 @@
+/*! \file
+***************************************************************************************************************
+file name:					diagnostics.c
+*	\copyright				FourE
+*	\brief					diagnostics source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	Records can be reported from every thread, they are sorted by file, line and column before they are
+	written, so the order does not depend on the number of jobs.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "diagnostics.h"
+#include "outputbuffer.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, realloc, free, qsort
+#include <string.h>			// memcpy, strlen, strcmp
+#include <stdarg.h>
+#include <pthread.h>
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define DEFAULT_DIAGNOSTIC_LEVEL		DL_WARN
+#define MAX_DETAIL_LENGTH				(80)		// longer details (source lines) are cut off
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+typedef struct {
+	E_diagnosticLevel level;
+	uint8_t code;					// E_diagnosticCode
+	uint32_t line;					// 0: not related to a line
+	uint32_t column;				// 0: not related to a column
+	uint32_t sequence;			// order of reporting, makes sorting stable
+	char* file;						// "": not related to a file, also owns the detail string
+	char* detail;					// NULL: no detail
+} T_diagnostic;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static int CompareDiagnostics(const void* a, const void* b);
+static void AppendDiagnostic(T_outputBuffer* output, const T_diagnostic* diagnostic);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// indexed by E_diagnosticCode
+static const char* const diagnosticMessages[DC_COUNT] = {
+	 "no error"
+	,"out of memory"
+	,"could not open input file"
+	,"could not open directory"
+	,"no .vm file or directory with .vm files"
+	,"could not create output file"
+	,"could not write output file"
+	,"too many tokens"
+	,"unknown command"
+	,"unknown memory segment"
+	,"missing argument"
+	,"invalid value"
+	,"could not encode assembly code"
+	,"undefined label or function"
+	,"label or function is defined twice"
+	,"constant out of range 0..32767"
+};
+
+static E_diagnosticLevel currentLevel = DEFAULT_DIAGNOSTIC_LEVEL;
+
+// collected records, protected by lock
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static T_diagnostic* records = NULL;
+static uint32_t recordCount = 0;
+static uint32_t recordCapacity = 0;
+static uint32_t sequence = 0;
+static uint32_t errorCount = 0;
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void SetDiagnosticLevel(E_diagnosticLevel level) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function sets the highest level of the diagnostics that are written
+
+	\param[in]		level		DL_QUIET, DL_ERROR, DL_WARN or DL_TRACE
+
+	\note
+		- set the level before worker threads are started
+
+***************************************************************************************************************
+*/
+	currentLevel = (level > DL_TRACE) ? DL_TRACE : level;
+}
+/*
+***************************************************************************************************************
+	End SetDiagnosticLevel
+***************************************************************************************************************
+*/
+
+E_diagnosticLevel GetDiagnosticLevel(void) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the highest level of the diagnostics that are written
+
+	\returns
+		DL_QUIET, DL_ERROR, DL_WARN or DL_TRACE
+
+***************************************************************************************************************
+*/
+	return currentLevel;
+}
+/*
+***************************************************************************************************************
+	End GetDiagnosticLevel
+***************************************************************************************************************
+*/
+
+uint8_t ParseDiagnosticLevel(const char* input, E_diagnosticLevel* level) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function converts the name of a level (quiet, error, warn, trace) to the level
+
+	\param[in]		input		Pointer to name of the level
+	\param[out]		level		Pointer that receives the level
+
+	\returns
+			0: name is not a level
+			1: level was found
+
+***************************************************************************************************************
+*/
+	static const char* const levelNames[] = { "quiet", "error", "warn", "trace" };
+
+	for (uint8_t i = 0; i < (sizeof(levelNames) / sizeof(levelNames[0])); i++) {
+		if (strcmp(input, levelNames[i]) == 0) {
+			*level = i;
+			return 1;
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End ParseDiagnosticLevel
+***************************************************************************************************************
+*/
+
+void ReportDiagnostic(E_diagnosticLevel level, E_diagnosticCode code, const char* file, uint32_t line, uint32_t column, const char* detail) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function records an error or warning, the records are written by FlushDiagnostics
+
+	\param[in]		level		DL_ERROR or DL_WARN
+	\param[in]		code		Diagnostic code
+	\param[in]		file		Pointer to file name, NULL when the diagnostic is not related to a file
+	\param[in]		line		Line number (starting at 1), 0 when not related to a line
+	\param[in]		column	Column number (starting at 1), 0 when not related to a column
+	\param[in]		detail	Pointer to detail (token, source line), NULL for none
+
+	\note
+		- file and detail are copied
+		- errors are always counted, also when they are not written because of the level
+		- can be called from every thread
+
+***************************************************************************************************************
+*/
+	size_t fileLength = (file != NULL) ? strlen(file) : 0;
+	size_t detailLength = (detail != NULL) ? strlen(detail) : 0;
+	char* strings = NULL;
+
+	if (detailLength > MAX_DETAIL_LENGTH) {
+		detailLength = MAX_DETAIL_LENGTH;
+	}
+
+	pthread_mutex_lock(&lock);
+
+	if (level == DL_ERROR) {
+		errorCount++;
+	}
+
+	if ((level > currentLevel) || (level == DL_QUIET)) {
+		pthread_mutex_unlock(&lock);
+		return;
+	}
+
+	if (recordCount == recordCapacity) {
+		uint32_t capacity = (recordCapacity == 0) ? 16 : (recordCapacity * 2);
+		T_diagnostic* newRecords = realloc(records, capacity * sizeof(T_diagnostic));
+		if (newRecords != NULL) {
+			records = newRecords;
+			recordCapacity = capacity;
+		}
+	}
+	strings = malloc(fileLength + detailLength + 2);
+
+	if ((recordCount == recordCapacity) || (strings == NULL)) {
+		// no memory to keep the record, write it right away
+		pthread_mutex_unlock(&lock);
+		free(strings);
+		fprintf(stderr, "%s: %s\n", (level == DL_ERROR) ? "error" : "warning", diagnosticMessages[code]);
+		return;
+	}
+
+	T_diagnostic* record = &records[recordCount];
+	record->level = level;
+	record->code = (uint8_t)code;
+	record->line = line;
+	record->column = column;
+	record->sequence = sequence++;
+	record->file = NULL;
+	record->detail = NULL;
+
+	if (file != NULL) {
+		record->file = strings;
+		memcpy(record->file, file, fileLength);
+		record->file[fileLength] = '\0';
+	}
+	if (detail != NULL) {
+		record->detail = strings + fileLength + 1;
+		memcpy(record->detail, detail, detailLength);
+		record->detail[detailLength] = '\0';
+	}
+	if (record->file == NULL) {
+		// the strings are freed through the file pointer
+		record->file = strings;
+		record->file[0] = '\0';
+	}
+	recordCount++;
+
+	pthread_mutex_unlock(&lock);
+}
+/*
+***************************************************************************************************************
+	End ReportDiagnostic
+***************************************************************************************************************
+*/
+
+void TraceDiagnostic(const char* format, ...) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes a printf style trace message to stderr right away
+
+	\param[in]		format		Pointer to printf style format string
+
+	\note
+		- use the DIAG_TRACE macro, it checks the level before the arguments are evaluated
+
+***************************************************************************************************************
+*/
+	va_list arguments;
+
+	va_start(arguments, format);
+	vfprintf(stderr, format, arguments);
+	va_end(arguments);
+	fputc('\n', stderr);
+}
+/*
+***************************************************************************************************************
+	End TraceDiagnostic
+***************************************************************************************************************
+*/
+
+uint32_t FlushDiagnostics(void) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes all collected errors and warnings to stderr with one write and frees the records
+
+	\returns
+		Number of errors that were reported since the program started (also the errors that were not written)
+
+***************************************************************************************************************
+*/
+	T_outputBuffer output;
+	uint32_t errors = 0;
+
+	pthread_mutex_lock(&lock);
+
+	if (recordCount > 1) {
+		qsort(records, recordCount, sizeof(T_diagnostic), CompareDiagnostics);
+	}
+
+	InitOutputBuffer(&output);
+	for (uint32_t i = 0; i < recordCount; i++) {
+		AppendDiagnostic(&output, &records[i]);
+		free(records[i].file);
+	}
+	if (output.length > 0) {
+		fwrite(output.data, 1, output.length, stderr);
+		fflush(stderr);
+	}
+	FreeOutputBuffer(&output);
+
+	free(records);
+	records = NULL;
+	recordCount = 0;
+	recordCapacity = 0;
+	errors = errorCount;
+
+	pthread_mutex_unlock(&lock);
+	return errors;
+}
+/*
+***************************************************************************************************************
+	End FlushDiagnostics
+***************************************************************************************************************
+*/
+
+static int CompareDiagnostics(const void* a, const void* b) {
+/*!
+***************************************************************************************************************
+
+	\description
+		qsort compare function for diagnostics, orders by file, line, column and order of reporting
+
+***************************************************************************************************************
+*/
+	const T_diagnostic* left = a;
+	const T_diagnostic* right = b;
+	int result = strcmp(left->file, right->file);
+
+	if (result == 0) {
+		if (left->line != right->line) {
+			result = (left->line < right->line) ? -1 : 1;
+		} else if (left->column != right->column) {
+			result = (left->column < right->column) ? -1 : 1;
+		} else if (left->sequence != right->sequence) {
+			result = (left->sequence < right->sequence) ? -1 : 1;
+		}
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End CompareDiagnostics
+***************************************************************************************************************
+*/
+
+static void AppendDiagnostic(T_outputBuffer* output, const T_diagnostic* diagnostic) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function formats a diagnostic as "file:line:column: level[Ecode]: message 'detail'"
+
+	\param[in,out]	output			Pointer to output buffer
+	\param[in]		diagnostic		Pointer to diagnostic
+
+***************************************************************************************************************
+*/
+	if (diagnostic->file[0] != '\0') {
+		AppendString(output, diagnostic->file);
+		if (diagnostic->line > 0) {
+			AppendFormat(output, ":%u", diagnostic->line);
+			if (diagnostic->column > 0) {
+				AppendFormat(output, ":%u", diagnostic->column);
+			}
+		}
+		AppendLiteral(output, ": ");
+	}
+	AppendFormat(output, "%s[E%03u]: %s", (diagnostic->level == DL_ERROR) ? "error" : "warning"
+					, diagnostic->code, diagnosticMessages[diagnostic->code]);
+	if (diagnostic->detail != NULL) {
+		AppendFormat(output, " '%s'", diagnostic->detail);
+	}
+	AppendLiteral(output, "\n");
+}
+/*
+***************************************************************************************************************
+	End AppendDiagnostic
+***************************************************************************************************************
+*/
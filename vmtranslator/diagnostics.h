@@ -0,0 +1,148 @@
+/*! \file
+***************************************************************************************************************
+file name:					diagnostics.h
+*	\copyright				FourE
+*	\brief					diagnostics header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Errors and warnings are collected as records (file, line, column, code) and written to stderr in one batch
+	by FlushDiagnostics. Trace messages are written to stderr immediately, they are meant for debugging only.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	DIAGNOSTICS_LEVEL sets the highest level that is compiled in, for example -DDIAGNOSTICS_LEVEL=DL_ERROR
+	removes all warning and trace calls from the translator (the arguments are still evaluated, they do not
+	have side effects). The runtime level is set with SetDiagnosticLevel.
+
+***************************************************************************************************************
+*/
+
+#ifndef __DIAGNOSTICS_H
+#define __DIAGNOSTICS_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define DL_QUIET			(0)
+#define DL_ERROR			(1)
+#define DL_WARN			(2)
+#define DL_TRACE			(3)
+
+#ifndef DIAGNOSTICS_LEVEL
+#define DIAGNOSTICS_LEVEL	DL_TRACE
+#endif
+
+#if DIAGNOSTICS_LEVEL >= DL_ERROR
+#define DIAG_ERROR(code, file, line, column, detail) \
+	ReportDiagnostic(DL_ERROR, (code), (file), (line), (column), (detail))
+#else
+#define DIAG_ERROR(code, file, line, column, detail) \
+	((void)(code), (void)(file), (void)(line), (void)(column), (void)(detail))
+#endif
+
+#if DIAGNOSTICS_LEVEL >= DL_WARN
+#define DIAG_WARN(code, file, line, column, detail) \
+	ReportDiagnostic(DL_WARN, (code), (file), (line), (column), (detail))
+#else
+#define DIAG_WARN(code, file, line, column, detail) \
+	((void)(code), (void)(file), (void)(line), (void)(column), (void)(detail))
+#endif
+
+#if DIAGNOSTICS_LEVEL >= DL_TRACE
+#define DIAG_TRACE(...) \
+	do { \
+		if (GetDiagnosticLevel() >= DL_TRACE) { \
+			TraceDiagnostic(__VA_ARGS__); \
+		} \
+	} while (0)
+#else
+#define DIAG_TRACE(...)												((void)0)
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef uint8_t E_diagnosticLevel;		// DL_QUIET .. DL_TRACE
+
+typedef enum {
+	 DC_NONE = 0
+	,DC_OUT_OF_MEMORY
+	,DC_OPEN_INPUT
+	,DC_OPEN_DIRECTORY
+	,DC_NO_INPUT
+	,DC_CREATE_OUTPUT
+	,DC_WRITE_OUTPUT
+	,DC_TOO_MANY_TOKENS
+	,DC_UNKNOWN_COMMAND
+	,DC_UNKNOWN_SEGMENT
+	,DC_MISSING_ARGUMENT
+	,DC_INVALID_VALUE
+	,DC_ENCODING
+	,DC_UNDEFINED_NAME
+	,DC_DUPLICATE_NAME
+	,DC_CONSTANT_RANGE
+	,DC_COUNT
+} E_diagnosticCode;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void SetDiagnosticLevel(E_diagnosticLevel level);
+E_diagnosticLevel GetDiagnosticLevel(void);
+uint8_t ParseDiagnosticLevel(const char* input, E_diagnosticLevel* level);
+void ReportDiagnostic(E_diagnosticLevel level, E_diagnosticCode code, const char* file, uint32_t line, uint32_t column, const char* detail);
+void TraceDiagnostic(const char* format, ...);
+uint32_t FlushDiagnostics(void);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __DIAGNOSTICS_H
@@ -0,0 +1,484 @@
+/*! \file
+***************************************************************************************************************
+file name:					emulatormain.c
+*	\copyright				FourE
+*	\brief					Hack emulator main source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Command line front end of the Hack CPU emulator: loads a program, runs it and reports the number of
+	executed instructions and the RAM words that are asked for. A .vm file or a directory with .vm files
+	is run by the VM interpreter instead, which reports the number of executed VM commands.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The RAM can be preset before the run, for programs without bootstrap code that expect SP, LCL, ARG, THIS
+	and THAT to be set like the test scripts do.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>			// EXIT_FAILURE, strtoul, strtoull
+#include <string.h>
+#include <time.h>				// clock_gettime
+#include "hackemulator.h"
+#include "vminterpreter.h"
+#include "diagnostics.h"
+#include "filehelper.h"
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define MAX_RAM_ARGUMENTS		(32)				// -r and -d arguments that can be given
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// -r address=value or -d first-last
+typedef struct {
+	uint16_t first;
+	uint16_t last;							// -r: value
+} T_ramArgument;
+
+typedef struct {
+	uint64_t limit;						// number of instructions or VM commands after which the run stops
+	T_ramArgument presets[MAX_RAM_ARGUMENTS];
+	uint8_t presetCount;
+	T_ramArgument dumps[MAX_RAM_ARGUMENTS];
+	uint8_t dumpCount;
+} T_emulatorOptions;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t ParseArguments(int argc, char *argv[], T_emulatorOptions* options, char** input);
+static uint8_t ParseRamArgument(const char* argument, char separator, T_ramArgument* ramArgument);
+static int EmulateHackFile(const T_emulatorOptions* options, const char* input);
+static int InterpretVMInput(const T_emulatorOptions* options, char* input);
+static void PrintRun(const T_hackEmulator* emulator, E_hackStop stop, double seconds);
+static void PrintInterpreterRun(const T_vmInterpreter* interpreter, E_vmStop stop, double seconds);
+static void PrintDumps(const T_emulatorOptions* options, const uint16_t* ram);
+static double GetSeconds(const struct timespec* start, const struct timespec* stop);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// the emulator and the interpreter hold the RAM, too large for the stack
+static T_hackEmulator emulator;
+static T_vmInterpreter interpreter;
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+int main(int argc, char *argv[]) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Main program: load, run and report
+
+***************************************************************************************************************
+*/
+	T_emulatorOptions options;
+	char* input = NULL;
+
+	if (ParseArguments(argc, argv, &options, &input) == 0) {
+		fprintf(stderr, "Usage: %s [-l N] [-r address=value]... [-d first-last]... [-v quiet|error|warn|trace] <.asm/.hack/.bin/.vm file or directory>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (GetInputFileType(input) != IFT_NONE) {
+		return InterpretVMInput(&options, input);
+	}
+	return EmulateHackFile(&options, input);
+}
+/*
+***************************************************************************************************************
+	End main
+***************************************************************************************************************
+*/
+
+static int EmulateHackFile(const T_emulatorOptions* options, const char* input) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function loads a Hack program, runs it on the emulator and reports the run
+
+	\param[in]		options		Pointer to emulator options
+	\param[in]		input			Pointer to name of the .asm, .hack or .bin file
+
+	\returns
+		Exit code of the program
+
+***************************************************************************************************************
+*/
+	struct timespec start;
+	struct timespec stop;
+	E_hackStop reason = HS_END;
+
+	if (InitHackEmulator(&emulator) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		FlushDiagnostics();
+		return EXIT_FAILURE;
+	}
+	if (LoadHackFile(&emulator, input) == 0) {
+		FreeHackEmulator(&emulator);
+		FlushDiagnostics();
+		return EXIT_FAILURE;
+	}
+
+	for (uint8_t i = 0; i < options->presetCount; i++) {
+		emulator.ram[options->presets[i].first] = options->presets[i].last;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	reason = RunHackEmulator(&emulator, options->limit);
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+
+	PrintRun(&emulator, reason, GetSeconds(&start, &stop));
+	PrintDumps(options, emulator.ram);
+
+	FreeHackEmulator(&emulator);
+	if (FlushDiagnostics() > 0) {
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+/*
+***************************************************************************************************************
+	End EmulateHackFile
+***************************************************************************************************************
+*/
+
+static int InterpretVMInput(const T_emulatorOptions* options, char* input) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function loads a .vm file or a directory with .vm files, runs it on the VM interpreter and reports
+		the run
+
+	\param[in]		options		Pointer to emulator options, the limit counts VM commands
+	\param[in]		input			Pointer to name of the .vm file or the directory
+
+	\returns
+		Exit code of the program
+
+***************************************************************************************************************
+*/
+	struct timespec start;
+	struct timespec stop;
+	E_vmStop reason = VS_END;
+
+	InitVMInterpreter(&interpreter);
+	if (LoadVMInput(&interpreter, input) == 0) {
+		FreeVMInterpreter(&interpreter);
+		FlushDiagnostics();
+		return EXIT_FAILURE;
+	}
+
+	for (uint8_t i = 0; i < options->presetCount; i++) {
+		interpreter.ram[options->presets[i].first] = options->presets[i].last;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	reason = RunVMInterpreter(&interpreter, options->limit);
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+
+	PrintInterpreterRun(&interpreter, reason, GetSeconds(&start, &stop));
+	PrintDumps(options, interpreter.ram);
+
+	FreeVMInterpreter(&interpreter);
+	if (	(FlushDiagnostics() > 0)
+		|| (reason == VS_BAD_RETURN)
+	) {
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+/*
+***************************************************************************************************************
+	End InterpretVMInput
+***************************************************************************************************************
+*/
+
+static uint8_t ParseArguments(int argc, char *argv[], T_emulatorOptions* options, char** input) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses the command line arguments
+
+	\param[in]		argc			Number of arguments
+	\param[in]		argv			Array of arguments
+	\param[out]		options		Pointer to emulator options
+	\param[out]		input			Pointer that receives the file argument
+
+	\returns
+			0: arguments are not valid
+			1: arguments are valid
+
+	\note
+		- -l N stops the run after N instructions or VM commands (default no limit)
+		- -r address=value sets a RAM word before the run
+		- -d first-last prints the RAM words from first to last (signed) after the run
+		- -v sets the level of the diagnostics that are written to stderr (default warn)
+
+***************************************************************************************************************
+*/
+	memset(options, 0, sizeof(T_emulatorOptions));
+	options->limit = NO_INSTRUCTION_LIMIT;
+	*input = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-l") == 0) {
+			char* end = NULL;
+
+			if ((i + 1) >= argc) {
+				return 0;
+			}
+			i++;
+			options->limit = strtoull(argv[i], &end, 10);
+			if ((end == argv[i]) || (*end != '\0')) {
+				fprintf(stderr, "Error: instruction limit must be a number\n");
+				return 0;
+			}
+		} else if (strcmp(argv[i], "-r") == 0) {
+			if (	((i + 1) >= argc)
+				|| (options->presetCount >= MAX_RAM_ARGUMENTS)
+				|| (ParseRamArgument(argv[i + 1], '=', &options->presets[options->presetCount]) == 0)
+			) {
+				return 0;
+			}
+			options->presetCount++;
+			i++;
+		} else if (strcmp(argv[i], "-d") == 0) {
+			if (	((i + 1) >= argc)
+				|| (options->dumpCount >= MAX_RAM_ARGUMENTS)
+				|| (ParseRamArgument(argv[i + 1], '-', &options->dumps[options->dumpCount]) == 0)
+				|| (options->dumps[options->dumpCount].last < options->dumps[options->dumpCount].first)
+				|| (options->dumps[options->dumpCount].last >= HACK_RAM_SIZE)
+			) {
+				return 0;
+			}
+			options->dumpCount++;
+			i++;
+		} else if (strcmp(argv[i], "-v") == 0) {
+			E_diagnosticLevel level = DL_WARN;
+
+			if (	((i + 1) >= argc)
+				|| (ParseDiagnosticLevel(argv[i + 1], &level) == 0)
+			) {
+				return 0;
+			}
+			i++;
+			SetDiagnosticLevel(level);
+		} else if (*input == NULL) {
+			*input = argv[i];
+		} else {
+			return 0;
+		}
+	}
+	return (*input != NULL) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End ParseArguments
+***************************************************************************************************************
+*/
+
+static uint8_t ParseRamArgument(const char* argument, char separator, T_ramArgument* ramArgument) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses "address=value" or "first-last", a single address is accepted for "first-last"
+
+	\param[in]		argument			Pointer to the argument
+	\param[in]		separator		'=' or '-'
+	\param[out]		ramArgument		Pointer that receives the two numbers
+
+	\returns
+			0: argument is not valid
+			1: argument is valid
+
+	\note
+		- the value of "address=value" may be negative, it is stored as 16 bit two's complement
+
+***************************************************************************************************************
+*/
+	char* end = NULL;
+	unsigned long first = strtoul(argument, &end, 10);
+	long second = 0;
+
+	if (	(end == argument)
+		|| (first >= HACK_RAM_SIZE)
+	) {
+		return 0;
+	}
+	ramArgument->first = (uint16_t)first;
+	ramArgument->last = (uint16_t)first;
+
+	if (*end == '\0') {
+		return (separator == '-') ? 1 : 0;
+	}
+	if (*end != separator) {
+		return 0;
+	}
+
+	argument = end + 1;
+	second = strtol(argument, &end, 10);
+	if (	(end == argument)
+		|| (*end != '\0')
+		|| (second < -32768)
+		|| (second > 65535)
+	) {
+		return 0;
+	}
+	ramArgument->last = (uint16_t)second;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ParseRamArgument
+***************************************************************************************************************
+*/
+
+static void PrintRun(const T_hackEmulator* emulator, E_hackStop stop, double seconds) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the number of executed instructions, the speed of the emulator and where it stopped
+
+	\param[in]		emulator		Pointer to emulator after the run
+	\param[in]		stop			Reason the run stopped
+	\param[in]		seconds		Duration of the run
+
+***************************************************************************************************************
+*/
+	static const char* const stopNames[] = { "halted", "ran past the end", "reached the instruction limit" };
+
+	printf("emulator: %llu instructions in %.3f ms, %.1f M instructions/s, %s at %u\n"
+			, (unsigned long long)emulator->executed, seconds * 1e3
+			, (seconds > 0.0) ? ((double)emulator->executed / seconds / 1e6) : 0.0
+			, stopNames[stop], emulator->pc);
+}
+/*
+***************************************************************************************************************
+	End PrintRun
+***************************************************************************************************************
+*/
+
+static void PrintInterpreterRun(const T_vmInterpreter* interpreter, E_vmStop stop, double seconds) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the number of executed VM commands, the speed of the interpreter and where it stopped
+
+	\param[in]		interpreter		Pointer to interpreter after the run
+	\param[in]		stop				Reason the run stopped
+	\param[in]		seconds			Duration of the run
+
+***************************************************************************************************************
+*/
+	static const char* const stopNames[] = { "halted", "ran past the end", "reached the command limit", "returned to an invalid address" };
+
+	printf("interpreter: %llu VM commands in %.3f ms, %.1f M commands/s, %s at operation %u\n"
+			, (unsigned long long)interpreter->executed, seconds * 1e3
+			, (seconds > 0.0) ? ((double)interpreter->executed / seconds / 1e6) : 0.0
+			, stopNames[stop], interpreter->pc);
+}
+/*
+***************************************************************************************************************
+	End PrintInterpreterRun
+***************************************************************************************************************
+*/
+
+static void PrintDumps(const T_emulatorOptions* options, const uint16_t* ram) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the RAM words that are asked for with -d, as signed values
+
+	\param[in]		options		Pointer to emulator options
+	\param[in]		ram			Pointer to RAM after the run
+
+***************************************************************************************************************
+*/
+	for (uint8_t i = 0; i < options->dumpCount; i++) {
+		printf("RAM[%u..%u]:", options->dumps[i].first, options->dumps[i].last);
+		for (uint32_t address = options->dumps[i].first; address <= options->dumps[i].last; address++) {
+			printf(" %d", (int16_t)ram[address]);
+		}
+		printf("\n");
+	}
+}
+/*
+***************************************************************************************************************
+	End PrintDumps
+***************************************************************************************************************
+*/
+
+static double GetSeconds(const struct timespec* start, const struct timespec* stop) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the time between two clock readings
+
+	\param[in]		start		Pointer to first reading
+	\param[in]		stop			Pointer to second reading
+
+	\returns
+		Time in seconds
+
+***************************************************************************************************************
+*/
+	return (double)(stop->tv_sec - start->tv_sec) + ((double)(stop->tv_nsec - start->tv_nsec) / 1e9);
+}
+/*
+***************************************************************************************************************
+	End GetSeconds
+***************************************************************************************************************
+*/
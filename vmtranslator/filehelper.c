@@ -1,211 +1,315 @@
-/*! \file
-***************************************************************************************************************
-file name:					filehelper.c
-*	\copyright				FourE
-*	\brief					filehelper source file
-*	\author					Frank Eggink
-*	\date	created:			2020-03-21
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include "filehelper.h"
-#include <stdio.h>
-#include <string.h>				// strlen
-#include <dirent.h>
-#include "stringhelper.h"
-
-/*
-***************************************************************************************************************
-	LOCAL DEFINES
-***************************************************************************************************************
-*/
-
-#define MAX_DIR_NAME_LENGTH	(50)
-
-/*
-***************************************************************************************************************
-	LOCAL TYPEDEFS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	IMPLEMENTATION
-***************************************************************************************************************
-*/
-
-E_inputFileType GetInputFileType(char* input) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function determines if input string is a .vm file or a directory that holds .vm files
-
-	\param[in]		input		Pointer to input string
-
-	\returns
-			IFT_SINGLE_VM_FILE	: input is a single .vm file
-			IFT_DIRECTORY			: input is a directory with .vm files inside
-			IFT_NONE					: no .vm files were found
-
-	\note
-		- make sure that input is not NULL
-		- make sure input string is nul terminated with '\0
-
-***************************************************************************************************************
-*/
-	E_inputFileType result = IFT_NONE;
-
-	// check if input is a single .vm file
-	if (HasFileNameExtension(input, ".vm") != 0) {
-		result = IFT_SINGLE_VM_FILE;
-	} else {
-		if (GetNumberOfFilesInDirectory(input, ".vm") > 0) {
-			result = IFT_DIRECTORY;
-		}
-	}
-	return result;
-}
-/*
-***************************************************************************************************************
-	End GetInputFileType
-***************************************************************************************************************
-*/
-
-void CreateOutputFileName(const char* input, char* output, E_inputFileType inputFileType) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function takes the input string (either fileName of directory name) and creates an output fileName (.asm)
-
-	\param[in]		input				Pointer to input string
-	\param[out]		output			Pointer to output string
-	\param[in]		inputFileType	File type of the input
-
-	\note
-		- make sure that both input and output are not NULL
-		- make sure input string is nul terminated with '\0
-		- make sure that output has atleast the same size as input
-
-***************************************************************************************************************
-*/
-	char directoryName[MAX_DIR_NAME_LENGTH] = { 0 };
-
-	memset(directoryName, 0, sizeof(directoryName));
-
-	switch (inputFileType) {
-	case IFT_SINGLE_VM_FILE:
-		// get rid of extension
-		StripExtension(input, output);
-		// add new extension
-		strcat(output, ".asm");
-		break;
-	case IFT_DIRECTORY:
-		// DIRECTORY
-		GetDirectoryNameAndLength(input, directoryName);
-		strcpy(output, input);
-		strcat(output, "/");  // this seems to work under windows (otherwise we would have added "\\")
-		strcat(output, directoryName);
-		strcat(output, ".asm");
-		break;
-	default:
-		break;
-	}
-}
-/*
-***************************************************************************************************************
-	End CreateOutputFileName
-***************************************************************************************************************
-*/
-
-int8_t GetNumberOfFilesInDirectory(char* directoryName, char* extension) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function removes the trailing whitespace from a string
-
-	\param[in]		input			Pointer to directory name
-	\param[in]		extension	Pointer to extension
-
-	\returns
-			0		: NO files were found with the specified extension in the directory
-			> 0	: the number or files found in the directory with the specified extension
-
-	\note
-		- make sure that both input and output are not NULL
-		- make sure input string is nul terminated with '\0
-
-***************************************************************************************************************
-*/
-	struct dirent *pDirent;
-	DIR *pDir;
-	uint8_t count = 0;
-
-	pDir = opendir(directoryName);
-	if (pDir == NULL) {
-		printf ("Cannot open directory '%s'\n", directoryName);
-		return -1;
-	}
-
-	pDirent = readdir(pDir);
-
-	while (pDirent != NULL) {
-	  if (HasFileNameExtension(pDirent->d_name, extension) != 0) {
-			printf ("[%s]\n", pDirent->d_name);
-			count++;
-	  }
-	  pDirent = readdir(pDir);
-	}
-
-	closedir (pDir);
-	return count;
-}
-/*
-***************************************************************************************************************
-	End GetNumberOfFilesInDirectory
-***************************************************************************************************************
-*/
+/*! \file
+***************************************************************************************************************
+file name:					filehelper.c
+*	\copyright				FourE
+*	\brief					filehelper source file
+*	\author					Frank Eggink
+*	\date	created:			2020-03-21
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "filehelper.h"
+#include <stdio.h>
+#include <stdlib.h>				// malloc, realloc, free, qsort
+#include <string.h>				// strlen, strcpy, strcmp
+#include <dirent.h>
+#include "stringhelper.h"
+#include "diagnostics.h"
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define MAX_DIR_NAME_LENGTH	(50)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static int CompareFileNames(const void* a, const void* b);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+E_inputFileType GetInputFileType(char* input) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function determines if input string is a .vm file or a directory that holds .vm files
+
+	\param[in]		input		Pointer to input string
+
+	\returns
+			IFT_SINGLE_VM_FILE	: input is a single .vm file
+			IFT_DIRECTORY			: input is a directory with .vm files inside
+			IFT_NONE					: no .vm files were found
+
+	\note
+		- make sure that input is not NULL
+		- make sure input string is nul terminated with '\0
+
+***************************************************************************************************************
+*/
+	E_inputFileType result = IFT_NONE;
+
+	// check if input is a single .vm file
+	if (HasFileNameExtension(input, ".vm") != 0) {
+		result = IFT_SINGLE_VM_FILE;
+	} else {
+		if (GetNumberOfFilesInDirectory(input, ".vm") > 0) {
+			result = IFT_DIRECTORY;
+		}
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End GetInputFileType
+***************************************************************************************************************
+*/
+
+void CreateOutputFileName(const char* input, char* output, E_inputFileType inputFileType, const char* extension) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function takes the input string (either fileName of directory name) and creates an output fileName
+
+	\param[in]		input				Pointer to input string
+	\param[out]		output			Pointer to output string
+	\param[in]		inputFileType	File type of the input
+	\param[in]		extension		Pointer to extension of the output file with '.' (".asm", ".hack")
+
+	\note
+		- make sure that both input and output are not NULL
+		- make sure input string is nul terminated with '\0
+		- make sure that output has atleast the same size as input
+
+***************************************************************************************************************
+*/
+	char directoryName[MAX_DIR_NAME_LENGTH] = { 0 };
+
+	memset(directoryName, 0, sizeof(directoryName));
+
+	switch (inputFileType) {
+	case IFT_SINGLE_VM_FILE:
+		// get rid of extension
+		StripExtension(input, output);
+		// add new extension
+		strcat(output, extension);
+		break;
+	case IFT_DIRECTORY:
+		// DIRECTORY
+		GetDirectoryNameAndLength(input, directoryName);
+		strcpy(output, input);
+		strcat(output, "/");  // this seems to work under windows (otherwise we would have added "\\")
+		strcat(output, directoryName);
+		strcat(output, extension);
+		break;
+	default:
+		break;
+	}
+}
+/*
+***************************************************************************************************************
+	End CreateOutputFileName
+***************************************************************************************************************
+*/
+
+int32_t GetNumberOfFilesInDirectory(char* directoryName, char* extension) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function removes the trailing whitespace from a string
+
+	\param[in]		input			Pointer to directory name
+	\param[in]		extension	Pointer to extension
+
+	\returns
+			0		: NO files were found with the specified extension in the directory
+			> 0	: the number or files found in the directory with the specified extension
+
+	\note
+		- make sure that both input and output are not NULL
+		- make sure input string is nul terminated with '\0
+
+***************************************************************************************************************
+*/
+	struct dirent *pDirent;
+	DIR *pDir;
+	int32_t count = 0;
+
+	pDir = opendir(directoryName);
+	if (pDir == NULL) {
+		DIAG_TRACE("cannot open directory '%s'", directoryName);
+		return -1;
+	}
+
+	pDirent = readdir(pDir);
+
+	while (pDirent != NULL) {
+	  if (HasFileNameExtension(pDirent->d_name, extension) != 0) {
+			DIAG_TRACE("[%s]", pDirent->d_name);
+			count++;
+	  }
+	  pDirent = readdir(pDir);
+	}
+
+	closedir (pDir);
+	return count;
+}
+/*
+***************************************************************************************************************
+	End GetNumberOfFilesInDirectory
+***************************************************************************************************************
+*/
+
+uint8_t ListVMFiles(const char* directory, char*** fileNames, uint32_t* count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function creates a sorted list of the .vm files in the specified directory
+
+	\param[in]		directory		Pointer to path string
+	\param[out]		fileNames		Pointer that receives the allocated array of allocated file names
+	\param[out]		count				Pointer that receives the number of file names
+
+	\returns
+			0: directory could not be opened or out of memory
+			1: list was created
+
+	\note
+		- the caller frees every file name and the array
+		- the order of readdir is not defined, the list is sorted to get the same output on every system
+
+***************************************************************************************************************
+*/
+	struct dirent *pDirent;
+	DIR *pDir;
+	char** names = NULL;
+	uint32_t capacity = 0;
+	uint32_t length = 0;
+	uint8_t result = 1;
+
+	pDir = opendir(directory);
+	if (pDir == NULL) {
+		DIAG_ERROR(DC_OPEN_DIRECTORY, directory, 0, 0, NULL);
+		return 0;
+	}
+
+	pDirent = readdir(pDir);
+
+	while ((pDirent != NULL) && (result != 0)) {
+		if (HasFileNameExtension(pDirent->d_name, ".vm") != 0) {
+			if (length == capacity) {
+				uint32_t newCapacity = (capacity == 0) ? 16 : (capacity * 2);
+				char** newNames = realloc(names, newCapacity * sizeof(char*));
+				if (newNames == NULL) {
+					result = 0;
+					break;
+				}
+				names = newNames;
+				capacity = newCapacity;
+			}
+			names[length] = malloc(strlen(pDirent->d_name) + 1);
+			if (names[length] == NULL) {
+				result = 0;
+				break;
+			}
+			strcpy(names[length], pDirent->d_name);
+			length++;
+		}
+		pDirent = readdir(pDir);
+	}
+	closedir (pDir);
+
+	if (result == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		for (uint32_t i = 0; i < length; i++) {
+			free(names[i]);
+		}
+		free(names);
+		return 0;
+	}
+
+	if (length > 1) {
+		qsort(names, length, sizeof(char*), CompareFileNames);
+	}
+
+	*fileNames = names;
+	*count = length;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ListVMFiles
+***************************************************************************************************************
+*/
+
+static int CompareFileNames(const void* a, const void* b) {
+/*!
+***************************************************************************************************************
+
+	\description
+		qsort compare function for file names
+
+***************************************************************************************************************
+*/
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+/*
+***************************************************************************************************************
+	End CompareFileNames
+***************************************************************************************************************
+*/
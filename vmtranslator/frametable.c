@@ -0,0 +1,835 @@
+/*! \file
+***************************************************************************************************************
+file name:					frametable.c
+*	\copyright				FourE
+*	\brief					frame table source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	A function gets a static frame when it is not in a cycle of the call graph, it is not the entry function,
+	it is defined once and its stack depth is 1 at every return (the caller's stack pointer is not restored by
+	a static return). The frame holds the return address, the pointers the function sets, its arguments and
+	its locals:
+
+		base								return address
+		base + 1 ..						saved THIS and/or THAT
+		arguments .. + argumentCount	arguments, popped there by the call site
+		locals .. + localCount		locals, set to 0 by the function
+
+	The components of the call graph are visited callers first, a frame starts behind the end of the frames
+	of all its callers, a dynamic function passes the start it gets on to its callees. When the frames need
+	more RAM than the limit, the function with the highest end gets a dynamic frame and the frames are placed
+	again.
+
+	A dynamic frame saves the pointers its function sets. A tail call reuses the frame of the caller and the
+	callee's return restores from it, so the functions that are connected by tail calls save the union of
+	their pointers. A tail call of a function that is not defined saves both.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "frametable.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, calloc, free
+#include <string.h>			// memset
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t AnalyzeFrame(const T_vmProgram* program, const T_callGraphFunction* function, T_labelDepth* labels, T_frameInfo* frame);
+static void TrimDynamicFrames(const T_callGraph* graph, T_vmProgram* const* programs, T_frameInfo* frames);
+static uint32_t PlaceFrames(const T_callGraph* graph, uint32_t components, const uint32_t* members, const uint32_t* firstMember, T_frameInfo* frames, uint32_t* start, uint32_t* highest);
+static uint32_t RewriteProgram(const T_callGraph* graph, const T_vmProgram* program, const T_frameInfo* frames, T_vmCommand* out);
+static uint32_t AddCommand(T_vmCommand* out, uint32_t count, E_commandType commandType, E_memorySegment memorySegment, uint16_t value, uint32_t nameId, const T_vmCommand* origin);
+static uint32_t FindCallee(const T_callGraph* graph, const T_vmProgram* program, const T_vmCommand* call);
+static uint16_t SaveAddress(const T_frameInfo* frame, uint8_t pointer);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InitFrameTable(T_frameTable* table) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an empty frame table, every function has a dynamic frame
+
+	\param[out]		table		Pointer to frame table
+
+	\returns
+			0: out of memory
+			1: table is initialized
+
+***************************************************************************************************************
+*/
+	memset(table, 0, sizeof(T_frameTable));
+	table->stackStart = STACK_START_ADDRESS;
+	return InitStringTable(&table->names);
+}
+/*
+***************************************************************************************************************
+	End InitFrameTable
+***************************************************************************************************************
+*/
+
+void FreeFrameTable(T_frameTable* table) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees all memory of a frame table
+
+	\param[in,out]	table		Pointer to frame table
+
+***************************************************************************************************************
+*/
+	FreeStringTable(&table->names);
+	free(table->frames);
+	memset(table, 0, sizeof(T_frameTable));
+	table->stackStart = STACK_START_ADDRESS;
+}
+/*
+***************************************************************************************************************
+	End FreeFrameTable
+***************************************************************************************************************
+*/
+
+uint8_t BuildFrameTable(T_frameTable* table, T_callGraph* graph, T_vmProgram* const* programs, uint32_t count, uint32_t entry, uint32_t staticLimit, uint8_t trimFrames) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function decides the frame of every function: the functions that are not recursive get a static frame
+		and the VM programs are rewritten to use them, the other frames save the pointers that are needed
+
+	\param[in,out]	table			Pointer to initialized frame table that receives the frames
+	\param[in,out]	graph			Pointer to call graph of the programs, its components are found
+	\param[in,out]	programs		Pointer to array of pointers to the VM programs the graph was built from
+	\param[in]		count			Number of VM programs
+	\param[in]		entry			Index of the entry function (it keeps its frame on the stack), FUNCTION_NONE
+	\param[in]		staticLimit	Largest number of words of all static frames together, 0: no static frames
+	\param[in]		trimFrames	1: dynamic frames only save the pointers their function sets, 0: both
+
+	\returns
+		0: out of memory (the programs are unchanged and every function keeps a dynamic frame)
+		1: frames are allocated
+
+	\note
+		- the function command of a static function is followed by the saves of the pointers and the zeroing
+		  of its locals, its local and argument accesses become frame accesses (MS_FRAME) at the fixed
+		  addresses and the pointers are restored before every return
+		- every call of a static function pops its arguments into the frame, the function and call commands
+		  keep their counts, the code writer knows from the frame table that the frame is not on the stack
+		- the graph keeps the original command ranges, they are no longer valid for the programs afterwards
+
+***************************************************************************************************************
+*/
+	uint32_t size = (graph->count > 0) ? graph->count : 1;
+	uint32_t components = FindComponents(graph);
+	T_frameInfo* frames = calloc(size, sizeof(T_frameInfo));
+	uint32_t* definitions = calloc((graph->nameCount > 0) ? graph->nameCount : 1, sizeof(uint32_t));
+	uint32_t* members = calloc(size, sizeof(uint32_t));
+	uint32_t* firstMember = calloc(((components != FUNCTION_NONE) ? components : 0) + 1, sizeof(uint32_t));
+	uint32_t* start = malloc(size * sizeof(uint32_t));
+	T_vmCommand** commands = calloc((count > 0) ? count : 1, sizeof(T_vmCommand*));
+	uint32_t* commandCounts = calloc((count > 0) ? count : 1, sizeof(uint32_t));
+	T_labelDepth* labels = NULL;
+	uint32_t longest = 1;
+	uint32_t words = 0;
+	uint32_t highest = FUNCTION_NONE;
+	uint8_t result = 1;
+
+	for (uint32_t f = 0; f < graph->count; f++) {
+		uint32_t length = graph->functions[f].endCommand - graph->functions[f].firstCommand;
+
+		if (length > longest) {
+			longest = length;
+		}
+	}
+	labels = malloc(longest * sizeof(T_labelDepth));
+
+	if (	(components == FUNCTION_NONE)
+		|| (frames == NULL)
+		|| (definitions == NULL)
+		|| (members == NULL)
+		|| (firstMember == NULL)
+		|| (start == NULL)
+		|| (commands == NULL)
+		|| (commandCounts == NULL)
+		|| (labels == NULL)
+	) {
+		result = 0;
+	}
+
+	if (result != 0) {
+		for (uint32_t f = 0; f < graph->count; f++) {
+			definitions[graph->functions[f].nameId]++;
+		}
+		for (uint32_t f = 0; f < graph->count; f++) {
+			const T_callGraphFunction* function = &graph->functions[f];
+
+			if (	(AnalyzeFrame(programs[function->program], function, labels, &frames[f]) != 0)
+				&& (staticLimit > 0)
+				&& (function->recursive == 0)
+				&& (f != entry)
+				&& (definitions[function->nameId] == 1)
+			) {
+				frames[f].isStatic = 1;
+			}
+		}
+
+		// a call site passes its number of arguments, the frame needs room for the largest call
+		for (uint32_t p = 0; p < count; p++) {
+			for (uint32_t i = 0; i < programs[p]->count; i++) {
+				const T_vmCommand* command = &programs[p]->commands[i];
+				uint32_t callee = FUNCTION_NONE;
+
+				if (command->commandType != CT_CALL) {
+					continue;
+				}
+				callee = FindCallee(graph, programs[p], command);
+				if (	(callee != FUNCTION_NONE)
+					&& (command->value > frames[callee].argumentCount)
+				) {
+					frames[callee].argumentCount = command->value;
+				}
+			}
+		}
+
+		// the members of every component, counting sort on the component index
+		for (uint32_t f = 0; f < graph->count; f++) {
+			firstMember[graph->functions[f].component + 1]++;
+		}
+		for (uint32_t c = 0; c < components; c++) {
+			firstMember[c + 1] += firstMember[c];
+		}
+		for (uint32_t f = 0; f < graph->count; f++) {
+			uint32_t c = graph->functions[f].component;
+
+			members[firstMember[c]] = f;
+			firstMember[c]++;
+		}
+		for (uint32_t c = components; c > 0; c--) {
+			firstMember[c] = firstMember[c - 1];
+		}
+		firstMember[0] = 0;
+
+		words = PlaceFrames(graph, components, members, firstMember, frames, start, &highest);
+		while (words > staticLimit) {
+			frames[highest].isStatic = 0;
+			words = PlaceFrames(graph, components, members, firstMember, frames, start, &highest);
+		}
+
+		for (uint32_t f = 0; f < graph->count; f++) {
+			T_frameInfo* frame = &frames[f];
+
+			if (frame->isStatic == 0) {
+				// the code writer finds a frame by name, a name defined twice keeps the full frame
+				if (	(trimFrames == 0)
+					|| (definitions[graph->functions[f].nameId] > 1)
+				) {
+					frame->savePointer[0] = 1;
+					frame->savePointer[1] = 1;
+				}
+				continue;
+			}
+			frame->base = (uint16_t)(STACK_START_ADDRESS + start[f]);
+			frame->arguments = frame->base + 1 + frame->savePointer[0] + frame->savePointer[1];
+			frame->locals = frame->arguments + frame->argumentCount;
+		}
+		if (trimFrames != 0) {
+			TrimDynamicFrames(graph, programs, frames);
+		}
+	}
+
+	// the programs are only replaced when all are rewritten
+	for (uint32_t p = 0; (p < count) && (result != 0); p++) {
+		commandCounts[p] = RewriteProgram(graph, programs[p], frames, NULL);
+		commands[p] = malloc(((commandCounts[p] > 0) ? commandCounts[p] : 1) * sizeof(T_vmCommand));
+		if (commands[p] == NULL) {
+			result = 0;
+		} else {
+			RewriteProgram(graph, programs[p], frames, commands[p]);
+		}
+	}
+
+	if (result != 0) {
+		table->frames = calloc((graph->nameCount > 0) ? graph->nameCount : 1, sizeof(T_frameInfo));
+		if (table->frames == NULL) {
+			result = 0;
+		}
+	}
+	for (uint32_t f = 0; (f < graph->count) && (result != 0); f++) {
+		uint32_t id = InternString(&table->names, GetString(&graph->names, graph->functions[f].nameId)
+											, GetStringLength(&graph->names, graph->functions[f].nameId));
+
+		if (	(id == STRING_ID_INVALID)
+			|| (id >= graph->nameCount)
+		) {
+			result = 0;
+		} else {
+			table->frames[id] = frames[f];
+			table->count = (id >= table->count) ? id + 1 : table->count;
+			table->staticCount += frames[f].isStatic;
+			if (	(frames[f].isStatic == 0)
+				&& ((frames[f].savePointer[0] & frames[f].savePointer[1]) == 0)
+			) {
+				table->trimmedCount++;
+			}
+		}
+	}
+
+	for (uint32_t p = 0; p < count; p++) {
+		if (commands[p] == NULL) {
+			continue;
+		}
+		if (result != 0) {
+			free(programs[p]->commands);
+			programs[p]->commands = commands[p];
+			programs[p]->count = commandCounts[p];
+			programs[p]->capacity = (commandCounts[p] > 0) ? commandCounts[p] : 1;
+		} else {
+			free(commands[p]);
+		}
+	}
+
+	if (result != 0) {
+		table->functionCount = graph->count;
+		table->stackStart = (uint16_t)(STACK_START_ADDRESS + words);
+	} else {
+		FreeFrameTable(table);
+		InitFrameTable(table);
+	}
+
+	free(frames);
+	free(definitions);
+	free(members);
+	free(firstMember);
+	free(start);
+	free(commands);
+	free(commandCounts);
+	free(labels);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End BuildFrameTable
+***************************************************************************************************************
+*/
+
+const T_frameInfo* FindFrame(const T_frameTable* table, const char* name, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the frame of a function by its name
+
+	\param[in]		table		Pointer to frame table
+	\param[in]		name		Pointer to function name
+	\param[in]		length	Length of the function name
+
+	\returns
+		Pointer to the frame, NULL when the function is not in the table
+
+	\note
+		- the table is not changed, so it can be searched by several threads at the same time
+
+***************************************************************************************************************
+*/
+	uint32_t id = STRING_ID_INVALID;
+
+	if (table->count == 0) {
+		return NULL;
+	}
+	id = FindString(&table->names, name, length);
+	if (	(id == STRING_ID_INVALID)
+		|| (id >= table->count)
+	) {
+		return NULL;
+	}
+	return &table->frames[id];
+}
+/*
+***************************************************************************************************************
+	End FindFrame
+***************************************************************************************************************
+*/
+
+void PrintFrameTable(const T_frameTable* table) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the number of static frames, the RAM they use and the number of trimmed frames
+
+	\param[in]		table		Pointer to frame table
+
+***************************************************************************************************************
+*/
+	printf("static frames: %u of %u functions, %u words at %u..%u\n", table->staticCount, table->functionCount
+			, table->stackStart - STACK_START_ADDRESS, STACK_START_ADDRESS, table->stackStart);
+	printf("trimmed frames: %u of %u frames on the stack save fewer pointers\n", table->trimmedCount
+			, table->functionCount - table->staticCount);
+}
+/*
+***************************************************************************************************************
+	End PrintFrameTable
+***************************************************************************************************************
+*/
+
+static uint8_t AnalyzeFrame(const T_vmProgram* program, const T_callGraphFunction* function, T_labelDepth* labels, T_frameInfo* frame) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks whether a function can have a static frame and collects what its frame holds
+
+	\param[in]		program		Pointer to VM program of the function
+	\param[in]		function		Pointer to function in the call graph
+	\param[out]		labels		Pointer to scratch array with an entry for every command of the function
+	\param[out]		frame			Pointer to frame that receives the arguments, locals and saved pointers
+
+	\returns
+		0: the function keeps a dynamic frame
+		1: the function can have a static frame (when it is not recursive)
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* body = &program->commands[function->firstCommand];
+	uint32_t length = function->endCommand - function->firstCommand;
+	uint8_t result = CheckStackDepth(program, function, labels);
+
+	memset(frame, 0, sizeof(T_frameInfo));
+	frame->localCount = body[0].value;
+
+	for (uint32_t i = 1; i < length; i++) {
+		const T_vmCommand* command = &body[i];
+
+		if (	(command->commandType != CT_PUSH)
+			&& (command->commandType != CT_POP)
+		) {
+			continue;
+		}
+
+		switch (command->memorySegment) {
+		case MS_ARGUMENT:
+			if (command->value >= frame->argumentCount) {
+				frame->argumentCount = command->value + 1;
+			}
+			break;
+		case MS_LOCAL:
+			// beyond its locals a function would access its own working stack
+			if (command->value >= frame->localCount) {
+				result = 0;
+			}
+			break;
+		case MS_POINTER:
+			if (command->value > 1) {
+				result = 0;
+			} else if (command->commandType == CT_POP) {
+				frame->savePointer[command->value] = 1;
+			}
+			break;
+		case MS_UNKNOWN:
+			result = 0;
+			break;
+		default:
+			break;
+		}
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End AnalyzeFrame
+***************************************************************************************************************
+*/
+
+static void TrimDynamicFrames(const T_callGraph* graph, T_vmProgram* const* programs, T_frameInfo* frames) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function makes the dynamic frames that are connected by tail calls save the same pointers
+
+	\param[in]		graph			Pointer to call graph of the programs
+	\param[in]		programs		Pointer to array of pointers to the VM programs the graph was built from
+	\param[in,out]	frames		Pointer to frame of every function, the dynamic ones save their own pointers
+
+	\note
+		- the pointers are merged over every "call f n, return" pair until nothing changes, a chain of tail
+		  calls takes a pass per link
+
+***************************************************************************************************************
+*/
+	uint8_t changed = 1;
+
+	while (changed != 0) {
+		changed = 0;
+
+		for (uint32_t f = 0; f < graph->count; f++) {
+			const T_callGraphFunction* function = &graph->functions[f];
+			const T_vmProgram* program = programs[function->program];
+			T_frameInfo* frame = &frames[f];
+
+			if (frame->isStatic != 0) {
+				continue;
+			}
+			for (uint32_t i = function->firstCommand; (i + 1) < function->endCommand; i++) {
+				uint32_t callee = FUNCTION_NONE;
+
+				if (	(program->commands[i].commandType != CT_CALL)
+					|| (program->commands[i + 1].commandType != CT_RETURN)
+				) {
+					continue;
+				}
+				callee = FindCallee(graph, program, &program->commands[i]);
+				if (	(callee != FUNCTION_NONE)
+					&& (frames[callee].isStatic != 0)
+				) {
+					// a dynamic frame is not reused by a static callee
+					continue;
+				}
+				for (uint8_t p = 0; p < 2; p++) {
+					uint8_t save = (callee == FUNCTION_NONE) ? 1 : (frame->savePointer[p] | frames[callee].savePointer[p]);
+
+					if (frame->savePointer[p] != save) {
+						frame->savePointer[p] = save;
+						changed = 1;
+					}
+					if (	(callee != FUNCTION_NONE)
+						&& (frames[callee].savePointer[p] != save)
+					) {
+						frames[callee].savePointer[p] = save;
+						changed = 1;
+					}
+				}
+			}
+		}
+	}
+}
+/*
+***************************************************************************************************************
+	End TrimDynamicFrames
+***************************************************************************************************************
+*/
+
+static uint32_t PlaceFrames(const T_callGraph* graph, uint32_t components, const uint32_t* members, const uint32_t* firstMember, T_frameInfo* frames, uint32_t* start, uint32_t* highest) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function places the static frames behind the frames of all their callers
+
+	\param[in]		graph				Pointer to call graph with components
+	\param[in]		components		Number of components
+	\param[in]		members			Pointer to functions sorted on component
+	\param[in]		firstMember		Pointer to index in members of the first function of every component
+	\param[in]		frames			Pointer to frame of every function, isStatic selects the static ones
+	\param[out]		start				Pointer to offset of every static frame from STACK_START_ADDRESS
+	\param[out]		highest			Pointer to static function whose frame ends last, FUNCTION_NONE for none
+
+	\returns
+		Number of words of all static frames together
+
+	\note
+		- a component is numbered after the components it calls, so decreasing order visits callers first
+
+***************************************************************************************************************
+*/
+	uint32_t words = 0;
+
+	*highest = FUNCTION_NONE;
+	for (uint32_t c = 0; c < components; c++) {
+		for (uint32_t m = firstMember[c]; m < firstMember[c + 1]; m++) {
+			start[members[m]] = 0;
+		}
+	}
+
+	for (uint32_t c = components; c > 0; c--) {
+		uint32_t componentStart = 0;
+
+		// the callers of all components are placed, a recursive component starts behind the callers of all its
+		// members (any member can be active when one of them is called)
+		for (uint32_t m = firstMember[c - 1]; m < firstMember[c]; m++) {
+			if (start[members[m]] > componentStart) {
+				componentStart = start[members[m]];
+			}
+		}
+
+		for (uint32_t m = firstMember[c - 1]; m < firstMember[c]; m++) {
+			uint32_t f = members[m];
+			const T_callGraphFunction* function = &graph->functions[f];
+			const T_frameInfo* frame = &frames[f];
+			uint32_t end = componentStart;
+
+			start[f] = componentStart;
+			if (frame->isStatic != 0) {
+				end += 1 + frame->savePointer[0] + frame->savePointer[1] + frame->argumentCount + frame->localCount;
+				if (end > words) {
+					words = end;
+					*highest = f;
+				}
+			}
+
+			// the callees in other components start behind the frame
+			for (uint32_t i = 0; i < function->calleeCount; i++) {
+				uint32_t callee = graph->callees[function->firstCallee + i];
+
+				if (callee == FUNCTION_NONE) {
+					continue;
+				}
+				if (graph->functions[callee].component == c - 1) {
+					continue;
+				}
+				if (end > start[callee]) {
+					start[callee] = end;
+				}
+			}
+		}
+	}
+	return words;
+}
+/*
+***************************************************************************************************************
+	End PlaceFrames
+***************************************************************************************************************
+*/
+
+static uint32_t RewriteProgram(const T_callGraph* graph, const T_vmProgram* program, const T_frameInfo* frames, T_vmCommand* out) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the commands of a VM program with the accesses and calls of the static frames
+
+	\param[in]		graph			Pointer to call graph of the programs
+	\param[in]		program		Pointer to VM program
+	\param[in]		frames		Pointer to frame of every function of the graph
+	\param[out]		out			Pointer to array that receives the commands, NULL to only count them
+
+	\returns
+		Number of commands of the rewritten program
+
+***************************************************************************************************************
+*/
+	const T_frameInfo* frame = NULL;
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < program->count; i++) {
+		const T_vmCommand* command = &program->commands[i];
+		uint32_t callee = FUNCTION_NONE;
+
+		switch (command->commandType) {
+		case CT_FUNCTION:
+			callee = FindCallee(graph, program, command);
+			frame = ((callee != FUNCTION_NONE) && (frames[callee].isStatic != 0)) ? &frames[callee] : NULL;
+			if (frame == NULL) {
+				break;
+			}
+			count = AddCommand(out, count, CT_FUNCTION, MS_UNKNOWN, command->value, command->nameId, command);
+			for (uint8_t p = 0; p < 2; p++) {
+				if (frame->savePointer[p] != 0) {
+					count = AddCommand(out, count, CT_PUSH, MS_POINTER, p, STRING_ID_NONE, command);
+					count = AddCommand(out, count, CT_POP, MS_FRAME, SaveAddress(frame, p)
+											, STRING_ID_NONE, command);
+				}
+			}
+			for (uint16_t l = 0; l < frame->localCount; l++) {
+				count = AddCommand(out, count, CT_PUSH, MS_CONSTANT, 0, STRING_ID_NONE, command);
+				count = AddCommand(out, count, CT_POP, MS_FRAME, frame->locals + l, STRING_ID_NONE, command);
+			}
+			continue;
+		case CT_PUSH:
+		case CT_POP:
+			if (frame == NULL) {
+				break;
+			}
+			if (command->memorySegment == MS_LOCAL) {
+				count = AddCommand(out, count, (E_commandType)command->commandType, MS_FRAME, frame->locals + command->value
+										, command->nameId, command);
+				continue;
+			}
+			if (command->memorySegment == MS_ARGUMENT) {
+				count = AddCommand(out, count, (E_commandType)command->commandType, MS_FRAME, frame->arguments + command->value
+										, command->nameId, command);
+				continue;
+			}
+			break;
+		case CT_RETURN:
+			if (frame == NULL) {
+				break;
+			}
+			for (uint8_t p = 0; p < 2; p++) {
+				if (frame->savePointer[p] != 0) {
+					count = AddCommand(out, count, CT_PUSH, MS_FRAME, SaveAddress(frame, p)
+											, STRING_ID_NONE, command);
+					count = AddCommand(out, count, CT_POP, MS_POINTER, p, STRING_ID_NONE, command);
+				}
+			}
+			break;
+		case CT_CALL:
+			callee = FindCallee(graph, program, command);
+			if (	(callee == FUNCTION_NONE)
+				|| (frames[callee].isStatic == 0)
+			) {
+				break;
+			}
+			for (uint16_t a = command->value; a > 0; a--) {
+				count = AddCommand(out, count, CT_POP, MS_FRAME, frames[callee].arguments + a - 1
+										, STRING_ID_NONE, command);
+			}
+			count = AddCommand(out, count, CT_CALL, MS_UNKNOWN, command->value, command->nameId, command);
+			continue;
+		default:
+			break;
+		}
+
+		if (out != NULL) {
+			out[count] = *command;
+		}
+		count++;
+	}
+	return count;
+}
+/*
+***************************************************************************************************************
+	End RewriteProgram
+***************************************************************************************************************
+*/
+
+static uint32_t AddCommand(T_vmCommand* out, uint32_t count, E_commandType commandType, E_memorySegment memorySegment, uint16_t value, uint32_t nameId, const T_vmCommand* origin) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes a new command behind the commands that are already written
+
+	\param[out]		out				Pointer to array that receives the command, NULL to only count it
+	\param[in]		count				Number of commands that are already written
+	\param[in]		commandType		Command type
+	\param[in]		memorySegment	Memory segment
+	\param[in]		value				Index or count of the command
+	\param[in]		nameId			ID of the name in the string table of the program
+	\param[in]		origin			Pointer to command it is generated for, its position is reported
+
+	\returns
+		Number of commands after the new one
+
+***************************************************************************************************************
+*/
+	if (out != NULL) {
+		out[count].commandType = (uint8_t)commandType;
+		out[count].memorySegment = (uint8_t)memorySegment;
+		out[count].value = value;
+		out[count].nameId = nameId;
+		out[count].lineNumber = origin->lineNumber;
+		out[count].column = origin->column;
+	}
+	return count + 1;
+}
+/*
+***************************************************************************************************************
+	End AddCommand
+***************************************************************************************************************
+*/
+
+static uint32_t FindCallee(const T_callGraph* graph, const T_vmProgram* program, const T_vmCommand* call) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the function that a call or function command names
+
+	\param[in]		graph			Pointer to call graph
+	\param[in]		program		Pointer to VM program of the command
+	\param[in]		call			Pointer to call or function command
+
+	\returns
+		Index of the function, FUNCTION_NONE when the function is not defined
+
+***************************************************************************************************************
+*/
+	return FindFunction(graph, GetString(&program->names, call->nameId));
+}
+/*
+***************************************************************************************************************
+	End FindCallee
+***************************************************************************************************************
+*/
+
+static uint16_t SaveAddress(const T_frameInfo* frame, uint8_t pointer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the address in a static frame where the caller's value of a pointer is saved
+
+	\param[in]		frame			Pointer to static frame
+	\param[in]		pointer		0: THIS, 1: THAT
+
+	\returns
+		Address of the saved pointer
+
+	\note
+		- THAT follows THIS when the function sets both
+
+***************************************************************************************************************
+*/
+	return frame->base + 1 + ((pointer == 1) ? frame->savePointer[0] : 0);
+}
+/*
+***************************************************************************************************************
+	End SaveAddress
+***************************************************************************************************************
+*/
@@ -0,0 +1,123 @@
+/*! \file
+***************************************************************************************************************
+file name:					frametable.h
+*	\copyright				FourE
+*	\brief					frame table header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Frames of the functions of a whole program: the functions that are not recursive get a frame at a fixed
+	address, the others keep their frame on the stack. A frame on the stack only needs to save the THIS and
+	THAT of the caller when the function sets them.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The static frames overlay each other like a compiled stack: two functions share RAM when they can never be
+	active at the same time. The frames are placed from STACK_START_ADDRESS on and the stack starts behind
+	them. The local and argument accesses of a function with a static frame are rewritten to frame accesses
+	(MS_FRAME) at the fixed addresses, so the code writer only has to change the call, function and return
+	commands.
+
+	Every function restores the pointers it sets before it returns, so a call only clobbers what the callee
+	sets itself. LCL and ARG are always part of a frame on the stack, the return finds the frame through
+	them. A frame on the stack keeps its 5 words, the slots of pointers that are not saved are skipped.
+
+***************************************************************************************************************
+*/
+
+#ifndef __FRAMETABLE_H
+#define __FRAMETABLE_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "parser.h"
+#include "callgraph.h"
+#include "stringtable.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define STACK_START_ADDRESS		(256)		// address of the stack when there are no static frames
+#define MAX_STATIC_FRAME_WORDS	(512)		// RAM for static frames, the rest up to the heap is left to the stack
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// frame of one function, the addresses are only valid for a static frame
+typedef struct {
+	uint8_t isStatic;						// 1: the frame is at a fixed address, 0: the frame is on the stack
+	uint8_t savePointer[2];				// 1: the frame saves the caller's THIS (0) or THAT (1)
+	uint16_t base;							// address of the return address, the saved pointers follow it
+	uint16_t arguments;					// address of argument 0
+	uint16_t argumentCount;				// arguments of the largest call, at least the ones that are accessed
+	uint16_t locals;						// address of local 0
+	uint16_t localCount;
+} T_frameInfo;
+
+typedef struct {
+	T_stringTable names;					// names of the functions, the ID is the index in frames
+	T_frameInfo* frames;
+	uint32_t count;						// number of entries in frames
+	uint32_t functionCount;				// number of functions in the program
+	uint32_t staticCount;				// number of functions with a static frame
+	uint32_t trimmedCount;				// number of frames on the stack that save fewer than both pointers
+	uint16_t stackStart;					// address of the stack, the static frames are below it
+} T_frameTable;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InitFrameTable(T_frameTable* table);
+void FreeFrameTable(T_frameTable* table);
+uint8_t BuildFrameTable(T_frameTable* table, T_callGraph* graph, T_vmProgram* const* programs, uint32_t count, uint32_t entry, uint32_t staticLimit, uint8_t trimFrames);
+const T_frameInfo* FindFrame(const T_frameTable* table, const char* name, uint32_t length);
+void PrintFrameTable(const T_frameTable* table);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __FRAMETABLE_H
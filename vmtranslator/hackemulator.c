@@ -0,0 +1,729 @@
+/*! \file
+***************************************************************************************************************
+file name:					hackemulator.c
+*	\copyright				FourE
+*	\brief					Hack CPU emulator source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The 28 comps of the Hack specification have their own operation, any other comp is computed from its bits
+	like the ALU does. The dest and jump bits are constants in every store and jump operation, so only the
+	stores and the compare of that combination remain after compilation.
+
+	The instruction limit is only checked when a jump is taken: a program without jumps ends by itself, so
+	the limit can be passed by at most the length of the code between two jumps.
+
+	"@L" at address L followed by an unconditional jump without destination is the endless loop a program
+	ends with, it is predecoded as halt.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "hackemulator.h"
+#include "diagnostics.h"
+#include "hackprogram.h"
+#include "sourcereader.h"
+#include <stdio.h>				// snprintf
+#include <stdlib.h>			// malloc, calloc, free
+#include <string.h>			// memset, strrchr, strcmp
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define STORE_COUNT				(64)				// dest bits | jump bits << 3
+#define MAX_DETAIL_TEXT			(40)				// characters of a line that are reported
+
+// the memory word the A register points at
+#define MEMORY						(ram[a & HACK_ADDRESS_MASK])
+
+// continues with the next operation
+#define NEXT()						goto *(++operation)->handler
+
+// operation of a comp: computes the result and continues with the store and jump operation
+#define COMPUTE(label, expression) \
+	label: \
+		result = (uint16_t)(expression); \
+		executed++; \
+		goto *operation->store;
+
+#define IS_JUMP_TAKEN(jump, value) \
+	(		((((jump) & 4) != 0) && ((int16_t)(value) < 0)) \
+		||	((((jump) & 2) != 0) && ((value) == 0)) \
+		||	((((jump) & 1) != 0) && ((int16_t)(value) > 0)) \
+	)
+
+// store and jump operation, the A register that addresses M and the jump is the one before the store
+#define STORE_AND_JUMP(index) \
+	store##index: \
+		target = a; \
+		if (((index) & DEST_M) != 0) { \
+			ram[a & HACK_ADDRESS_MASK] = result; \
+		} \
+		if (((index) & DEST_D) != 0) { \
+			d = result; \
+		} \
+		if (((index) & DEST_A) != 0) { \
+			a = result; \
+		} \
+		if (IS_JUMP_TAKEN((index) >> 3, result)) { \
+			operation = &rom[target & HACK_ADDRESS_MASK]; \
+			if (executed >= limit) { \
+				stop = HS_LIMIT; \
+				goto stopped; \
+			} \
+			goto *operation->handler; \
+		} \
+		NEXT();
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 OP_ALU = 0								// comp that is not in the Hack specification
+	,OP_LOAD_A
+	,OP_HALT
+	,OP_END
+	,OP_ZERO
+	,OP_ONE
+	,OP_MINUS_ONE
+	,OP_D
+	,OP_A
+	,OP_NOT_D
+	,OP_NOT_A
+	,OP_NEG_D
+	,OP_NEG_A
+	,OP_D_PLUS_1
+	,OP_A_PLUS_1
+	,OP_D_MINUS_1
+	,OP_A_MINUS_1
+	,OP_D_PLUS_A
+	,OP_D_MINUS_A
+	,OP_A_MINUS_D
+	,OP_D_AND_A
+	,OP_D_OR_A
+	,OP_M
+	,OP_NOT_M
+	,OP_NEG_M
+	,OP_M_PLUS_1
+	,OP_M_MINUS_1
+	,OP_D_PLUS_M
+	,OP_D_MINUS_M
+	,OP_M_MINUS_D
+	,OP_D_AND_M
+	,OP_D_OR_M
+	,OP_COUNT
+} E_hackOperation;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static void DecodeWord(T_hackOperation* operation, uint16_t word);
+static uint16_t ComputeAlu(uint8_t comp, uint16_t x, uint16_t y);
+static uint8_t LoadAssemblyFile(T_hackEmulator* emulator, const char* fileName, T_sourceReader* reader);
+static uint8_t LoadHackText(T_hackEmulator* emulator, const char* fileName, T_sourceReader* reader);
+static uint8_t LoadHackBinary(T_hackEmulator* emulator, const char* fileName, const T_sourceReader* reader);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// indexed by the comp field, OP_ALU: not a comp of the Hack specification
+static const uint8_t compOperations[128] = {
+	 [0x2A] = OP_ZERO, [0x3F] = OP_ONE, [0x3A] = OP_MINUS_ONE, [0x0C] = OP_D, [0x30] = OP_A
+	,[0x0D] = OP_NOT_D, [0x31] = OP_NOT_A, [0x0F] = OP_NEG_D, [0x33] = OP_NEG_A, [0x1F] = OP_D_PLUS_1
+	,[0x37] = OP_A_PLUS_1, [0x0E] = OP_D_MINUS_1, [0x32] = OP_A_MINUS_1, [0x02] = OP_D_PLUS_A
+	,[0x13] = OP_D_MINUS_A, [0x07] = OP_A_MINUS_D, [0x00] = OP_D_AND_A, [0x15] = OP_D_OR_A
+	,[0x70] = OP_M, [0x71] = OP_NOT_M, [0x73] = OP_NEG_M, [0x77] = OP_M_PLUS_1, [0x72] = OP_M_MINUS_1
+	,[0x42] = OP_D_PLUS_M, [0x53] = OP_D_MINUS_M, [0x47] = OP_M_MINUS_D, [0x40] = OP_D_AND_M
+	,[0x55] = OP_D_OR_M
+};
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InitHackEmulator(T_hackEmulator* emulator) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an emulator with an empty ROM and cleared RAM
+
+	\param[out]		emulator		Pointer to emulator
+
+	\returns
+			0: out of memory
+			1: emulator is initialized
+
+***************************************************************************************************************
+*/
+	memset(emulator, 0, sizeof(T_hackEmulator));
+	emulator->rom = calloc(ROM_SIZE + 1, sizeof(T_hackOperation));
+	if (emulator->rom == NULL) {
+		return 0;
+	}
+	return LoadMachineCode(emulator, NULL, 0);
+}
+/*
+***************************************************************************************************************
+	End InitHackEmulator
+***************************************************************************************************************
+*/
+
+void FreeHackEmulator(T_hackEmulator* emulator) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the ROM of an emulator
+
+	\param[in,out]	emulator		Pointer to emulator
+
+***************************************************************************************************************
+*/
+	free(emulator->rom);
+	memset(emulator, 0, sizeof(T_hackEmulator));
+}
+/*
+***************************************************************************************************************
+	End FreeHackEmulator
+***************************************************************************************************************
+*/
+
+uint8_t LoadMachineCode(T_hackEmulator* emulator, const uint16_t* words, uint32_t count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function predecodes machine code into the ROM and resets the CPU and the RAM
+
+	\param[in,out]	emulator		Pointer to emulator
+	\param[in]		words			Pointer to machine code
+	\param[in]		count			Number of words
+
+	\returns
+			0: the program does not fit in ROM (the error is reported)
+			1: program is loaded
+
+***************************************************************************************************************
+*/
+	T_hackOperation* rom = emulator->rom;
+
+	if (count > ROM_SIZE) {
+		DIAG_ERROR(DC_ENCODING, NULL, 0, 0, "program does not fit in ROM");
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		DecodeWord(&rom[i], words[i]);
+	}
+	for (uint32_t i = count; i <= ROM_SIZE; i++) {
+		memset(&rom[i], 0, sizeof(T_hackOperation));
+		rom[i].operation = OP_END;
+	}
+
+	for (uint32_t i = 0; (i + 1) < count; i++) {
+		if (	(rom[i].operation == OP_LOAD_A)
+			&& (rom[i].value == i)
+			&& (rom[i + 1].operation != OP_LOAD_A)
+			&& (rom[i + 1].storeIndex == (7 << 3))
+		) {
+			rom[i].operation = OP_HALT;
+		}
+	}
+
+	memset(emulator->ram, 0, sizeof(emulator->ram));
+	emulator->size = count;
+	emulator->a = 0;
+	emulator->d = 0;
+	emulator->pc = 0;
+	emulator->executed = 0;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End LoadMachineCode
+***************************************************************************************************************
+*/
+
+uint8_t LoadHackFile(T_hackEmulator* emulator, const char* fileName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function loads a program from a file, the extension selects the format: Hack assembly code (.asm),
+		machine code as text (.hack) or as binary image (.bin)
+
+	\param[in,out]	emulator		Pointer to emulator
+	\param[in]		fileName		Pointer to name of the file
+
+	\returns
+			0: the file could not be read or is not valid (the error is reported)
+			1: program is loaded
+
+***************************************************************************************************************
+*/
+	const char* extension = strrchr(fileName, '.');
+	T_sourceReader reader;
+	uint8_t result = 0;
+
+	if (OpenSourceReader(&reader, fileName) == 0) {
+		DIAG_ERROR(DC_OPEN_INPUT, fileName, 0, 0, NULL);
+		return 0;
+	}
+
+	if (	(extension != NULL)
+		&& (strcmp(extension, GetOutputExtension(OF_HACK_TEXT)) == 0)
+	) {
+		result = LoadHackText(emulator, fileName, &reader);
+	} else if (	(extension != NULL)
+				&& (strcmp(extension, GetOutputExtension(OF_HACK_BINARY)) == 0)
+	) {
+		result = LoadHackBinary(emulator, fileName, &reader);
+	} else {
+		result = LoadAssemblyFile(emulator, fileName, &reader);
+	}
+
+	CloseSourceReader(&reader);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LoadHackFile
+***************************************************************************************************************
+*/
+
+E_hackStop RunHackEmulator(T_hackEmulator* emulator, uint64_t limit) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function runs the program from the current program counter until it halts, runs past its end or
+		reaches the instruction limit
+
+	\param[in,out]	emulator		Pointer to emulator with a loaded program
+	\param[in]		limit			Number of executed instructions after which the run stops,
+										NO_INSTRUCTION_LIMIT for none
+
+	\returns
+		Reason the run stopped, the program counter is the instruction that was not executed
+
+	\note
+		- the registers are kept in local variables during the run, they are stored in the emulator at the end
+
+***************************************************************************************************************
+*/
+	static const void* const operationLabels[OP_COUNT] = {
+		 [OP_ALU] = &&alu, [OP_LOAD_A] = &&loadA, [OP_HALT] = &&halt, [OP_END] = &&end
+		,[OP_ZERO] = &&zero, [OP_ONE] = &&one, [OP_MINUS_ONE] = &&minusOne, [OP_D] = &&dRegister
+		,[OP_A] = &&aRegister, [OP_NOT_D] = &&notD, [OP_NOT_A] = &&notA, [OP_NEG_D] = &&negD
+		,[OP_NEG_A] = &&negA, [OP_D_PLUS_1] = &&dPlus1, [OP_A_PLUS_1] = &&aPlus1, [OP_D_MINUS_1] = &&dMinus1
+		,[OP_A_MINUS_1] = &&aMinus1, [OP_D_PLUS_A] = &&dPlusA, [OP_D_MINUS_A] = &&dMinusA
+		,[OP_A_MINUS_D] = &&aMinusD, [OP_D_AND_A] = &&dAndA, [OP_D_OR_A] = &&dOrA, [OP_M] = &&memory
+		,[OP_NOT_M] = &&notM, [OP_NEG_M] = &&negM, [OP_M_PLUS_1] = &&mPlus1, [OP_M_MINUS_1] = &&mMinus1
+		,[OP_D_PLUS_M] = &&dPlusM, [OP_D_MINUS_M] = &&dMinusM, [OP_M_MINUS_D] = &&mMinusD
+		,[OP_D_AND_M] = &&dAndM, [OP_D_OR_M] = &&dOrM
+	};
+	static const void* const storeLabels[STORE_COUNT] = {
+		 &&store0, &&store1, &&store2, &&store3, &&store4, &&store5, &&store6, &&store7
+		,&&store8, &&store9, &&store10, &&store11, &&store12, &&store13, &&store14, &&store15
+		,&&store16, &&store17, &&store18, &&store19, &&store20, &&store21, &&store22, &&store23
+		,&&store24, &&store25, &&store26, &&store27, &&store28, &&store29, &&store30, &&store31
+		,&&store32, &&store33, &&store34, &&store35, &&store36, &&store37, &&store38, &&store39
+		,&&store40, &&store41, &&store42, &&store43, &&store44, &&store45, &&store46, &&store47
+		,&&store48, &&store49, &&store50, &&store51, &&store52, &&store53, &&store54, &&store55
+		,&&store56, &&store57, &&store58, &&store59, &&store60, &&store61, &&store62, &&store63
+	};
+	uint16_t* const ram = emulator->ram;
+	T_hackOperation* const rom = emulator->rom;
+	const T_hackOperation* operation = NULL;
+	uint64_t executed = emulator->executed;
+	uint16_t a = emulator->a;
+	uint16_t d = emulator->d;
+	uint16_t result = 0;
+	uint16_t target = 0;
+	E_hackStop stop = HS_END;
+
+	// thread the code: the labels are only known inside this function
+	for (uint32_t i = 0; i <= ROM_SIZE; i++) {
+		rom[i].handler = operationLabels[rom[i].operation];
+		rom[i].store = storeLabels[rom[i].storeIndex];
+	}
+
+	operation = &rom[emulator->pc];
+	if (executed >= limit) {
+		return HS_LIMIT;
+	}
+	goto *operation->handler;
+
+loadA:
+	a = operation->value;
+	executed++;
+	NEXT();
+
+alu:
+	result = ComputeAlu((uint8_t)operation->value, d, ((operation->value & COMP_A_BIT) != 0) ? MEMORY : a);
+	executed++;
+	goto *operation->store;
+
+	COMPUTE(zero		, 0)
+	COMPUTE(one			, 1)
+	COMPUTE(minusOne	, 0xFFFF)
+	COMPUTE(dRegister	, d)
+	COMPUTE(aRegister	, a)
+	COMPUTE(notD		, ~d)
+	COMPUTE(notA		, ~a)
+	COMPUTE(negD		, -d)
+	COMPUTE(negA		, -a)
+	COMPUTE(dPlus1		, d + 1)
+	COMPUTE(aPlus1		, a + 1)
+	COMPUTE(dMinus1	, d - 1)
+	COMPUTE(aMinus1	, a - 1)
+	COMPUTE(dPlusA		, d + a)
+	COMPUTE(dMinusA	, d - a)
+	COMPUTE(aMinusD	, a - d)
+	COMPUTE(dAndA		, d & a)
+	COMPUTE(dOrA		, d | a)
+	COMPUTE(memory		, MEMORY)
+	COMPUTE(notM		, ~MEMORY)
+	COMPUTE(negM		, -MEMORY)
+	COMPUTE(mPlus1		, MEMORY + 1)
+	COMPUTE(mMinus1	, MEMORY - 1)
+	COMPUTE(dPlusM		, d + MEMORY)
+	COMPUTE(dMinusM	, d - MEMORY)
+	COMPUTE(mMinusD	, MEMORY - d)
+	COMPUTE(dAndM		, d & MEMORY)
+	COMPUTE(dOrM		, d | MEMORY)
+
+	STORE_AND_JUMP(0)  STORE_AND_JUMP(1)  STORE_AND_JUMP(2)  STORE_AND_JUMP(3)
+	STORE_AND_JUMP(4)  STORE_AND_JUMP(5)  STORE_AND_JUMP(6)  STORE_AND_JUMP(7)
+	STORE_AND_JUMP(8)  STORE_AND_JUMP(9)  STORE_AND_JUMP(10) STORE_AND_JUMP(11)
+	STORE_AND_JUMP(12) STORE_AND_JUMP(13) STORE_AND_JUMP(14) STORE_AND_JUMP(15)
+	STORE_AND_JUMP(16) STORE_AND_JUMP(17) STORE_AND_JUMP(18) STORE_AND_JUMP(19)
+	STORE_AND_JUMP(20) STORE_AND_JUMP(21) STORE_AND_JUMP(22) STORE_AND_JUMP(23)
+	STORE_AND_JUMP(24) STORE_AND_JUMP(25) STORE_AND_JUMP(26) STORE_AND_JUMP(27)
+	STORE_AND_JUMP(28) STORE_AND_JUMP(29) STORE_AND_JUMP(30) STORE_AND_JUMP(31)
+	STORE_AND_JUMP(32) STORE_AND_JUMP(33) STORE_AND_JUMP(34) STORE_AND_JUMP(35)
+	STORE_AND_JUMP(36) STORE_AND_JUMP(37) STORE_AND_JUMP(38) STORE_AND_JUMP(39)
+	STORE_AND_JUMP(40) STORE_AND_JUMP(41) STORE_AND_JUMP(42) STORE_AND_JUMP(43)
+	STORE_AND_JUMP(44) STORE_AND_JUMP(45) STORE_AND_JUMP(46) STORE_AND_JUMP(47)
+	STORE_AND_JUMP(48) STORE_AND_JUMP(49) STORE_AND_JUMP(50) STORE_AND_JUMP(51)
+	STORE_AND_JUMP(52) STORE_AND_JUMP(53) STORE_AND_JUMP(54) STORE_AND_JUMP(55)
+	STORE_AND_JUMP(56) STORE_AND_JUMP(57) STORE_AND_JUMP(58) STORE_AND_JUMP(59)
+	STORE_AND_JUMP(60) STORE_AND_JUMP(61) STORE_AND_JUMP(62) STORE_AND_JUMP(63)
+
+halt:
+	stop = HS_HALTED;
+	goto stopped;
+
+end:
+	stop = HS_END;
+
+stopped:
+	emulator->a = a;
+	emulator->d = d;
+	emulator->pc = (uint16_t)(operation - rom);
+	emulator->executed = executed;
+	return stop;
+}
+/*
+***************************************************************************************************************
+	End RunHackEmulator
+***************************************************************************************************************
+*/
+
+static void DecodeWord(T_hackOperation* operation, uint16_t word) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function predecodes a machine word into an operation
+
+	\param[out]		operation		Pointer to operation
+	\param[in]		word				Machine word
+
+	\note
+		- every word with the most significant bit set is a C-instruction, the two unused bits are ignored
+
+***************************************************************************************************************
+*/
+	memset(operation, 0, sizeof(T_hackOperation));
+
+	if ((word & 0x8000) == 0) {
+		operation->operation = OP_LOAD_A;
+		operation->value = word;
+		return;
+	}
+	operation->value = (word >> 6) & 0x7F;
+	operation->operation = compOperations[operation->value];
+	operation->storeIndex = (uint8_t)(((word >> 3) & 7) | ((word & 7) << 3));
+}
+/*
+***************************************************************************************************************
+	End DecodeWord
+***************************************************************************************************************
+*/
+
+static uint16_t ComputeAlu(uint8_t comp, uint16_t x, uint16_t y) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function computes any comp from its bits like the Hack ALU
+
+	\param[in]		comp			Comp field (a and c bits)
+	\param[in]		x				D register
+	\param[in]		y				A register or M
+
+	\returns
+		Result of the ALU
+
+***************************************************************************************************************
+*/
+	uint16_t result = 0;
+
+	if ((comp & COMP_ZX) != 0) {
+		x = 0;
+	}
+	if ((comp & 0x10) != 0) {
+		x = (uint16_t)~x;
+	}
+	if ((comp & COMP_ZY) != 0) {
+		y = 0;
+	}
+	if ((comp & 0x04) != 0) {
+		y = (uint16_t)~y;
+	}
+	result = ((comp & 0x02) != 0) ? (uint16_t)(x + y) : (uint16_t)(x & y);
+	if ((comp & 0x01) != 0) {
+		result = (uint16_t)~result;
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End ComputeAlu
+***************************************************************************************************************
+*/
+
+static uint8_t LoadAssemblyFile(T_hackEmulator* emulator, const char* fileName, T_sourceReader* reader) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function assembles a Hack assembly file with the integrated assembler and loads the machine code
+
+	\param[in,out]	emulator		Pointer to emulator
+	\param[in]		fileName		Pointer to name of the file
+	\param[in,out]	reader		Pointer to source reader of the file
+
+	\returns
+			0: the file is not valid or out of memory (the error is reported)
+			1: program is loaded
+
+	\note
+		- every line becomes one instruction of the list, so the assembler reports the lines of the file
+
+***************************************************************************************************************
+*/
+	T_hackProgram program;
+	T_assembler assembler;
+	T_stringView line;
+	uint8_t result = 1;
+
+	// both are initialized first, so both can be freed
+	result = InitHackProgram(&program);
+	result &= InitAssembler(&assembler);
+	if (result == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		FreeHackProgram(&program);
+		FreeAssembler(&assembler);
+		return 0;
+	}
+
+	while (ReadSourceLine(reader, &line) != 0) {
+		if (AppendAssemblyLine(&program, line.start, line.length) == 0) {
+			char detail[MAX_DETAIL_TEXT + 1];
+
+			snprintf(detail, sizeof(detail), "%.*s", (int)((line.length < MAX_DETAIL_TEXT) ? line.length : MAX_DETAIL_TEXT), line.start);
+			DIAG_ERROR(DC_ENCODING, fileName, reader->lineNumber, 0, detail);
+			result = 0;
+			break;
+		}
+	}
+
+	if (	(result != 0)
+		&& (AssembleProgram(&assembler, &program) != 0)
+		&& (FinishAssembly(&assembler) != 0)
+	) {
+		result = LoadMachineCode(emulator, assembler.words, assembler.count);
+	} else {
+		result = 0;
+	}
+
+	FreeHackProgram(&program);
+	FreeAssembler(&assembler);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LoadAssemblyFile
+***************************************************************************************************************
+*/
+
+static uint8_t LoadHackText(T_hackEmulator* emulator, const char* fileName, T_sourceReader* reader) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function loads machine code as text: one word of 16 '0' and '1' characters per line
+
+	\param[in,out]	emulator		Pointer to emulator
+	\param[in]		fileName		Pointer to name of the file
+	\param[in,out]	reader		Pointer to source reader of the file
+
+	\returns
+			0: a line is not a machine word or out of memory (the error is reported)
+			1: program is loaded
+
+	\note
+		- empty lines are skipped, every other line has at least 16 characters and a '\n' except the last, which
+		  limits the number of words
+
+***************************************************************************************************************
+*/
+	uint16_t* words = malloc(((reader->size / 17) + 1) * sizeof(uint16_t));
+	uint32_t count = 0;
+	T_stringView line;
+	uint8_t result = 1;
+
+	if (words == NULL) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+
+	while (ReadSourceLine(reader, &line) != 0) {
+		uint16_t word = 0;
+		uint32_t length = line.length;
+
+		if (	(length > 0)
+			&& (line.start[length - 1] == '\r')
+		) {
+			length--;
+		}
+		if (length == 0) {
+			continue;
+		}
+
+		for (uint32_t i = 0; (i < length) && (result != 0); i++) {
+			if (	(length != 16)
+				|| ((line.start[i] != '0') && (line.start[i] != '1'))
+			) {
+				char detail[MAX_DETAIL_TEXT + 1];
+
+				snprintf(detail, sizeof(detail), "%.*s", (int)((length < MAX_DETAIL_TEXT) ? length : MAX_DETAIL_TEXT), line.start);
+				DIAG_ERROR(DC_INVALID_VALUE, fileName, reader->lineNumber, i + 1, detail);
+				result = 0;
+			}
+			word = (uint16_t)((word << 1) | (uint16_t)(line.start[i] - '0'));
+		}
+		if (result == 0) {
+			break;
+		}
+		words[count++] = word;
+	}
+
+	if (result != 0) {
+		result = LoadMachineCode(emulator, words, count);
+	}
+	free(words);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LoadHackText
+***************************************************************************************************************
+*/
+
+static uint8_t LoadHackBinary(T_hackEmulator* emulator, const char* fileName, const T_sourceReader* reader) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function loads machine code as binary image: 2 bytes per word, most significant byte first
+
+	\param[in,out]	emulator		Pointer to emulator
+	\param[in]		fileName		Pointer to name of the file
+	\param[in]		reader		Pointer to source reader of the file
+
+	\returns
+			0: the size is odd or out of memory (the error is reported)
+			1: program is loaded
+
+***************************************************************************************************************
+*/
+	const uint8_t* bytes = (const uint8_t*)reader->data;
+	uint32_t count = (uint32_t)(reader->size / 2);
+	uint16_t* words = NULL;
+	uint8_t result = 0;
+
+	if ((reader->size % 2) != 0) {
+		DIAG_ERROR(DC_INVALID_VALUE, fileName, 0, 0, "odd number of bytes");
+		return 0;
+	}
+
+	words = malloc((count + 1) * sizeof(uint16_t));
+	if (words == NULL) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		words[i] = (uint16_t)((bytes[2 * i] << 8) | bytes[(2 * i) + 1]);
+	}
+
+	result = LoadMachineCode(emulator, words, count);
+	free(words);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LoadHackBinary
+***************************************************************************************************************
+*/
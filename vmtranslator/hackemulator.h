@@ -0,0 +1,120 @@
+/*! \file
+***************************************************************************************************************
+file name:					hackemulator.h
+*	\copyright				FourE
+*	\brief					Hack CPU emulator header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Headless emulator of the Hack CPU that runs the machine code of the translator (.asm, .hack or .bin) and
+	counts the executed instructions, so the cost of the generated code can be measured instead of estimated.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The ROM is predecoded once into an array of operations: an A-instruction becomes a load of A, a
+	C-instruction becomes the operation of its comp followed by one of 64 store and jump operations for its
+	dest and jump bits. The interpreter loop jumps from operation to operation through label addresses
+	(threaded code, the labels as values extension of GCC and clang), there is no central switch.
+
+***************************************************************************************************************
+*/
+
+#ifndef __HACKEMULATOR_H
+#define __HACKEMULATOR_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "assembler.h"			// ROM_SIZE
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define HACK_RAM_SIZE			(32768)			// the 15 bit address space: RAM, screen and keyboard
+#define HACK_ADDRESS_MASK		(0x7FFF)			// the address bits of the A register
+#define NO_INSTRUCTION_LIMIT	(UINT64_MAX)
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 HS_HALTED = 0							// reached an endless loop "(L) @L 0;JMP"
+	,HS_END									// ran past the last instruction of the program
+	,HS_LIMIT								// executed the maximum number of instructions
+} E_hackStop;
+
+// predecoded instruction
+typedef struct {
+	const void* handler;					// label of the operation, set when the emulator runs
+	const void* store;					// C-instruction: label of the store and jump operation
+	uint16_t value;						// A-instruction: value, C-instruction: comp field
+	uint8_t operation;					// E_hackOperation
+	uint8_t storeIndex;					// C-instruction: dest bits | jump bits << 3
+} T_hackOperation;
+
+typedef struct {
+	uint16_t ram[HACK_RAM_SIZE];
+	T_hackOperation* rom;				// ROM_SIZE + 1 operations, the ones after the program end it
+	uint32_t size;							// number of instructions of the program
+	uint16_t a;
+	uint16_t d;
+	uint16_t pc;
+	uint64_t executed;					// number of instructions executed
+} T_hackEmulator;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InitHackEmulator(T_hackEmulator* emulator);
+void FreeHackEmulator(T_hackEmulator* emulator);
+uint8_t LoadMachineCode(T_hackEmulator* emulator, const uint16_t* words, uint32_t count);
+uint8_t LoadHackFile(T_hackEmulator* emulator, const char* fileName);
+E_hackStop RunHackEmulator(T_hackEmulator* emulator, uint64_t limit);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __HACKEMULATOR_H
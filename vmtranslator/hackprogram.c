@@ -0,0 +1,840 @@
+/*! \file
+***************************************************************************************************************
+file name:					hackprogram.c
+*	\copyright				FourE
+*	\brief					Hack instruction list source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	A C-instruction is decoded from its parts: the destination letters are or-ed into the d bits, the comp
+	is looked up with M replaced by A (M sets the a bit) and the jump is looked up by name. The commutative
+	forms "A+D", "A&D" and "A|D" are accepted next to the forms of the Hack specification, they are printed
+	in the form of the specification.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "hackprogram.h"
+#include "stringhelper.h"
+#include <stdlib.h>			// realloc, free
+#include <string.h>			// memcpy, memset
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define INITIAL_CAPACITY		(1024)			// instructions allocated for a new program
+#define MAX_COMP_LENGTH			(3)				// longest comp of the Hack specification
+
+// mnemonic of up to 3 characters packed in an integer, so it is compared with one comparison
+#define MNEMONIC(a, b, c)		((uint32_t)(uint8_t)(a) | ((uint32_t)(uint8_t)(b) << 8) | ((uint32_t)(uint8_t)(c) << 16))
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+typedef struct {
+	uint32_t key;							// MNEMONIC of the text
+	uint8_t value;
+} T_mnemonic;
+
+// part of a C-instruction, always copied with 4 bytes so the copy needs no call
+typedef struct {
+	char text[4];
+	uint8_t length;
+} T_name;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static char* PrintLine(const T_hackInstruction* instruction, const char* text, uint32_t length, char* position);
+static uint8_t DecodeCompute(const char* text, uint32_t length, T_hackInstruction* instruction);
+static uint8_t FindMnemonic(const T_mnemonic* mnemonics, uint8_t count, const char* text, uint32_t length, uint8_t* value);
+static uint8_t GrowInstructions(T_hackInstruction** instructions, uint32_t* capacity, uint32_t needed);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// c bits of the comps with A, the ones with M are looked up with M replaced by A and get the a bit
+static const T_mnemonic comps[] = {
+	 {MNEMONIC('0', 0, 0), 0x2A}, {MNEMONIC('1', 0, 0), 0x3F}, {MNEMONIC('-', '1', 0), 0x3A}
+	,{MNEMONIC('D', 0, 0), 0x0C}, {MNEMONIC('A', 0, 0), 0x30}, {MNEMONIC('!', 'D', 0), 0x0D}
+	,{MNEMONIC('!', 'A', 0), 0x31}, {MNEMONIC('-', 'D', 0), 0x0F}, {MNEMONIC('-', 'A', 0), 0x33}
+	,{MNEMONIC('D', '+', '1'), 0x1F}, {MNEMONIC('A', '+', '1'), 0x37}, {MNEMONIC('D', '-', '1'), 0x0E}
+	,{MNEMONIC('A', '-', '1'), 0x32}, {MNEMONIC('D', '+', 'A'), 0x02}, {MNEMONIC('A', '+', 'D'), 0x02}
+	,{MNEMONIC('D', '-', 'A'), 0x13}, {MNEMONIC('A', '-', 'D'), 0x07}, {MNEMONIC('D', '&', 'A'), 0x00}
+	,{MNEMONIC('A', '&', 'D'), 0x00}, {MNEMONIC('D', '|', 'A'), 0x15}, {MNEMONIC('A', '|', 'D'), 0x15}
+};
+
+// j bits
+static const T_mnemonic jumps[] = {
+	 {MNEMONIC('J', 'G', 'T'), 1}, {MNEMONIC('J', 'E', 'Q'), 2}, {MNEMONIC('J', 'G', 'E'), 3}
+	,{MNEMONIC('J', 'L', 'T'), 4}, {MNEMONIC('J', 'N', 'E'), 5}, {MNEMONIC('J', 'L', 'E'), 6}
+	,{MNEMONIC('J', 'M', 'P'), 7}
+};
+
+// indexed by the comp field, length 0: not a comp of the Hack specification
+static const T_name compNames[128] = {
+	 [0x2A] = {"0", 1}, [0x3F] = {"1", 1}, [0x3A] = {"-1", 2}, [0x0C] = {"D", 1}, [0x30] = {"A", 1}
+	,[0x0D] = {"!D", 2}, [0x31] = {"!A", 2}, [0x0F] = {"-D", 2}, [0x33] = {"-A", 2}, [0x1F] = {"D+1", 3}
+	,[0x37] = {"A+1", 3}, [0x0E] = {"D-1", 3}, [0x32] = {"A-1", 3}, [0x02] = {"D+A", 3}, [0x13] = {"D-A", 3}
+	,[0x07] = {"A-D", 3}, [0x00] = {"D&A", 3}, [0x15] = {"D|A", 3}
+	,[0x70] = {"M", 1}, [0x71] = {"!M", 2}, [0x73] = {"-M", 2}, [0x77] = {"M+1", 3}, [0x72] = {"M-1", 3}
+	,[0x42] = {"D+M", 3}, [0x53] = {"D-M", 3}, [0x47] = {"M-D", 3}, [0x40] = {"D&M", 3}, [0x55] = {"D|M", 3}
+};
+
+// indexed by the destination bits
+static const T_name destNames[8] = {
+	 {"", 0}, {"M=", 2}, {"D=", 2}, {"MD=", 3}, {"A=", 2}, {"AM=", 3}, {"AD=", 3}, {"AMD=", 4}
+};
+
+// indexed by the jump bits
+static const T_name jumpNames[8] = {
+	 {"", 0}, {";JGT", 4}, {";JEQ", 4}, {";JGE", 4}, {";JLT", 4}, {";JNE", 4}, {";JLE", 4}, {";JMP", 4}
+};
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InitHackProgram(T_hackProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an empty instruction list
+
+	\param[out]		program		Pointer to instruction list
+
+	\returns
+			0: out of memory
+			1: instruction list is initialized
+
+***************************************************************************************************************
+*/
+	memset(program, 0, sizeof(T_hackProgram));
+	InitOutputBuffer(&program->name);
+	if (InitStringTable(&program->symbols) == 0) {
+		return 0;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End InitHackProgram
+***************************************************************************************************************
+*/
+
+void FreeHackProgram(T_hackProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the instructions and the symbols of an instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+
+***************************************************************************************************************
+*/
+	free(program->instructions);
+	FreeStringTable(&program->symbols);
+	FreeOutputBuffer(&program->name);
+	memset(program, 0, sizeof(T_hackProgram));
+}
+/*
+***************************************************************************************************************
+	End FreeHackProgram
+***************************************************************************************************************
+*/
+
+uint8_t AppendInstruction(T_hackProgram* program, const T_hackInstruction* instruction) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends an instruction to an instruction list
+
+	\param[in,out]	program			Pointer to instruction list
+	\param[in]		instruction		Pointer to instruction
+
+	\returns
+			0: out of memory
+			1: instruction was appended
+
+***************************************************************************************************************
+*/
+	if (	(program->count == program->capacity)
+		&& (GrowInstructions(&program->instructions, &program->capacity, program->count + 1) == 0)
+	) {
+		return 0;
+	}
+	program->instructions[program->count++] = *instruction;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AppendInstruction
+***************************************************************************************************************
+*/
+
+T_hackInstruction* BeginInstructions(T_hackProgram* program, uint32_t maxCount) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function makes room for at least maxCount instructions, so the caller can write them directly into the
+		instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+	\param[in]		maxCount		Maximum number of instructions the caller writes
+
+	\returns
+		Pointer to the first free instruction, NULL when out of memory
+
+	\note
+		- finish with EndInstructions, the instruction list must not be changed in between
+
+***************************************************************************************************************
+*/
+	if (GrowInstructions(&program->instructions, &program->capacity, program->count + maxCount) == 0) {
+		return NULL;
+	}
+	return &program->instructions[program->count];
+}
+/*
+***************************************************************************************************************
+	End BeginInstructions
+***************************************************************************************************************
+*/
+
+void EndInstructions(T_hackProgram* program, const T_hackInstruction* end) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function adds the instructions that were written after BeginInstructions to the instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+	\param[in]		end			Pointer just after the last instruction that was written
+
+***************************************************************************************************************
+*/
+	program->count = (uint32_t)(end - program->instructions);
+}
+/*
+***************************************************************************************************************
+	End EndInstructions
+***************************************************************************************************************
+*/
+
+uint8_t AppendComment(T_hackProgram* program, const char* text, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a comment to an instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+	\param[in]		text			Pointer to text of the comment without "//"
+	\param[in]		length		Length of the text
+
+	\returns
+			0: out of memory
+			1: comment was appended
+
+***************************************************************************************************************
+*/
+	T_hackInstruction instruction = { 0, HK_COMMENT, 0, 0, 0 };
+
+	instruction.operand = InternString(&program->symbols, text, length);
+	return (instruction.operand != STRING_ID_INVALID) ? AppendInstruction(program, &instruction) : 0;
+}
+/*
+***************************************************************************************************************
+	End AppendComment
+***************************************************************************************************************
+*/
+
+uint8_t AppendAssemblyLine(T_hackProgram* program, const char* text, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function decodes one line of assembly code and appends it to an instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+	\param[in]		text			Pointer to text of the line
+	\param[in]		length		Length of the line without '\n'
+
+	\returns
+			0: out of memory or the line is not valid, nothing is appended
+			1: line was appended
+
+	\note
+		- white space around the instruction and a comment after an instruction are skipped, a line that is
+		  only a comment is kept
+
+***************************************************************************************************************
+*/
+	T_hackInstruction instruction = { 0, HK_BLANK, 0, 0, 0 };
+	uint32_t end = 0;
+	uint32_t value = 0;
+
+	while (	(length > 0)
+			&& ((text[0] == ' ') || (text[0] == '\t'))
+	) {
+		text++;
+		length--;
+	}
+	if (	(length > 0)
+		&& (text[length - 1] == '\r')
+	) {
+		length--;
+	}
+
+	// the text of a comment is kept as it is, it is printed again
+	if (	(length >= 2)
+		&& (text[0] == '/')
+		&& (text[1] == '/')
+	) {
+		instruction.kind = HK_COMMENT;
+		instruction.operand = InternString(&program->symbols, &text[2], length - 2);
+		return (instruction.operand != STRING_ID_INVALID) ? AppendInstruction(program, &instruction) : 0;
+	}
+
+	// the instruction ends at white space or at a comment, only white space and a comment may follow it
+	while (	(end < length)
+			&& (text[end] != ' ')
+			&& (text[end] != '\t')
+			&& (text[end] != '/')
+	) {
+		end++;
+	}
+	for (uint32_t i = end; i < length; i++) {
+		if (	(text[i] == '/')
+			&& ((i + 1) < length)
+			&& (text[i + 1] == '/')
+		) {
+			break;
+		}
+		if (	(text[i] != ' ')
+			&& (text[i] != '\t')
+		) {
+			return 0;
+		}
+	}
+	length = end;
+	if (length == 0) {
+		return AppendInstruction(program, &instruction);
+	}
+
+	switch (text[0]) {
+	case '(':
+		if (	(length < 3)
+			|| (text[length - 1] != ')')
+		) {
+			return 0;
+		}
+		instruction.kind = HK_LABEL;
+		instruction.operand = InternString(&program->symbols, &text[1], length - 2);
+		break;
+	case '@':
+		if (length < 2) {
+			return 0;
+		}
+		if ((text[1] >= '0') && (text[1] <= '9')) {
+			for (uint32_t i = 1; i < length; i++) {
+				if (	(text[i] < '0')
+					|| (text[i] > '9')
+					|| (value > MAX_A_VALUE)
+				) {
+					return 0;
+				}
+				value = (value * 10) + (uint32_t)(text[i] - '0');
+			}
+			if (value > MAX_A_VALUE) {
+				return 0;
+			}
+			instruction.kind = HK_ADDRESS;
+			instruction.operand = value;
+			return AppendInstruction(program, &instruction);
+		}
+		instruction.kind = HK_SYMBOL;
+		instruction.operand = InternString(&program->symbols, &text[1], length - 1);
+		break;
+	default:
+		if (DecodeCompute(text, length, &instruction) == 0) {
+			return 0;
+		}
+		return AppendInstruction(program, &instruction);
+	}
+
+	return (instruction.operand != STRING_ID_INVALID) ? AppendInstruction(program, &instruction) : 0;
+}
+/*
+***************************************************************************************************************
+	End AppendAssemblyLine
+***************************************************************************************************************
+*/
+
+char* GetNameBuffer(T_hackProgram* program, size_t maxLength) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gives a buffer of at least maxLength bytes to compose a symbol, label or comment in before it
+		is interned in the symbols of the instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+	\param[in]		maxLength	Maximum number of bytes the caller writes
+
+	\returns
+		Pointer to the buffer, NULL when out of memory
+
+	\note
+		- the buffer stays valid until the next call
+
+***************************************************************************************************************
+*/
+	program->name.length = 0;
+	return BeginAppend(&program->name, maxLength);
+}
+/*
+***************************************************************************************************************
+	End GetNameBuffer
+***************************************************************************************************************
+*/
+
+uint32_t CountMachineInstructions(const T_hackProgram* program, uint32_t first) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function counts the A- and C-instructions of an instruction list from an index on
+
+	\param[in]		program		Pointer to instruction list
+	\param[in]		first			Index of the first instruction that is counted
+
+	\returns
+		Number of instructions that become a machine word
+
+***************************************************************************************************************
+*/
+	uint32_t count = 0;
+
+	for (uint32_t i = first; i < program->count; i++) {
+		if (program->instructions[i].kind >= HK_ADDRESS) {
+			count++;
+		}
+	}
+	return count;
+}
+/*
+***************************************************************************************************************
+	End CountMachineInstructions
+***************************************************************************************************************
+*/
+
+uint16_t EncodeComputeInstruction(const T_hackInstruction* instruction) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function encodes a C-instruction as machine word 111a cccc ccdd djjj
+
+	\param[in]		instruction		Pointer to HK_COMPUTE instruction
+
+	\returns
+		Machine word
+
+***************************************************************************************************************
+*/
+	return (uint16_t)(0xE000 | (instruction->comp << 6) | (instruction->dest << 3) | instruction->jump);
+}
+/*
+***************************************************************************************************************
+	End EncodeComputeInstruction
+***************************************************************************************************************
+*/
+
+uint8_t WriteAssembly(const T_hackProgram* program, T_outputBuffer* output) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints an instruction list as assembly code, one line per instruction
+
+	\param[in]		program		Pointer to instruction list
+	\param[in,out]	output		Pointer to output buffer the assembly code is appended to
+
+	\returns
+			0: out of memory
+			1: assembly code was written
+
+***************************************************************************************************************
+*/
+	const T_stringTableEntry* names = program->symbols.entries;
+	size_t maxLength = 0;
+	char* position = NULL;
+
+	for (uint32_t i = 0; i < program->count; i++) {
+		const T_hackInstruction* instruction = &program->instructions[i];
+
+		switch (instruction->kind) {
+		case HK_COMMENT:
+		case HK_LABEL:
+		case HK_SYMBOL:
+			maxLength += names[instruction->operand].length + NAME_LINE_EXTRA;
+			break;
+		case HK_ADDRESS:
+		case HK_COMPUTE:
+			maxLength += MAX_INSTRUCTION_LINE_LENGTH;
+			break;
+		default:
+			maxLength += 1;
+			break;
+		}
+	}
+
+	position = BeginAppend(output, maxLength);
+	if (position == NULL) {
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < program->count; i++) {
+		position = PrintInstruction(program, &program->instructions[i], position);
+	}
+
+	EndAppend(output, position);
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End WriteAssembly
+***************************************************************************************************************
+*/
+
+char* PrintInstruction(const T_hackProgram* program, const T_hackInstruction* instruction, char* position) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints one instruction as a line of assembly code
+
+	\param[in]		program			Pointer to instruction list with the symbols of the instruction
+	\param[in]		instruction		Pointer to instruction
+	\param[out]		position			Pointer to room for the line: MAX_INSTRUCTION_LINE_LENGTH bytes, or the length of
+										the symbol + NAME_LINE_EXTRA bytes
+
+	\returns
+		Pointer just after the line
+
+***************************************************************************************************************
+*/
+	// the operand of HK_BLANK and HK_COMPUTE is 0, the empty string
+	const T_stringTableEntry* name = &program->symbols.entries[(instruction->kind != HK_ADDRESS) ? instruction->operand : STRING_ID_NONE];
+
+	return PrintLine(instruction, name->string, name->length, position);
+}
+/*
+***************************************************************************************************************
+	End PrintInstruction
+***************************************************************************************************************
+*/
+
+char* PrintNamedInstruction(uint8_t kind, const char* name, uint32_t length, char* position) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints a comment, label or symbol as a line of assembly code without interning its name
+
+	\param[in]		kind			HK_COMMENT, HK_LABEL or HK_SYMBOL
+	\param[in]		name			Pointer to text of the comment, label or symbol
+	\param[in]		length		Length of the text
+	\param[out]		position		Pointer to room for the line, length + NAME_LINE_EXTRA bytes
+
+	\returns
+		Pointer just after the line
+
+***************************************************************************************************************
+*/
+	const T_hackInstruction instruction = { STRING_ID_NONE, kind, 0, 0, 0 };
+
+	return PrintLine(&instruction, name, length, position);
+}
+/*
+***************************************************************************************************************
+	End PrintNamedInstruction
+***************************************************************************************************************
+*/
+
+static char* PrintLine(const T_hackInstruction* instruction, const char* text, uint32_t length, char* position) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints an instruction as a line of assembly code
+
+	\param[in]		instruction		Pointer to instruction
+	\param[in]		text				Pointer to text of a comment, label or symbol
+	\param[in]		length			Length of the text
+	\param[out]		position			Pointer to room for the line
+
+	\returns
+		Pointer just after the line
+
+***************************************************************************************************************
+*/
+	switch (instruction->kind) {
+	case HK_COMMENT:
+		*position++ = '/';
+		*position++ = '/';
+		memcpy(position, text, length);
+		position += length;
+		break;
+	case HK_LABEL:
+		*position++ = '(';
+		memcpy(position, text, length);
+		position += length;
+		*position++ = ')';
+		break;
+	case HK_SYMBOL:
+		*position++ = '@';
+		memcpy(position, text, length);
+		position += length;
+		break;
+	case HK_ADDRESS:
+		*position++ = '@';
+		position += FormatDecimal(instruction->operand, position);
+		break;
+	case HK_COMPUTE:
+		memcpy(position, destNames[instruction->dest].text, 4);
+		position += destNames[instruction->dest].length;
+		memcpy(position, compNames[instruction->comp].text, 4);
+		position += compNames[instruction->comp].length;
+		memcpy(position, jumpNames[instruction->jump].text, 4);
+		position += jumpNames[instruction->jump].length;
+		break;
+	default:
+		break;
+	}
+	*position++ = '\n';
+	return position;
+}
+/*
+***************************************************************************************************************
+	End PrintLine
+***************************************************************************************************************
+*/
+
+static uint8_t DecodeCompute(const char* text, uint32_t length, T_hackInstruction* instruction) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function decodes a C-instruction "dest=comp;jump" (dest and jump are optional)
+
+	\param[in]		text				Pointer to instruction
+	\param[in]		length			Length of the instruction
+	\param[out]		instruction		Pointer that receives the HK_COMPUTE instruction
+
+	\returns
+			0: instruction is not valid
+			1: instruction was decoded
+
+***************************************************************************************************************
+*/
+	const char* end = text + length;
+	const char* equals = NULL;
+	const char* semicolon = NULL;
+	const char* comp = text;
+	const char* compEnd = end;
+	char normalized[MAX_COMP_LENGTH];
+	uint8_t dest = 0;
+	uint8_t bits = 0;
+	uint8_t jump = 0;
+	uint8_t aBit = 0;
+
+	for (const char* position = text; position < end; position++) {
+		if (	(*position == '=')
+			&& (equals == NULL)
+		) {
+			equals = position;
+			comp = position + 1;
+		} else if (*position == ';') {
+			semicolon = position;
+			compEnd = position;
+			break;
+		}
+	}
+
+	if (	(compEnd <= comp)
+		|| ((compEnd - comp) > MAX_COMP_LENGTH)
+	) {
+		return 0;
+	}
+
+	if (equals != NULL) {
+		for (const char* position = text; position < equals; position++) {
+			uint8_t bit = (*position == 'A') ? DEST_A : (*position == 'D') ? DEST_D : (*position == 'M') ? DEST_M : 0;
+
+			if (	(bit == 0)
+				|| ((dest & bit) != 0)
+			) {
+				return 0;
+			}
+			dest |= bit;
+		}
+	}
+
+	for (const char* position = comp; position < compEnd; position++) {
+		normalized[position - comp] = *position;
+		if (*position == 'M') {
+			normalized[position - comp] = 'A';
+			aBit = COMP_A_BIT;
+		}
+	}
+	if (FindMnemonic(comps, sizeof(comps) / sizeof(comps[0]), normalized, (uint32_t)(compEnd - comp), &bits) == 0) {
+		return 0;
+	}
+
+	if (	(semicolon != NULL)
+		&& (FindMnemonic(jumps, sizeof(jumps) / sizeof(jumps[0]), semicolon + 1, (uint32_t)(end - semicolon - 1), &jump) == 0)
+	) {
+		return 0;
+	}
+
+	instruction->kind = HK_COMPUTE;
+	instruction->operand = 0;
+	instruction->dest = dest;
+	instruction->comp = (uint8_t)(aBit | bits);
+	instruction->jump = jump;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End DecodeCompute
+***************************************************************************************************************
+*/
+
+static uint8_t FindMnemonic(const T_mnemonic* mnemonics, uint8_t count, const char* text, uint32_t length, uint8_t* value) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function looks up a mnemonic that is not nul terminated
+
+	\param[in]		mnemonics	Pointer to array of mnemonics
+	\param[in]		count			Number of mnemonics
+	\param[in]		text			Pointer to mnemonic
+	\param[in]		length		Length of the mnemonic
+	\param[out]		value			Pointer that receives the value of the mnemonic
+
+	\returns
+			0: mnemonic was not found
+			1: mnemonic was found
+
+***************************************************************************************************************
+*/
+	uint32_t key = 0;
+
+	if (	(length == 0)
+		|| (length > MAX_COMP_LENGTH)
+	) {
+		return 0;
+	}
+	for (uint32_t i = 0; i < length; i++) {
+		key |= (uint32_t)(uint8_t)text[i] << (8 * i);
+	}
+	for (uint8_t i = 0; i < count; i++) {
+		if (mnemonics[i].key == key) {
+			*value = mnemonics[i].value;
+			return 1;
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End FindMnemonic
+***************************************************************************************************************
+*/
+
+static uint8_t GrowInstructions(T_hackInstruction** instructions, uint32_t* capacity, uint32_t needed) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function makes sure an array of instructions holds at least a number of instructions, it grows by half
+		of its size when it is full
+
+	\param[in,out]	instructions	Pointer to pointer to array
+	\param[in,out]	capacity			Pointer to number of instructions the array holds
+	\param[in]		needed			Number of instructions the array must hold
+
+	\returns
+			0: out of memory
+			1: array is large enough
+
+***************************************************************************************************************
+*/
+	uint32_t newCapacity = (*capacity == 0) ? INITIAL_CAPACITY : *capacity;
+	T_hackInstruction* newInstructions = NULL;
+
+	if (needed <= *capacity) {
+		return 1;
+	}
+	while (newCapacity < needed) {
+		newCapacity += newCapacity / 2;
+	}
+	newInstructions = realloc(*instructions, newCapacity * sizeof(T_hackInstruction));
+	if (newInstructions == NULL) {
+		return 0;
+	}
+	*instructions = newInstructions;
+	*capacity = newCapacity;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End GrowInstructions
+***************************************************************************************************************
+*/
+
@@ -0,0 +1,179 @@
+/*! \file
+***************************************************************************************************************
+file name:					hackprogram.h
+*	\copyright				FourE
+*	\brief					Hack instruction list header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Hack assembly code as an array of typed instructions instead of text: every line is one 8 byte record
+	with its kind, the encoded dest, comp and jump bits of a C-instruction and the value or symbol of an
+	A-instruction. The code writer appends the records of its templates directly, the peephole optimizer
+	rewrites them and the assembler encodes them, no text is formatted and parsed again in between.
+	WriteAssembly prints the list as .asm text, AppendAssemblyLine decodes the lines of an .asm file.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The symbols, labels and comments of a program are interned in its own string table, the operand of those
+	records is the ID. Printing gives exactly the text that was appended when it only uses the forms the
+	Hack specification lists: one instruction per line, no white space and no comments after an instruction.
+
+***************************************************************************************************************
+*/
+
+#ifndef __HACKPROGRAM_H
+#define __HACKPROGRAM_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "outputbuffer.h"
+#include "stringtable.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+// destination bits of a C-instruction (the d1 d2 d3 bits of the Hack encoding)
+#define DEST_M					(1)
+#define DEST_D					(2)
+#define DEST_A					(4)
+
+// comp field: the a bit and the 6 c bits of the Hack encoding
+#define COMP_A_BIT			(0x40)			// the comp reads M instead of A
+#define COMP_ZX				(0x20)			// x input (D) is zeroed, so D is not read
+#define COMP_ZY				(0x08)			// y input (A or M) is zeroed, so A and M are not read
+#define COMP_0					(0x2A)
+#define COMP_1					(0x3F)
+#define COMP_MINUS_1			(0x3A)
+#define COMP_D					(0x0C)
+#define COMP_A					(0x30)
+#define COMP_NOT_D			(0x0D)
+#define COMP_NOT_A			(0x31)
+#define COMP_NEG_D			(0x0F)
+#define COMP_NEG_A			(0x33)
+#define COMP_D_PLUS_1		(0x1F)
+#define COMP_A_PLUS_1		(0x37)
+#define COMP_D_MINUS_1		(0x0E)
+#define COMP_A_MINUS_1		(0x32)
+#define COMP_D_PLUS_A		(0x02)
+#define COMP_D_MINUS_A		(0x13)
+#define COMP_A_MINUS_D		(0x07)
+#define COMP_D_AND_A			(0x00)
+#define COMP_D_OR_A			(0x15)
+#define COMP_M					(COMP_A_BIT | COMP_A)
+#define COMP_NOT_M			(COMP_A_BIT | COMP_NOT_A)
+#define COMP_NEG_M			(COMP_A_BIT | COMP_NEG_A)
+#define COMP_M_PLUS_1		(COMP_A_BIT | COMP_A_PLUS_1)
+#define COMP_M_MINUS_1		(COMP_A_BIT | COMP_A_MINUS_1)
+#define COMP_D_PLUS_M		(COMP_A_BIT | COMP_D_PLUS_A)
+#define COMP_D_MINUS_M		(COMP_A_BIT | COMP_D_MINUS_A)
+#define COMP_M_MINUS_D		(COMP_A_BIT | COMP_A_MINUS_D)
+#define COMP_D_AND_M			(COMP_A_BIT | COMP_D_AND_A)
+#define COMP_D_OR_M			(COMP_A_BIT | COMP_D_OR_A)
+
+// jump bits of a C-instruction (the j1 j2 j3 bits of the Hack encoding)
+#define JUMP_JGT				(1)
+#define JUMP_JEQ				(2)
+#define JUMP_JGE				(3)
+#define JUMP_JLT				(4)
+#define JUMP_JNE				(5)
+#define JUMP_JLE				(6)
+#define JUMP_JMP				(7)
+
+#define MAX_A_VALUE			(0x7FFF)			// largest value of an A-instruction
+
+#define MAX_INSTRUCTION_LINE_LENGTH	(12)	// longest line of an A- or C-instruction: "AMD=D+M;JMP\n"
+#define NAME_LINE_EXTRA				(3)		// characters of a line around a name: "//", "()" or "@" and "\n"
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 HK_BLANK = 0							// empty line
+	,HK_COMMENT								// //text, operand: ID of the text after "//"
+	,HK_LABEL								// (label), operand: ID of the label
+	,HK_ADDRESS								// @value, operand: value
+	,HK_SYMBOL								// @symbol, operand: ID of the symbol
+	,HK_COMPUTE								// dest=comp;jump
+} E_hackKind;
+
+typedef struct {
+	uint32_t operand;						// value or string ID, see E_hackKind
+	uint8_t kind;							// E_hackKind
+	uint8_t dest;							// HK_COMPUTE: DEST_A | DEST_D | DEST_M
+	uint8_t comp;							// HK_COMPUTE: a and c bits
+	uint8_t jump;							// HK_COMPUTE: j bits, 0: no jump
+} T_hackInstruction;
+
+typedef struct {
+	T_hackInstruction* instructions;
+	uint32_t count;
+	uint32_t capacity;
+	T_stringTable symbols;				// symbols, labels and comments, the operands are IDs in this table
+	T_outputBuffer name;					// buffer of GetNameBuffer
+} T_hackProgram;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InitHackProgram(T_hackProgram* program);
+void FreeHackProgram(T_hackProgram* program);
+uint8_t AppendInstruction(T_hackProgram* program, const T_hackInstruction* instruction);
+T_hackInstruction* BeginInstructions(T_hackProgram* program, uint32_t maxCount);
+void EndInstructions(T_hackProgram* program, const T_hackInstruction* end);
+uint8_t AppendComment(T_hackProgram* program, const char* text, uint32_t length);
+uint8_t AppendAssemblyLine(T_hackProgram* program, const char* text, uint32_t length);
+char* GetNameBuffer(T_hackProgram* program, size_t maxLength);
+uint32_t CountMachineInstructions(const T_hackProgram* program, uint32_t first);
+uint16_t EncodeComputeInstruction(const T_hackInstruction* instruction);
+uint8_t WriteAssembly(const T_hackProgram* program, T_outputBuffer* output);
+char* PrintInstruction(const T_hackProgram* program, const T_hackInstruction* instruction, char* position);
+char* PrintNamedInstruction(uint8_t kind, const char* name, uint32_t length, char* position);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __HACKPROGRAM_H
@@ -0,0 +1,834 @@
+/*! \file
+***************************************************************************************************************
+file name:					inliner.c
+*	\copyright				FourE
+*	\brief					inliner source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	A function is inlined when it calls no other function (so it is never recursive), its body is not longer
+	than the limit, and the depth of its stack is known at every command. At a call site the arguments are
+	popped into extra locals of the caller, the locals of the callee follow them and, when the callee sets
+	THIS or THAT, the caller's pointers are saved behind those. The body is then copied with argument and
+	local accesses renumbered, its labels renamed per call site and every return replaced by a restore of the
+	pointers and a jump to the end of the body. The return value is already on top of the stack at that point.
+
+	All call sites of one caller share the same extra locals, the caller gets as many as its largest site.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "inliner.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, calloc, realloc, free
+#include <string.h>			// memset
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define INITIAL_CAPACITY		(16)
+
+// extra locals of a function without inlined call sites (a site can need 0 extra locals)
+#define NO_CALL_SITES			(0xFFFFFFFFu)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// what a call site needs to know about a function
+typedef struct {
+	uint8_t inlinable;					// 1: the function can be substituted at its call sites
+	uint8_t usesStatic;					// 1: the function accesses static, only callers in the same file qualify
+	uint8_t hasLabels;					// 0: the body is straight line code
+	uint8_t savePointer[2];				// 1: the function sets pointer 0 (THIS) or pointer 1 (THAT)
+	uint16_t argumentCount;				// highest argument index that is accessed + 1
+	uint16_t localCount;
+	uint32_t frameSize;					// extra locals of the caller without the arguments
+} T_inlineCandidate;
+
+// commands of a VM program that is rebuilt
+typedef struct {
+	T_vmCommand* commands;
+	uint32_t count;
+	uint32_t capacity;
+} T_commandList;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t AnalyzeFunction(const T_vmProgram* program, const T_callGraphFunction* function, uint32_t limit, T_labelDepth* labels, T_inlineCandidate* candidate);
+static uint8_t CanInlineCall(const T_callGraph* graph, const T_inlineCandidate* candidates, uint32_t caller, uint32_t callee, const T_vmCommand* call);
+static uint8_t InlineProgram(const T_callGraph* graph, T_vmProgram* const* programs, uint32_t firstFunction, uint32_t endFunction, const T_inlineCandidate* candidates, const uint32_t* extraLocals, T_commandList* list, T_inlineReport* report);
+static uint8_t WriteInlineBody(T_commandList* list, T_stringTable* names, const T_vmProgram* callee, const T_callGraphFunction* function, const T_inlineCandidate* candidate, const T_vmCommand* call, uint16_t base, uint32_t site);
+static uint8_t NeedsZero(const T_vmCommand* body, uint32_t length, uint16_t local, uint8_t hasLabels);
+static uint32_t InternInlineLabel(T_stringTable* names, const char* function, uint32_t functionLength, uint32_t site, const char* label, uint32_t labelLength);
+static uint8_t AppendCommand(T_commandList* list, const T_vmCommand* command);
+static uint8_t AppendNewCommand(T_commandList* list, E_commandType commandType, E_memorySegment memorySegment, uint32_t value, uint32_t nameId, const T_vmCommand* call);
+static uint8_t AddInlineSite(T_inlineReport* report, uint32_t caller, uint32_t callee, uint32_t lineNumber);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InlineLeafFunctions(const T_callGraph* graph, T_vmProgram* const* programs, uint32_t count, uint32_t limit, T_inlineReport* report) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function substitutes the bodies of small leaf functions at their call sites
+
+	\param[in]		graph			Pointer to call graph of the programs
+	\param[in,out]	programs		Pointer to array of pointers to the VM programs the graph was built from
+	\param[in]		count			Number of VM programs
+	\param[in]		limit			Largest number of VM commands of a function body that is inlined
+	\param[out]		report		Pointer to report that receives the inlined call sites
+
+	\returns
+		0: out of memory (the programs are unchanged)
+		1: calls are inlined
+
+	\note
+		- the graph keeps the original command ranges, they are no longer valid for the programs afterwards
+		- the inlined functions stay in the programs, dead function elimination removes the ones that are no
+		  longer called
+
+***************************************************************************************************************
+*/
+	T_inlineCandidate* candidates = calloc((graph->count > 0) ? graph->count : 1, sizeof(T_inlineCandidate));
+	uint32_t* extraLocals = malloc(((graph->count > 0) ? graph->count : 1) * sizeof(uint32_t));
+	T_labelDepth* labels = malloc((limit + 1) * sizeof(T_labelDepth));
+	T_commandList* lists = calloc((count > 0) ? count : 1, sizeof(T_commandList));
+	uint8_t result = 1;
+
+	memset(report, 0, sizeof(T_inlineReport));
+	for (uint32_t p = 0; p < count; p++) {
+		report->commandsBefore += programs[p]->count;
+	}
+
+	if (	(candidates == NULL)
+		|| (extraLocals == NULL)
+		|| (labels == NULL)
+		|| (lists == NULL)
+	) {
+		result = 0;
+	} else {
+		for (uint32_t f = 0; f < graph->count; f++) {
+			AnalyzeFunction(programs[graph->functions[f].program], &graph->functions[f], limit, labels, &candidates[f]);
+		}
+
+		// the extra locals of every caller, the largest call site decides
+		for (uint32_t f = 0; f < graph->count; f++) {
+			const T_callGraphFunction* function = &graph->functions[f];
+			const T_vmProgram* program = programs[function->program];
+			uint32_t call = function->firstCallee;
+
+			extraLocals[f] = NO_CALL_SITES;
+
+			for (uint32_t i = function->firstCommand; i < function->endCommand; i++) {
+				const T_vmCommand* command = &program->commands[i];
+
+				if (command->commandType != CT_CALL) {
+					continue;
+				}
+				if (CanInlineCall(graph, candidates, f, graph->callees[call], command) != 0) {
+					uint32_t frame = command->value + candidates[graph->callees[call]].frameSize;
+
+					if (	(extraLocals[f] == NO_CALL_SITES)
+						|| (frame > extraLocals[f])
+					) {
+						extraLocals[f] = frame;
+					}
+				}
+				call++;
+			}
+			if (	(extraLocals[f] != NO_CALL_SITES)
+				&& ((program->commands[function->firstCommand].value + extraLocals[f]) > UINT16_MAX)
+			) {
+				extraLocals[f] = NO_CALL_SITES;
+			}
+		}
+
+		// the bodies are copied from the original programs, so they are only replaced when all are rebuilt
+		for (uint32_t f = 0; (f < graph->count) && (result != 0);) {
+			uint32_t p = graph->functions[f].program;
+			uint32_t endFunction = f;
+			uint8_t hasSites = 0;
+
+			for (; (endFunction < graph->count) && (graph->functions[endFunction].program == p); endFunction++) {
+				if (extraLocals[endFunction] != NO_CALL_SITES) {
+					hasSites = 1;
+				}
+			}
+			if (hasSites != 0) {
+				result = InlineProgram(graph, programs, f, endFunction, candidates, extraLocals, &lists[p], report);
+			}
+			f = endFunction;
+		}
+
+		for (uint32_t p = 0; p < count; p++) {
+			if (lists[p].commands == NULL) {
+				continue;
+			}
+			if (result != 0) {
+				free(programs[p]->commands);
+				programs[p]->commands = lists[p].commands;
+				programs[p]->count = lists[p].count;
+				programs[p]->capacity = lists[p].capacity;
+			} else {
+				free(lists[p].commands);
+			}
+		}
+	}
+
+	for (uint32_t p = 0; p < count; p++) {
+		report->commandsAfter += programs[p]->count;
+	}
+
+	free(candidates);
+	free(extraLocals);
+	free(labels);
+	free(lists);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End InlineLeafFunctions
+***************************************************************************************************************
+*/
+
+void FreeInlineReport(T_inlineReport* report) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees all memory of an inline report
+
+	\param[in,out]	report		Pointer to inline report
+
+***************************************************************************************************************
+*/
+	free(report->sites);
+	memset(report, 0, sizeof(T_inlineReport));
+}
+/*
+***************************************************************************************************************
+	End FreeInlineReport
+***************************************************************************************************************
+*/
+
+void PrintInlineReport(const T_inlineReport* report, const T_callGraph* graph) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the inlined call sites
+
+	\param[in]		report		Pointer to inline report
+	\param[in]		graph			Pointer to call graph the function indices of the report refer to
+
+***************************************************************************************************************
+*/
+	printf("inlined calls: %u call sites, %u -> %u VM commands\n", report->count, report->commandsBefore, report->commandsAfter);
+	for (uint32_t i = 0; i < report->count; i++) {
+		const T_inlineSite* site = &report->sites[i];
+
+		printf("  %-40s in %s line %u\n", GetString(&graph->names, graph->functions[site->callee].nameId)
+				, GetString(&graph->names, graph->functions[site->caller].nameId), site->lineNumber);
+	}
+}
+/*
+***************************************************************************************************************
+	End PrintInlineReport
+***************************************************************************************************************
+*/
+
+static uint8_t AnalyzeFunction(const T_vmProgram* program, const T_callGraphFunction* function, uint32_t limit, T_labelDepth* labels, T_inlineCandidate* candidate) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks whether a function can be inlined and collects what its call sites need
+
+	\param[in]		program		Pointer to VM program of the function
+	\param[in]		function		Pointer to function in the call graph
+	\param[in]		limit			Largest number of VM commands of a function body that is inlined
+	\param[out]		labels		Pointer to scratch array of at least limit entries
+	\param[out]		candidate	Pointer to candidate that receives the result
+
+	\returns
+		0: function is not inlined
+		1: function can be inlined
+
+	\note
+		- every return must leave exactly the return value on the stack (see CheckStackDepth)
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* body = &program->commands[function->firstCommand];
+	uint32_t length = function->endCommand - function->firstCommand;
+
+	memset(candidate, 0, sizeof(T_inlineCandidate));
+	candidate->localCount = body[0].value;
+
+	if (	(function->calleeCount != 0)
+		|| (length < 2)
+		|| ((length - 1) > limit)
+		|| (CheckStackDepth(program, function, labels) == 0)
+	) {
+		return 0;
+	}
+
+	for (uint32_t i = 1; i < length; i++) {
+		const T_vmCommand* command = &body[i];
+
+		if (command->commandType == CT_LABEL) {
+			candidate->hasLabels = 1;
+		}
+		if (	(command->commandType != CT_PUSH)
+			&& (command->commandType != CT_POP)
+		) {
+			continue;
+		}
+
+		switch (command->memorySegment) {
+		case MS_ARGUMENT:
+			if (command->value >= candidate->argumentCount) {
+				candidate->argumentCount = command->value + 1;
+			}
+			break;
+		case MS_LOCAL:
+			// beyond its locals a function would access its own working stack
+			if (command->value >= candidate->localCount) {
+				return 0;
+			}
+			break;
+		case MS_STATIC:
+			candidate->usesStatic = 1;
+			break;
+		case MS_POINTER:
+			if (command->value > 1) {
+				return 0;
+			}
+			if (command->commandType == CT_POP) {
+				candidate->savePointer[command->value] = 1;
+			}
+			break;
+		case MS_CONSTANT:
+			if (command->commandType == CT_POP) {
+				return 0;
+			}
+			break;
+		case MS_UNKNOWN:
+			return 0;
+		default:
+			break;
+		}
+	}
+
+	candidate->frameSize = candidate->localCount + candidate->savePointer[0] + candidate->savePointer[1];
+	candidate->inlinable = 1;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AnalyzeFunction
+***************************************************************************************************************
+*/
+
+static uint8_t CanInlineCall(const T_callGraph* graph, const T_inlineCandidate* candidates, uint32_t caller, uint32_t callee, const T_vmCommand* call) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks whether a call command is replaced by the body of the called function
+
+	\param[in]		graph				Pointer to call graph
+	\param[in]		candidates		Pointer to array with the candidate of every function
+	\param[in]		caller			Index of the calling function
+	\param[in]		callee			Index of the called function, FUNCTION_NONE when it is not defined
+	\param[in]		call				Pointer to call command
+
+	\returns
+		0: call is kept
+		1: call is inlined
+
+***************************************************************************************************************
+*/
+	if (	(callee == FUNCTION_NONE)
+		|| (callee == caller)
+		|| (candidates[callee].inlinable == 0)
+		|| (candidates[callee].argumentCount > call->value)
+	) {
+		return 0;
+	}
+	// static variables are named after the file of the function
+	if (	(candidates[callee].usesStatic != 0)
+		&& (graph->functions[callee].program != graph->functions[caller].program)
+	) {
+		return 0;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End CanInlineCall
+***************************************************************************************************************
+*/
+
+static uint8_t InlineProgram(const T_callGraph* graph, T_vmProgram* const* programs, uint32_t firstFunction, uint32_t endFunction, const T_inlineCandidate* candidates, const uint32_t* extraLocals, T_commandList* list, T_inlineReport* report) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function builds the commands of one VM program with the inlinable calls replaced
+
+	\param[in]		graph				Pointer to call graph
+	\param[in,out]	programs			Pointer to array of pointers to the VM programs
+	\param[in]		firstFunction	Index of the first function of the program
+	\param[in]		endFunction		Index after the last function of the program
+	\param[in]		candidates		Pointer to array with the candidate of every function
+	\param[in]		extraLocals		Pointer to array with the number of extra locals of every function, NO_CALL_SITES
+										for a function without inlined calls
+	\param[out]		list				Pointer to command list that receives the commands
+	\param[in,out]	report			Pointer to inline report
+
+	\returns
+		0: out of memory (the list is freed)
+		1: commands are built, the program itself is unchanged
+
+	\note
+		- the call sites are numbered per program and not per caller, so the renamed labels are unique in the
+		  whole file and do not depend on the label scope of a backend
+
+***************************************************************************************************************
+*/
+	T_vmProgram* program = programs[graph->functions[firstFunction].program];
+	uint32_t site = 0;
+
+	list->count = 0;
+	list->capacity = program->count * 2;
+	list->commands = malloc(list->capacity * sizeof(T_vmCommand));
+	if (list->commands == NULL) {
+		return 0;
+	}
+
+	// commands before the first function
+	for (uint32_t i = 0; i < graph->functions[firstFunction].firstCommand; i++) {
+		if (AppendCommand(list, &program->commands[i]) == 0) {
+			free(list->commands);
+			list->commands = NULL;
+			return 0;
+		}
+	}
+
+	for (uint32_t f = firstFunction; f < endFunction; f++) {
+		const T_callGraphFunction* function = &graph->functions[f];
+		T_vmCommand command = program->commands[function->firstCommand];
+		uint16_t base = command.value;
+		uint32_t call = function->firstCallee;
+
+		if (extraLocals[f] != NO_CALL_SITES) {
+			command.value = (uint16_t)(command.value + extraLocals[f]);
+		}
+		if (AppendCommand(list, &command) == 0) {
+			free(list->commands);
+			list->commands = NULL;
+			return 0;
+		}
+
+		for (uint32_t i = function->firstCommand + 1; i < function->endCommand; i++) {
+			const T_vmCommand* current = &program->commands[i];
+			uint8_t result = 1;
+
+			if (current->commandType != CT_CALL) {
+				result = AppendCommand(list, current);
+			} else {
+				uint32_t callee = graph->callees[call];
+
+				call++;
+				if (	(extraLocals[f] != NO_CALL_SITES)
+					&& (CanInlineCall(graph, candidates, f, callee, current) != 0)
+				) {
+					result = WriteInlineBody(list, &program->names, programs[graph->functions[callee].program]
+													, &graph->functions[callee], &candidates[callee], current, base, site);
+					if (result != 0) {
+						result = AddInlineSite(report, f, callee, current->lineNumber);
+					}
+					site++;
+				} else {
+					result = AppendCommand(list, current);
+				}
+			}
+			if (result == 0) {
+				free(list->commands);
+				list->commands = NULL;
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End InlineProgram
+***************************************************************************************************************
+*/
+
+static uint8_t WriteInlineBody(T_commandList* list, T_stringTable* names, const T_vmProgram* callee, const T_callGraphFunction* function, const T_inlineCandidate* candidate, const T_vmCommand* call, uint16_t base, uint32_t site) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the body of a function in place of a call command
+
+	\param[in,out]	list				Pointer to command list of the caller
+	\param[in,out]	names				Pointer to string table of the caller's program
+	\param[in]		callee			Pointer to VM program of the called function
+	\param[in]		function			Pointer to called function in the call graph
+	\param[in]		candidate		Pointer to candidate of the called function
+	\param[in]		call				Pointer to call command
+	\param[in]		base				Index of the first extra local of the caller
+	\param[in]		site				Number of the call site within the program, keeps the labels apart
+
+	\returns
+		0: out of memory
+		1: body is written
+
+	\note
+		- the inlined commands get the line and column of the call, so diagnostics point to the call site
+		- a local of the callee is only cleared when it can be read before it is written
+
+***************************************************************************************************************
+*/
+	const T_vmCommand* body = &callee->commands[function->firstCommand];
+	uint32_t length = function->endCommand - function->firstCommand;
+	const char* functionName = GetString(&callee->names, body[0].nameId);
+	uint32_t functionNameLength = GetStringLength(&callee->names, body[0].nameId);
+	uint32_t localBase = base + call->value;
+	uint32_t saveSlot[2] = { 0, 0 };
+	uint32_t slot = localBase + candidate->localCount;
+	uint32_t endLabel = STRING_ID_INVALID;
+	uint8_t result = 1;
+
+	// the arguments are on the stack, the last one on top
+	for (uint32_t i = call->value; (i > 0) && (result != 0); i--) {
+		result = AppendNewCommand(list, CT_POP, MS_LOCAL, base + i - 1, STRING_ID_NONE, call);
+	}
+	for (uint32_t p = 0; (p < 2) && (result != 0); p++) {
+		if (candidate->savePointer[p] != 0) {
+			saveSlot[p] = slot;
+			slot++;
+			result = AppendNewCommand(list, CT_PUSH, MS_POINTER, p, STRING_ID_NONE, call)
+					&& AppendNewCommand(list, CT_POP, MS_LOCAL, saveSlot[p], STRING_ID_NONE, call);
+		}
+	}
+	for (uint16_t j = 0; (j < candidate->localCount) && (result != 0); j++) {
+		if (NeedsZero(body, length, j, candidate->hasLabels) != 0) {
+			result = AppendNewCommand(list, CT_PUSH, MS_CONSTANT, 0, STRING_ID_NONE, call)
+					&& AppendNewCommand(list, CT_POP, MS_LOCAL, localBase + j, STRING_ID_NONE, call);
+		}
+	}
+
+	for (uint32_t i = 1; (i < length) && (result != 0); i++) {
+		T_vmCommand command = body[i];
+
+		command.lineNumber = call->lineNumber;
+		command.column = call->column;
+		command.nameId = STRING_ID_NONE;
+
+		switch (command.commandType) {
+		case CT_PUSH:
+		case CT_POP:
+			if (command.memorySegment == MS_ARGUMENT) {
+				command.memorySegment = MS_LOCAL;
+				command.value = (uint16_t)(base + command.value);
+			} else if (command.memorySegment == MS_LOCAL) {
+				command.value = (uint16_t)(localBase + command.value);
+			}
+			result = AppendCommand(list, &command);
+			break;
+		case CT_LABEL:
+		case CT_GOTO:
+		case CT_IFGOTO:
+			command.nameId = InternInlineLabel(names, functionName, functionNameLength, site
+														, GetString(&callee->names, body[i].nameId), GetStringLength(&callee->names, body[i].nameId));
+			result = (command.nameId != STRING_ID_INVALID) ? AppendCommand(list, &command) : 0;
+			break;
+		case CT_RETURN:
+			for (uint32_t p = 0; (p < 2) && (result != 0); p++) {
+				if (candidate->savePointer[p] != 0) {
+					result = AppendNewCommand(list, CT_PUSH, MS_LOCAL, saveSlot[p], STRING_ID_NONE, call)
+							&& AppendNewCommand(list, CT_POP, MS_POINTER, p, STRING_ID_NONE, call);
+				}
+			}
+			if (	(result != 0)
+				&& ((i + 1) < length)
+			) {
+				if (endLabel == STRING_ID_INVALID) {
+					endLabel = InternInlineLabel(names, functionName, functionNameLength, site, NULL, 0);
+				}
+				result = (endLabel != STRING_ID_INVALID)
+						&& AppendNewCommand(list, CT_GOTO, MS_UNKNOWN, 0, endLabel, call);
+			}
+			break;
+		default:
+			result = AppendCommand(list, &command);
+			break;
+		}
+	}
+
+	if (	(result != 0)
+		&& (endLabel != STRING_ID_INVALID)
+	) {
+		result = AppendNewCommand(list, CT_LABEL, MS_UNKNOWN, 0, endLabel, call);
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteInlineBody
+***************************************************************************************************************
+*/
+
+static uint8_t NeedsZero(const T_vmCommand* body, uint32_t length, uint16_t local, uint8_t hasLabels) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks whether a local of an inlined function has to be cleared at the call site
+
+	\param[in]		body			Pointer to function command of the function
+	\param[in]		length		Number of commands of the function, including the function command
+	\param[in]		local			Index of the local
+	\param[in]		hasLabels	1: the body contains labels
+
+	\returns
+		0: the local is never read, or straight line code writes it before it is read
+		1: the local must start at 0
+
+***************************************************************************************************************
+*/
+	uint8_t written = 0;
+
+	for (uint32_t i = 1; i < length; i++) {
+		if (	(body[i].memorySegment != MS_LOCAL)
+			|| (body[i].value != local)
+		) {
+			continue;
+		}
+		if (body[i].commandType == CT_PUSH) {
+			return ((written != 0) && (hasLabels == 0)) ? 0 : 1;
+		}
+		if (body[i].commandType == CT_POP) {
+			written = 1;
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End NeedsZero
+***************************************************************************************************************
+*/
+
+static uint32_t InternInlineLabel(T_stringTable* names, const char* function, uint32_t functionLength, uint32_t site, const char* label, uint32_t labelLength) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function interns the name of a label of an inlined function, "<function>$<site>$<label>"
+
+	\param[in,out]	names					Pointer to string table of the caller's program
+	\param[in]		function				Pointer to name of the inlined function
+	\param[in]		functionLength		Length of the function name
+	\param[in]		site					Number of the call site within the program
+	\param[in]		label					Pointer to name of the label, NULL for the end of the body "<function>$<site>"
+	\param[in]		labelLength			Length of the label name
+
+	\returns
+		ID of the name, STRING_ID_INVALID when out of memory
+
+	\note
+		- the code writer prefixes labels with the name of the caller, so the names only have to be unique within
+		  one caller
+
+***************************************************************************************************************
+*/
+	uint32_t size = functionLength + labelLength + 16;
+	char* buffer = malloc(size);
+	uint32_t id = STRING_ID_INVALID;
+	int length = 0;
+
+	if (buffer == NULL) {
+		return STRING_ID_INVALID;
+	}
+	if (label != NULL) {
+		length = snprintf(buffer, size, "%.*s$%u$%.*s", (int)functionLength, function, site, (int)labelLength, label);
+	} else {
+		length = snprintf(buffer, size, "%.*s$%u", (int)functionLength, function, site);
+	}
+	if (length > 0) {
+		id = InternString(names, buffer, (uint32_t)length);
+	}
+	free(buffer);
+	return id;
+}
+/*
+***************************************************************************************************************
+	End InternInlineLabel
+***************************************************************************************************************
+*/
+
+static uint8_t AppendCommand(T_commandList* list, const T_vmCommand* command) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a command to a command list
+
+	\param[in,out]	list			Pointer to command list
+	\param[in]		command		Pointer to command
+
+	\returns
+		0: out of memory
+		1: command is appended
+
+***************************************************************************************************************
+*/
+	if (list->count == list->capacity) {
+		uint32_t capacity = (list->capacity > 0) ? list->capacity * 2 : INITIAL_CAPACITY;
+		T_vmCommand* commands = realloc(list->commands, capacity * sizeof(T_vmCommand));
+
+		if (commands == NULL) {
+			return 0;
+		}
+		list->commands = commands;
+		list->capacity = capacity;
+	}
+	list->commands[list->count] = *command;
+	list->count++;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AppendCommand
+***************************************************************************************************************
+*/
+
+static uint8_t AppendNewCommand(T_commandList* list, E_commandType commandType, E_memorySegment memorySegment, uint32_t value, uint32_t nameId, const T_vmCommand* call) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a command that is generated at a call site to a command list
+
+	\param[in,out]	list				Pointer to command list
+	\param[in]		commandType		Type of the command
+	\param[in]		memorySegment	Segment (push and pop)
+	\param[in]		value				Index (push and pop)
+	\param[in]		nameId			Label name (label and goto), STRING_ID_NONE for none
+	\param[in]		call				Pointer to call command, its position is reported
+
+	\returns
+		0: out of memory
+		1: command is appended
+
+***************************************************************************************************************
+*/
+	T_vmCommand command;
+
+	command.commandType = (uint8_t)commandType;
+	command.memorySegment = (uint8_t)memorySegment;
+	command.value = (uint16_t)value;
+	command.nameId = nameId;
+	command.lineNumber = call->lineNumber;
+	command.column = call->column;
+	return AppendCommand(list, &command);
+}
+/*
+***************************************************************************************************************
+	End AppendNewCommand
+***************************************************************************************************************
+*/
+
+static uint8_t AddInlineSite(T_inlineReport* report, uint32_t caller, uint32_t callee, uint32_t lineNumber) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function adds an inlined call site to the report
+
+	\param[in,out]	report			Pointer to inline report
+	\param[in]		caller			Index of the calling function
+	\param[in]		callee			Index of the inlined function
+	\param[in]		lineNumber		Line number of the call command
+
+	\returns
+		0: out of memory
+		1: call site is added
+
+***************************************************************************************************************
+*/
+	if (report->count == report->capacity) {
+		uint32_t capacity = (report->capacity > 0) ? report->capacity * 2 : INITIAL_CAPACITY;
+		T_inlineSite* sites = realloc(report->sites, capacity * sizeof(T_inlineSite));
+
+		if (sites == NULL) {
+			return 0;
+		}
+		report->sites = sites;
+		report->capacity = capacity;
+	}
+	report->sites[report->count].caller = caller;
+	report->sites[report->count].callee = callee;
+	report->sites[report->count].lineNumber = lineNumber;
+	report->count++;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AddInlineSite
+***************************************************************************************************************
+*/
@@ -0,0 +1,103 @@
+/*! \file
+***************************************************************************************************************
+file name:					inliner.h
+*	\copyright				FourE
+*	\brief					inliner header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Substitutes the bodies of small leaf functions at their call sites in the parsed VM programs.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The arguments and locals of an inlined function are mapped onto extra locals of the calling function, so
+	the result is plain VM code that is translated and optimized like every other command.
+
+***************************************************************************************************************
+*/
+
+#ifndef __INLINER_H
+#define __INLINER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "parser.h"
+#include "callgraph.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// call command that was replaced by the body of the called function
+typedef struct {
+	uint32_t caller;						// function index in the call graph
+	uint32_t callee;						// function index in the call graph
+	uint32_t lineNumber;					// line number of the call command
+} T_inlineSite;
+
+typedef struct {
+	T_inlineSite* sites;
+	uint32_t count;
+	uint32_t capacity;
+	uint32_t commandsBefore;			// VM commands of all programs before inlining
+	uint32_t commandsAfter;				// VM commands of all programs after inlining
+} T_inlineReport;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InlineLeafFunctions(const T_callGraph* graph, T_vmProgram* const* programs, uint32_t count, uint32_t limit, T_inlineReport* report);
+void FreeInlineReport(T_inlineReport* report);
+void PrintInlineReport(const T_inlineReport* report, const T_callGraph* graph);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __INLINER_H
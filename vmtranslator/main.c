@@ -30,9 +30,12 @@ file name:					VMTranslator.c
 
 #include <stdio.h>
 #include <stdint.h>
-#include <stdlib.h>			// EXIT_FAILURE
+#include <stdlib.h>			// EXIT_FAILURE, strtoul
+#include <string.h>
 #include "filehelper.h"
 #include "processhelper.h"
+#include "workerpool.h"			// MAX_WORKER_THREADS
+#include "diagnostics.h"
 
 /*
 ***************************************************************************************************************
@@ -47,6 +50,11 @@ file name:					VMTranslator.c
 ***************************************************************************************************************
 */
 
+// name of an optimization for -f<name> and -fno-<name>
+typedef struct {
+	const char* name;
+	uint32_t flag;
+} T_optimizationName;
 
 /*
 ***************************************************************************************************************
@@ -54,6 +62,9 @@ file name:					VMTranslator.c
 ***************************************************************************************************************
 */
 
+static uint8_t ParseArguments(int argc, char *argv[], T_translatorOptions* options, char** input);
+static uint8_t ParseOptimization(const char* argument, uint32_t* optimizations);
+
 /*
 ***************************************************************************************************************
 	GLOBAL VARS
@@ -67,6 +78,24 @@ file name:					VMTranslator.c
 ***************************************************************************************************************
 */
 
+static const T_optimizationName optimizationNames[] = {
+	 {"peephole"		,OPT_PEEPHOLE		}
+	,{"cache-top"		,OPT_CACHE_TOP		}
+	,{"shared-calls"	,OPT_SHARED_CALLS	}
+	,{"fold-constants"	,OPT_FOLD_CONSTANTS	}
+	,{"specialize-index"	,OPT_SPECIALIZE_INDEX	}
+	,{"fuse-compare"		,OPT_FUSE_COMPARE	}
+	,{"fuse-move"			,OPT_FUSE_MOVE		}
+	,{"fuse-array"		,OPT_FUSE_ARRAY		}
+	,{"dead-functions"	,OPT_DEAD_FUNCTIONS	}
+	,{"inline"			,OPT_INLINE			}
+	,{"tail-calls"		,OPT_TAIL_CALLS		}
+	,{"static-frames"	,OPT_STATIC_FRAMES	}
+	,{"trim-frames"		,OPT_TRIM_FRAMES	}
+};
+
+#define MAX_OPTIMIZATION_NAMES (sizeof(optimizationNames) / sizeof(optimizationNames[0]))
+
 
 /*
 ***************************************************************************************************************
@@ -83,54 +112,63 @@ int main(int argc, char *argv[]) {
 
 ***************************************************************************************************************
 */
-	FILE* pFile = NULL;
-	FILE* pOutFile = NULL;
+	T_outputFile outFile;
 
 	E_inputFileType inputFileType;
 	char outputFileName[MAX_FILENAME_LENGTH] = { 0 };
+	T_translatorOptions options;
+	char* input = NULL;
 
-	// argc should be 2 for correct execution
-   if (argc != 2) {
-   	printf("Usage: %s [VM file/directory]\n", argv[0]);
-   	return EXIT_FAILURE;
-   }
+	InitTranslatorOptions(&options);
+
+	if (ParseArguments(argc, argv, &options, &input) == 0) {
+		fprintf(stderr, "Usage: %s [-j N] [-m] [-s] [-O0|-O1|-O2|-Os] [-f[no-]<optimization>] [-finline-limit=N] [-t asm|hack|bin|c] [-v quiet|error|warn|trace] [VM file/directory]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
 
-   inputFileType = GetInputFileType(argv[1]);
+   inputFileType = GetInputFileType(input);
 
    switch(inputFileType) {
    case IFT_SINGLE_VM_FILE:
-   	CreateOutputFileName(argv[1], outputFileName, IFT_SINGLE_VM_FILE);
+   	CreateOutputFileName(input, outputFileName, IFT_SINGLE_VM_FILE, GetOutputExtension(options.outputFormat));
    	break;
    case IFT_DIRECTORY:
-   	CreateOutputFileName(argv[1], outputFileName, IFT_DIRECTORY);
+   	CreateOutputFileName(input, outputFileName, IFT_DIRECTORY, GetOutputExtension(options.outputFormat));
    	break;
    default:
-   	break;
+   	DIAG_ERROR(DC_NO_INPUT, input, 0, 0, NULL);
+   	FlushDiagnostics();
+   	return EXIT_FAILURE;
    }
 
 	// try to open output file
-	pOutFile = fopen(outputFileName, "w");
-	if (pOutFile == NULL) {
-		printf("Error: could not create output file '%s'\n", outputFileName);
-		fclose(pFile);
+	if (OpenOutputFile(&outFile, outputFileName, options.mapOutput) == 0) {
+		DIAG_ERROR(DC_CREATE_OUTPUT, outputFileName, 0, 0, NULL);
+		FlushDiagnostics();
 		return EXIT_FAILURE;
 	}
 
 	switch(inputFileType) {
 	case IFT_SINGLE_VM_FILE:
-		ProcessVMFile(argv[1], pOutFile);
+		ProcessVMFile(input, &outFile, &options);
 		break;
 	case IFT_DIRECTORY:
 		// only write bootstrap code when there are one or more .vm files inside a directory
-		ProcessDirectory(argv[1], pOutFile);
+		ProcessDirectory(input, &outFile, &options);
 		break;
 	default:
 		break;
 	}
 
-	if (pOutFile != NULL) {
-		fclose(pOutFile);
-		pOutFile = NULL;
+	CloseOutputFile(&outFile);
+
+	if (options.printStats != 0) {
+		PrintOutputStats(&outFile);
+	}
+
+	// errors and warnings are written in one batch, sorted by file and line
+	if (FlushDiagnostics() > 0) {
+		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
@@ -139,3 +177,154 @@ int main(int argc, char *argv[]) {
 	End main
 ***************************************************************************************************************
 */
+
+static uint8_t ParseArguments(int argc, char *argv[], T_translatorOptions* options, char** input) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses the command line arguments
+
+	\param[in]		argc			Number of arguments
+	\param[in]		argv			Array of arguments
+	\param[out]		options		Pointer to translator options
+	\param[out]		input			Pointer that receives the VM file/directory argument
+
+	\returns
+			0: arguments are not valid
+			1: arguments are valid
+
+	\note
+		- -j N sets the number of threads that translate the files of a directory (1 .. MAX_WORKER_THREADS)
+		- -m writes the output file through a memory mapping
+		- -s prints the throughput of the write side, the optimizer statistics and the call sizes
+		- -O0 translates without optimization (default), -O1 folds constants, specializes push and pop, fuses
+		  compare and if-goto, push and pop and array accesses, removes the functions that are not reachable
+		  from Sys.init (directory only) and runs the peephole optimizer, -O2 also keeps the top of the stack
+		  in D, inlines small leaf functions, turns call followed by return into a tail call and gives the
+		  functions that are not recursive a frame at a fixed address, the other frames only save the THIS
+		  and THAT their function sets (both directory only), -Os calls and returns through shared routines
+		  instead of inlining to shrink the code
+		- -f<name> and -fno-<name> switch a single optimization on or off, they are applied in order
+		- -finline-limit=N sets the largest function body in VM commands that is inlined (0 .. MAX_INLINE_LIMIT)
+		- -t sets the output format: Hack assembly code (asm, default), or machine code from the integrated
+		  assembler as .hack text (hack) or as binary image with 2 bytes per word (bin), or C code that is
+		  built with the C compiler (c)
+		- -v sets the level of the diagnostics that are written to stderr (default warn)
+
+***************************************************************************************************************
+*/
+	*input = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-j") == 0) {
+			char* end = NULL;
+			unsigned long jobs = 0;
+
+			if ((i + 1) >= argc) {
+				return 0;
+			}
+			i++;
+			jobs = strtoul(argv[i], &end, 10);
+			if ((*end != '\0') || (jobs < 1) || (jobs > MAX_WORKER_THREADS)) {
+				fprintf(stderr, "Error: number of jobs must be 1 .. %d\n", MAX_WORKER_THREADS);
+				return 0;
+			}
+			options->jobs = (uint16_t)jobs;
+		} else if (strcmp(argv[i], "-m") == 0) {
+			options->mapOutput = 1;
+		} else if (strcmp(argv[i], "-s") == 0) {
+			options->printStats = 1;
+		} else if (strcmp(argv[i], "-O0") == 0) {
+			options->optimizations = 0;
+		} else if (strcmp(argv[i], "-O1") == 0) {
+			options->optimizations = OPT_LEVEL_1;
+		} else if (strcmp(argv[i], "-O2") == 0) {
+			options->optimizations = OPT_LEVEL_2;
+		} else if (strcmp(argv[i], "-Os") == 0) {
+			options->optimizations = OPT_LEVEL_S;
+		} else if (strncmp(argv[i], "-finline-limit=", 15) == 0) {
+			char* end = NULL;
+			unsigned long limit = strtoul(&argv[i][15], &end, 10);
+
+			if ((end == &argv[i][15]) || (*end != '\0') || (limit > MAX_INLINE_LIMIT)) {
+				fprintf(stderr, "Error: inline limit must be 0 .. %d\n", MAX_INLINE_LIMIT);
+				return 0;
+			}
+			options->inlineLimit = (uint16_t)limit;
+		} else if (strncmp(argv[i], "-f", 2) == 0) {
+			if (ParseOptimization(&argv[i][2], &options->optimizations) == 0) {
+				fprintf(stderr, "Error: unknown optimization '%s'\n", argv[i]);
+				return 0;
+			}
+		} else if (strcmp(argv[i], "-t") == 0) {
+			if (	((i + 1) >= argc)
+				|| (ParseOutputFormat(argv[i + 1], &options->outputFormat) == 0)
+			) {
+				return 0;
+			}
+			i++;
+		} else if (strcmp(argv[i], "-v") == 0) {
+			E_diagnosticLevel level = DL_WARN;
+
+			if (	((i + 1) >= argc)
+				|| (ParseDiagnosticLevel(argv[i + 1], &level) == 0)
+			) {
+				return 0;
+			}
+			i++;
+			SetDiagnosticLevel(level);
+		} else if (*input == NULL) {
+			*input = argv[i];
+		} else {
+			return 0;
+		}
+	}
+	return (*input != NULL) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End ParseArguments
+***************************************************************************************************************
+*/
+
+static uint8_t ParseOptimization(const char* argument, uint32_t* optimizations) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function switches an optimization on (name) or off (no-name)
+
+	\param[in]		argument			Pointer to the argument after "-f"
+	\param[in,out]	optimizations	Pointer to OPT_ flags
+
+	\returns
+			0: name is not an optimization
+			1: optimization was switched
+
+***************************************************************************************************************
+*/
+	uint8_t enable = 1;
+
+	if (strncmp(argument, "no-", 3) == 0) {
+		enable = 0;
+		argument += 3;
+	}
+
+	for (uint8_t i = 0; i < MAX_OPTIMIZATION_NAMES; i++) {
+		if (strcmp(argument, optimizationNames[i].name) == 0) {
+			if (enable != 0) {
+				*optimizations |= optimizationNames[i].flag;
+			} else {
+				*optimizations &= ~optimizationNames[i].flag;
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End ParseOptimization
+***************************************************************************************************************
+*/
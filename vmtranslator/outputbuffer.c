@@ -0,0 +1,339 @@
+/*! \file
+***************************************************************************************************************
+file name:					outputbuffer.c
+*	\copyright				FourE
+*	\brief					output buffer source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "outputbuffer.h"
+#include <stdarg.h>
+#include <stdio.h>			// vsnprintf
+#include <stdlib.h>			// realloc, free
+#include <string.h>			// memcpy, strlen
+#include <assert.h>
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define MIN_GROW_SIZE			(64 * 1024)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t ReserveOutputBuffer(T_outputBuffer* buffer, size_t size);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void InitOutputBuffer(T_outputBuffer* buffer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an empty output buffer, memory is allocated when the first data is appended
+
+	\param[out]		buffer		Pointer to output buffer
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+
+	buffer->data = NULL;
+	buffer->length = 0;
+	buffer->capacity = 0;
+}
+/*
+***************************************************************************************************************
+	End InitOutputBuffer
+***************************************************************************************************************
+*/
+
+void FreeOutputBuffer(T_outputBuffer* buffer) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the memory of the output buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+
+	free(buffer->data);
+	InitOutputBuffer(buffer);
+}
+/*
+***************************************************************************************************************
+	End FreeOutputBuffer
+***************************************************************************************************************
+*/
+
+uint8_t AppendBytes(T_outputBuffer* buffer, const char* data, size_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends raw bytes to the output buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+	\param[in]		data			Pointer to bytes
+	\param[in]		length		Number of bytes
+
+	\returns
+			0: out of memory
+			1: bytes were appended
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+	assert((data != NULL) || (length == 0));
+
+	if (ReserveOutputBuffer(buffer, length) == 0) {
+		return 0;
+	}
+	memcpy(&buffer->data[buffer->length], data, length);
+	buffer->length += length;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AppendBytes
+***************************************************************************************************************
+*/
+
+uint8_t AppendString(T_outputBuffer* buffer, const char* string) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a string to the output buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+	\param[in]		string		Pointer to string
+
+	\returns
+			0: out of memory
+			1: string was appended
+
+	\note
+		- make sure string is nul terminated with '\0
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+	assert(string != NULL);
+
+	return AppendBytes(buffer, string, strlen(string));
+}
+/*
+***************************************************************************************************************
+	End AppendString
+***************************************************************************************************************
+*/
+
+uint8_t AppendFormat(T_outputBuffer* buffer, const char* format, ...) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends a printf style formatted string to the output buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+	\param[in]		format		Pointer to printf style format string
+
+	\returns
+			0: encoding error or out of memory
+			1: formatted string was appended
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+	assert(format != NULL);
+
+	va_list arguments;
+	int val = 0;
+	size_t available = buffer->capacity - buffer->length;
+
+	// first try to format into the space that is available
+	va_start(arguments, format);
+	val = vsnprintf((available > 0) ? &buffer->data[buffer->length] : NULL, available, format, arguments);
+	va_end(arguments);
+
+	// vsnprintf returns a negative value if something went wrong while encoding the string
+	if (val < 0) {
+		return 0;
+	}
+
+	if ((size_t)val >= available) {
+		// did not fit, grow the buffer and format again
+		if (ReserveOutputBuffer(buffer, (size_t)val + 1) == 0) {
+			return 0;
+		}
+		va_start(arguments, format);
+		val = vsnprintf(&buffer->data[buffer->length], (size_t)val + 1, format, arguments);
+		va_end(arguments);
+		if (val < 0) {
+			return 0;
+		}
+	}
+	buffer->length += (size_t)val;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End AppendFormat
+***************************************************************************************************************
+*/
+
+char* BeginAppend(T_outputBuffer* buffer, size_t maxLength) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function makes room for at least maxLength bytes, so the caller can write directly into the buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+	\param[in]		maxLength	Maximum number of bytes the caller writes
+
+	\returns
+		Pointer to the first free byte, NULL when out of memory
+
+	\note
+		- finish with EndAppend, the buffer must not be changed in between
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+
+	if (ReserveOutputBuffer(buffer, maxLength) == 0) {
+		return NULL;
+	}
+	return &buffer->data[buffer->length];
+}
+/*
+***************************************************************************************************************
+	End BeginAppend
+***************************************************************************************************************
+*/
+
+void EndAppend(T_outputBuffer* buffer, const char* end) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function adds the bytes that were written after BeginAppend to the buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+	\param[in]		end			Pointer just after the last byte that was written
+
+***************************************************************************************************************
+*/
+	assert(buffer != NULL);
+	assert(end >= &buffer->data[buffer->length]);
+	assert(end <= &buffer->data[buffer->capacity]);
+
+	buffer->length = (size_t)(end - buffer->data);
+}
+/*
+***************************************************************************************************************
+	End EndAppend
+***************************************************************************************************************
+*/
+
+static uint8_t ReserveOutputBuffer(T_outputBuffer* buffer, size_t size) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function makes sure there is room for at least size bytes after the data in the buffer
+
+	\param[in,out]	buffer		Pointer to output buffer
+	\param[in]		size			Number of bytes that must fit in the buffer
+
+	\returns
+			0: out of memory
+			1: buffer has enough room
+
+***************************************************************************************************************
+*/
+	if ((buffer->capacity - buffer->length) >= size) {
+		return 1;
+	}
+
+	// grow at least by half of the current capacity to keep appending cheap
+	size_t capacity = buffer->capacity + (buffer->capacity / 2);
+	if (capacity < (buffer->length + size)) {
+		capacity = buffer->length + size;
+	}
+	if (capacity < MIN_GROW_SIZE) {
+		capacity = MIN_GROW_SIZE;
+	}
+
+	char* data = realloc(buffer->data, capacity);
+	if (data == NULL) {
+		return 0;
+	}
+	buffer->data = data;
+	buffer->capacity = capacity;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ReserveOutputBuffer
+***************************************************************************************************************
+*/
@@ -0,0 +1,99 @@
+/*! \file
+***************************************************************************************************************
+file name:					outputbuffer.h
+*	\copyright				FourE
+*	\brief					output buffer header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Growable in-memory buffer that receives the generated assembly code
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The data in the buffer is not nul terminated, use length
+
+***************************************************************************************************************
+*/
+
+#ifndef __OUTPUTBUFFER_H
+#define __OUTPUTBUFFER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include <stddef.h>			// size_t
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+// appends a string literal, the length is known at compile time
+#define AppendLiteral(buffer, literal)		AppendBytes((buffer), (literal), sizeof(literal) - 1)
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef struct {
+	char* data;
+	size_t length;				// number of bytes in use
+	size_t capacity;			// number of bytes allocated
+} T_outputBuffer;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void InitOutputBuffer(T_outputBuffer* buffer);
+void FreeOutputBuffer(T_outputBuffer* buffer);
+uint8_t AppendBytes(T_outputBuffer* buffer, const char* data, size_t length);
+uint8_t AppendString(T_outputBuffer* buffer, const char* string);
+uint8_t AppendFormat(T_outputBuffer* buffer, const char* format, ...);
+char* BeginAppend(T_outputBuffer* buffer, size_t maxLength);
+void EndAppend(T_outputBuffer* buffer, const char* end);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __OUTPUTBUFFER_H
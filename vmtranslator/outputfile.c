@@ -0,0 +1,423 @@
+/*! \file
+***************************************************************************************************************
+file name:					outputfile.c
+*	\copyright				FourE
+*	\brief					output file source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "outputfile.h"
+#include <string.h>			// memcpy, memset
+#include <time.h>				// clock_gettime
+#include <limits.h>			// IOV_MAX
+#include <assert.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>			// open
+#include <unistd.h>			// close, ftruncate, lseek
+#include <sys/mman.h>		// mmap, munmap
+#include <sys/stat.h>		// fstat
+#include <sys/uio.h>			// writev
+#endif
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#if !defined(IOV_MAX)
+#define IOV_MAX					(1024)
+#endif
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint64_t GetNanoseconds(void);
+#if !defined(_WIN32)
+static uint8_t WriteMapped(T_outputFile* file, const T_outputBuffer* const* buffers, uint32_t count, uint64_t total);
+static uint8_t WriteVector(T_outputFile* file, const T_outputBuffer* const* buffers, uint32_t count);
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t OpenOutputFile(T_outputFile* file, const char* fileName, uint8_t useMapping) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function creates (or truncates) the output file
+
+	\param[out]		file				Pointer to output file
+	\param[in]		fileName			Pointer to fileName
+	\param[in]		useMapping		1: write the file through a memory mapping, 0: write the file with writev
+
+	\returns
+			0: file could not be created
+			1: file was created
+
+	\note
+		- make sure fileName string is nul terminated with '\0
+
+***************************************************************************************************************
+*/
+	assert(file != NULL);
+	assert(fileName != NULL);
+
+	memset(file, 0, sizeof(T_outputFile));
+	file->useMapping = useMapping;
+
+#if !defined(_WIN32)
+	file->fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0666);
+	return (file->fd >= 0) ? 1 : 0;
+#else
+	file->pFile = fopen(fileName, "wb");
+	return (file->pFile != NULL) ? 1 : 0;
+#endif
+}
+/*
+***************************************************************************************************************
+	End OpenOutputFile
+***************************************************************************************************************
+*/
+
+uint8_t CloseOutputFile(T_outputFile* file) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function closes the output file
+
+	\param[in,out]	file		Pointer to output file
+
+	\returns
+			0: closing failed (data may be lost)
+			1: file was closed
+
+***************************************************************************************************************
+*/
+	assert(file != NULL);
+
+	uint8_t result = 1;
+
+#if !defined(_WIN32)
+	if (file->fd >= 0) {
+		result = (close(file->fd) == 0) ? 1 : 0;
+		file->fd = -1;
+	}
+#else
+	if (file->pFile != NULL) {
+		result = (fclose(file->pFile) == 0) ? 1 : 0;
+		file->pFile = NULL;
+	}
+#endif
+	return result;
+}
+/*
+***************************************************************************************************************
+	End CloseOutputFile
+***************************************************************************************************************
+*/
+
+uint8_t WriteOutputFile(T_outputFile* file, const T_outputBuffer* const* buffers, uint32_t count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends the contents of a number of output buffers to the output file
+
+	\param[in,out]	file			Pointer to opened output file
+	\param[in]		buffers		Array of pointers to output buffers, NULL entries are skipped
+	\param[in]		count			Number of entries in buffers
+
+	\returns
+			0: writing failed
+			1: writing was successful
+
+	\note
+		- collect as many buffers as possible before calling, every call costs at least one system call
+		- when the file can not be mapped (for example when it is not a regular file) writev is used
+
+***************************************************************************************************************
+*/
+	assert(file != NULL);
+	assert((buffers != NULL) || (count == 0));
+
+	uint64_t start = GetNanoseconds();
+	uint64_t total = 0;
+	uint8_t result = 1;
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (buffers[i] != NULL) {
+			total += buffers[i]->length;
+		}
+	}
+
+	if (total > 0) {
+#if !defined(_WIN32)
+		if ((file->useMapping == 0) || (WriteMapped(file, buffers, count, total) == 0)) {
+			result = WriteVector(file, buffers, count);
+		}
+#else
+		for (uint32_t i = 0; (i < count) && (result != 0); i++) {
+			if ((buffers[i] != NULL) && (buffers[i]->length > 0)) {
+				file->stats.writeCalls++;
+				if (fwrite(buffers[i]->data, 1, buffers[i]->length, file->pFile) != buffers[i]->length) {
+					result = 0;
+				}
+			}
+		}
+#endif
+		if (result != 0) {
+			file->size += total;
+			file->stats.bytes += total;
+		}
+	}
+
+	file->stats.nanoseconds += GetNanoseconds() - start;
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteOutputFile
+***************************************************************************************************************
+*/
+
+void PrintOutputStats(const T_outputFile* file) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the throughput of the write side
+
+	\param[in]		file		Pointer to output file
+
+***************************************************************************************************************
+*/
+	assert(file != NULL);
+
+	double seconds = (double)file->stats.nanoseconds / 1e9;
+	double megabytes = (double)file->stats.bytes / (1024.0 * 1024.0);
+
+	printf("output: %llu bytes in %u %s, %.3f ms, %.1f MB/s\n"
+			, (unsigned long long)file->stats.bytes, file->stats.writeCalls
+			, (file->useMapping != 0) ? "mappings/writes" : "writes"
+			, seconds * 1e3, (seconds > 0.0) ? (megabytes / seconds) : 0.0);
+}
+/*
+***************************************************************************************************************
+	End PrintOutputStats
+***************************************************************************************************************
+*/
+
+static uint64_t GetNanoseconds(void) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns a monotonic time stamp
+
+	\returns
+		Time in nanoseconds
+
+***************************************************************************************************************
+*/
+#if !defined(_WIN32)
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+#else
+	return ((uint64_t)clock() * 1000000000u) / CLOCKS_PER_SEC;
+#endif
+}
+/*
+***************************************************************************************************************
+	End GetNanoseconds
+***************************************************************************************************************
+*/
+
+#if !defined(_WIN32)
+static uint8_t WriteMapped(T_outputFile* file, const T_outputBuffer* const* buffers, uint32_t count, uint64_t total) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function grows the output file with ftruncate and copies the buffers into a memory mapping of the new
+		part of the file
+
+	\param[in,out]	file			Pointer to opened output file
+	\param[in]		buffers		Array of pointers to output buffers, NULL entries are skipped
+	\param[in]		count			Number of entries in buffers
+	\param[in]		total			Sum of the lengths of the buffers
+
+	\returns
+			0: file could not be mapped, nothing was written
+			1: buffers were copied to the file
+
+	\note
+		- the mapping starts at the page that holds the current end of the file
+
+***************************************************************************************************************
+*/
+	uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+	uint64_t mapStart = file->size - (file->size % pageSize);
+	size_t mapLength = (size_t)(file->size + total - mapStart);
+	struct stat fileStatus;
+	char* map = NULL;
+	char* position = NULL;
+
+	if ((fstat(file->fd, &fileStatus) != 0) || (S_ISREG(fileStatus.st_mode) == 0)) {
+		return 0;
+	}
+	if (ftruncate(file->fd, (off_t)(file->size + total)) != 0) {
+		return 0;
+	}
+
+	map = mmap(NULL, mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, (off_t)mapStart);
+	if (map == MAP_FAILED) {
+		// the caller writes the buffers into the space that was added instead
+		return 0;
+	}
+	file->stats.writeCalls++;
+
+	position = map + (file->size - mapStart);
+	for (uint32_t i = 0; i < count; i++) {
+		if ((buffers[i] != NULL) && (buffers[i]->length > 0)) {
+			memcpy(position, buffers[i]->data, buffers[i]->length);
+			position += buffers[i]->length;
+		}
+	}
+
+	munmap(map, mapLength);
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End WriteMapped
+***************************************************************************************************************
+*/
+
+static uint8_t WriteVector(T_outputFile* file, const T_outputBuffer* const* buffers, uint32_t count) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the buffers to the file with writev, up to IOV_MAX buffers per call
+
+	\param[in,out]	file			Pointer to opened output file
+	\param[in]		buffers		Array of pointers to output buffers, NULL entries are skipped
+	\param[in]		count			Number of entries in buffers
+
+	\returns
+			0: writing failed
+			1: writing was successful
+
+	\note
+		- writev may write less than requested, the remaining bytes are written with the next call
+		- the buffers are written at the end of the data in the file, also when mapped writes were done before
+
+***************************************************************************************************************
+*/
+	struct iovec vectors[IOV_MAX];
+	uint32_t index = 0;
+	int used = 0;
+	int first = 0;
+
+	// mapped writes do not move the file offset
+	if ((file->useMapping != 0) && (lseek(file->fd, (off_t)file->size, SEEK_SET) < 0)) {
+		return 0;
+	}
+
+	while ((index < count) || (first < used)) {
+		// fill the vector with the next buffers
+		if (first == used) {
+			first = 0;
+			used = 0;
+		}
+		while ((index < count) && (used < IOV_MAX)) {
+			if ((buffers[index] != NULL) && (buffers[index]->length > 0)) {
+				vectors[used].iov_base = buffers[index]->data;
+				vectors[used].iov_len = buffers[index]->length;
+				used++;
+			}
+			index++;
+		}
+		if (first == used) {
+			break;
+		}
+
+		file->stats.writeCalls++;
+		ssize_t written = writev(file->fd, &vectors[first], used - first);
+		if (written < 0) {
+			return 0;
+		}
+
+		// skip the vectors that are written completely, and the written part of the next one
+		while ((first < used) && ((size_t)written >= vectors[first].iov_len)) {
+			written -= (ssize_t)vectors[first].iov_len;
+			first++;
+		}
+		if (first < used) {
+			vectors[first].iov_base = (char*)vectors[first].iov_base + written;
+			vectors[first].iov_len -= (size_t)written;
+		}
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End WriteVector
+***************************************************************************************************************
+*/
+#endif
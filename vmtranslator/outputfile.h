@@ -0,0 +1,108 @@
+/*! \file
+***************************************************************************************************************
+file name:					outputfile.h
+*	\copyright				FourE
+*	\brief					output file header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Writes output buffers to the .asm file with as few system calls as possible
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The output file is either written with writev or, when mapping is selected, it is grown with ftruncate
+	and the buffers are copied into a memory mapping of the file. On systems without POSIX I/O the file is
+	written with fwrite.
+
+***************************************************************************************************************
+*/
+
+#ifndef __OUTPUTFILE_H
+#define __OUTPUTFILE_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include "outputbuffer.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// statistics of the write side
+typedef struct {
+	uint64_t bytes;				// number of bytes written
+	uint32_t writeCalls;			// number of write, writev or fwrite calls (or mappings)
+	uint64_t nanoseconds;		// time spent writing
+} T_outputStats;
+
+typedef struct {
+#if defined(_WIN32)
+	FILE* pFile;
+#else
+	int fd;
+#endif
+	uint8_t useMapping;			// 1: copy the buffers into a memory mapping of the file
+	uint64_t size;					// number of bytes in the file
+	T_outputStats stats;
+} T_outputFile;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t OpenOutputFile(T_outputFile* file, const char* fileName, uint8_t useMapping);
+uint8_t CloseOutputFile(T_outputFile* file);
+uint8_t WriteOutputFile(T_outputFile* file, const T_outputBuffer* const* buffers, uint32_t count);
+void PrintOutputStats(const T_outputFile* file);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __OUTPUTFILE_H
@@ -1,426 +1,737 @@
-/*! \file
-***************************************************************************************************************
-file name:					parser.c
-*	\copyright				FourE
-*	\brief					parser source file
-*	\author					Frank Eggink
-*	\date	created:			2020-02-03
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include "parser.h"
-#include <stddef.h>
-#include <assert.h>
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h> // atoi
-
-/*
-***************************************************************************************************************
-	LOCAL DEFINES
-***************************************************************************************************************
-*/
-
-#define NO_TOKENS_FOUND					(0)
-#define MAX_TOKEN_PARTS					(3)
-#define MAX_VMCOMMAND_STRING_LEN		(9) // max string length of string (including '\0') in table vmCommands
-#define MAX_MEMSEGMENT_STRING_LEN	(9) // max string length of string (including '\0') in table vmMemorySegments
-
-/*
-***************************************************************************************************************
-	LOCAL TYPEDEFS
-***************************************************************************************************************
-*/
-
-typedef struct {
-	char vmCommandString[MAX_VMCOMMAND_STRING_LEN];
-	E_commandType command;
-} T_vmCommandString;
-
-typedef struct {
-	char memorySegmentString[MAX_MEMSEGMENT_STRING_LEN];
-	E_memorySegment memorySegment;
-} T_vmMemorySegmentString;
-
-/*
-***************************************************************************************************************
-	LOCAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-static E_commandType ParseCommandType(const char* input);
-static E_memorySegment ParseMemorySegment(const char* input);
-static void ClearCurrentCommand(void);
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL VARS
-***************************************************************************************************************
-*/
-
-static const T_vmCommandString vmCommands[] = {
-	 {"add"			,CT_ADD			}
-	,{"sub"			,CT_SUB			}
-	,{"neg"			,CT_NEG			}
-	,{"eq"			,CT_EQ			}
-   ,{"gt"			,CT_GT			}
-	,{"lt"			,CT_LT			}
-	,{"and"			,CT_AND			}
-	,{"or"			,CT_OR			}
-	,{"not"			,CT_NOT			}
-	,{"push"			,CT_PUSH			}
-	,{"pop"			,CT_POP			}
-	,{"label"		,CT_LABEL		}
-	,{"goto"			,CT_GOTO			}
-	,{"if-goto"		,CT_IFGOTO		}
-	,{"function"	,CT_FUNCTION	}
-	,{"call"			,CT_CALL			}
-	,{"return"		,CT_RETURN		}
-};
-
-
-#define MAX_VM_COMMANDS (sizeof(vmCommands) / sizeof(vmCommands[0]))
-
-static const uint8_t maxVMCommands = MAX_VM_COMMANDS;
-
-
-static const T_vmMemorySegmentString vmMemorySegments[] = {
-	 {"local"		,MS_LOCAL			}
-	,{"argument"	,MS_ARGUMENT		}
-	,{"this"			,MS_THIS				}
-	,{"that"			,MS_THAT				}
-	,{"constant"	,MS_CONSTANT		}
-	,{"static"		,MS_STATIC			}
-	,{"pointer"		,MS_POINTER			}
-	,{"temp"			,MS_TEMP				}
-};
-
-
-#define MAX_VM_MEMORY_SEGMENTS (sizeof(vmMemorySegments) / sizeof(vmMemorySegments[0]))
-
-static const uint8_t maxVMMemorySegments = MAX_VM_MEMORY_SEGMENTS;
-
-static T_vmCommand currentCommand;
-
-
-/*
-***************************************************************************************************************
-	IMPLEMENTATION
-***************************************************************************************************************
-*/
-
-void InitParser(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function initializes the parser
-
-***************************************************************************************************************
-*/
-	ClearCurrentCommand();
-}
-/*
-***************************************************************************************************************
-	End InitParser
-***************************************************************************************************************
-*/
-
-uint8_t ParseCommand(char* input) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function parses input string (command) and dissects it into specific parts like:
-		- commandType
-		- memorySegment
-		- value
-
-	\param[in]		input		Pointer to input string
-
-	\returns
-			0: parsing failed
-			1: parsing was successful
-
-	\note
-		- make sure that input is not NULL
-		- make sure input string is nul terminated with '\0
-
-		- !!! the input string is MODIFIED by the function (strtok modifies it) !!!
-
-***************************************************************************************************************
-*/
-	assert(input != NULL);
-
-	char* token = NULL;
-	uint8_t count = NO_TOKENS_FOUND;
-
-	ClearCurrentCommand();
-
-	// find first token
-	token = strtok(input, " ");
-
-	while (	(token != NULL)
-			&&	(count <= MAX_TOKEN_PARTS)
-	) {
-		count++; // used to keep track of current token in input string
-		printf("%s\n", token);
-
-		// parse and store token based on "position" in input string
-		switch (count) {
-		case 1:
-			// command
-			currentCommand.commandType = ParseCommandType(token);
-			break;
-		case 2:
-			// argument 1
-			if (	(currentCommand.commandType == CT_PUSH)
-				|| (currentCommand.commandType == CT_POP)
-			) {
-				currentCommand.argument1.memorySegment = ParseMemorySegment(token);
-			} else {
-				// assume it is: label, goto, if-goto, function, call
-				currentCommand.argument1.name = token;
-			}
-			break;
-		case 3:
-			// argument 2
-			currentCommand.value = atoi(token);
-			break;
-		default:
-			// not handled
-			break;
-		}
-
-		// get next token
-		token = strtok(NULL, " ");
-	}
-
-	//printf("count = %d\n", count);
-	if (	(count <= MAX_TOKEN_PARTS)
-		&& (count > NO_TOKENS_FOUND)
-	) {
-		return 1;
-	} else {
-		ClearCurrentCommand(); // clear command struct just to be sure
-		return 0;
-	}
-}
-/*
-***************************************************************************************************************
-	End ParseCommand
-***************************************************************************************************************
-*/
-
-E_commandType GetCommandType(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function returns the commandType of the current command that was parsed
-
-	\returns
-		CommandType of the current command that was parsed
-
-***************************************************************************************************************
-*/
-
-	return currentCommand.commandType;
-}
-/*
-***************************************************************************************************************
-	End GetCommandType
-***************************************************************************************************************
-*/
-
-uint16_t GetValue(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function returns the integer value of the current command that was parsed
-
-	\returns
-		Integer value of the current command that was parsed
-
-***************************************************************************************************************
-*/
-	return currentCommand.value;
-}
-/*
-***************************************************************************************************************
-	End GetValue
-***************************************************************************************************************
-*/
-
-E_memorySegment GetMemorySegment(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function returns the memory segment of the current command that was parsed
-
-	\returns
-		Memory segment of the current command that was parsed
-
-***************************************************************************************************************
-*/
-	return currentCommand.argument1.memorySegment;
-}
-/*
-***************************************************************************************************************
-	End GetMemorySegment
-***************************************************************************************************************
-*/
-
-char* GetName(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function returns the name (string) of the current command that was parsed
-
-	\returns
-		Name (string) of the current command that was parsed
-
-***************************************************************************************************************
-*/
-	return currentCommand.argument1.name;
-}
-/*
-***************************************************************************************************************
-	End GetName
-***************************************************************************************************************
-*/
-
-static void ClearCurrentCommand(void) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function reinitializes the fields of the currentCommand
-
-***************************************************************************************************************
-*/
-	memset(&currentCommand, 0 , sizeof(T_vmCommand));
-}
-/*
-***************************************************************************************************************
-	End ClearCurrentCommand
-***************************************************************************************************************
-*/
-
-static E_commandType ParseCommandType(const char* input) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function tries to find the commandType by parsing the command token
-
-	\param[in]		input		Pointer to input string (commandType token)
-
-	\returns
-		commandType of the parsed command
-
-***************************************************************************************************************
-*/
-	uint8_t i = 0;
-	uint8_t found = 0;
-
-	while (	(found == 0)
-			&& (i < maxVMCommands)
-	) {
-		if (strcmp(vmCommands[i].vmCommandString, input) == 0) {
-			found = 1;
-		} else {
-			i++;
-		}
-	}
-
-	if (found != 0) {
-		return vmCommands[i].command;
-	} else {
-		return CT_UNKNOWN;
-	}
-}
-/*
-***************************************************************************************************************
-	End ParseCommandType
-***************************************************************************************************************
-*/
-
-static E_memorySegment ParseMemorySegment(const char* input) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function tries to find the memorySegment by parsing the memorySegment token
-
-	\param[in]		input		Pointer to input string (memorySegment token)
-
-	\returns
-		memorySegment of the parsed command
-
-***************************************************************************************************************
-*/
-	uint8_t i = 0;
-	uint8_t found = 0;
-
-	while (	(found == 0)
-			&& (i < maxVMMemorySegments)
-	) {
-		if (strcmp(vmMemorySegments[i].memorySegmentString, input) == 0) {
-			found = 1;
-		} else {
-			i++;
-		}
-	}
-
-	if (found != 0) {
-		return vmMemorySegments[i].memorySegment;
-	} else {
-		return MS_UNKNOWN;
-	}
-}
-/*
-***************************************************************************************************************
-	End ParseMemorySegment
-***************************************************************************************************************
-*/
-
-
-
-/*
-***************************************************************************************************************
-	TEST CODE
-***************************************************************************************************************
-*/
-
-// TODO ADD MODULE TESTCODE
+/*! \file
+***************************************************************************************************************
+file name:					parser.c
+*	\copyright				FourE
+*	\brief					parser source file
+*	\author					Frank Eggink
+*	\date	created:			2020-02-03
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "parser.h"
+#include <stddef.h>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>			// malloc, realloc, free
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define NO_TOKENS_FOUND					(0)
+#define MAX_TOKEN_PARTS					(3)
+#define MAX_VMCOMMAND_STRING_LEN		(9) // max string length of string (including '\0') in table vmCommands
+#define MAX_MEMSEGMENT_STRING_LEN	(9) // max string length of string (including '\0') in table vmMemorySegments
+#define INITIAL_COMMAND_CAPACITY		(1024)
+#define MAX_ISSUE_DETAIL_LENGTH		(80)
+#define MAX_CONSTANT_VALUE			(32767) // largest value of push constant, the Hack platform loads 15 bits
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+typedef struct {
+	char vmCommandString[MAX_VMCOMMAND_STRING_LEN];
+	E_commandType command;
+} T_vmCommandString;
+
+typedef struct {
+	char memorySegmentString[MAX_MEMSEGMENT_STRING_LEN];
+	E_memorySegment memorySegment;
+} T_vmMemorySegmentString;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t NextToken(const char** token, uint32_t* tokenLength, const char* end);
+static E_commandType ParseCommandType(const char* input, uint32_t length);
+static E_memorySegment ParseMemorySegment(const char* input, uint32_t length);
+static uint8_t ParseValue(const char* input, uint32_t length, uint16_t* value);
+static uint8_t GetRequiredTokens(E_commandType commandType);
+static void SetParseIssue(T_parseIssue* issue, E_diagnosticCode code, uint32_t offset, uint32_t length);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+static const T_vmCommandString vmCommands[] = {
+	 {"add"			,CT_ADD			}
+	,{"sub"			,CT_SUB			}
+	,{"neg"			,CT_NEG			}
+	,{"eq"			,CT_EQ			}
+   ,{"gt"			,CT_GT			}
+	,{"lt"			,CT_LT			}
+	,{"and"			,CT_AND			}
+	,{"or"			,CT_OR			}
+	,{"not"			,CT_NOT			}
+	,{"push"			,CT_PUSH			}
+	,{"pop"			,CT_POP			}
+	,{"label"		,CT_LABEL		}
+	,{"goto"			,CT_GOTO			}
+	,{"if-goto"		,CT_IFGOTO		}
+	,{"function"	,CT_FUNCTION	}
+	,{"call"			,CT_CALL			}
+	,{"return"		,CT_RETURN		}
+};
+
+
+#define MAX_VM_COMMANDS (sizeof(vmCommands) / sizeof(vmCommands[0]))
+
+static const uint8_t maxVMCommands = MAX_VM_COMMANDS;
+
+
+static const T_vmMemorySegmentString vmMemorySegments[] = {
+	 {"local"		,MS_LOCAL			}
+	,{"argument"	,MS_ARGUMENT		}
+	,{"this"			,MS_THIS				}
+	,{"that"			,MS_THAT				}
+	,{"constant"	,MS_CONSTANT		}
+	,{"static"		,MS_STATIC			}
+	,{"pointer"		,MS_POINTER			}
+	,{"temp"			,MS_TEMP				}
+};
+
+
+#define MAX_VM_MEMORY_SEGMENTS (sizeof(vmMemorySegments) / sizeof(vmMemorySegments[0]))
+
+static const uint8_t maxVMMemorySegments = MAX_VM_MEMORY_SEGMENTS;
+
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InitVMProgram(T_vmProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an empty VM program
+
+	\param[out]		program		Pointer to VM program
+
+	\returns
+			0: out of memory
+			1: program is initialized
+
+	\note
+		- a program that was initialized successfully must be freed with FreeVMProgram
+
+***************************************************************************************************************
+*/
+	assert(program != NULL);
+
+	memset(program, 0, sizeof(T_vmProgram));
+
+	program->commands = malloc(sizeof(T_vmCommand) * INITIAL_COMMAND_CAPACITY);
+	if (program->commands == NULL) {
+		return 0;
+	}
+	program->capacity = INITIAL_COMMAND_CAPACITY;
+
+	if (InitStringTable(&program->names) == 0) {
+		free(program->commands);
+		program->commands = NULL;
+		return 0;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End InitVMProgram
+***************************************************************************************************************
+*/
+
+void FreeVMProgram(T_vmProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the commands and names of a VM program
+
+	\param[in,out]	program		Pointer to VM program
+
+***************************************************************************************************************
+*/
+	assert(program != NULL);
+
+	free(program->commands);
+	FreeStringTable(&program->names);
+	memset(program, 0, sizeof(T_vmProgram));
+}
+/*
+***************************************************************************************************************
+	End FreeVMProgram
+***************************************************************************************************************
+*/
+
+uint32_t ParseSource(T_sourceReader* reader, T_vmProgram* program, const char* fileName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses all lines of the input file and appends the VM commands to the program
+
+	\param[in]		reader		Pointer to opened source reader of the input file
+	\param[in,out]	program		Pointer to initialized VM program
+	\param[in]		fileName		Pointer to fileName (only used for diagnostics)
+
+	\returns
+		Number of lines that could not be parsed
+
+	\note
+		- all names are interned in the string table of the program, so the reader can be closed as soon as the
+		  file is parsed
+		- problems are reported as diagnostics with line and column, nothing is written while parsing
+
+***************************************************************************************************************
+*/
+	assert(reader != NULL);
+	assert(program != NULL);
+
+	T_stringView line;
+	T_parseIssue issue;
+	uint32_t errors = 0;
+
+	while (ReadSourceLine(reader, &line) != 0) {
+		const char* lineStart = line.start;
+
+		RemoveCommentsAndTrimView(&line);
+		if (line.length > 0) { // handles special case (skip blank lines and comments)
+			if (program->count == program->capacity) {
+				T_vmCommand* commands = realloc(program->commands, sizeof(T_vmCommand) * program->capacity * 2);
+				if (commands == NULL) {
+					DIAG_ERROR(DC_OUT_OF_MEMORY, fileName, reader->lineNumber, 0, NULL);
+					errors++;
+					break;
+				}
+				program->commands = commands;
+				program->capacity *= 2;
+			}
+
+			T_vmCommand* command = &program->commands[program->count];
+			if (ParseCommand(line.start, line.length, &program->names, command, &issue) != 0) {
+				uint32_t column = (uint32_t)(line.start - lineStart) + 1;
+
+				command->lineNumber = reader->lineNumber;
+				command->column = (column > UINT16_MAX) ? UINT16_MAX : (uint16_t)column;
+				program->count++;
+			} else {
+				errors++;
+			}
+
+			if (issue.code != DC_NONE) {
+				// reader->lineNumber and the column are used to indicate where the problem is in the input file
+				char detail[MAX_ISSUE_DETAIL_LENGTH + 1];
+				uint32_t detailLength = (issue.length > MAX_ISSUE_DETAIL_LENGTH) ? MAX_ISSUE_DETAIL_LENGTH : issue.length;
+				uint32_t column = (uint32_t)(line.start - lineStart) + issue.offset + 1;
+
+				memcpy(detail, &line.start[issue.offset], detailLength);
+				detail[detailLength] = '\0';
+
+				if (	(issue.code == DC_MISSING_ARGUMENT)
+					|| (issue.code == DC_INVALID_VALUE)
+				) {
+					DIAG_WARN((E_diagnosticCode)issue.code, fileName, reader->lineNumber, column, (detailLength > 0) ? detail : NULL);
+				} else {
+					DIAG_ERROR((E_diagnosticCode)issue.code, fileName, reader->lineNumber, column, (detailLength > 0) ? detail : NULL);
+				}
+			}
+		}
+	}
+	return errors;
+}
+/*
+***************************************************************************************************************
+	End ParseSource
+***************************************************************************************************************
+*/
+
+uint8_t ParseCommand(const char* input, uint32_t length, T_stringTable* names, T_vmCommand* command, T_parseIssue* issue) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses input string (command) and dissects it into specific parts like:
+		- commandType
+		- memorySegment
+		- value
+		- name
+
+	\param[in]		input		Pointer to input string
+	\param[in]		length	Length of the input string
+	\param[in,out]	names		Pointer to string table that is used to intern the name
+	\param[out]		command	Pointer to command that receives the parsed command
+	\param[out]		issue		Pointer that receives the first problem found in the command, may be NULL
+
+	\returns
+			0: parsing failed
+			1: parsing was successful (the command may still have an issue, for example an unknown command)
+
+	\note
+		- make sure that input, names and command are not NULL
+		- the input string does NOT have to be nul terminated and is NOT modified
+		- for commands that are not recognized the complete input string is interned as the name, so it can be
+		  reported by the codewriter
+
+***************************************************************************************************************
+*/
+	assert(input != NULL);
+	assert(names != NULL);
+	assert(command != NULL);
+
+	const char* end = input + length;
+	const char* token = input;
+	uint32_t tokenLength = 0;
+	uint8_t count = NO_TOKENS_FOUND;
+	uint8_t extraToken = 0;
+
+	memset(command, 0, sizeof(T_vmCommand));
+	if (issue != NULL) {
+		memset(issue, 0, sizeof(T_parseIssue));
+	}
+
+	while (	(count <= MAX_TOKEN_PARTS)
+			&& (NextToken(&token, &tokenLength, end) != 0)
+	) {
+		count++; // used to keep track of current token in input string
+		DIAG_TRACE("%.*s", (int)tokenLength, token);
+
+		// an operand that a known command does not take, e.g. "add extra" or "label L M"
+		if (	(count > 1)
+			&& (command->commandType != CT_UNKNOWN)
+			&& (count > GetRequiredTokens((E_commandType)command->commandType))
+		) {
+			SetParseIssue(issue, DC_TOO_MANY_TOKENS, (uint32_t)(token - input), (uint32_t)(end - token));
+			extraToken = 1;
+			break;
+		}
+
+		// parse and store token based on "position" in input string
+		switch (count) {
+		case 1:
+			// command
+			command->commandType = ParseCommandType(token, tokenLength);
+			if (command->commandType == CT_UNKNOWN) {
+				SetParseIssue(issue, DC_UNKNOWN_COMMAND, (uint32_t)(token - input), tokenLength);
+			}
+			break;
+		case 2:
+			// argument 1
+			if (	(command->commandType == CT_PUSH)
+				|| (command->commandType == CT_POP)
+			) {
+				command->memorySegment = ParseMemorySegment(token, tokenLength);
+				if (command->memorySegment == MS_UNKNOWN) {
+					SetParseIssue(issue, DC_UNKNOWN_SEGMENT, (uint32_t)(token - input), tokenLength);
+				}
+			} else {
+				// assume it is: label, goto, if-goto, function, call
+				command->nameId = InternString(names, token, tokenLength);
+			}
+			break;
+		case 3:
+			// argument 2
+			if (ParseValue(token, tokenLength, &command->value) == 0) {
+				SetParseIssue(issue, DC_INVALID_VALUE, (uint32_t)(token - input), tokenLength);
+			} else if (	(command->commandType == CT_PUSH)
+						&& (command->memorySegment == MS_CONSTANT)
+						&& (command->value > MAX_CONSTANT_VALUE)
+			) {
+				// every backend rejects it, the Hack backend could not load it without folding
+				SetParseIssue(issue, DC_CONSTANT_RANGE, (uint32_t)(token - input), tokenLength);
+			}
+			break;
+		default:
+			// not handled
+			SetParseIssue(issue, DC_TOO_MANY_TOKENS, (uint32_t)(token - input), (uint32_t)(end - token));
+			break;
+		}
+
+		// continue after the current token
+		token += tokenLength;
+	}
+
+	if (	(count > NO_TOKENS_FOUND)
+		&& (count < GetRequiredTokens((E_commandType)command->commandType))
+	) {
+		SetParseIssue(issue, DC_MISSING_ARGUMENT, length, 0);
+	}
+
+	// keep the complete command for commands that can not be translated
+	if (	(command->commandType == CT_UNKNOWN)
+		|| (	((command->commandType == CT_PUSH) || (command->commandType == CT_POP))
+			&& (command->memorySegment == MS_UNKNOWN)
+			)
+	) {
+		command->nameId = InternString(names, input, length);
+	}
+
+	if (	(count <= MAX_TOKEN_PARTS)
+		&& (count > NO_TOKENS_FOUND)
+		&& (extraToken == 0)
+		&& (command->nameId != STRING_ID_INVALID)
+	) {
+		return 1;
+	} else {
+		memset(command, 0, sizeof(T_vmCommand)); // clear command struct just to be sure
+		return 0;
+	}
+}
+/*
+***************************************************************************************************************
+	End ParseCommand
+***************************************************************************************************************
+*/
+
+const char* GetCommandString(E_commandType commandType) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the VM keyword of a commandType
+
+	\param[in]		commandType		commandType
+
+	\returns
+		Pointer to the keyword or "unknown" when the commandType has no keyword
+
+***************************************************************************************************************
+*/
+	for (uint8_t i = 0; i < maxVMCommands; i++) {
+		if (vmCommands[i].command == commandType) {
+			return vmCommands[i].vmCommandString;
+		}
+	}
+	return "unknown";
+}
+/*
+***************************************************************************************************************
+	End GetCommandString
+***************************************************************************************************************
+*/
+
+const char* GetMemorySegmentString(E_memorySegment memorySegment) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the VM keyword of a memorySegment
+
+	\param[in]		memorySegment		memorySegment
+
+	\returns
+		Pointer to the keyword or "unknown" when the memorySegment has no keyword
+
+	\note
+		- MS_FRAME has no keyword in the VM language, "frame" is only used to show generated commands
+
+***************************************************************************************************************
+*/
+	if (memorySegment == MS_FRAME) {
+		return "frame";
+	}
+	for (uint8_t i = 0; i < maxVMMemorySegments; i++) {
+		if (vmMemorySegments[i].memorySegment == memorySegment) {
+			return vmMemorySegments[i].memorySegmentString;
+		}
+	}
+	return "unknown";
+}
+/*
+***************************************************************************************************************
+	End GetMemorySegmentString
+***************************************************************************************************************
+*/
+
+static uint8_t NextToken(const char** token, uint32_t* tokenLength, const char* end) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the next token in a string, tokens are separated by spaces or tabs
+
+	\param[in,out]	token				Pointer to the position where the search starts, receives the token
+	\param[out]		tokenLength		Length of the token that was found
+	\param[in]		end				Pointer just beyond the last character of the string
+
+	\returns
+			0: no more tokens found
+			1: token was found
+
+***************************************************************************************************************
+*/
+	const char* start = *token;
+	const char* stop = NULL;
+
+	// skip separators
+	while (	(start < end)
+			&& ((*start == ' ') || (*start == '\t'))
+	) {
+		start++;
+	}
+
+	stop = start;
+	while (	(stop < end)
+			&& (*stop != ' ')
+			&& (*stop != '\t')
+	) {
+		stop++;
+	}
+
+	*token = start;
+	*tokenLength = (uint32_t)(stop - start);
+
+	return (stop > start) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End NextToken
+***************************************************************************************************************
+*/
+
+static E_commandType ParseCommandType(const char* input, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function tries to find the commandType by parsing the command token
+
+	\param[in]		input		Pointer to input string (commandType token)
+	\param[in]		length	Length of the token
+
+	\returns
+		commandType of the parsed command
+
+***************************************************************************************************************
+*/
+	uint8_t i = 0;
+	uint8_t found = 0;
+
+	while (	(found == 0)
+			&& (i < maxVMCommands)
+	) {
+		if (	(length < MAX_VMCOMMAND_STRING_LEN)
+			&& (strncmp(vmCommands[i].vmCommandString, input, length) == 0)
+			&& (vmCommands[i].vmCommandString[length] == '\0')
+		) {
+			found = 1;
+		} else {
+			i++;
+		}
+	}
+
+	if (found != 0) {
+		return vmCommands[i].command;
+	} else {
+		return CT_UNKNOWN;
+	}
+}
+/*
+***************************************************************************************************************
+	End ParseCommandType
+***************************************************************************************************************
+*/
+
+static E_memorySegment ParseMemorySegment(const char* input, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function tries to find the memorySegment by parsing the memorySegment token
+
+	\param[in]		input		Pointer to input string (memorySegment token)
+	\param[in]		length	Length of the token
+
+	\returns
+		memorySegment of the parsed command
+
+***************************************************************************************************************
+*/
+	uint8_t i = 0;
+	uint8_t found = 0;
+
+	while (	(found == 0)
+			&& (i < maxVMMemorySegments)
+	) {
+		if (	(length < MAX_MEMSEGMENT_STRING_LEN)
+			&& (strncmp(vmMemorySegments[i].memorySegmentString, input, length) == 0)
+			&& (vmMemorySegments[i].memorySegmentString[length] == '\0')
+		) {
+			found = 1;
+		} else {
+			i++;
+		}
+	}
+
+	if (found != 0) {
+		return vmMemorySegments[i].memorySegment;
+	} else {
+		return MS_UNKNOWN;
+	}
+}
+/*
+***************************************************************************************************************
+	End ParseMemorySegment
+***************************************************************************************************************
+*/
+
+static uint8_t ParseValue(const char* input, uint32_t length, uint16_t* value) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function converts the decimal value token to an integer value
+
+	\param[in]		input		Pointer to input string (value token)
+	\param[in]		length	Length of the token
+	\param[out]		value		Pointer that receives the value
+
+	\returns
+			0: token is not a decimal number or does not fit in 16 bits, value holds what could be converted
+			1: value is valid
+
+	\note
+		- parsing stops at the first character that is not a digit, the value wraps at 16 bits
+
+***************************************************************************************************************
+*/
+	uint32_t result = 0;
+	uint8_t valid = (length > 0) ? 1 : 0;
+
+	for (uint32_t i = 0; i < length; i++) {
+		if (	(input[i] < '0')
+			|| (input[i] > '9')
+		) {
+			valid = 0;
+			break;
+		}
+		result = (result * 10) + (uint32_t)(input[i] - '0');
+		if (result > UINT16_MAX) {
+			valid = 0;
+			result &= UINT16_MAX;
+		}
+	}
+	*value = (uint16_t)result;
+	return valid;
+}
+/*
+***************************************************************************************************************
+	End ParseValue
+***************************************************************************************************************
+*/
+
+static uint8_t GetRequiredTokens(E_commandType commandType) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the number of tokens a command needs, including the command itself
+
+	\param[in]		commandType		commandType
+
+	\returns
+		Number of tokens, 0 for an unknown command
+
+***************************************************************************************************************
+*/
+	switch (commandType) {
+	case CT_PUSH:
+	case CT_POP:
+	case CT_FUNCTION:
+	case CT_CALL:
+		return 3;
+	case CT_LABEL:
+	case CT_GOTO:
+	case CT_IFGOTO:
+		return 2;
+	case CT_UNKNOWN:
+		return 0;
+	default:
+		// arithmetic and return
+		return 1;
+	}
+}
+/*
+***************************************************************************************************************
+	End GetRequiredTokens
+***************************************************************************************************************
+*/
+
+static void SetParseIssue(T_parseIssue* issue, E_diagnosticCode code, uint32_t offset, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function stores a problem of the command, only the first problem is kept
+
+	\param[out]		issue		Pointer to issue, may be NULL
+	\param[in]		code		Diagnostic code of the problem
+	\param[in]		offset	Offset of the token in the input string
+	\param[in]		length	Length of the token
+
+***************************************************************************************************************
+*/
+	if (	(issue != NULL)
+		&& (issue->code == DC_NONE)
+	) {
+		issue->code = (uint8_t)code;
+		issue->offset = offset;
+		issue->length = length;
+	}
+}
+/*
+***************************************************************************************************************
+	End SetParseIssue
+***************************************************************************************************************
+*/
+
+
+
+/*
+***************************************************************************************************************
+	TEST CODE
+***************************************************************************************************************
+*/
+
+// TODO ADD MODULE TESTCODE
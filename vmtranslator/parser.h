@@ -1,132 +1,152 @@
-/*! \file
-***************************************************************************************************************
-file name:					parser.h
-*	\copyright				FourE
-*	\brief					parser header file
-*	\author					Frank Eggink
-*	\date	created:			2020-02-03
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-#ifndef __PARSER_H
-#define __PARSER_H
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include <stdint.h>
-
-
-/*
-***************************************************************************************************************
-	Make header CPP compatible
-***************************************************************************************************************
-*/
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
-***************************************************************************************************************
-	GLOBAL DEFINES
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL TYPEDEF
-***************************************************************************************************************
-*/
-
-typedef enum {
-	 CT_ADD
-	,CT_SUB
-	,CT_NEG
-	,CT_EQ
-	,CT_GT
-	,CT_LT
-	,CT_AND
-	,CT_OR
-	,CT_NOT
-	,CT_PUSH
-	,CT_POP
-	,CT_LABEL
-	,CT_GOTO
-	,CT_IFGOTO
-	,CT_FUNCTION
-	,CT_CALL
-	,CT_RETURN
-	,CT_UNKNOWN
-} E_commandType;
-
-typedef enum {
-	 MS_LOCAL
-	,MS_ARGUMENT
-	,MS_THIS
-	,MS_THAT
-	,MS_CONSTANT
-	,MS_STATIC
-	,MS_POINTER
-	,MS_TEMP
-	,MS_UNKNOWN
-} E_memorySegment;
-
-
-typedef struct {
-	E_commandType commandType;
-	union {
-		char* name;
-		E_memorySegment memorySegment;
-	} argument1;
-	uint16_t value;
-} T_vmCommand;
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-uint8_t ParseCommand(char* input);
-E_commandType GetCommandType(void);
-uint16_t GetValue(void);
-E_memorySegment GetMemorySegment(void);
-char* GetName(void);
-
-/*
-***************************************************************************************************************
-
-***************************************************************************************************************
-*/
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif		// __PARSER_H
-
+/*! \file
+***************************************************************************************************************
+file name:					parser.h
+*	\copyright				FourE
+*	\brief					parser header file
+*	\author					Frank Eggink
+*	\date	created:			2020-02-03
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+#ifndef __PARSER_H
+#define __PARSER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "sourcereader.h"
+#include "stringtable.h"
+#include "diagnostics.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 CT_ADD
+	,CT_SUB
+	,CT_NEG
+	,CT_EQ
+	,CT_GT
+	,CT_LT
+	,CT_AND
+	,CT_OR
+	,CT_NOT
+	,CT_PUSH
+	,CT_POP
+	,CT_LABEL
+	,CT_GOTO
+	,CT_IFGOTO
+	,CT_FUNCTION
+	,CT_CALL
+	,CT_RETURN
+	,CT_UNKNOWN
+} E_commandType;
+
+typedef enum {
+	 MS_LOCAL
+	,MS_ARGUMENT
+	,MS_THIS
+	,MS_THAT
+	,MS_CONSTANT
+	,MS_STATIC
+	,MS_POINTER
+	,MS_TEMP
+	,MS_FRAME						// word of a static frame, the value is its RAM address (generated, never parsed)
+	,MS_UNKNOWN
+} E_memorySegment;
+
+
+// fixed size record of a parsed VM command
+typedef struct {
+	uint8_t commandType;			// E_commandType
+	uint8_t memorySegment;		// E_memorySegment (push and pop)
+	uint16_t value;				// index (push and pop), number of locals (function) or arguments (call)
+	uint32_t nameId;				// interned name (label, goto, if-goto, function and call)
+	uint32_t lineNumber;			// line number of the command in the source file
+	uint16_t column;				// column of the command in the source line (1 based), for diagnostics
+} T_vmCommand;
+
+// first problem that was found while parsing a command
+typedef struct {
+	uint8_t code;					// E_diagnosticCode, DC_NONE: no problem found
+	uint32_t offset;				// offset of the token that caused the problem in the input string
+	uint32_t length;				// length of the token (0: the problem is at the end of the input string)
+} T_parseIssue;
+
+// all commands of a .vm file, in source order
+typedef struct {
+	T_vmCommand* commands;
+	uint32_t count;
+	uint32_t capacity;
+	T_stringTable names;			// names that are referenced by the nameId of the commands
+} T_vmProgram;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InitVMProgram(T_vmProgram* program);
+void FreeVMProgram(T_vmProgram* program);
+uint32_t ParseSource(T_sourceReader* reader, T_vmProgram* program, const char* fileName);
+uint8_t ParseCommand(const char* input, uint32_t length, T_stringTable* names, T_vmCommand* command, T_parseIssue* issue);
+const char* GetCommandString(E_commandType commandType);
+const char* GetMemorySegmentString(E_memorySegment memorySegment);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __PARSER_H
+
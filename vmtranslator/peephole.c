@@ -0,0 +1,733 @@
+/*! \file
+***************************************************************************************************************
+file name:					peephole.c
+*	\copyright				FourE
+*	\brief					peephole optimizer source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The rules work on the decoded instructions: they mark instructions as deleted or change the destination
+	of C-instructions. The rules are applied until none of them matches anymore, then the instructions that
+	are left are moved together.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "peephole.h"
+#include <stdio.h>
+#include <stdlib.h>			// calloc, free
+#include <string.h>			// memset
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+// number of instructions that are checked to find out if a register is still used
+#define MAX_LIVENESS_SCAN	(32)
+
+// PUSH_D followed by the original or the optimized POP_D
+#define PUSH_POP_WINDOW		(10)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// instruction list that is optimized
+typedef struct {
+	T_hackInstruction* lines;			// instructions of the list
+	uint8_t* deleted;						// 1: instruction is removed when the list is compacted
+	uint32_t count;
+	uint32_t sp;							// ID of the symbol SP, STRING_ID_INVALID when it is not used
+	uint32_t pushMarker;					// ID of the comment PUSH_D
+	uint32_t popMarker;					// ID of the comment POP_D
+} T_peephole;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint32_t NextLine(const T_peephole* peephole, uint32_t index);
+static uint32_t CollectWindow(const T_peephole* peephole, uint32_t first, uint32_t* window, uint32_t size);
+static uint8_t IsAddress(const T_hackInstruction* line, uint32_t symbol);
+static uint8_t IsCompute(const T_hackInstruction* line, uint8_t dest, uint8_t comp);
+static uint8_t ReadsRegister(const T_hackInstruction* line, uint8_t reg);
+static uint8_t IsRegisterDead(const T_peephole* peephole, uint32_t index, uint8_t reg);
+static void DeleteMarker(T_peephole* peephole, uint32_t index, uint32_t marker);
+static uint8_t ApplyPushPop(T_peephole* peephole, uint32_t index);
+static uint8_t ApplyMergeCopy(T_peephole* peephole, uint32_t index);
+static uint8_t ApplyDeadDestination(T_peephole* peephole, uint32_t index);
+static uint8_t ApplyReloadAddress(T_peephole* peephole, uint32_t index);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// indexed by E_peepholeRule
+static const char* const ruleNames[PR_COUNT] = {
+	 "push/pop pairs removed"
+	,"copies merged"
+	,"dead destinations removed"
+	,"address reloads removed"
+};
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void InitPeepholeStats(T_peepholeStats* stats) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function clears the statistics of the peephole optimizer
+
+	\param[out]		stats		Pointer to statistics
+
+***************************************************************************************************************
+*/
+	memset(stats, 0, sizeof(T_peepholeStats));
+}
+/*
+***************************************************************************************************************
+	End InitPeepholeStats
+***************************************************************************************************************
+*/
+
+void AddPeepholeStats(T_peepholeStats* total, const T_peepholeStats* stats) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function adds the statistics of one instruction list to the total
+
+	\param[in,out]	total		Pointer to total statistics
+	\param[in]		stats		Pointer to statistics that are added
+
+***************************************************************************************************************
+*/
+	total->instructionsBefore += stats->instructionsBefore;
+	total->instructionsAfter += stats->instructionsAfter;
+	for (uint8_t i = 0; i < PR_COUNT; i++) {
+		total->applied[i] += stats->applied[i];
+	}
+}
+/*
+***************************************************************************************************************
+	End AddPeepholeStats
+***************************************************************************************************************
+*/
+
+uint8_t OptimizeAssembly(T_hackProgram* program, T_peepholeStats* stats) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function applies the peephole rules to the instructions of an instruction list
+
+	\param[in,out]	program		Pointer to instruction list
+	\param[in,out]	stats			Pointer to statistics, the numbers of this list are added
+
+	\returns
+			0: out of memory, the list is not changed
+			1: list was optimized
+
+	\note
+		- the instructions are compacted in place, the optimized code is never longer than the original
+
+***************************************************************************************************************
+*/
+	T_peephole peephole;
+	uint32_t before = CountMachineInstructions(program, 0);
+	uint32_t kept = 0;
+	uint8_t changed = 0;
+
+	if (program->count == 0) {
+		return 1;
+	}
+
+	peephole.lines = program->instructions;
+	peephole.count = program->count;
+	peephole.deleted = calloc(program->count, sizeof(uint8_t));
+	if (peephole.deleted == NULL) {
+		return 0;
+	}
+	peephole.sp = FindString(&program->symbols, "SP", 2);
+	peephole.pushMarker = FindString(&program->symbols, "PUSH_D", 6);
+	peephole.popMarker = FindString(&program->symbols, "POP_D", 5);
+
+	do {
+		changed = 0;
+
+		// push/pop pairs first, the other rules would change the instructions of the pairs
+		for (uint32_t i = 0; i < peephole.count; i++) {
+			if (	(peephole.deleted[i] == 0)
+				&& (ApplyPushPop(&peephole, i) != 0)
+			) {
+				stats->applied[PR_PUSH_POP]++;
+				changed = 1;
+			}
+		}
+
+		// the same line is tried again after a change, so chains of rewrites need few passes
+		for (uint32_t i = 0; i < peephole.count; ) {
+			uint8_t rule = PR_COUNT;
+
+			if (peephole.deleted[i] != 0) {
+				i++;
+				continue;
+			}
+			if (ApplyMergeCopy(&peephole, i) != 0) {
+				rule = PR_MERGE_COPY;
+			} else if (ApplyDeadDestination(&peephole, i) != 0) {
+				rule = PR_DEAD_DESTINATION;
+			} else if (ApplyReloadAddress(&peephole, i) != 0) {
+				rule = PR_RELOAD_ADDRESS;
+			}
+
+			if (rule < PR_COUNT) {
+				stats->applied[rule]++;
+				changed = 1;
+			} else {
+				i++;
+			}
+		}
+	} while (changed != 0);
+
+	for (uint32_t i = 0; i < peephole.count; i++) {
+		if (peephole.deleted[i] == 0) {
+			program->instructions[kept++] = program->instructions[i];
+		}
+	}
+	program->count = kept;
+	free(peephole.deleted);
+
+	stats->instructionsBefore += before;
+	stats->instructionsAfter += CountMachineInstructions(program, 0);
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End OptimizeAssembly
+***************************************************************************************************************
+*/
+
+void PrintPeepholeStats(const T_peepholeStats* stats) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function prints the number of instructions the peephole optimizer removed
+
+	\param[in]		stats		Pointer to statistics
+
+***************************************************************************************************************
+*/
+	uint32_t removed = stats->instructionsBefore - stats->instructionsAfter;
+
+	printf("peephole: %u -> %u instructions, %u removed (%.1f%%)\n"
+			, stats->instructionsBefore, stats->instructionsAfter, removed
+			, (stats->instructionsBefore > 0) ? (100.0 * removed / stats->instructionsBefore) : 0.0);
+	for (uint8_t i = 0; i < PR_COUNT; i++) {
+		printf("  %-28s %u\n", ruleNames[i], stats->applied[i]);
+	}
+}
+/*
+***************************************************************************************************************
+	End PrintPeepholeStats
+***************************************************************************************************************
+*/
+
+static uint32_t NextLine(const T_peephole* peephole, uint32_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function finds the next instruction or label after a line, blank lines and comments are skipped
+
+	\returns
+		Index of the line, count when there is none
+
+***************************************************************************************************************
+*/
+	for (uint32_t i = index + 1; i < peephole->count; i++) {
+		if (	(peephole->deleted[i] == 0)
+			&& (peephole->lines[i].kind >= HK_LABEL)
+		) {
+			return i;
+		}
+	}
+	return peephole->count;
+}
+/*
+***************************************************************************************************************
+	End NextLine
+***************************************************************************************************************
+*/
+
+static uint32_t CollectWindow(const T_peephole* peephole, uint32_t first, uint32_t* window, uint32_t size) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function collects the indexes of up to size instructions, starting with the instruction at first
+
+	\returns
+		Number of instructions collected, collecting stops at a label
+
+***************************************************************************************************************
+*/
+	uint32_t used = 0;
+	uint32_t index = first;
+
+	while (	(used < size)
+			&& (index < peephole->count)
+			&& (peephole->lines[index].kind >= HK_ADDRESS)
+	) {
+		window[used++] = index;
+		index = NextLine(peephole, index);
+	}
+	return used;
+}
+/*
+***************************************************************************************************************
+	End CollectWindow
+***************************************************************************************************************
+*/
+
+static uint8_t IsAddress(const T_hackInstruction* line, uint32_t symbol) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks if a line is the A-instruction "@symbol"
+
+***************************************************************************************************************
+*/
+	return (	(line->kind == HK_SYMBOL)
+			&& (line->operand == symbol)
+	) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End IsAddress
+***************************************************************************************************************
+*/
+
+static uint8_t IsCompute(const T_hackInstruction* line, uint8_t dest, uint8_t comp) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks if a line is the C-instruction "dest=comp" without a jump
+
+***************************************************************************************************************
+*/
+	return (	(line->kind == HK_COMPUTE)
+			&& (line->dest == dest)
+			&& (line->jump == 0)
+			&& (line->comp == comp)
+	) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End IsCompute
+***************************************************************************************************************
+*/
+
+static uint8_t ReadsRegister(const T_hackInstruction* line, uint8_t reg) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks if an instruction reads the A or D register (M and jumps read A too)
+
+	\note
+		- the ALU zeroes an input that is not read: zx for D, zy for A or M
+		- an M destination reads A as the address, also when the comp does not read A or M, e.g. "AM=1"
+
+***************************************************************************************************************
+*/
+	if (line->kind != HK_COMPUTE) {
+		return 0;
+	}
+	if (reg == DEST_D) {
+		return ((line->comp & COMP_ZX) == 0) ? 1 : 0;
+	}
+	return (	(line->jump != 0)
+			|| ((line->comp & COMP_ZY) == 0)
+			|| ((line->dest & DEST_M) != 0)
+	) ? 1 : 0;
+}
+/*
+***************************************************************************************************************
+	End ReadsRegister
+***************************************************************************************************************
+*/
+
+static uint8_t IsRegisterDead(const T_peephole* peephole, uint32_t index, uint8_t reg) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function checks if the value of the A or D register after a line is overwritten before it is read
+
+	\returns
+			0: register may be read (or it could not be determined)
+			1: register is overwritten before it is read
+
+	\note
+		- labels are followed, the code after a label is also reached from this line
+		- a jump ends the search, the registers may be read at the target
+
+***************************************************************************************************************
+*/
+	uint32_t i = index;
+
+	for (uint32_t checked = 0; checked < MAX_LIVENESS_SCAN; checked++) {
+		const T_hackInstruction* line = NULL;
+
+		i = NextLine(peephole, i);
+		if (i >= peephole->count) {
+			return 0;
+		}
+		line = &peephole->lines[i];
+		if (	(line->kind == HK_ADDRESS)
+			|| (line->kind == HK_SYMBOL)
+		) {
+			if (reg == DEST_A) {
+				return 1;
+			}
+		} else if (line->kind == HK_COMPUTE) {
+			if (	(ReadsRegister(line, reg) != 0)
+				|| (line->jump != 0)
+			) {
+				return 0;
+			}
+			if ((line->dest & reg) != 0) {
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End IsRegisterDead
+***************************************************************************************************************
+*/
+
+static void DeleteMarker(T_peephole* peephole, uint32_t index, uint32_t marker) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function deletes the comment line just before an instruction when it is the marker of the deleted
+		instruction sequence
+
+***************************************************************************************************************
+*/
+	while (index > 0) {
+		index--;
+		if (peephole->deleted[index] == 0) {
+			if (	(peephole->lines[index].kind == HK_COMMENT)
+				&& (peephole->lines[index].operand == marker)
+			) {
+				peephole->deleted[index] = 1;
+			}
+			return;
+		}
+	}
+}
+/*
+***************************************************************************************************************
+	End DeleteMarker
+***************************************************************************************************************
+*/
+
+static uint8_t ApplyPushPop(T_peephole* peephole, uint32_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Rule PR_PUSH_POP: PUSH_D that is directly followed by POP_D leaves D unchanged, both are removed
+
+	\returns
+			0: rule does not match
+			1: rule was applied
+
+	\note
+		- the stack slot above SP is not written anymore, it is not part of the stack
+		- POP_D leaves A pointing at the stack, so A may not be read afterwards
+
+***************************************************************************************************************
+*/
+	const T_hackInstruction* lines = peephole->lines;
+	uint32_t window[PUSH_POP_WINDOW];
+	uint32_t used = 0;
+	uint32_t size = 0;
+
+	if (IsAddress(&lines[index], peephole->sp) == 0) {
+		return 0;
+	}
+
+	used = CollectWindow(peephole, index, window, PUSH_POP_WINDOW);
+	if (	(used < 8)
+		|| (IsCompute(&lines[window[1]], DEST_A, COMP_M) == 0)
+		|| (IsCompute(&lines[window[2]], DEST_M, COMP_D) == 0)
+		|| (IsAddress(&lines[window[3]], peephole->sp) == 0)
+		|| (IsCompute(&lines[window[4]], DEST_M, COMP_M_PLUS_1) == 0)
+		|| (IsAddress(&lines[window[5]], peephole->sp) == 0)
+	) {
+		return 0;
+	}
+
+	if (	(IsCompute(&lines[window[6]], DEST_A | DEST_M, COMP_M_MINUS_1) != 0)
+		&& (IsCompute(&lines[window[7]], DEST_D, COMP_M) != 0)
+	) {
+		size = 8;
+	} else if (	(used == PUSH_POP_WINDOW)
+				&& (IsCompute(&lines[window[6]], DEST_M, COMP_M_MINUS_1) != 0)
+				&& (IsCompute(&lines[window[7]], DEST_D, COMP_M) != 0)
+				&& (IsCompute(&lines[window[8]], DEST_A, COMP_D) != 0)
+				&& (IsCompute(&lines[window[9]], DEST_D, COMP_M) != 0)
+	) {
+		size = 10;
+	} else {
+		return 0;
+	}
+
+	if (IsRegisterDead(peephole, window[size - 1], DEST_A) == 0) {
+		return 0;
+	}
+
+	DeleteMarker(peephole, window[0], peephole->pushMarker);
+	DeleteMarker(peephole, window[5], peephole->popMarker);
+	for (uint32_t i = 0; i < size; i++) {
+		peephole->deleted[window[i]] = 1;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ApplyPushPop
+***************************************************************************************************************
+*/
+
+static uint8_t ApplyMergeCopy(T_peephole* peephole, uint32_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Rule PR_MERGE_COPY: "dest=comp" followed by "dest2=R" where R is one of the destinations is merged to
+		"dest|dest2=comp"
+
+	\returns
+			0: rule does not match
+			1: rule was applied
+
+	\note
+		- M is RAM[A], so when the first instruction writes A the copy may not read or write M
+
+***************************************************************************************************************
+*/
+	T_hackInstruction* line = &peephole->lines[index];
+	T_hackInstruction* next = NULL;
+	uint32_t nextIndex = 0;
+	uint8_t source = 0;
+
+	if (	(line->kind != HK_COMPUTE)
+		|| (line->jump != 0)
+		|| (line->dest == 0)
+	) {
+		return 0;
+	}
+
+	nextIndex = NextLine(peephole, index);
+	if (nextIndex >= peephole->count) {
+		return 0;
+	}
+	next = &peephole->lines[nextIndex];
+	if (	(next->kind != HK_COMPUTE)
+		|| (next->jump != 0)
+		|| (next->dest == 0)
+	) {
+		return 0;
+	}
+
+	source = (next->comp == COMP_A) ? DEST_A : (next->comp == COMP_D) ? DEST_D : (next->comp == COMP_M) ? DEST_M : 0;
+	if ((line->dest & source) == 0) {
+		return 0;
+	}
+	if (	((line->dest & DEST_A) != 0)
+		&& ((source == DEST_M) || ((next->dest & DEST_M) != 0))
+	) {
+		return 0;
+	}
+
+	line->dest |= next->dest;
+	peephole->deleted[nextIndex] = 1;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ApplyMergeCopy
+***************************************************************************************************************
+*/
+
+static uint8_t ApplyDeadDestination(T_peephole* peephole, uint32_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Rule PR_DEAD_DESTINATION: the A or D destination of an instruction is removed when the next instruction
+		overwrites the register without reading it, an instruction without destinations is removed
+
+	\returns
+			0: rule does not match
+			1: rule was applied
+
+***************************************************************************************************************
+*/
+	T_hackInstruction* line = &peephole->lines[index];
+	const T_hackInstruction* next = NULL;
+	uint32_t nextIndex = 0;
+	uint8_t dead = 0;
+
+	if (	(line->kind != HK_COMPUTE)
+		|| (line->jump != 0)
+		|| ((line->dest & (DEST_A | DEST_D)) == 0)
+	) {
+		return 0;
+	}
+
+	nextIndex = NextLine(peephole, index);
+	if (nextIndex >= peephole->count) {
+		return 0;
+	}
+	next = &peephole->lines[nextIndex];
+
+	if (	(next->kind == HK_ADDRESS)
+		|| (next->kind == HK_SYMBOL)
+	) {
+		dead = DEST_A;
+	} else if (next->kind == HK_COMPUTE) {
+		if (	((next->dest & DEST_D) != 0)
+			&& (ReadsRegister(next, DEST_D) == 0)
+		) {
+			dead |= DEST_D;
+		}
+		if (	((next->dest & DEST_A) != 0)
+			&& (ReadsRegister(next, DEST_A) == 0)
+		) {
+			dead |= DEST_A;
+		}
+	}
+
+	dead &= line->dest;
+	if (dead == 0) {
+		return 0;
+	}
+
+	line->dest &= (uint8_t)~dead;
+	if (line->dest == 0) {
+		// computing without destination and jump has no effect
+		peephole->deleted[index] = 1;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ApplyDeadDestination
+***************************************************************************************************************
+*/
+
+static uint8_t ApplyReloadAddress(T_peephole* peephole, uint32_t index) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Rule PR_RELOAD_ADDRESS: "@X" is removed when the previous "@X" is still in A, for example the second
+		"@SP" of "@SP, M=M+1, @SP"
+
+	\returns
+			0: rule does not match
+			1: rule was applied
+
+***************************************************************************************************************
+*/
+	const T_hackInstruction* address = &peephole->lines[index];
+	uint32_t i = index;
+
+	if (	(address->kind != HK_ADDRESS)
+		&& (address->kind != HK_SYMBOL)
+	) {
+		return 0;
+	}
+
+	for (;;) {
+		const T_hackInstruction* line = NULL;
+
+		i = NextLine(peephole, i);
+		if (	(i >= peephole->count)
+			|| (peephole->lines[i].kind == HK_LABEL)
+		) {
+			return 0;
+		}
+		line = &peephole->lines[i];
+		if (	(line->kind == HK_ADDRESS)
+			|| (line->kind == HK_SYMBOL)
+		) {
+			if (	(line->kind == address->kind)
+				&& (line->operand == address->operand)
+			) {
+				peephole->deleted[i] = 1;
+				return 1;
+			}
+			return 0;
+		}
+		if (	((line->dest & DEST_A) != 0)
+			|| (line->jump != 0)
+		) {
+			return 0;
+		}
+	}
+}
+/*
+***************************************************************************************************************
+	End ApplyReloadAddress
+***************************************************************************************************************
+*/
@@ -0,0 +1,111 @@
+/*! \file
+***************************************************************************************************************
+file name:					peephole.h
+*	\copyright				FourE
+*	\brief					peephole optimizer header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Window based peephole optimizer that rewrites the generated Hack instructions of an instruction list
+	before they are written (-O1).
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	Rules:
+	- PR_PUSH_POP				PUSH_D directly followed by POP_D is removed (when A is not used afterwards)
+	- PR_MERGE_COPY			"dest=comp" followed by a copy of one of its destinations ("A=D", "D=M") is
+									merged into one instruction, for example "M=M-1, D=M" becomes "MD=M-1"
+	- PR_DEAD_DESTINATION	a destination that is overwritten by the next instruction before it is read is
+									removed, for example "AD=M, D=M" becomes "A=M, D=M"
+	- PR_RELOAD_ADDRESS		"@X" that loads the value A already holds is removed
+
+	Together these turn the POP_D sequence "@SP, M=M-1, D=M, A=D, D=M" into "@SP, AM=M-1, D=M".
+	Labels are never crossed, comments and blank lines are kept.
+
+***************************************************************************************************************
+*/
+
+#ifndef __PEEPHOLE_H
+#define __PEEPHOLE_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "hackprogram.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 PR_PUSH_POP = 0
+	,PR_MERGE_COPY
+	,PR_DEAD_DESTINATION
+	,PR_RELOAD_ADDRESS
+	,PR_COUNT
+} E_peepholeRule;
+
+typedef struct {
+	uint32_t instructionsBefore;			// number of Hack instructions before optimizing
+	uint32_t instructionsAfter;			// number of Hack instructions after optimizing
+	uint32_t applied[PR_COUNT];			// number of times each rule was applied
+} T_peepholeStats;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void InitPeepholeStats(T_peepholeStats* stats);
+void AddPeepholeStats(T_peepholeStats* total, const T_peepholeStats* stats);
+uint8_t OptimizeAssembly(T_hackProgram* program, T_peepholeStats* stats);
+void PrintPeepholeStats(const T_peepholeStats* stats);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __PEEPHOLE_H
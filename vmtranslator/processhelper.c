@@ -1,243 +1,1064 @@
-/*! \file
-***************************************************************************************************************
-file name:					processhelper.c
-*	\copyright				FourE
-*	\brief					process helper source file
-*	\author					Frank Eggink
-*	\date	created:			2020-03-21
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include "processhelper.h"
-#include <stdio.h>
-#include <string.h>
-#include <dirent.h>
-#include "stringhelper.h"
-#include "parser.h"
-#include "codewriter_hack.h"
-
-/*
-***************************************************************************************************************
-	LOCAL DEFINES
-***************************************************************************************************************
-*/
-
-#define MAX_LINE_LENGTH			(256)
-
-/*
-***************************************************************************************************************
-	LOCAL TYPEDEFS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	LOCAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	IMPLEMENTATION
-***************************************************************************************************************
-*/
-
-// TODO maybe merge Process File and OutputCode ??
-void OutputCode(FILE* inputFile, FILE* outputFile, char* fileName) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function processes each line in the inputFile and calls the codewriter to assemble each VM command
-
-	\param[in]		inputFile		Pointer to input file
-	\param[out]		outputFile		Pointer to output file
-	\param[in]		filename			Pointer to fileName
-
-	\note
-		- make sure that both inputFile and outputFile are opened
-		- make sure fileName string is nul terminated with '\0
-		- fileName is used to generate file specific labels for the assembly code output
-
-***************************************************************************************************************
-*/
-	char lineBuffer[MAX_LINE_LENGTH];
-	char parseBuffer[MAX_LINE_LENGTH];
-	uint32_t lineNumber = 0; // used to indicate where an error is detected in the input file
-
-	while (fgets(lineBuffer, MAX_LINE_LENGTH, inputFile) != NULL) {
-		lineNumber++;
-		// skip commments
-		if (IsLineComment(lineBuffer) == 0) {
-			RemoveCommentsAndTrim(lineBuffer, lineBuffer);
-			if (lineBuffer[0] != '\0') { // handles special case (skip blank lines)
-				// make a copy to be able to output the VM command as a comment in the output file for debugging purposes
-				memcpy(parseBuffer, lineBuffer, MAX_LINE_LENGTH);
-				// we need to make copy because we want to have original line of VM code as a comment in the output file
-				// parseCommand will change the string because it tokenizes it!!
-				if (ParseCommand(parseBuffer) != 0) {
-					E_commandType command;
-					command = GetCommandType();
-					// TODO refactor WriteCommand
-					// TODO Get parser data (struct) and pass that as parameter to WriteCommand
-					// string inside lineBuffer is output to output file as a comment for debug purposes
-					WriteCommand(outputFile, lineBuffer, fileName, command);
-				} else {
-					printf("Error in file: %s on source line #%d\n", fileName, lineNumber);
-				}
-			}
-		}
-	}
-}
-/*
-***************************************************************************************************************
-	End OutputCode
-***************************************************************************************************************
-*/
-
-uint8_t ProcessDirectory(const char* directory, FILE* outputFile) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function processes each .vm file that it finds in the specified directory
-
-	\param[in]		directory		Pointer to path string
-	\param[out]		outputFile		Pointer to output file
-
-	\returns
-			0: directory could not be opened
-			1: processing directory was successful
-
-	\note
-		- make sure that directory is not NULL
-		- make sure directory string is nul terminated with '\0
-		- make sure that outputFile is opened
-
-***************************************************************************************************************
-*/
-	char inputFileName[MAX_FILENAME_LENGTH] = { 0 };
-
-	WriteInit(outputFile);
-
-	struct dirent *pDirent;
-	DIR *pDir;
-
-	pDir = opendir(directory);
-	if (pDir == NULL) {
-		printf ("Cannot open directory '%s'\n", directory);
-		return 0;
-	}
-
-	pDirent = readdir(pDir);
-
-	while (pDirent != NULL) {
-		if (HasFileNameExtension(pDirent->d_name, ".vm") != 0) {
-			//printf ("[%s]\n", pDirent->d_name);
-			memset(inputFileName, 2, sizeof(inputFileName));
-			strcpy(inputFileName, directory);
-			strcat(inputFileName, "/"); // this seems to work under windows (otherwise we would have added "\\")
-			strcat(inputFileName, pDirent->d_name);
-			ProcessVMFile(inputFileName, outputFile);
-	  }
-	  pDirent = readdir(pDir);
-	}
-	closedir (pDir);
-
-	return 1;
-}
-/*
-***************************************************************************************************************
-	End ProcessDirectory
-***************************************************************************************************************
-*/
-
-uint8_t ProcessVMFile(char* inputFileName, FILE* outputFile) {
-/*!
-***************************************************************************************************************
-
-	\description
-		Function processes input .vm file
-
-	\param[in]		inputFileName		Pointer to input fileName
-	\param[out]		outputFile			Point to output file
-
-	\returns
-			0: processing of .vm file was NOT successful
-			1: processing of .vm file successful
-
-	\note
-		- make sure that inputFileName is not NULL
-		- make sure inputFileName string is nul terminated with '\0
-		- make sure that outputFile is opened
-
-***************************************************************************************************************
-*/
-	FILE* pFile = NULL;
-
-	// try to open input file
-	pFile = fopen(inputFileName, "r");
-	if (pFile == NULL) {
-		printf( "Could not open input file\n" );
-		return 0;
-	}
-
-	// write filename of input file as a comment to the output file
-	fprintf(outputFile, "//input file: %s\n", inputFileName);
-
-	// also create a string that is used to generate file specific labels in the assembly code
-	// https://stackoverflow.com/questions/7180293/how-to-extract-filename-from-path
-	ExtractFileName(inputFileName, inputFileName);
-	StripExtension(inputFileName, inputFileName);
-
-	// write assembly code to the output file
-	OutputCode(pFile, outputFile, inputFileName);
-
-	// cleanup stuff
-	if (pFile != NULL) {
-		fclose(pFile);
-		pFile = NULL;
-	}
-	return 1;
-}
-/*
-***************************************************************************************************************
-	End ProcessVMFile
-***************************************************************************************************************
-*/
+/*! \file
+***************************************************************************************************************
+file name:					processhelper.c
+*	\copyright				FourE
+*	\brief					process helper source file
+*	\author					Frank Eggink
+*	\date	created:			2020-03-21
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	Translation is done in two phases that both run on a worker pool. First every .vm file is parsed into
+	its own VM program. Then the programs are split into chunks at function boundaries and every chunk is
+	translated into its own instruction list, which is printed into its own output buffer in the same task.
+	The buffers are written to the output file in sorted file name order and in source order, so the output
+	does not depend on the number of jobs.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "processhelper.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, realloc, free
+#include <string.h>
+#include "stringhelper.h"
+#include "filehelper.h"
+#include "parser.h"
+#include "codewriter_hack.h"
+#include "codewriter_c.h"
+#include "sourcereader.h"
+#include "workerpool.h"
+#include "peephole.h"
+#include "callgraph.h"
+#include "inliner.h"
+#include "frametable.h"
+#include "diagnostics.h"
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+// root of the call graph, called by the bootstrap code
+#define ENTRY_FUNCTION			"Sys.init"
+
+// a chunk holds at least this number of commands (unless the file is smaller), smaller chunks cost more to
+// schedule than they gain
+#define MIN_CHUNK_COMMANDS		(4096)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// one .vm file
+typedef struct {
+	char inputFileName[MAX_FILENAME_LENGTH];
+	char fileName[MAX_FILENAME_LENGTH];			// inputFileName without path and extension
+	T_vmProgram program;
+	uint8_t isParsed;									// 1 when the file was opened and parsed
+	uint32_t firstChunk;
+	uint32_t chunkCount;
+} T_translationUnit;
+
+// range of commands of a .vm file that is translated into its own instruction list
+typedef struct {
+	const T_translationUnit* unit;
+	const T_translatorOptions* options;
+	const T_frameTable* frames;						// NULL: every function has a dynamic frame
+	uint32_t firstCommand;
+	uint32_t endCommand;
+	T_hackProgram program;
+	T_outputBuffer output;							// program printed as assembly code (OF_ASSEMBLY) or C code
+	T_cRegion next;									// OF_C_SOURCE: C function the chunk falls through into
+	uint32_t firstCallSite;							// OF_C_SOURCE: number of the first call of the chunk
+	T_peepholeStats peephole;
+	T_codeWriterStats calls;
+	uint8_t result;
+} T_translationChunk;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t TranslateUnits(T_translationUnit* units, uint32_t count, T_hackProgram* preamble, uint8_t wholeProgram, T_outputFile* outputFile, const T_translatorOptions* options);
+static uint8_t OptimizeProgram(T_translationUnit* units, uint32_t count, uint8_t wholeProgram, T_frameTable* frames, const T_translatorOptions* options);
+static uint8_t InlineFunctions(T_vmProgram* const* programs, uint32_t count, const T_translatorOptions* options);
+static uint8_t EliminateDeadFunctions(T_vmProgram* const* programs, uint32_t count, const T_translatorOptions* options);
+static uint8_t AllocateFrames(T_vmProgram* const* programs, uint32_t count, T_frameTable* frames, const T_translatorOptions* options);
+static uint8_t AssembleOutput(const T_hackProgram* const* programs, uint32_t count, T_outputFile* outputFile, const T_translatorOptions* options);
+static uint8_t WriteCOutputPreamble(const T_translationUnit* units, uint32_t count, uint8_t wholeProgram, T_outputBuffer* output);
+static void LinkCChunks(T_translationChunk* chunks, uint32_t chunkCount, uint8_t wholeProgram);
+static void ParseFileTask(void* context, uint32_t taskIndex);
+static void WriteChunkTask(void* context, uint32_t taskIndex);
+static uint32_t SplitProgram(const T_translationUnit* unit, uint32_t minCommands, T_translationChunk* chunks);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void InitTranslatorOptions(T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function sets the translator options to their default values
+
+	\param[out]		options		Pointer to translator options
+
+***************************************************************************************************************
+*/
+	options->jobs = DEFAULT_JOBS;
+	options->mapOutput = 0;
+	options->printStats = 0;
+	options->optimizations = 0;
+	options->inlineLimit = DEFAULT_INLINE_LIMIT;
+	options->outputFormat = OF_ASSEMBLY;
+}
+/*
+***************************************************************************************************************
+	End InitTranslatorOptions
+***************************************************************************************************************
+*/
+
+uint8_t ProcessDirectory(const char* directory, T_outputFile* outputFile, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function processes each .vm file that it finds in the specified directory
+
+	\param[in]		directory		Pointer to path string
+	\param[out]		outputFile		Pointer to output file
+	\param[in]		options			Pointer to translator options
+
+	\returns
+			0: directory could not be opened or processing one or more files failed
+			1: processing directory was successful
+
+	\note
+		- make sure that directory is not NULL
+		- make sure directory string is nul terminated with '\0
+		- make sure that outputFile is opened
+		- the files are written in sorted file name order
+
+***************************************************************************************************************
+*/
+	T_hackProgram bootstrap;
+	T_translationUnit* units = NULL;
+	char** fileNames = NULL;
+	uint32_t count = 0;
+	uint8_t result = 1;
+
+	if (ListVMFiles(directory, &fileNames, &count) == 0) {
+		return 0;
+	}
+
+	// the bootstrap code is written by TranslateUnits, it sets the stack behind the static frames
+	if (InitHackProgram(&bootstrap) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		count = 0;
+		result = 0;
+	}
+
+	if (count > 0) {
+		units = calloc(count, sizeof(T_translationUnit));
+		if (units == NULL) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			result = 0;
+		}
+	}
+
+	if (units != NULL) {
+		for (uint32_t i = 0; i < count; i++) {
+			// this seems to work under windows (otherwise we would have added "\\")
+			snprintf(units[i].inputFileName, sizeof(units[i].inputFileName), "%s/%s", directory, fileNames[i]);
+		}
+		if (TranslateUnits(units, count, &bootstrap, 1, outputFile, options) == 0) {
+			result = 0;
+		}
+		free(units);
+	}
+	FreeHackProgram(&bootstrap);
+
+	for (uint32_t i = 0; i < count; i++) {
+		free(fileNames[i]);
+	}
+	free(fileNames);
+
+	return result;
+}
+/*
+***************************************************************************************************************
+	End ProcessDirectory
+***************************************************************************************************************
+*/
+
+uint8_t ProcessVMFile(const char* inputFileName, T_outputFile* outputFile, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function processes input .vm file
+
+	\param[in]		inputFileName		Pointer to input fileName
+	\param[out]		outputFile			Point to output file
+	\param[in]		options				Pointer to translator options
+
+	\returns
+			0: processing of .vm file was NOT successful
+			1: processing of .vm file successful
+
+	\note
+		- make sure that inputFileName is not NULL
+		- make sure inputFileName string is nul terminated with '\0
+		- make sure that outputFile is opened
+		- with more than 1 job a large file is translated in parallel chunks
+		- with shared calls the $call and $return routines are written before the code of the file
+
+***************************************************************************************************************
+*/
+	T_hackProgram routines;
+	T_translationUnit unit;
+	uint8_t result = 1;
+
+	memset(&unit, 0, sizeof(unit));
+	snprintf(unit.inputFileName, sizeof(unit.inputFileName), "%s", inputFileName);
+
+	// without bootstrap code the shared routines are placed at the start and are jumped over
+	if ((options->optimizations & OPT_SHARED_CALLS) == 0) {
+		return TranslateUnits(&unit, 1, NULL, 0, outputFile, options);
+	}
+
+	if (	(InitHackProgram(&routines) == 0)
+		|| (WriteSharedRoutines(&routines, 1) == 0)
+	) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	}
+	if (TranslateUnits(&unit, 1, &routines, 0, outputFile, options) == 0) {
+		result = 0;
+	}
+	FreeHackProgram(&routines);
+
+	return result;
+}
+/*
+***************************************************************************************************************
+	End ProcessVMFile
+***************************************************************************************************************
+*/
+
+static uint8_t TranslateUnits(T_translationUnit* units, uint32_t count, T_hackProgram* preamble, uint8_t wholeProgram, T_outputFile* outputFile, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses and translates .vm files and writes the assembly or machine code to the output file
+
+	\param[in,out]	units				Pointer to array of translation units, only inputFileName has to be set
+	\param[in]		count				Number of translation units
+	\param[in,out]	preamble			Pointer to instruction list that is written before the files, NULL for none
+	\param[in]		wholeProgram		1: the units are a complete program that is started by calling Sys.init,
+										   the bootstrap code is written to the preamble
+	\param[out]		outputFile		Pointer to output file
+	\param[in]		options			Pointer to translator options
+
+	\returns
+			0: one or more files could not be translated
+			1: translating was successful
+
+	\note
+		- with 1 job every file is one chunk, with more jobs files are split at function boundaries so the
+		  functions of one large file are translated in parallel too
+		- chunks always start at a function command (or at the start of the file), the code writer numbers the
+		  generated labels per function, so the output is the same for every number of jobs
+		- all buffers are handed to the output file at once, so it can be written with a few large system calls
+		- with the peephole optimizer every chunk is optimized in its own task
+		- whole program optimizations run after all files are parsed and before they are split in chunks
+		- the bootstrap code is written after the whole program optimizations, the static frames decide where
+		  the stack starts
+		- for a machine code format the instruction lists are assembled in the same order instead of printed
+		- for C code the preamble is the runtime and main of the C program, the chunks are written by the C
+		  code writer and the Hack specific optimizations of the code writer and the frames are not used
+
+***************************************************************************************************************
+*/
+	T_translationChunk* chunks = NULL;
+	const T_outputBuffer** buffers = NULL;
+	const T_hackProgram** programs = NULL;
+	T_outputBuffer preambleText;
+	T_frameTable frames;
+	T_peepholeStats peephole;
+	T_codeWriterStats calls;
+	uint32_t chunkCount = 0;
+	uint32_t minCommands = (options->jobs > 1) ? MIN_CHUNK_COMMANDS : UINT32_MAX;
+	uint8_t result = 1;
+
+	InitPeepholeStats(&peephole);
+	InitOutputBuffer(&preambleText);
+	memset(&calls, 0, sizeof(calls));
+	if (InitFrameTable(&frames) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	}
+
+	// parse phase
+	RunWorkerPool(ParseFileTask, units, count, options->jobs);
+
+	// without frame table the programs can not be optimized either, the translation fails anyway
+	if (	(result == 0)
+		|| (OptimizeProgram(units, count, wholeProgram, &frames, options) == 0)
+	) {
+		result = 0;
+	}
+
+	if (options->outputFormat == OF_C_SOURCE) {
+		if (WriteCOutputPreamble(units, count, wholeProgram, &preambleText) == 0) {
+			result = 0;
+		}
+	} else {
+		if (	(wholeProgram != 0)
+			&& (WriteInit(preamble, ((options->optimizations & OPT_SHARED_CALLS) != 0) ? 1 : 0, frames.stackStart) == 0)
+		) {
+			result = 0;
+		}
+		if (	(preamble != NULL)
+			&& ((options->optimizations & OPT_PEEPHOLE) != 0)
+			&& (OptimizeAssembly(preamble, &peephole) == 0)
+		) {
+			result = 0;
+		}
+		if (	(preamble != NULL)
+			&& (options->outputFormat == OF_ASSEMBLY)
+			&& (WriteAssembly(preamble, &preambleText) == 0)
+		) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			result = 0;
+		}
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (units[i].isParsed != 0) {
+			units[i].chunkCount = SplitProgram(&units[i], minCommands, NULL);
+			units[i].firstChunk = chunkCount;
+			chunkCount += units[i].chunkCount;
+		} else {
+			result = 0;
+		}
+	}
+
+	if (chunkCount > 0) {
+		chunks = calloc(chunkCount, sizeof(T_translationChunk));
+		if (chunks == NULL) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			chunkCount = 0;
+			result = 0;
+		}
+	}
+
+	if (chunks != NULL) {
+		for (uint32_t i = 0; i < count; i++) {
+			if (units[i].isParsed != 0) {
+				SplitProgram(&units[i], minCommands, &chunks[units[i].firstChunk]);
+			}
+		}
+		for (uint32_t i = 0; i < chunkCount; i++) {
+			chunks[i].options = options;
+			chunks[i].frames = ((frames.staticCount > 0) || (frames.trimmedCount > 0)) ? &frames : NULL;
+		}
+		if (options->outputFormat == OF_C_SOURCE) {
+			LinkCChunks(chunks, chunkCount, wholeProgram);
+		}
+
+		// codegen phase
+		RunWorkerPool(WriteChunkTask, chunks, chunkCount, options->jobs);
+	}
+
+	// write the preamble and the chunks in source order
+	buffers = malloc((chunkCount + 1) * sizeof(T_outputBuffer*));
+	programs = malloc((chunkCount + 1) * sizeof(T_hackProgram*));
+	if (	(buffers == NULL)
+		|| (programs == NULL)
+	) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	} else {
+		buffers[0] = &preambleText;
+		programs[0] = preamble;
+		for (uint32_t i = 0; i < chunkCount; i++) {
+			buffers[i + 1] = &chunks[i].output;
+			programs[i + 1] = &chunks[i].program;
+			if (chunks[i].result == 0) {
+				result = 0;
+			}
+			AddPeepholeStats(&peephole, &chunks[i].peephole);
+			AddCodeWriterStats(&calls, &chunks[i].calls);
+		}
+		if (	(options->outputFormat != OF_ASSEMBLY)
+			&& (options->outputFormat != OF_C_SOURCE)
+		) {
+			if (AssembleOutput(programs, chunkCount + 1, outputFile, options) == 0) {
+				result = 0;
+			}
+		} else if (WriteOutputFile(outputFile, buffers, chunkCount + 1) == 0) {
+			DIAG_ERROR(DC_WRITE_OUTPUT, NULL, 0, 0, NULL);
+			result = 0;
+		}
+	}
+	free(buffers);
+	free(programs);
+
+	if (	(options->printStats != 0)
+		&& ((options->optimizations & OPT_PEEPHOLE) != 0)
+	) {
+		PrintPeepholeStats(&peephole);
+	}
+	if (options->printStats != 0) {
+		PrintCodeWriterStats(&calls, ((options->optimizations & OPT_SHARED_CALLS) != 0) ? 1 : 0);
+	}
+	if (	(options->printStats != 0)
+		&& (frames.count > 0)
+	) {
+		PrintFrameCosts(&frames, ((options->optimizations & OPT_SHARED_CALLS) != 0) ? 1 : 0);
+	}
+
+	for (uint32_t i = 0; i < chunkCount; i++) {
+		FreeHackProgram(&chunks[i].program);
+		FreeOutputBuffer(&chunks[i].output);
+	}
+	FreeOutputBuffer(&preambleText);
+	for (uint32_t i = 0; i < count; i++) {
+		if (units[i].isParsed != 0) {
+			FreeVMProgram(&units[i].program);
+		}
+	}
+
+	FreeFrameTable(&frames);
+	free(chunks);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End TranslateUnits
+***************************************************************************************************************
+*/
+
+static uint8_t OptimizeProgram(T_translationUnit* units, uint32_t count, uint8_t wholeProgram, T_frameTable* frames, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function runs the optimizations that need the VM programs of all parsed translation units
+
+	\param[in,out]	units				Pointer to array of translation units
+	\param[in]		count				Number of translation units
+	\param[in]		wholeProgram		1: the units are a complete program that is started by calling Sys.init
+	\param[in,out]	frames			Pointer to initialized frame table that receives the static frames
+	\param[in]		options			Pointer to translator options
+
+	\returns
+			0: out of memory
+			1: programs are optimized
+
+	\note
+		- inlining runs first, so the functions that are no longer called are removed too
+		- the frames are allocated last, every call that is left is known then
+		- C output keeps the standard frames, the static and trimmed frames belong to the Hack calling convention
+
+***************************************************************************************************************
+*/
+	T_vmProgram** programs = NULL;
+	uint32_t programCount = 0;
+	uint8_t result = 1;
+
+	if (	((options->optimizations & OPT_INLINE) == 0)
+		&& (	(wholeProgram == 0)
+			|| ((options->optimizations & (OPT_DEAD_FUNCTIONS | OPT_STATIC_FRAMES | OPT_TRIM_FRAMES)) == 0)
+			)
+	) {
+		return 1;
+	}
+
+	programs = malloc(((count > 0) ? count : 1) * sizeof(T_vmProgram*));
+	if (programs == NULL) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		if (units[i].isParsed != 0) {
+			programs[programCount] = &units[i].program;
+			programCount++;
+		}
+	}
+
+	if (	((options->optimizations & OPT_INLINE) != 0)
+		&& (InlineFunctions(programs, programCount, options) == 0)
+	) {
+		result = 0;
+	}
+	if (	(wholeProgram != 0)
+		&& ((options->optimizations & OPT_DEAD_FUNCTIONS) != 0)
+		&& (EliminateDeadFunctions(programs, programCount, options) == 0)
+	) {
+		result = 0;
+	}
+	if (	(wholeProgram != 0)
+		&& ((options->optimizations & (OPT_STATIC_FRAMES | OPT_TRIM_FRAMES)) != 0)
+		&& (options->outputFormat != OF_C_SOURCE)
+		&& (AllocateFrames(programs, programCount, frames, options) == 0)
+	) {
+		result = 0;
+	}
+
+	free(programs);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End OptimizeProgram
+***************************************************************************************************************
+*/
+
+static uint8_t InlineFunctions(T_vmProgram* const* programs, uint32_t count, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function substitutes small leaf functions at their call sites in the parsed VM programs
+
+	\param[in,out]	programs			Pointer to array of pointers to parsed VM programs
+	\param[in]		count				Number of VM programs
+	\param[in]		options			Pointer to translator options
+
+	\returns
+			0: out of memory
+			1: calls are inlined
+
+	\note
+		- with -s the inlined call sites are printed
+
+***************************************************************************************************************
+*/
+	T_callGraph graph;
+	T_inlineReport report;
+	uint8_t result = 1;
+
+	if (BuildCallGraph(&graph, programs, count) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+
+	if (InlineLeafFunctions(&graph, programs, count, options->inlineLimit, &report) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	} else if (options->printStats != 0) {
+		PrintInlineReport(&report, &graph);
+	}
+
+	FreeInlineReport(&report);
+	FreeCallGraph(&graph);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End InlineFunctions
+***************************************************************************************************************
+*/
+
+static uint8_t EliminateDeadFunctions(T_vmProgram* const* programs, uint32_t count, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function removes the functions that can not be reached from Sys.init from the parsed VM programs
+
+	\param[in,out]	programs			Pointer to array of pointers to parsed VM programs
+	\param[in]		count				Number of VM programs
+	\param[in]		options			Pointer to translator options
+
+	\returns
+			0: out of memory
+			1: unreachable functions are removed (or the program has no Sys.init and nothing is removed)
+
+	\note
+		- with -s the removed functions are printed with their number of VM commands
+
+***************************************************************************************************************
+*/
+	T_callGraph graph;
+	uint32_t entry = FUNCTION_NONE;
+	uint8_t result = 1;
+
+	if (BuildCallGraph(&graph, programs, count) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+
+	// without entry function every function is kept
+	entry = FindFunction(&graph, ENTRY_FUNCTION);
+	if (entry != FUNCTION_NONE) {
+		if (MarkReachable(&graph, entry) == FUNCTION_NONE) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			result = 0;
+		}
+		RemoveUnreachable(&graph, programs);
+		if (options->printStats != 0) {
+			PrintUnreachable(&graph);
+		}
+	}
+
+	FreeCallGraph(&graph);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End EliminateDeadFunctions
+***************************************************************************************************************
+*/
+
+static uint8_t AllocateFrames(T_vmProgram* const* programs, uint32_t count, T_frameTable* frames, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gives the functions that are not recursive a frame at a fixed address and decides which
+		pointers the other frames save
+
+	\param[in,out]	programs			Pointer to array of pointers to parsed VM programs
+	\param[in]		count				Number of VM programs
+	\param[in,out]	frames			Pointer to initialized frame table that receives the frames
+	\param[in]		options			Pointer to translator options
+
+	\returns
+			0: out of memory (every function keeps its frame on the stack)
+			1: frames are allocated
+
+	\note
+		- with -s the number of static and trimmed frames is printed
+
+***************************************************************************************************************
+*/
+	T_callGraph graph;
+	uint32_t staticLimit = ((options->optimizations & OPT_STATIC_FRAMES) != 0) ? MAX_STATIC_FRAME_WORDS : 0;
+	uint8_t trimFrames = ((options->optimizations & OPT_TRIM_FRAMES) != 0) ? 1 : 0;
+	uint8_t result = 1;
+
+	if (BuildCallGraph(&graph, programs, count) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+
+	if (BuildFrameTable(frames, &graph, programs, count, FindFunction(&graph, ENTRY_FUNCTION), staticLimit, trimFrames) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	} else if (options->printStats != 0) {
+		PrintFrameTable(frames);
+	}
+
+	FreeCallGraph(&graph);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End AllocateFrames
+***************************************************************************************************************
+*/
+
+static uint8_t AssembleOutput(const T_hackProgram* const* programs, uint32_t count, T_outputFile* outputFile, const T_translatorOptions* options) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function assembles the instruction lists and writes the machine code to the output file
+
+	\param[in]		programs			Array of pointers to instruction lists, NULL entries are skipped
+	\param[in]		count				Number of instruction lists
+	\param[out]		outputFile		Pointer to output file
+	\param[in]		options			Pointer to translator options, outputFormat is a machine code format
+
+	\returns
+			0: out of memory, the assembly code could not be encoded or the file could not be written
+			1: machine code was written
+
+	\note
+		- the machine code is written with one buffer, it is much smaller than the assembly code
+		- with -s the size of the machine code and the number of symbols are printed
+
+***************************************************************************************************************
+*/
+	T_assembler assembler;
+	T_outputBuffer image;
+	const T_outputBuffer* imageBuffer = &image;
+	uint8_t result = 1;
+
+	InitOutputBuffer(&image);
+	if (InitAssembler(&assembler) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	}
+	for (uint32_t i = 0; (i < count) && (result != 0); i++) {
+		result = AssembleProgram(&assembler, programs[i]);
+	}
+	if (	(result != 0)
+		&& (FinishAssembly(&assembler) == 0)
+	) {
+		result = 0;
+	}
+	if (	(result != 0)
+		&& (WriteMachineCode(&assembler, options->outputFormat, &image) == 0)
+	) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		result = 0;
+	}
+	if (	(result != 0)
+		&& (WriteOutputFile(outputFile, &imageBuffer, 1) == 0)
+	) {
+		DIAG_ERROR(DC_WRITE_OUTPUT, NULL, 0, 0, NULL);
+		result = 0;
+	}
+
+	if (	(result != 0)
+		&& (options->printStats != 0)
+	) {
+		PrintAssemblerStats(&assembler.stats);
+	}
+
+	FreeAssembler(&assembler);
+	FreeOutputBuffer(&image);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End AssembleOutput
+***************************************************************************************************************
+*/
+
+static uint8_t WriteCOutputPreamble(const T_translationUnit* units, uint32_t count, uint8_t wholeProgram, T_outputBuffer* output) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function writes the runtime, the statics, the prototypes and main of the C program of the parsed units
+
+	\param[in]		units				Pointer to array of translation units
+	\param[in]		count				Number of translation units
+	\param[in]		wholeProgram		1: main calls Sys.init, 0: main runs the first unit
+	\param[out]		output			Pointer to output buffer
+
+	\returns
+			0: out of memory
+			1: preamble is written
+
+	\note
+		- units that were not parsed are skipped, the translation fails anyway
+
+***************************************************************************************************************
+*/
+	const T_vmProgram** programs = malloc(((count > 0) ? count : 1) * sizeof(T_vmProgram*));
+	const char** fileNames = malloc(((count > 0) ? count : 1) * sizeof(const char*));
+	uint32_t programCount = 0;
+	uint8_t result = 0;
+
+	if (	(programs != NULL)
+		&& (fileNames != NULL)
+	) {
+		for (uint32_t i = 0; i < count; i++) {
+			if (units[i].isParsed != 0) {
+				programs[programCount] = &units[i].program;
+				fileNames[programCount] = units[i].fileName;
+				programCount++;
+			}
+		}
+		result = WriteCPreamble(output, programs, fileNames, programCount, wholeProgram);
+	}
+	if (result == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+	}
+
+	free(programs);
+	free(fileNames);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End WriteCOutputPreamble
+***************************************************************************************************************
+*/
+
+static void LinkCChunks(T_translationChunk* chunks, uint32_t chunkCount, uint8_t wholeProgram) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function sets the C function every chunk falls through into and the number of its first call
+
+	\param[in,out]	chunks			Pointer to array of translation chunks in output order
+	\param[in]		chunkCount		Number of translation chunks
+	\param[in]		wholeProgram		1: the bootstrap call of Sys.init is call site 0
+
+	\note
+		- empty chunks are skipped, they have no C function
+
+***************************************************************************************************************
+*/
+	T_cRegion next;
+	uint32_t callSite = (wholeProgram != 0) ? 1 : 0;
+
+	memset(&next, 0, sizeof(next));
+	for (uint32_t i = chunkCount; i > 0; i--) {
+		T_translationChunk* chunk = &chunks[i - 1];
+
+		chunk->next = next;
+		if (chunk->firstCommand < chunk->endCommand) {
+			next.program = &chunk->unit->program;
+			next.fileName = chunk->unit->fileName;
+			next.command = chunk->firstCommand;
+		}
+	}
+
+	for (uint32_t i = 0; i < chunkCount; i++) {
+		chunks[i].firstCallSite = callSite;
+		callSite += CountCalls(&chunks[i].unit->program, chunks[i].firstCommand, chunks[i].endCommand);
+	}
+}
+/*
+***************************************************************************************************************
+	End LinkCChunks
+***************************************************************************************************************
+*/
+
+static void ParseFileTask(void* context, uint32_t taskIndex) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Worker pool task that parses the .vm file of one translation unit into its VM program
+
+	\param[in,out]	context			Pointer to array of translation units
+	\param[in]		taskIndex		Index of the translation unit
+
+***************************************************************************************************************
+*/
+	T_translationUnit* unit = &((T_translationUnit*)context)[taskIndex];
+	T_sourceReader reader;
+
+	unit->isParsed = 0;
+
+	// try to open input file (the input file is memory mapped when possible)
+	if (OpenSourceReader(&reader, unit->inputFileName) == 0) {
+		DIAG_ERROR(DC_OPEN_INPUT, unit->inputFileName, 0, 0, NULL);
+		return;
+	}
+
+	// also create a string that is used to generate file specific labels in the assembly code
+	// https://stackoverflow.com/questions/7180293/how-to-extract-filename-from-path
+	ExtractFileName(unit->inputFileName, unit->fileName);
+	StripExtension(unit->fileName, unit->fileName);
+
+	if (InitVMProgram(&unit->program) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, unit->inputFileName, 0, 0, NULL);
+	} else {
+		// lines that can not be parsed are reported and skipped
+		ParseSource(&reader, &unit->program, unit->inputFileName);
+		unit->isParsed = 1;
+	}
+
+	// cleanup stuff (all names are copied to the program)
+	CloseSourceReader(&reader);
+}
+/*
+***************************************************************************************************************
+	End ParseFileTask
+***************************************************************************************************************
+*/
+
+static void WriteChunkTask(void* context, uint32_t taskIndex) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Worker pool task that generates the assembly code of one chunk into its instruction list, for .asm
+		output the list is printed into the output buffer of the chunk, C code is written into it directly
+
+	\param[in,out]	context			Pointer to array of translation chunks
+	\param[in]		taskIndex		Index of the translation chunk
+
+	\note
+		- .asm output without the peephole optimizer is printed directly into the output buffer, the records
+		  are only built when a pass needs them
+
+***************************************************************************************************************
+*/
+	T_translationChunk* chunk = &((T_translationChunk*)context)[taskIndex];
+	T_codeWriter writer;
+	char header[MAX_FILENAME_LENGTH + 16];
+
+	InitOutputBuffer(&chunk->output);
+
+	// write filename of input file as a comment to the output file
+	snprintf(header, sizeof(header), "//input file: %s\n", chunk->unit->inputFileName);
+	if (chunk->options->outputFormat == OF_C_SOURCE) {
+		chunk->result = 1;
+		if (	(chunk->firstCommand == 0)
+			&& (AppendString(&chunk->output, header) == 0)
+		) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, chunk->unit->inputFileName, 0, 0, NULL);
+			chunk->result = 0;
+		}
+		if (WriteCCommandRange(&chunk->output, &chunk->unit->program, chunk->unit->fileName, chunk->unit->inputFileName, chunk->firstCommand, chunk->endCommand, &chunk->next, chunk->firstCallSite) == 0) {
+			chunk->result = 0;
+		}
+		return;
+	}
+
+	if (InitHackProgram(&chunk->program) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, chunk->unit->inputFileName, 0, 0, NULL);
+		chunk->result = 0;
+		return;
+	}
+
+	InitCodeWriter(&writer, &chunk->program, chunk->unit->fileName, chunk->unit->inputFileName);
+
+	// without a pass over the records the assembly code is printed directly
+	if (	(chunk->options->outputFormat == OF_ASSEMBLY)
+		&& ((chunk->options->optimizations & OPT_PEEPHOLE) == 0)
+	) {
+		writer.text = &chunk->output;
+	}
+
+	if (chunk->firstCommand == 0) {
+		if (writer.text != NULL) {
+			if (AppendString(&chunk->output, header) == 0) {
+				DIAG_ERROR(DC_OUT_OF_MEMORY, chunk->unit->inputFileName, 0, 0, NULL);
+				chunk->result = 0;
+				FreeCodeWriter(&writer);
+				return;
+			}
+		} else if (AppendComment(&chunk->program, &header[2], (uint32_t)strcspn(&header[2], "\n")) == 0) {
+			chunk->result = 0;
+			return;
+		}
+	}
+
+	writer.cacheTop = ((chunk->options->optimizations & OPT_CACHE_TOP) != 0) ? 1 : 0;
+	writer.sharedCalls = ((chunk->options->optimizations & OPT_SHARED_CALLS) != 0) ? 1 : 0;
+	writer.foldConstants = ((chunk->options->optimizations & OPT_FOLD_CONSTANTS) != 0) ? 1 : 0;
+	writer.specializeIndex = ((chunk->options->optimizations & OPT_SPECIALIZE_INDEX) != 0) ? 1 : 0;
+	writer.fuseCompare = ((chunk->options->optimizations & OPT_FUSE_COMPARE) != 0) ? 1 : 0;
+	writer.fuseMove = ((chunk->options->optimizations & OPT_FUSE_MOVE) != 0) ? 1 : 0;
+	writer.fuseArray = ((chunk->options->optimizations & OPT_FUSE_ARRAY) != 0) ? 1 : 0;
+	writer.tailCalls = ((chunk->options->optimizations & OPT_TAIL_CALLS) != 0) ? 1 : 0;
+	writer.frames = chunk->frames;
+	chunk->result = WriteCommandRange(&writer, &chunk->unit->program, chunk->firstCommand, chunk->endCommand);
+	chunk->calls = writer.stats;
+	FreeCodeWriter(&writer);
+
+	InitPeepholeStats(&chunk->peephole);
+	if (	((chunk->options->optimizations & OPT_PEEPHOLE) != 0)
+		&& (OptimizeAssembly(&chunk->program, &chunk->peephole) == 0)
+	) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, chunk->unit->inputFileName, 0, 0, NULL);
+		chunk->result = 0;
+	}
+
+	// the instructions are not needed anymore once they are printed
+	if (chunk->options->outputFormat == OF_ASSEMBLY) {
+		if (	(writer.text == NULL)
+			&& (WriteAssembly(&chunk->program, &chunk->output) == 0)
+		) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, chunk->unit->inputFileName, 0, 0, NULL);
+			chunk->result = 0;
+		}
+		FreeHackProgram(&chunk->program);
+	}
+}
+/*
+***************************************************************************************************************
+	End WriteChunkTask
+***************************************************************************************************************
+*/
+
+static uint32_t SplitProgram(const T_translationUnit* unit, uint32_t minCommands, T_translationChunk* chunks) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function splits the VM program of a translation unit in chunks that start at a function command
+
+	\param[in]		unit				Pointer to parsed translation unit
+	\param[in]		minCommands		Minimum number of commands of a chunk
+	\param[out]		chunks			Pointer to array that receives the chunks, NULL to only count the chunks
+
+	\returns
+		Number of chunks (a file without commands has 1 empty chunk)
+
+	\note
+		- a new chunk is started at the first function command after minCommands commands, so every chunk
+		  holds one or more complete functions
+
+***************************************************************************************************************
+*/
+	const T_vmProgram* program = &unit->program;
+	uint32_t count = 0;
+	uint32_t first = 0;
+
+	for (uint32_t i = 1; i < program->count; i++) {
+		if ((program->commands[i].commandType == CT_FUNCTION) && ((i - first) >= minCommands)) {
+			if (chunks != NULL) {
+				chunks[count].unit = unit;
+				chunks[count].firstCommand = first;
+				chunks[count].endCommand = i;
+			}
+			count++;
+			first = i;
+		}
+	}
+
+	if (chunks != NULL) {
+		chunks[count].unit = unit;
+		chunks[count].firstCommand = first;
+		chunks[count].endCommand = program->count;
+	}
+	return count + 1;
+}
+/*
+***************************************************************************************************************
+	End SplitProgram
+***************************************************************************************************************
+*/
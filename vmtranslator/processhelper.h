@@ -1,88 +1,123 @@
-/*! \file
-***************************************************************************************************************
-file name:					processhelper.h
-*	\copyright				FourE
-*	\brief					process helper header file
-*	\author					Frank Eggink
-*	\date	created:			2020-03-21
-
-***************************************************************************************************************
-\par	Description
-***************************************************************************************************************
-
-	Description
-
-***************************************************************************************************************
-\note
-***************************************************************************************************************
-
-	note description
-
-***************************************************************************************************************
-*/
-
-#ifndef __PROCESSHELPER_H
-#define __PROCESSHELPER_H
-
-/*
-***************************************************************************************************************
-	INCLUDE FILES
-***************************************************************************************************************
-*/
-
-#include <stdint.h>
-#include <stdio.h>
-
-/*
-***************************************************************************************************************
-	Make header CPP compatible
-***************************************************************************************************************
-*/
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
-***************************************************************************************************************
-	GLOBAL DEFINES
-***************************************************************************************************************
-*/
-
-#define MAX_FILENAME_LENGTH	(250)
-
-/*
-***************************************************************************************************************
-	GLOBAL TYPEDEF
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL VARS
-***************************************************************************************************************
-*/
-
-
-/*
-***************************************************************************************************************
-	GLOBAL FUNCTION PROTOTYPES
-***************************************************************************************************************
-*/
-
-uint8_t ProcessVMFile(char* inputFileName, FILE* outputFile);
-uint8_t ProcessDirectory(const char* directory, FILE* outputFile);
-void OutputCode(FILE* inputFile, FILE* outputFile, char* fileName);
-
-/*
-***************************************************************************************************************
-
-***************************************************************************************************************
-*/
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif		// __PROCESSHELPER_H
+/*! \file
+***************************************************************************************************************
+file name:					processhelper.h
+*	\copyright				FourE
+*	\brief					process helper header file
+*	\author					Frank Eggink
+*	\date	created:			2020-03-21
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	note description
+
+***************************************************************************************************************
+*/
+
+#ifndef __PROCESSHELPER_H
+#define __PROCESSHELPER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "outputfile.h"
+#include "assembler.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define MAX_FILENAME_LENGTH	(250)
+#define DEFAULT_JOBS				(1)
+#define DEFAULT_INLINE_LIMIT	(12)			// VM commands of the largest function body that is inlined
+#define MAX_INLINE_LIMIT		(1000)
+
+// optimizations, selected with -O<level> and -f<name>
+#define OPT_PEEPHOLE				(1u << 0)		// peephole optimizer over the generated assembly code
+#define OPT_CACHE_TOP			(1u << 1)		// keep the top of the stack in D between commands
+#define OPT_SHARED_CALLS		(1u << 2)		// call and return through shared $call and $return routines
+#define OPT_FOLD_CONSTANTS		(1u << 3)		// evaluate arithmetic on constants at translation time
+#define OPT_SPECIALIZE_INDEX	(1u << 4)		// shortest push and pop sequence for every segment and index
+#define OPT_FUSE_COMPARE		(1u << 5)		// compare followed by if-goto jumps directly
+#define OPT_FUSE_MOVE			(1u << 6)		// push followed by pop moves the value without the stack
+#define OPT_FUSE_ARRAY			(1u << 7)		// array reads and writes compute the address without the stack
+#define OPT_DEAD_FUNCTIONS		(1u << 8)		// only functions that are reachable from Sys.init are translated
+#define OPT_INLINE				(1u << 9)		// small leaf functions are substituted at their call sites
+#define OPT_TAIL_CALLS			(1u << 10)		// call followed by return reuses the frame of the current function
+#define OPT_STATIC_FRAMES		(1u << 11)		// functions that are not recursive get their frame at a fixed address
+#define OPT_TRIM_FRAMES			(1u << 12)		// frames on the stack only save the THIS and THAT their function sets
+
+#define OPT_LEVEL_1				(OPT_PEEPHOLE | OPT_FOLD_CONSTANTS | OPT_SPECIALIZE_INDEX | OPT_FUSE_COMPARE \
+										| OPT_FUSE_MOVE | OPT_FUSE_ARRAY | OPT_DEAD_FUNCTIONS)
+#define OPT_LEVEL_2				(OPT_LEVEL_1 | OPT_CACHE_TOP | OPT_INLINE | OPT_TAIL_CALLS | OPT_STATIC_FRAMES \
+										| OPT_TRIM_FRAMES)
+#define OPT_LEVEL_S				((OPT_LEVEL_2 | OPT_SHARED_CALLS) & ~OPT_INLINE)
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+// options that are set on the command line
+typedef struct {
+	uint16_t jobs;					// number of threads that translate .vm files and functions at the same time
+	uint8_t mapOutput;			// 1: write the output file through a memory mapping
+	uint8_t printStats;			// 1: print the throughput of the write side and the optimizer statistics
+	uint32_t optimizations;		// OPT_ flags
+	uint16_t inlineLimit;		// VM commands of the largest function body that is inlined
+	E_outputFormat outputFormat;	// assembly code or machine code from the integrated assembler
+} T_translatorOptions;
+
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void InitTranslatorOptions(T_translatorOptions* options);
+uint8_t ProcessVMFile(const char* inputFileName, T_outputFile* outputFile, const T_translatorOptions* options);
+uint8_t ProcessDirectory(const char* directory, T_outputFile* outputFile, const T_translatorOptions* options);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __PROCESSHELPER_H
@@ -0,0 +1,326 @@
+/*! \file
+***************************************************************************************************************
+file name:					sourcereader.c
+*	\copyright				FourE
+*	\brief					source reader source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	On Windows the file is read into a heap buffer, on all other platforms the file is memory mapped.
+	If mapping the file fails (e.g. the input is a pipe) the file is read into a heap buffer as well.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "sourcereader.h"
+#include <stdio.h>
+#include <stdlib.h>			// malloc, realloc, free
+#include <string.h>			// memchr, memset
+#include <assert.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>			// open
+#include <unistd.h>			// close
+#include <sys/mman.h>		// mmap, munmap
+#include <sys/stat.h>		// fstat
+#endif
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define READ_CHUNK_SIZE		(64 * 1024)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t MapSourceFile(T_sourceReader* reader, const char* fileName);
+static uint8_t LoadSourceFile(T_sourceReader* reader, const char* fileName);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t OpenSourceReader(T_sourceReader* reader, const char* fileName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function makes the contents of the input file available to the reader
+
+	\param[out]		reader		Pointer to source reader
+	\param[in]		fileName		Pointer to fileName
+
+	\returns
+			0: file could not be opened or read
+			1: file is ready to be read
+
+	\note
+		- make sure that both reader and fileName are not NULL
+		- make sure fileName string is nul terminated with '\0
+		- a reader that was opened successfully must be closed with CloseSourceReader
+
+***************************************************************************************************************
+*/
+	assert(reader != NULL);
+	assert(fileName != NULL);
+
+	memset(reader, 0, sizeof(T_sourceReader));
+
+	if (MapSourceFile(reader, fileName) != 0) {
+		return 1;
+	}
+	return LoadSourceFile(reader, fileName);
+}
+/*
+***************************************************************************************************************
+	End OpenSourceReader
+***************************************************************************************************************
+*/
+
+void CloseSourceReader(T_sourceReader* reader) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function releases the contents of the input file
+
+	\param[in,out]	reader		Pointer to source reader
+
+	\note
+		- all string views handed out by the reader are invalid after this call
+
+***************************************************************************************************************
+*/
+	assert(reader != NULL);
+
+	if (reader->data != NULL) {
+#if !defined(_WIN32)
+		if (reader->isMapped != 0) {
+			munmap((void*)reader->data, reader->size);
+		} else {
+			free((void*)reader->data);
+		}
+#else
+		free((void*)reader->data);
+#endif
+	}
+	memset(reader, 0, sizeof(T_sourceReader));
+}
+/*
+***************************************************************************************************************
+	End CloseSourceReader
+***************************************************************************************************************
+*/
+
+uint8_t ReadSourceLine(T_sourceReader* reader, T_stringView* line) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns a view on the next line of the input file
+
+	\param[in,out]	reader		Pointer to source reader
+	\param[out]		line			Pointer to string view that receives the line
+
+	\returns
+			0: end of file reached, there are no more lines
+			1: line contains the next line of the input file
+
+	\note
+		- the line does NOT contain the line terminator and is NOT nul terminated
+		- the line points into the contents of the file, it is valid until the reader is closed
+
+***************************************************************************************************************
+*/
+	assert(reader != NULL);
+	assert(line != NULL);
+
+	if (reader->position >= reader->size) {
+		return 0;
+	}
+
+	const char* start = reader->data + reader->position;
+	size_t remaining = reader->size - reader->position;
+	const char* newLine = memchr(start, '\n', remaining);
+
+	if (newLine != NULL) {
+		line->length = (uint32_t)(newLine - start);
+		reader->position += line->length + 1;
+	} else {
+		// last line of the file has no line terminator
+		line->length = (uint32_t)remaining;
+		reader->position = reader->size;
+	}
+	line->start = start;
+	reader->lineNumber++;
+
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End ReadSourceLine
+***************************************************************************************************************
+*/
+
+static uint8_t MapSourceFile(T_sourceReader* reader, const char* fileName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function memory maps the input file
+
+	\param[out]		reader		Pointer to source reader
+	\param[in]		fileName		Pointer to fileName
+
+	\returns
+			0: file could not be mapped
+			1: file is mapped (or empty)
+
+***************************************************************************************************************
+*/
+#if !defined(_WIN32)
+	struct stat fileStatus;
+	int fd = open(fileName, O_RDONLY);
+	uint8_t result = 0;
+
+	if (fd < 0) {
+		return 0;
+	}
+
+	if (	(fstat(fd, &fileStatus) == 0)
+		&& (S_ISREG(fileStatus.st_mode))
+	) {
+		if (fileStatus.st_size == 0) {
+			// an empty file can not be mapped, but there is nothing to read either
+			reader->data = NULL;
+			reader->size = 0;
+			reader->isMapped = 1;
+			result = 1;
+		} else {
+			void* data = mmap(NULL, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED) {
+				// the file is read front to back exactly once
+				posix_madvise(data, (size_t)fileStatus.st_size, POSIX_MADV_SEQUENTIAL);
+				reader->data = data;
+				reader->size = (size_t)fileStatus.st_size;
+				reader->isMapped = 1;
+				result = 1;
+			}
+		}
+	}
+
+	// the mapping stays valid after the file descriptor is closed
+	close(fd);
+	return result;
+#else
+	(void)reader;
+	(void)fileName;
+	return 0;
+#endif
+}
+/*
+***************************************************************************************************************
+	End MapSourceFile
+***************************************************************************************************************
+*/
+
+static uint8_t LoadSourceFile(T_sourceReader* reader, const char* fileName) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function reads the complete input file into a heap buffer
+
+	\param[out]		reader		Pointer to source reader
+	\param[in]		fileName		Pointer to fileName
+
+	\returns
+			0: file could not be read
+			1: file is read
+
+***************************************************************************************************************
+*/
+	FILE* pFile = NULL;
+	char* buffer = NULL;
+	size_t capacity = 0;
+	size_t size = 0;
+	size_t count = 0;
+
+	pFile = fopen(fileName, "rb");
+	if (pFile == NULL) {
+		return 0;
+	}
+
+	do {
+		if ((capacity - size) < READ_CHUNK_SIZE) {
+			char* newBuffer = realloc(buffer, capacity + READ_CHUNK_SIZE);
+			if (newBuffer == NULL) {
+				free(buffer);
+				fclose(pFile);
+				return 0;
+			}
+			buffer = newBuffer;
+			capacity += READ_CHUNK_SIZE;
+		}
+		count = fread(&buffer[size], 1, capacity - size, pFile);
+		size += count;
+	} while (count > 0);
+
+	fclose(pFile);
+
+	reader->data = buffer;
+	reader->size = size;
+	reader->isMapped = 0;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End LoadSourceFile
+***************************************************************************************************************
+*/
@@ -0,0 +1,96 @@
+/*! \file
+***************************************************************************************************************
+file name:					sourcereader.h
+*	\copyright				FourE
+*	\brief					source reader header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	The source reader makes the complete contents of a .vm file available in memory (memory mapped when
+	possible) and hands out the lines as string views that point directly into the file contents
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The lines are never copied, so there is no limit on the length of a line
+
+***************************************************************************************************************
+*/
+
+#ifndef __SOURCEREADER_H
+#define __SOURCEREADER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include <stddef.h>			// size_t
+#include "stringhelper.h"	// T_stringView
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef struct {
+	const char* data;			// contents of the source file
+	size_t size;				// size of the contents in bytes
+	size_t position;			// offset of the next line that is read
+	uint32_t lineNumber;		// line number of the last line that was read
+	uint8_t isMapped;			// 1: data is memory mapped, 0: data is allocated on the heap
+} T_sourceReader;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t OpenSourceReader(T_sourceReader* reader, const char* fileName);
+void CloseSourceReader(T_sourceReader* reader);
+uint8_t ReadSourceLine(T_sourceReader* reader, T_stringView* line);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __SOURCEREADER_H
@@ -0,0 +1,443 @@
+/*! \file
+***************************************************************************************************************
+file name:					stringtable.c
+*	\copyright				FourE
+*	\brief					string table source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	Lookups use an open addressing hash table (linear probing) on FNV-1a hashes
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "stringtable.h"
+#include <stdlib.h>			// malloc, realloc, free
+#include <string.h>			// memcpy, memcmp, memset
+#include <assert.h>
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define ARENA_BLOCK_SIZE		(64 * 1024)
+#define INITIAL_CAPACITY		(256)
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+struct T_stringArenaBlock {
+	T_stringArenaBlock* next;
+	size_t size;					// number of bytes that can be stored in data
+	size_t used;					// number of bytes in use
+	char data[];
+};
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint32_t HashString(const char* string, uint32_t length);
+static const char* StoreString(T_stringTable* table, const char* string, uint32_t length);
+static uint8_t GrowSlots(T_stringTable* table);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+uint8_t InitStringTable(T_stringTable* table) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an empty string table, the empty string is interned as STRING_ID_NONE
+
+	\param[out]		table		Pointer to string table
+
+	\returns
+			0: out of memory
+			1: table is initialized
+
+***************************************************************************************************************
+*/
+	assert(table != NULL);
+
+	memset(table, 0, sizeof(T_stringTable));
+
+	table->entries = malloc(sizeof(T_stringTableEntry) * INITIAL_CAPACITY);
+	table->slots = calloc(INITIAL_CAPACITY * 2, sizeof(uint32_t));
+	if (	(table->entries == NULL)
+		|| (table->slots == NULL)
+	) {
+		FreeStringTable(table);
+		return 0;
+	}
+	table->capacity = INITIAL_CAPACITY;
+	table->slotCount = INITIAL_CAPACITY * 2;
+
+	if (InternString(table, "", 0) != STRING_ID_NONE) {
+		FreeStringTable(table);
+		return 0;
+	}
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End InitStringTable
+***************************************************************************************************************
+*/
+
+void FreeStringTable(T_stringTable* table) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees all memory of the string table, all IDs and strings become invalid
+
+	\param[in,out]	table		Pointer to string table
+
+***************************************************************************************************************
+*/
+	assert(table != NULL);
+
+	T_stringArenaBlock* block = table->blocks;
+
+	while (block != NULL) {
+		T_stringArenaBlock* next = block->next;
+		free(block);
+		block = next;
+	}
+	free(table->entries);
+	free(table->slots);
+	memset(table, 0, sizeof(T_stringTable));
+}
+/*
+***************************************************************************************************************
+	End FreeStringTable
+***************************************************************************************************************
+*/
+
+uint32_t InternString(T_stringTable* table, const char* string, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the ID of a string, the string is added to the table when it is not present yet
+
+	\param[in,out]	table		Pointer to string table
+	\param[in]		string	Pointer to string
+	\param[in]		length	Length of the string
+
+	\returns
+		ID of the string or STRING_ID_INVALID when the table is out of memory
+
+	\note
+		- the string does NOT have to be nul terminated, the table stores a nul terminated copy
+
+***************************************************************************************************************
+*/
+	assert(table != NULL);
+	assert((string != NULL) || (length == 0));
+
+	uint32_t hash = HashString(string, length);
+	uint32_t mask = table->slotCount - 1;
+	uint32_t slot = hash & mask;
+
+	while (table->slots[slot] != 0) {
+		const T_stringTableEntry* entry = &table->entries[table->slots[slot] - 1];
+		if (	(entry->hash == hash)
+			&& (entry->length == length)
+			&& (memcmp(entry->string, string, length) == 0)
+		) {
+			return table->slots[slot] - 1;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	// new string, make sure there is room for the entry
+	if (table->count == table->capacity) {
+		T_stringTableEntry* entries = realloc(table->entries, sizeof(T_stringTableEntry) * table->capacity * 2);
+		if (entries == NULL) {
+			return STRING_ID_INVALID;
+		}
+		table->entries = entries;
+		table->capacity *= 2;
+	}
+
+	const char* stored = StoreString(table, string, length);
+	if (stored == NULL) {
+		return STRING_ID_INVALID;
+	}
+
+	uint32_t id = table->count;
+	table->entries[id].string = stored;
+	table->entries[id].length = length;
+	table->entries[id].hash = hash;
+	table->count++;
+	table->slots[slot] = id + 1;
+
+	// keep the load factor of the hash table below 50%
+	if (	((table->count * 2) > table->slotCount)
+		&& (GrowSlots(table) == 0)
+	) {
+		return STRING_ID_INVALID;
+	}
+	return id;
+}
+/*
+***************************************************************************************************************
+	End InternString
+***************************************************************************************************************
+*/
+
+uint32_t FindString(const T_stringTable* table, const char* string, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function looks up the ID of a string without adding it to the table
+
+	\param[in]		table		Pointer to string table
+	\param[in]		string	Pointer to string
+	\param[in]		length	Length of the string
+
+	\returns
+		ID of the string or STRING_ID_INVALID when the string is not in the table
+
+***************************************************************************************************************
+*/
+	assert(table != NULL);
+
+	uint32_t hash = HashString(string, length);
+	uint32_t mask = table->slotCount - 1;
+	uint32_t slot = hash & mask;
+
+	while (table->slots[slot] != 0) {
+		const T_stringTableEntry* entry = &table->entries[table->slots[slot] - 1];
+		if (	(entry->hash == hash)
+			&& (entry->length == length)
+			&& (memcmp(entry->string, string, length) == 0)
+		) {
+			return table->slots[slot] - 1;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return STRING_ID_INVALID;
+}
+/*
+***************************************************************************************************************
+	End FindString
+***************************************************************************************************************
+*/
+
+const char* GetString(const T_stringTable* table, uint32_t id) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the nul terminated string that belongs to an ID
+
+	\param[in]		table		Pointer to string table
+	\param[in]		id			ID of the string
+
+	\returns
+		Pointer to the string, the pointer stays valid until the table is freed
+
+***************************************************************************************************************
+*/
+	assert(table != NULL);
+	assert(id < table->count);
+
+	return table->entries[id].string;
+}
+/*
+***************************************************************************************************************
+	End GetString
+***************************************************************************************************************
+*/
+
+uint32_t GetStringLength(const T_stringTable* table, uint32_t id) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function returns the length of the string that belongs to an ID
+
+	\param[in]		table		Pointer to string table
+	\param[in]		id			ID of the string
+
+	\returns
+		Length of the string
+
+***************************************************************************************************************
+*/
+	assert(table != NULL);
+	assert(id < table->count);
+
+	return table->entries[id].length;
+}
+/*
+***************************************************************************************************************
+	End GetStringLength
+***************************************************************************************************************
+*/
+
+static uint32_t HashString(const char* string, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function calculates the 32-bit FNV-1a hash of a string
+
+	\param[in]		string	Pointer to string
+	\param[in]		length	Length of the string
+
+	\returns
+		hash value
+
+***************************************************************************************************************
+*/
+	uint32_t hash = 2166136261u;
+
+	for (uint32_t i = 0; i < length; i++) {
+		hash ^= (uint8_t)string[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+/*
+***************************************************************************************************************
+	End HashString
+***************************************************************************************************************
+*/
+
+static const char* StoreString(T_stringTable* table, const char* string, uint32_t length) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function copies a string (including a terminating '\0') into the arena
+
+	\param[in,out]	table		Pointer to string table
+	\param[in]		string	Pointer to string
+	\param[in]		length	Length of the string
+
+	\returns
+		Pointer to the stored string or NULL when out of memory
+
+***************************************************************************************************************
+*/
+	T_stringArenaBlock* block = table->blocks;
+	size_t needed = (size_t)length + 1;
+
+	if (	(block == NULL)
+		|| ((block->size - block->used) < needed)
+	) {
+		// strings that do not fit in a normal block get a block of their own
+		size_t size = (needed > ARENA_BLOCK_SIZE) ? needed : ARENA_BLOCK_SIZE;
+		block = malloc(sizeof(T_stringArenaBlock) + size);
+		if (block == NULL) {
+			return NULL;
+		}
+		block->size = size;
+		block->used = 0;
+		block->next = table->blocks;
+		table->blocks = block;
+	}
+
+	char* stored = &block->data[block->used];
+	if (length > 0) {
+		memcpy(stored, string, length);
+	}
+	stored[length] = '\0';
+	block->used += needed;
+
+	return stored;
+}
+/*
+***************************************************************************************************************
+	End StoreString
+***************************************************************************************************************
+*/
+
+static uint8_t GrowSlots(T_stringTable* table) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function doubles the number of slots of the hash table and re-inserts all entries
+
+	\param[in,out]	table		Pointer to string table
+
+	\returns
+			0: out of memory
+			1: hash table has grown
+
+***************************************************************************************************************
+*/
+	uint32_t slotCount = table->slotCount * 2;
+	uint32_t mask = slotCount - 1;
+	uint32_t* slots = calloc(slotCount, sizeof(uint32_t));
+
+	if (slots == NULL) {
+		return 0;
+	}
+
+	for (uint32_t id = 0; id < table->count; id++) {
+		uint32_t slot = table->entries[id].hash & mask;
+		while (slots[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		slots[slot] = id + 1;
+	}
+
+	free(table->slots);
+	table->slots = slots;
+	table->slotCount = slotCount;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End GrowSlots
+***************************************************************************************************************
+*/
@@ -0,0 +1,109 @@
+/*! \file
+***************************************************************************************************************
+file name:					stringtable.h
+*	\copyright				FourE
+*	\brief					string table header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	The string table interns strings: every distinct string is stored once and is identified by a 32-bit ID.
+	The characters are stored in large arena blocks, so a string never moves once it is interned.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	ID 0 (STRING_ID_NONE) is always the empty string
+
+***************************************************************************************************************
+*/
+
+#ifndef __STRINGTABLE_H
+#define __STRINGTABLE_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include <stddef.h>			// size_t
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define STRING_ID_NONE			(0)
+#define STRING_ID_INVALID		(0xFFFFFFFFu)
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef struct T_stringArenaBlock T_stringArenaBlock;
+
+typedef struct {
+	const char* string;		// nul terminated string inside an arena block
+	uint32_t length;
+	uint32_t hash;
+} T_stringTableEntry;
+
+typedef struct {
+	T_stringArenaBlock* blocks;	// list of arena blocks, the first block is the one that is filled
+	T_stringTableEntry* entries;	// entries indexed by ID
+	uint32_t count;
+	uint32_t capacity;
+	uint32_t* slots;					// hash table with (ID + 1) per slot, 0 means empty slot
+	uint32_t slotCount;				// always a power of 2
+} T_stringTable;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+uint8_t InitStringTable(T_stringTable* table);
+void FreeStringTable(T_stringTable* table);
+uint32_t InternString(T_stringTable* table, const char* string, uint32_t length);
+uint32_t FindString(const T_stringTable* table, const char* string, uint32_t length);
+const char* GetString(const T_stringTable* table, uint32_t id);
+uint32_t GetStringLength(const T_stringTable* table, uint32_t id);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __STRINGTABLE_H
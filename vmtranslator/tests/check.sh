@@ -0,0 +1,78 @@
+#!/bin/sh
+#
+# Runs every program of the test corpus under the VM interpreter, translated to Hack assembly on the Hack
+# emulator and translated to C, at every optimization level. Each program halts in an endless loop with
+# its results in RAM[3000..3015], every run must leave the words of <program>/expected.txt there. A program
+# whose expected.txt is "error <code>" (e.g. "error E009") must instead be rejected with that error by
+# every run.
+#
+# usage: tests/check.sh [directory of VMTranslator and HackEmulator]
+
+BIN=${1:-.}
+TESTS=$(dirname "$0")
+FIRST=3000
+LAST=3015
+CC=${CC:-cc}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+failures=0
+runs=0
+
+# what a run is compared on, $1: output of the run: the RAM dump, or the first error for a program that
+# must be rejected, the first line of the output when neither is there
+outcome() {
+	case "$expected" in
+	error*)
+		error=$(printf '%s\n' "$1" | grep -o 'error\[E[0-9]*\]' | head -n 1 | sed 's/error\[\(E[0-9]*\)\]/error \1/')
+		printf '%s\n' "${error:-no error}"
+		;;
+	*)
+		printf '%s\n' "$1" | grep '^RAM' || printf '%s\n' "$1" | head -n 1
+		;;
+	esac
+}
+
+# compares the outcome of a run with the expected one, $1: program, $2: run, $3: output of the run
+compare() {
+	runs=$((runs + 1))
+	actual=$(outcome "$3")
+	if [ "$actual" != "$expected" ]; then
+		failures=$((failures + 1))
+		echo "FAIL $1 ($2)"
+		echo "  expected: $expected"
+		echo "  actual:   $actual"
+	fi
+}
+
+# fresh copy of the program, the translator writes its output next to the .vm files
+copy() {
+	rm -rf "${WORK:?}/$1"
+	cp -r "$TESTS/$1" "$WORK/$1"
+	rm -f "$WORK/$1/expected.txt"
+}
+
+for dir in "$TESTS"/*/; do
+	program=$(basename "$dir")
+	expected=$(cat "$dir/expected.txt")
+
+	copy "$program"
+	compare "$program" "interpreter" "$("$BIN/HackEmulator" -d "$FIRST-$LAST" "$WORK/$program" 2>&1)"
+
+	for level in -O0 -O1 -O2 -Os; do
+		copy "$program"
+		if output=$("$BIN/VMTranslator" "$level" "$WORK/$program" 2>&1); then
+			output=$("$BIN/HackEmulator" -d "$FIRST-$LAST" "$WORK/$program/$program.asm" 2>&1)
+		fi
+		compare "$program" "hack $level" "$output"
+
+		copy "$program"
+		if		output=$("$BIN/VMTranslator" "$level" -t c "$WORK/$program" 2>&1) \
+			&&	output=$($CC -O1 -w -o "$WORK/$program/program" "$WORK/$program/$program.c" 2>&1); then
+			output=$("$WORK/$program/program" "$FIRST-$LAST" 2>&1)
+		fi
+		compare "$program" "c $level" "$output"
+	done
+done
+
+echo "$runs runs, $failures failed"
+[ "$failures" -eq 0 ]
@@ -0,0 +1,935 @@
+/*! \file
+***************************************************************************************************************
+file name:					vminterpreter.c
+*	\copyright				FourE
+*	\brief					VM interpreter source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The stack pointer is kept in a local variable during the run. RAM[0] is only written before a push
+	through LCL, ARG, THIS or THAT and when the run stops, the only ways a program can read it, and a pop
+	through those pointers that writes RAM[0] loads the local variable again.
+
+	"label L" followed by "goto L" is the endless loop a program ends with, it is linked as halt.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "vminterpreter.h"
+#include "assembler.h"			// VARIABLE_START_ADDRESS, MAX_VARIABLE_ADDRESS
+#include "diagnostics.h"
+#include "filehelper.h"
+#include "frametable.h"			// STACK_START_ADDRESS
+#include "sourcereader.h"
+#include <stdio.h>				// snprintf
+#include <stdlib.h>			// malloc, calloc, realloc, free
+#include <string.h>			// memset, strlen
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+#define SP_ADDRESS				(0)
+#define LCL_ADDRESS				(1)
+#define ARG_ADDRESS				(2)
+#define THIS_ADDRESS				(3)
+#define THAT_ADDRESS				(4)
+#define POINTER_ADDRESS			(3)				// pointer 0 is THIS, pointer 1 is THAT
+#define TEMP_ADDRESS				(5)
+#define FRAME_SIZE				(5)				// return address, LCL, ARG, THIS and THAT
+#define NO_INDEX					(UINT32_MAX)
+#define INITIAL_ENTRIES			(64)
+
+// the word on top of the stack
+#define TOP							(ram[(uint16_t)(sp - 1)])
+
+// counts the command and continues with the next operation
+#define NEXT() \
+	do { \
+		executed++; \
+		goto *(++operation)->handler; \
+	} while (0)
+
+// counts the command and continues with the operation at index, a jump is where the limit is checked
+#define JUMP(index) \
+	do { \
+		executed++; \
+		operation = &code[(index)]; \
+		if (executed >= limit) { \
+			stop = VS_LIMIT; \
+			goto stopped; \
+		} \
+		goto *operation->handler; \
+	} while (0)
+
+// push segment[index] of the segment the pointer at RAM address pointer points at
+#define PUSH_SEGMENT(label, pointer) \
+	label: \
+		ram[SP_ADDRESS] = sp; \
+		ram[sp] = ram[(uint16_t)(ram[(pointer)] + operation->value)]; \
+		sp++; \
+		NEXT();
+
+// pop segment[index] of the segment the pointer at RAM address pointer points at
+#define POP_SEGMENT(label, pointer) \
+	label: \
+		address = (uint16_t)(ram[(pointer)] + operation->value); \
+		sp--; \
+		ram[address] = ram[sp]; \
+		if (address == SP_ADDRESS) { \
+			sp = ram[SP_ADDRESS]; \
+		} \
+		NEXT();
+
+// eq, gt and lt compare the difference of the two words like the Hack translation does
+#define COMPARE(label, condition) \
+	label: \
+		sp--; \
+		difference = (uint16_t)(TOP - ram[sp]); \
+		TOP = (condition) ? 0xFFFF : 0; \
+		NEXT();
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// the push and pop operations of local, argument, this and that are in the order of E_memorySegment
+typedef enum {
+	 OP_PUSH_CONSTANT = 0
+	,OP_PUSH_LOCAL
+	,OP_PUSH_ARGUMENT
+	,OP_PUSH_THIS
+	,OP_PUSH_THAT
+	,OP_PUSH_ADDRESS						// static, pointer and temp: value is the RAM address
+	,OP_POP_LOCAL
+	,OP_POP_ARGUMENT
+	,OP_POP_THIS
+	,OP_POP_THAT
+	,OP_POP_ADDRESS
+	,OP_ADD
+	,OP_SUB
+	,OP_NEG
+	,OP_EQ
+	,OP_GT
+	,OP_LT
+	,OP_AND
+	,OP_OR
+	,OP_NOT
+	,OP_GOTO
+	,OP_IF_GOTO
+	,OP_FUNCTION
+	,OP_CALL
+	,OP_RETURN
+	,OP_HALT
+	,OP_END
+	,OP_COUNT
+} E_vmOperation;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static uint8_t DefineFunctions(T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, T_stringTable* functions, uint32_t** entries, uint32_t* operationCount, uint32_t* callCount);
+static uint8_t LinkProgram(T_vmInterpreter* interpreter, const T_vmProgram* program, const char* fileName, const T_stringTable* functions, const uint32_t* entries, uint32_t* nextStatic);
+static uint8_t LinkMemoryAccess(T_vmOperation* operation, const T_vmCommand* command, const char* fileName, uint16_t* statics, uint32_t* nextStatic);
+static uint8_t LoadVMFile(const char* fileName, T_vmProgram* program);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+// operations of the commands without operand, indexed by E_commandType
+static const uint8_t arithmeticOperations[CT_UNKNOWN] = {
+	 [CT_ADD] = OP_ADD, [CT_SUB] = OP_SUB, [CT_NEG] = OP_NEG, [CT_EQ] = OP_EQ, [CT_GT] = OP_GT
+	,[CT_LT] = OP_LT, [CT_AND] = OP_AND, [CT_OR] = OP_OR, [CT_NOT] = OP_NOT
+};
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void InitVMInterpreter(T_vmInterpreter* interpreter) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function initializes an interpreter without program and with cleared RAM
+
+	\param[out]		interpreter		Pointer to interpreter
+
+***************************************************************************************************************
+*/
+	memset(interpreter, 0, sizeof(T_vmInterpreter));
+}
+/*
+***************************************************************************************************************
+	End InitVMInterpreter
+***************************************************************************************************************
+*/
+
+void FreeVMInterpreter(T_vmInterpreter* interpreter) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function frees the program of an interpreter
+
+	\param[in,out]	interpreter		Pointer to interpreter
+
+***************************************************************************************************************
+*/
+	free(interpreter->code);
+	free(interpreter->returnSites);
+	memset(interpreter, 0, sizeof(T_vmInterpreter));
+}
+/*
+***************************************************************************************************************
+	End FreeVMInterpreter
+***************************************************************************************************************
+*/
+
+uint8_t LinkVMPrograms(T_vmInterpreter* interpreter, T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, uint8_t bootstrap) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function links the commands of the programs into the operations of the interpreter and resets the
+		RAM, the labels and functions are resolved to the index of their operation
+
+	\param[in,out]	interpreter		Pointer to interpreter
+	\param[in]		programs			Array of parsed programs, in the order they are linked
+	\param[in]		fileNames		Array of the names of their files (for the diagnostics)
+	\param[in]		count				Number of programs
+	\param[in]		bootstrap		1: the run starts with SP = 256 and a call of Sys.init that halts when it
+											returns, 0: the run starts with the first command
+
+	\returns
+			0: a name is not defined or defined twice or out of memory (the errors are reported)
+			1: programs are linked
+
+	\note
+		- the statics get the RAM addresses from VARIABLE_START_ADDRESS on in the order of first use, like
+		  the assembler gives them to the translation
+
+***************************************************************************************************************
+*/
+	T_stringTable functions;
+	uint32_t* entries = NULL;
+	uint32_t operationCount = (bootstrap != 0) ? 2 : 0;
+	uint32_t callCount = (bootstrap != 0) ? 1 : 0;
+	uint32_t nextStatic = VARIABLE_START_ADDRESS;
+	uint8_t result = 1;
+
+	FreeVMInterpreter(interpreter);
+	if (InitStringTable(&functions) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+		return 0;
+	}
+
+	// the functions are defined first, so calls of functions in later files can be resolved
+	result = DefineFunctions(programs, fileNames, count, &functions, &entries, &operationCount, &callCount);
+	if (	(result != 0)
+		&& (callCount > MAX_RETURN_SITES)
+	) {
+		DIAG_ERROR(DC_INVALID_VALUE, NULL, 0, 0, "more call sites than return addresses");
+		result = 0;
+	}
+
+	if (result != 0) {
+		// one more operation ends the run
+		interpreter->code = calloc(operationCount + 1, sizeof(T_vmOperation));
+		interpreter->returnSites = malloc(((callCount > 0) ? callCount : 1) * sizeof(uint32_t));
+		if (	(interpreter->code == NULL)
+			|| (interpreter->returnSites == NULL)
+		) {
+			DIAG_ERROR(DC_OUT_OF_MEMORY, NULL, 0, 0, NULL);
+			result = 0;
+		}
+	}
+
+	if (	(result != 0)
+		&& (bootstrap != 0)
+	) {
+		uint32_t id = FindString(&functions, "Sys.init", 8);
+
+		if (id == STRING_ID_INVALID) {
+			DIAG_ERROR(DC_UNDEFINED_NAME, NULL, 0, 0, "Sys.init");
+			result = 0;
+		} else {
+			interpreter->code[0].operation = OP_CALL;
+			interpreter->code[0].target = entries[id];
+			interpreter->code[1].operation = OP_HALT;
+			interpreter->returnSites[0] = 1;
+			interpreter->returnSiteCount = 1;
+			interpreter->count = 2;
+			interpreter->ram[SP_ADDRESS] = STACK_START_ADDRESS;
+		}
+	}
+
+	for (uint32_t i = 0; (result != 0) && (i < count); i++) {
+		result = LinkProgram(interpreter, programs[i], fileNames[i], &functions, entries, &nextStatic);
+	}
+
+	if (result != 0) {
+		interpreter->code[interpreter->count].operation = OP_END;
+		interpreter->count++;
+	} else {
+		free(interpreter->code);
+		free(interpreter->returnSites);
+		interpreter->code = NULL;
+		interpreter->returnSites = NULL;
+		interpreter->count = 0;
+		interpreter->returnSiteCount = 0;
+	}
+
+	free(entries);
+	FreeStringTable(&functions);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LinkVMPrograms
+***************************************************************************************************************
+*/
+
+uint8_t LoadVMInput(T_vmInterpreter* interpreter, char* input) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses and links a .vm file or all .vm files of a directory, a directory gets the bootstrap
+		code and the files are linked in sorted file name order, like the translator does
+
+	\param[in,out]	interpreter		Pointer to interpreter
+	\param[in]		input				Pointer to name of the .vm file or the directory
+
+	\returns
+			0: the input could not be read, parsed or linked (the errors are reported)
+			1: program is loaded
+
+***************************************************************************************************************
+*/
+	E_inputFileType inputFileType = GetInputFileType(input);
+	T_vmProgram* programs = NULL;
+	T_vmProgram** pointers = NULL;
+	char** fileNames = NULL;
+	uint32_t count = 0;
+	uint8_t result = 1;
+
+	if (inputFileType == IFT_DIRECTORY) {
+		if (ListVMFiles(input, &fileNames, &count) == 0) {
+			return 0;
+		}
+		// replace the names by paths
+		for (uint32_t i = 0; (result != 0) && (i < count); i++) {
+			size_t length = strlen(input) + strlen(fileNames[i]) + 2;
+			char* path = malloc(length);
+
+			if (path == NULL) {
+				result = 0;
+			} else {
+				snprintf(path, length, "%s/%s", input, fileNames[i]);
+				free(fileNames[i]);
+				fileNames[i] = path;
+			}
+		}
+	} else if (inputFileType == IFT_SINGLE_VM_FILE) {
+		fileNames = malloc(sizeof(char*));
+		if (fileNames != NULL) {
+			fileNames[0] = malloc(strlen(input) + 1);
+			if (fileNames[0] != NULL) {
+				strcpy(fileNames[0], input);
+				count = 1;
+			}
+		}
+		result = (count == 1) ? 1 : 0;
+	} else {
+		DIAG_ERROR(DC_NO_INPUT, input, 0, 0, NULL);
+		return 0;
+	}
+
+	if (result != 0) {
+		programs = calloc(count, sizeof(T_vmProgram));
+		pointers = malloc(count * sizeof(T_vmProgram*));
+		result = ((programs != NULL) && (pointers != NULL)) ? 1 : 0;
+	}
+	if (result == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, input, 0, 0, NULL);
+	}
+
+	// every file is parsed, so all parse errors are reported
+	for (uint32_t i = 0; (programs != NULL) && (pointers != NULL) && (i < count); i++) {
+		pointers[i] = &programs[i];
+		if (LoadVMFile(fileNames[i], &programs[i]) == 0) {
+			result = 0;
+		}
+	}
+
+	if (result != 0) {
+		result = LinkVMPrograms(interpreter, pointers, (const char* const*)fileNames, count, (inputFileType == IFT_DIRECTORY) ? 1 : 0);
+	}
+
+	// cleanup stuff (the interpreter does not refer to the programs)
+	for (uint32_t i = 0; i < count; i++) {
+		if (programs != NULL) {
+			FreeVMProgram(&programs[i]);
+		}
+		free(fileNames[i]);
+	}
+	free(programs);
+	free(pointers);
+	free(fileNames);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LoadVMInput
+***************************************************************************************************************
+*/
+
+E_vmStop RunVMInterpreter(T_vmInterpreter* interpreter, uint64_t limit) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function runs the program from the current operation until it halts, runs past its end, returns to
+		an address that no call pushed or reaches the command limit
+
+	\param[in,out]	interpreter		Pointer to interpreter with a linked program
+	\param[in]		limit				Number of executed commands after which the run stops,
+											NO_COMMAND_LIMIT for none
+
+	\returns
+		Reason the run stopped, pc is the operation that was not executed
+
+	\note
+		- the limit is checked at jumps, calls and returns, so the run can pass it by the length of a block
+		  of commands without jump
+
+***************************************************************************************************************
+*/
+	static const void* const operationLabels[OP_COUNT] = {
+		 [OP_PUSH_CONSTANT] = &&pushConstant, [OP_PUSH_LOCAL] = &&pushLocal, [OP_PUSH_ARGUMENT] = &&pushArgument
+		,[OP_PUSH_THIS] = &&pushThis, [OP_PUSH_THAT] = &&pushThat, [OP_PUSH_ADDRESS] = &&pushAddress
+		,[OP_POP_LOCAL] = &&popLocal, [OP_POP_ARGUMENT] = &&popArgument, [OP_POP_THIS] = &&popThis
+		,[OP_POP_THAT] = &&popThat, [OP_POP_ADDRESS] = &&popAddress, [OP_ADD] = &&add, [OP_SUB] = &&sub
+		,[OP_NEG] = &&neg, [OP_EQ] = &&eq, [OP_GT] = &&gt, [OP_LT] = &&lt, [OP_AND] = &&bitAnd, [OP_OR] = &&bitOr
+		,[OP_NOT] = &&bitNot, [OP_GOTO] = &&jump, [OP_IF_GOTO] = &&ifJump, [OP_FUNCTION] = &&function
+		,[OP_CALL] = &&call, [OP_RETURN] = &&functionReturn, [OP_HALT] = &&halt, [OP_END] = &&end
+	};
+	uint16_t* const ram = interpreter->ram;
+	T_vmOperation* const code = interpreter->code;
+	const uint32_t* const returnSites = interpreter->returnSites;
+	const T_vmOperation* operation = NULL;
+	uint64_t executed = interpreter->executed;
+	uint16_t sp = ram[SP_ADDRESS];
+	uint16_t address = 0;
+	uint16_t difference = 0;
+	uint16_t frame = 0;
+	uint16_t returnAddress = 0;
+	E_vmStop stop = VS_END;
+
+	if (code == NULL) {
+		return VS_END;
+	}
+
+	// thread the code: the labels are only known inside this function
+	for (uint32_t i = 0; i < interpreter->count; i++) {
+		code[i].handler = operationLabels[code[i].operation];
+	}
+
+	operation = &code[interpreter->pc];
+	if (executed >= limit) {
+		return VS_LIMIT;
+	}
+	goto *operation->handler;
+
+pushConstant:
+	ram[sp] = operation->value;
+	sp++;
+	NEXT();
+
+	PUSH_SEGMENT(pushLocal		, LCL_ADDRESS)
+	PUSH_SEGMENT(pushArgument	, ARG_ADDRESS)
+	PUSH_SEGMENT(pushThis		, THIS_ADDRESS)
+	PUSH_SEGMENT(pushThat		, THAT_ADDRESS)
+
+pushAddress:
+	ram[sp] = ram[operation->value];
+	sp++;
+	NEXT();
+
+	POP_SEGMENT(popLocal		, LCL_ADDRESS)
+	POP_SEGMENT(popArgument	, ARG_ADDRESS)
+	POP_SEGMENT(popThis		, THIS_ADDRESS)
+	POP_SEGMENT(popThat		, THAT_ADDRESS)
+
+popAddress:
+	sp--;
+	ram[operation->value] = ram[sp];
+	NEXT();
+
+add:
+	sp--;
+	TOP = (uint16_t)(TOP + ram[sp]);
+	NEXT();
+
+sub:
+	sp--;
+	TOP = (uint16_t)(TOP - ram[sp]);
+	NEXT();
+
+neg:
+	TOP = (uint16_t)(-TOP);
+	NEXT();
+
+	COMPARE(eq	, difference == 0)
+	COMPARE(gt	, (int16_t)difference > 0)
+	COMPARE(lt	, (int16_t)difference < 0)
+
+bitAnd:
+	sp--;
+	TOP &= ram[sp];
+	NEXT();
+
+bitOr:
+	sp--;
+	TOP |= ram[sp];
+	NEXT();
+
+bitNot:
+	TOP = (uint16_t)~TOP;
+	NEXT();
+
+jump:
+	JUMP(operation->target);
+
+ifJump:
+	sp--;
+	if (ram[sp] != 0) {
+		JUMP(operation->target);
+	}
+	NEXT();
+
+function:
+	for (uint16_t i = 0; i < operation->value; i++) {
+		ram[sp] = 0;
+		sp++;
+	}
+	NEXT();
+
+call:
+	ram[sp++] = operation->returnSite;
+	ram[sp++] = ram[LCL_ADDRESS];
+	ram[sp++] = ram[ARG_ADDRESS];
+	ram[sp++] = ram[THIS_ADDRESS];
+	ram[sp++] = ram[THAT_ADDRESS];
+	ram[ARG_ADDRESS] = (uint16_t)(sp - FRAME_SIZE - operation->value);
+	ram[LCL_ADDRESS] = sp;
+	JUMP(operation->target);
+
+functionReturn:
+	frame = ram[LCL_ADDRESS];
+	returnAddress = ram[(uint16_t)(frame - FRAME_SIZE)];
+	if (returnAddress >= interpreter->returnSiteCount) {
+		stop = VS_BAD_RETURN;
+		goto stopped;
+	}
+	// the return value can overwrite the return address of a function without arguments
+	ram[ram[ARG_ADDRESS]] = TOP;
+	sp = (uint16_t)(ram[ARG_ADDRESS] + 1);
+	ram[THAT_ADDRESS] = ram[(uint16_t)(frame - 1)];
+	ram[THIS_ADDRESS] = ram[(uint16_t)(frame - 2)];
+	ram[ARG_ADDRESS] = ram[(uint16_t)(frame - 3)];
+	ram[LCL_ADDRESS] = ram[(uint16_t)(frame - 4)];
+	JUMP(returnSites[returnAddress]);
+
+halt:
+	stop = VS_HALTED;
+	goto stopped;
+
+end:
+	stop = VS_END;
+
+stopped:
+	ram[SP_ADDRESS] = sp;
+	interpreter->pc = (uint32_t)(operation - code);
+	interpreter->executed = executed;
+	return stop;
+}
+/*
+***************************************************************************************************************
+	End RunVMInterpreter
+***************************************************************************************************************
+*/
+
+static uint8_t DefineFunctions(T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, T_stringTable* functions, uint32_t** entries, uint32_t* operationCount, uint32_t* callCount) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function gives every function the index of its operation and counts the operations and calls
+
+	\param[in]		programs				Array of parsed programs, in the order they are linked
+	\param[in]		fileNames			Array of the names of their files
+	\param[in]		count					Number of programs
+	\param[in,out]	functions			Pointer to string table that receives the function names
+	\param[out]		entries				Pointer that receives the array of operation indices, indexed by ID
+	\param[in,out]	operationCount		Pointer to number of operations before the programs, receives the
+												number of operations with the programs
+	\param[in,out]	callCount			Pointer to number of calls, the calls of the programs are added
+
+	\returns
+			0: a function is defined twice or out of memory (the errors are reported)
+			1: functions are defined
+
+***************************************************************************************************************
+*/
+	uint32_t capacity = 0;
+	uint8_t result = 1;
+
+	*entries = NULL;
+	for (uint32_t i = 0; i < count; i++) {
+		const T_vmProgram* program = programs[i];
+
+		for (uint32_t j = 0; j < program->count; j++) {
+			const T_vmCommand* command = &program->commands[j];
+
+			if (command->commandType == CT_LABEL) {
+				continue;
+			}
+			if (command->commandType == CT_CALL) {
+				(*callCount)++;
+			} else if (command->commandType == CT_FUNCTION) {
+				const char* name = GetString(&program->names, command->nameId);
+				uint32_t id = InternString(functions, name, GetStringLength(&program->names, command->nameId));
+
+				if (id == STRING_ID_INVALID) {
+					DIAG_ERROR(DC_OUT_OF_MEMORY, fileNames[i], command->lineNumber, 0, NULL);
+					return 0;
+				}
+				if (id >= capacity) {
+					uint32_t newCapacity = (capacity == 0) ? INITIAL_ENTRIES : (capacity * 2);
+					uint32_t* newEntries = realloc(*entries, newCapacity * sizeof(uint32_t));
+
+					if (newEntries == NULL) {
+						DIAG_ERROR(DC_OUT_OF_MEMORY, fileNames[i], command->lineNumber, 0, NULL);
+						return 0;
+					}
+					for (uint32_t k = capacity; k < newCapacity; k++) {
+						newEntries[k] = NO_INDEX;
+					}
+					*entries = newEntries;
+					capacity = newCapacity;
+				}
+				if ((*entries)[id] != NO_INDEX) {
+					DIAG_ERROR(DC_DUPLICATE_NAME, fileNames[i], command->lineNumber, command->column, name);
+					result = 0;
+				}
+				(*entries)[id] = *operationCount;
+			}
+			(*operationCount)++;
+		}
+	}
+	return result;
+}
+/*
+***************************************************************************************************************
+	End DefineFunctions
+***************************************************************************************************************
+*/
+
+static uint8_t LinkProgram(T_vmInterpreter* interpreter, const T_vmProgram* program, const char* fileName, const T_stringTable* functions, const uint32_t* entries, uint32_t* nextStatic) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function appends the operations of the commands of a program
+
+	\param[in,out]	interpreter		Pointer to interpreter with room for the operations
+	\param[in]		program			Pointer to parsed program
+	\param[in]		fileName			Pointer to name of its file
+	\param[in]		functions		Pointer to string table with the function names
+	\param[in]		entries			Array of the operation index of each function, indexed by ID
+	\param[in,out]	nextStatic		Pointer to RAM address of the next static
+
+	\returns
+			0: a label is not defined or defined twice, a function is not defined or out of memory
+			1: program is linked
+
+	\note
+		- a label is only visible in the function it is defined in (the commands before the first function
+		  are a scope of their own), the scopes are linked one after the other and a label name is only
+		  defined while its scope is linked, so every function can use the same label names
+
+***************************************************************************************************************
+*/
+	uint32_t nameCount = program->names.count;
+	uint32_t* labelTargets = malloc(((nameCount > 0) ? nameCount : 1) * sizeof(uint32_t));
+	uint32_t* labelScopes = calloc((nameCount > 0) ? nameCount : 1, sizeof(uint32_t));
+	uint16_t* statics = NULL;
+	uint32_t staticCount = 0;
+	uint32_t scope = 0;
+	uint32_t end = 0;
+	uint8_t result = 1;
+
+	if (	(labelTargets == NULL)
+		|| (labelScopes == NULL)
+	) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, fileName, 0, 0, NULL);
+		free(labelTargets);
+		free(labelScopes);
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < program->count; i++) {
+		const T_vmCommand* command = &program->commands[i];
+
+		if (	(	(command->commandType == CT_PUSH)
+				|| (command->commandType == CT_POP)
+				)
+			&& (command->memorySegment == MS_STATIC)
+			&& (command->value >= staticCount)
+		) {
+			staticCount = (uint32_t)command->value + 1;
+		}
+	}
+
+	// 0: the static has no address yet
+	statics = calloc((staticCount > 0) ? staticCount : 1, sizeof(uint16_t));
+	if (statics == NULL) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, fileName, 0, 0, NULL);
+		result = 0;
+	}
+
+	// one scope after the other, its labels are defined first, so a goto can jump forward
+	for (uint32_t first = 0; (statics != NULL) && (first < program->count); first = end) {
+		uint32_t index = interpreter->count;
+
+		scope++;
+		for (end = first; end < program->count; end++) {
+			const T_vmCommand* command = &program->commands[end];
+
+			if (	(command->commandType == CT_FUNCTION)
+				&& (end > first)
+			) {
+				break;
+			}
+			if (command->commandType != CT_LABEL) {
+				index++;
+				continue;
+			}
+			if (labelScopes[command->nameId] == scope) {
+				DIAG_ERROR(DC_DUPLICATE_NAME, fileName, command->lineNumber, command->column, GetString(&program->names, command->nameId));
+				result = 0;
+			}
+			labelScopes[command->nameId] = scope;
+			labelTargets[command->nameId] = index;
+		}
+
+		for (uint32_t i = first; i < end; i++) {
+			const T_vmCommand* command = &program->commands[i];
+			T_vmOperation* operation = &interpreter->code[interpreter->count];
+			uint32_t id = STRING_ID_INVALID;
+
+			switch (command->commandType) {
+			case CT_LABEL:
+				continue;
+			case CT_PUSH:
+			case CT_POP:
+				if (LinkMemoryAccess(operation, command, fileName, statics, nextStatic) == 0) {
+					result = 0;
+				}
+				break;
+			case CT_GOTO:
+			case CT_IFGOTO:
+				if (labelScopes[command->nameId] != scope) {
+					DIAG_ERROR(DC_UNDEFINED_NAME, fileName, command->lineNumber, command->column, GetString(&program->names, command->nameId));
+					result = 0;
+					break;
+				}
+				operation->target = labelTargets[command->nameId];
+				if (command->commandType == CT_IFGOTO) {
+					operation->operation = OP_IF_GOTO;
+				} else {
+					operation->operation = (operation->target == interpreter->count) ? OP_HALT : OP_GOTO;
+				}
+				break;
+			case CT_FUNCTION:
+				operation->operation = OP_FUNCTION;
+				operation->value = command->value;
+				break;
+			case CT_CALL:
+				id = FindString(functions, GetString(&program->names, command->nameId), GetStringLength(&program->names, command->nameId));
+				if (id == STRING_ID_INVALID) {
+					DIAG_ERROR(DC_UNDEFINED_NAME, fileName, command->lineNumber, command->column, GetString(&program->names, command->nameId));
+					result = 0;
+					break;
+				}
+				operation->operation = OP_CALL;
+				operation->target = entries[id];
+				operation->value = command->value;
+				operation->returnSite = (uint16_t)interpreter->returnSiteCount;
+				interpreter->returnSites[interpreter->returnSiteCount] = interpreter->count + 1;
+				interpreter->returnSiteCount++;
+				break;
+			case CT_RETURN:
+				operation->operation = OP_RETURN;
+				break;
+			default:
+				operation->operation = arithmeticOperations[command->commandType];
+				break;
+			}
+			interpreter->count++;
+		}
+	}
+
+	free(statics);
+	free(labelTargets);
+	free(labelScopes);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LinkProgram
+***************************************************************************************************************
+*/
+
+static uint8_t LinkMemoryAccess(T_vmOperation* operation, const T_vmCommand* command, const char* fileName, uint16_t* statics, uint32_t* nextStatic) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function sets the operation of a push or pop command
+
+	\param[out]		operation		Pointer to operation
+	\param[in]		command			Pointer to push or pop command
+	\param[in]		fileName			Pointer to name of the file of the command
+	\param[in,out]	statics			Array of the RAM addresses of the statics of the file, 0: none yet
+	\param[in,out]	nextStatic		Pointer to RAM address of the next static
+
+	\returns
+			0: pop constant or there is no RAM left for a static (the error is reported)
+			1: operation is set
+
+***************************************************************************************************************
+*/
+	uint8_t isPop = (command->commandType == CT_POP) ? 1 : 0;
+
+	switch (command->memorySegment) {
+	case MS_LOCAL:
+	case MS_ARGUMENT:
+	case MS_THIS:
+	case MS_THAT:
+		operation->operation = (uint8_t)(((isPop != 0) ? OP_POP_LOCAL : OP_PUSH_LOCAL) + (command->memorySegment - MS_LOCAL));
+		operation->value = command->value;
+		return 1;
+	case MS_CONSTANT:
+		if (isPop != 0) {
+			DIAG_ERROR(DC_UNKNOWN_SEGMENT, fileName, command->lineNumber, command->column, "pop constant");
+			return 0;
+		}
+		operation->operation = OP_PUSH_CONSTANT;
+		operation->value = command->value;
+		return 1;
+	case MS_STATIC:
+		if (statics[command->value] == 0) {
+			if (*nextStatic > MAX_VARIABLE_ADDRESS) {
+				DIAG_ERROR(DC_INVALID_VALUE, fileName, command->lineNumber, command->column, "no RAM left for statics");
+				return 0;
+			}
+			statics[command->value] = (uint16_t)*nextStatic;
+			(*nextStatic)++;
+		}
+		operation->value = statics[command->value];
+		break;
+	case MS_POINTER:
+		operation->value = (uint16_t)(POINTER_ADDRESS + command->value);
+		break;
+	default:
+		operation->value = (uint16_t)(TEMP_ADDRESS + command->value);
+		break;
+	}
+	operation->operation = (isPop != 0) ? OP_POP_ADDRESS : OP_PUSH_ADDRESS;
+	return 1;
+}
+/*
+***************************************************************************************************************
+	End LinkMemoryAccess
+***************************************************************************************************************
+*/
+
+static uint8_t LoadVMFile(const char* fileName, T_vmProgram* program) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function parses a .vm file
+
+	\param[in]		fileName		Pointer to name of the file
+	\param[out]		program		Pointer to program that receives the commands, it has to be freed even
+										when the function fails
+
+	\returns
+			0: the file could not be read or has errors (the errors are reported)
+			1: program is parsed
+
+***************************************************************************************************************
+*/
+	T_sourceReader reader;
+	uint8_t result = 1;
+
+	if (OpenSourceReader(&reader, fileName) == 0) {
+		DIAG_ERROR(DC_OPEN_INPUT, fileName, 0, 0, NULL);
+		return 0;
+	}
+
+	if (InitVMProgram(program) == 0) {
+		DIAG_ERROR(DC_OUT_OF_MEMORY, fileName, 0, 0, NULL);
+		result = 0;
+	} else if (ParseSource(&reader, program, fileName) > 0) {
+		result = 0;
+	}
+
+	CloseSourceReader(&reader);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End LoadVMFile
+***************************************************************************************************************
+*/
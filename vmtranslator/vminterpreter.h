@@ -0,0 +1,125 @@
+/*! \file
+***************************************************************************************************************
+file name:					vminterpreter.h
+*	\copyright				FourE
+*	\brief					VM interpreter header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Interpreter that runs .vm programs directly, without translating them to Hack first, for fast functional
+	tests of large Jack applications. The parsed commands of all files are linked into one array of
+	operations, the labels and functions are resolved to indices of that array before the run.
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The RAM holds the same words as the Hack translation does: SP, LCL, ARG, THIS and THAT at 0 to 4, temp
+	at 5 to 12, the statics from 16 on in the order of first use and the stack with the frame layout of
+	call and return. Only the return address differs: a call pushes the number of its call site instead of
+	a ROM address.
+
+	Like the Hack emulator the interpreter loop jumps from operation to operation through label addresses
+	(threaded code, the labels as values extension of GCC and clang).
+
+***************************************************************************************************************
+*/
+
+#ifndef __VMINTERPRETER_H
+#define __VMINTERPRETER_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+#include "parser.h"
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define VM_RAM_SIZE				(65536)			// every 16 bit address is valid, so no address is masked
+#define MAX_RETURN_SITES		(65536)			// a return address is one 16 bit word
+#define NO_COMMAND_LIMIT		(UINT64_MAX)
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef enum {
+	 VS_HALTED = 0							// reached an endless loop "label L, goto L"
+	,VS_END									// ran past the last command of the program
+	,VS_LIMIT								// executed the maximum number of commands
+	,VS_BAD_RETURN							// return to an address that no call pushed
+} E_vmStop;
+
+// linked VM command
+typedef struct {
+	const void* handler;					// label of the operation, set when the interpreter runs
+	uint32_t target;						// goto, if-goto: index of the operation, call: index of the function
+	uint16_t value;						// constant, segment index, RAM address or number of locals or arguments
+	uint16_t returnSite;					// call: return address that is pushed
+	uint8_t operation;					// E_vmOperation
+} T_vmOperation;
+
+typedef struct {
+	uint16_t ram[VM_RAM_SIZE];
+	T_vmOperation* code;					// the last operation ends the run
+	uint32_t count;						// number of operations
+	uint32_t* returnSites;				// index of the operation after each call, indexed by return address
+	uint32_t returnSiteCount;
+	uint32_t pc;							// index of the next operation
+	uint64_t executed;					// number of VM commands executed
+} T_vmInterpreter;
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void InitVMInterpreter(T_vmInterpreter* interpreter);
+void FreeVMInterpreter(T_vmInterpreter* interpreter);
+uint8_t LinkVMPrograms(T_vmInterpreter* interpreter, T_vmProgram* const* programs, const char* const* fileNames, uint32_t count, uint8_t bootstrap);
+uint8_t LoadVMInput(T_vmInterpreter* interpreter, char* input);
+E_vmStop RunVMInterpreter(T_vmInterpreter* interpreter, uint64_t limit);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __VMINTERPRETER_H
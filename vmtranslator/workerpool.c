@@ -0,0 +1,292 @@
+/*! \file
+***************************************************************************************************************
+file name:					workerpool.c
+*	\copyright				FourE
+*	\brief					worker pool source file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	Description
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	The calling thread takes part in the work, so threadCount 1 runs all tasks on the calling thread without
+	creating any threads.
+
+	Every worker starts with its own contiguous range of task indices and takes tasks from the front of that
+	range. A worker that runs out of tasks steals the back half of the range of another worker, so threads
+	that get the expensive tasks are helped by the others without a shared counter that every task contends
+	on.
+
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include "workerpool.h"
+#include <pthread.h>
+#include <assert.h>
+
+/*
+***************************************************************************************************************
+	LOCAL DEFINES
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL TYPEDEFS
+***************************************************************************************************************
+*/
+
+// range [next, end) of task indices that belongs to one worker
+typedef struct {
+	pthread_mutex_t lock;		// protects next and end
+	uint32_t next;
+	uint32_t end;
+} T_workerQueue;
+
+typedef struct {
+	F_workerTask task;
+	void* context;
+	uint16_t workerCount;
+	T_workerQueue queues[MAX_WORKER_THREADS];
+} T_workerPool;
+
+typedef struct {
+	T_workerPool* pool;
+	uint16_t index;				// index of the queue of the worker
+} T_worker;
+
+/*
+***************************************************************************************************************
+	LOCAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+static void* WorkerThread(void* argument);
+static uint8_t TakeTask(T_workerQueue* queue, uint32_t* taskIndex);
+static uint8_t StealTasks(T_workerPool* pool, uint16_t thief);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	LOCAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	IMPLEMENTATION
+***************************************************************************************************************
+*/
+
+void RunWorkerPool(F_workerTask task, void* context, uint32_t taskCount, uint16_t threadCount) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function executes task(context, index) for every index in [0, taskCount) and returns when all tasks are
+		finished
+
+	\param[in]		task				Pointer to task function
+	\param[in]		context			Pointer that is passed to every task
+	\param[in]		taskCount		Number of tasks
+	\param[in]		threadCount		Number of threads that execute the tasks (including the calling thread)
+
+	\note
+		- tasks must not depend on each other, they can run in any order and at the same time
+		- when threads can not be created the remaining work is done by the calling thread
+
+***************************************************************************************************************
+*/
+	assert(task != NULL);
+
+	T_workerPool pool;
+	T_worker workers[MAX_WORKER_THREADS];
+	pthread_t threads[MAX_WORKER_THREADS];
+	uint16_t started = 0;
+
+	if (threadCount > MAX_WORKER_THREADS) {
+		threadCount = MAX_WORKER_THREADS;
+	}
+	if (threadCount > taskCount) {
+		threadCount = (uint16_t)taskCount;
+	}
+	if (threadCount == 0) {
+		threadCount = 1;
+	}
+
+	pool.task = task;
+	pool.context = context;
+	pool.workerCount = threadCount;
+
+	// divide the tasks in equal contiguous ranges
+	for (uint16_t i = 0; i < threadCount; i++) {
+		pthread_mutex_init(&pool.queues[i].lock, NULL);
+		pool.queues[i].next = (uint32_t)(((uint64_t)taskCount * i) / threadCount);
+		pool.queues[i].end = (uint32_t)(((uint64_t)taskCount * (i + 1)) / threadCount);
+		workers[i].pool = &pool;
+		workers[i].index = i;
+	}
+
+	// the calling thread is worker 0, the ranges of threads that can not be created are stolen by the others
+	while ((started + 1) < threadCount) {
+		if (pthread_create(&threads[started], NULL, WorkerThread, &workers[started + 1]) != 0) {
+			break;
+		}
+		started++;
+	}
+
+	WorkerThread(&workers[0]);
+
+	for (uint16_t i = 0; i < started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	for (uint16_t i = 0; i < threadCount; i++) {
+		pthread_mutex_destroy(&pool.queues[i].lock);
+	}
+}
+/*
+***************************************************************************************************************
+	End RunWorkerPool
+***************************************************************************************************************
+*/
+
+static void* WorkerThread(void* argument) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function executes the tasks of the worker and steals tasks from other workers until no tasks are left
+
+	\param[in]		argument		Pointer to the worker
+
+	\returns
+		NULL
+
+***************************************************************************************************************
+*/
+	T_worker* worker = argument;
+	T_workerPool* pool = worker->pool;
+	T_workerQueue* queue = &pool->queues[worker->index];
+	uint32_t taskIndex = 0;
+
+	for (;;) {
+		if (TakeTask(queue, &taskIndex) != 0) {
+			pool->task(pool->context, taskIndex);
+		} else if (StealTasks(pool, worker->index) == 0) {
+			// tasks are never added, so when nothing can be stolen all tasks are handed out
+			break;
+		}
+	}
+	return NULL;
+}
+/*
+***************************************************************************************************************
+	End WorkerThread
+***************************************************************************************************************
+*/
+
+static uint8_t TakeTask(T_workerQueue* queue, uint32_t* taskIndex) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function takes the task at the front of the range of a worker
+
+	\param[in,out]	queue			Pointer to the queue of the worker
+	\param[out]		taskIndex	Pointer that receives the index of the task
+
+	\returns
+		0: the range is empty
+		1: a task was taken
+
+***************************************************************************************************************
+*/
+	uint8_t result = 0;
+
+	pthread_mutex_lock(&queue->lock);
+	if (queue->next < queue->end) {
+		*taskIndex = queue->next;
+		queue->next++;
+		result = 1;
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return result;
+}
+/*
+***************************************************************************************************************
+	End TakeTask
+***************************************************************************************************************
+*/
+
+static uint8_t StealTasks(T_workerPool* pool, uint16_t thief) {
+/*!
+***************************************************************************************************************
+
+	\description
+		Function moves the back half of the range of another worker to the (empty) range of the thief
+
+	\param[in,out]	pool			Pointer to the worker pool
+	\param[in]		thief			Index of the worker that steals
+
+	\returns
+		0: all other ranges are empty
+		1: tasks were stolen
+
+	\note
+		- the victims are visited starting at the next worker, so thieves spread over the workers
+
+***************************************************************************************************************
+*/
+	for (uint16_t i = 1; i < pool->workerCount; i++) {
+		T_workerQueue* victim = &pool->queues[(thief + i) % pool->workerCount];
+		uint32_t first = 0;
+		uint32_t end = 0;
+
+		pthread_mutex_lock(&victim->lock);
+		if (victim->next < victim->end) {
+			uint32_t count = (victim->end - victim->next + 1) / 2;
+			end = victim->end;
+			first = end - count;
+			victim->end = first;
+		}
+		pthread_mutex_unlock(&victim->lock);
+
+		if (first < end) {
+			T_workerQueue* queue = &pool->queues[thief];
+
+			pthread_mutex_lock(&queue->lock);
+			queue->next = first;
+			queue->end = end;
+			pthread_mutex_unlock(&queue->lock);
+			return 1;
+		}
+	}
+	return 0;
+}
+/*
+***************************************************************************************************************
+	End StealTasks
+***************************************************************************************************************
+*/
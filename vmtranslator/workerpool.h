@@ -0,0 +1,87 @@
+/*! \file
+***************************************************************************************************************
+file name:					workerpool.h
+*	\copyright				FourE
+*	\brief					worker pool header file
+*	\author					agent
+*	\date	created:			2026-10-17
+
+***************************************************************************************************************
+\par	Description
+***************************************************************************************************************
+
+	The worker pool executes a number of independent tasks on a number of threads
+
+***************************************************************************************************************
+\note
+***************************************************************************************************************
+
+	Tasks are identified by their index, the order in which tasks are executed is not defined. Idle workers
+	steal tasks from busy workers.
+
+***************************************************************************************************************
+*/
+
+#ifndef __WORKERPOOL_H
+#define __WORKERPOOL_H
+
+/*
+***************************************************************************************************************
+	INCLUDE FILES
+***************************************************************************************************************
+*/
+
+#include <stdint.h>
+
+/*
+***************************************************************************************************************
+	Make header CPP compatible
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+***************************************************************************************************************
+	GLOBAL DEFINES
+***************************************************************************************************************
+*/
+
+#define MAX_WORKER_THREADS		(64)
+
+/*
+***************************************************************************************************************
+	GLOBAL TYPEDEF
+***************************************************************************************************************
+*/
+
+typedef void (*F_workerTask)(void* context, uint32_t taskIndex);
+
+/*
+***************************************************************************************************************
+	GLOBAL VARS
+***************************************************************************************************************
+*/
+
+
+/*
+***************************************************************************************************************
+	GLOBAL FUNCTION PROTOTYPES
+***************************************************************************************************************
+*/
+
+void RunWorkerPool(F_workerTask task, void* context, uint32_t taskCount, uint16_t threadCount);
+
+/*
+***************************************************************************************************************
+
+***************************************************************************************************************
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		// __WORKERPOOL_H